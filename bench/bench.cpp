@@ -0,0 +1,386 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <regex>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+namespace robot {
+namespace bench {
+
+namespace {
+
+struct Benchmark {
+    std::string name;
+    Function function;
+};
+
+struct Run {
+    std::string name;           ///< 输出名称（聚合结果带 _mean 等后缀）
+    std::string run_name;       ///< 基准名称
+    int family_index = 0;
+    int repetition_index = 0;
+    std::string aggregate;      ///< 空为单次运行
+    int64_t iterations = 0;
+    double real_ns = 0;         ///< 每次迭代
+    double cpu_ns = 0;
+    std::string error;
+};
+
+struct Settings {
+    std::string filter = ".";
+    double min_time = 0.5;
+    int repetitions = 1;
+    std::string out;
+    bool json_stdout = false;
+    bool list = false;
+    std::string executable;
+    std::map<std::string, std::string> options;
+};
+
+std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+Settings& settings() {
+    static Settings s;
+    return s;
+}
+
+int64_t realNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t cpuNs() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+bool startsWith(const std::string& s, const char* prefix, std::string* value) {
+    size_t n = std::strlen(prefix);
+    if (s.compare(0, n, prefix) != 0) {
+        return false;
+    }
+    *value = s.substr(n);
+    return true;
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if ((unsigned char)c < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string formatTime(double ns) {
+    char buf[32];
+    if (ns < 1e4) {
+        std::snprintf(buf, sizeof(buf), "%.1f ns", ns);
+    } else if (ns < 1e7) {
+        std::snprintf(buf, sizeof(buf), "%.2f us", ns / 1e3);
+    } else {
+        std::snprintf(buf, sizeof(buf), "%.2f ms", ns / 1e6);
+    }
+    return buf;
+}
+
+/*
+ * 运行一次基准：迭代次数从 1 开始，按上一轮耗时预测达到 min_time 所需的次数（每轮最多放大 10 倍），
+ * 报告最后一轮的每次迭代时间
+ */
+Run runOnce(const Benchmark& benchmark, int family_index, int repetition) {
+    const double min_ns = settings().min_time * 1e9;
+    int64_t iterations = 1;
+    Run run;
+    run.name = benchmark.name;
+    run.run_name = benchmark.name;
+    run.family_index = family_index;
+    run.repetition_index = repetition;
+    for (;;) {
+        State state(iterations);
+        benchmark.function(state);
+        if (state.error_occurred()) {
+            run.error = state.error_message();
+            return run;
+        }
+        run.iterations = iterations;
+        run.real_ns = state.real_ns() / iterations;
+        run.cpu_ns = state.cpu_ns() / iterations;
+        if (state.real_ns() >= min_ns || iterations >= 1000000000LL) {
+            return run;
+        }
+        double multiplier = state.real_ns() > min_ns / 10 ? min_ns * 1.4 / state.real_ns() : 10.0;
+        iterations = std::max((int64_t)(iterations * multiplier), iterations + 1);
+        iterations = std::min<int64_t>(iterations, 1000000000LL);
+    }
+}
+
+Run aggregate(const std::vector<Run>& runs, const char* name) {
+    Run out = runs.front();
+    out.aggregate = name;
+    out.name = out.run_name + "_" + name;
+    out.repetition_index = 0;
+    std::vector<double> real, cpu;
+    for (const Run& r : runs) {
+        real.push_back(r.real_ns);
+        cpu.push_back(r.cpu_ns);
+    }
+    auto reduce = [name](std::vector<double> v) {
+        double mean = 0;
+        for (double x : v) {
+            mean += x;
+        }
+        mean /= v.size();
+        if (std::strcmp(name, "mean") == 0) {
+            return mean;
+        }
+        if (std::strcmp(name, "median") == 0) {
+            std::sort(v.begin(), v.end());
+            size_t n = v.size();
+            return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+        }
+        double var = 0;
+        for (double x : v) {
+            var += (x - mean) * (x - mean);
+        }
+        return v.size() > 1 ? std::sqrt(var / (v.size() - 1)) : 0.0;
+    };
+    out.real_ns = reduce(real);
+    out.cpu_ns = reduce(cpu);
+    return out;
+}
+
+void printConsole(const Run& run) {
+    if (!run.error.empty()) {
+        std::printf("%-44s ERROR: %s\n", run.name.c_str(), run.error.c_str());
+    } else if (!run.aggregate.empty()) {
+        std::printf("%-44s %14s %14s\n", run.name.c_str(), formatTime(run.real_ns).c_str(),
+                    formatTime(run.cpu_ns).c_str());
+    } else {
+        std::printf("%-44s %14s %14s %12lld\n", run.name.c_str(), formatTime(run.real_ns).c_str(),
+                    formatTime(run.cpu_ns).c_str(), (long long)run.iterations);
+    }
+    std::fflush(stdout);
+}
+
+/*
+ * 输出与 Google Benchmark 的 JSON 格式一致，可以直接用其 tools/compare.py 或 bench/compare.py 比较
+ */
+void writeJson(FILE* out, const std::vector<Run>& runs) {
+    char date[64];
+    time_t now = time(nullptr);
+    tm local;
+    localtime_r(&now, &local);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", &local);
+    char host[256] = {0};
+    gethostname(host, sizeof(host) - 1);
+
+    std::fprintf(out, "{\n  \"context\": {\n");
+    std::fprintf(out, "    \"date\": \"%s\",\n", date);
+    std::fprintf(out, "    \"host_name\": \"%s\",\n", jsonEscape(host).c_str());
+    std::fprintf(out, "    \"executable\": \"%s\",\n", jsonEscape(settings().executable).c_str());
+    std::fprintf(out, "    \"num_cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+#if defined(__loongarch__)
+    std::fprintf(out, "    \"arch\": \"loongarch64\",\n");
+#elif defined(__x86_64__)
+    std::fprintf(out, "    \"arch\": \"x86_64\",\n");
+#elif defined(__aarch64__)
+    std::fprintf(out, "    \"arch\": \"aarch64\",\n");
+#else
+    std::fprintf(out, "    \"arch\": \"unknown\",\n");
+#endif
+    std::fprintf(out, "    \"compiler\": \"%s\",\n", jsonEscape(__VERSION__).c_str());
+#ifdef BENCH_GIT_REVISION
+    std::fprintf(out, "    \"git_revision\": \"%s\",\n", BENCH_GIT_REVISION);
+#endif
+#ifdef __OPTIMIZE__
+    std::fprintf(out, "    \"library_build_type\": \"release\"\n");
+#else
+    std::fprintf(out, "    \"library_build_type\": \"debug\"\n");
+#endif
+    std::fprintf(out, "  },\n  \"benchmarks\": [");
+    for (size_t i = 0; i < runs.size(); ++i) {
+        const Run& r = runs[i];
+        std::fprintf(out, "%s\n    {\n", i ? "," : "");
+        std::fprintf(out, "      \"name\": \"%s\",\n", jsonEscape(r.name).c_str());
+        std::fprintf(out, "      \"family_index\": %d,\n", r.family_index);
+        std::fprintf(out, "      \"run_name\": \"%s\",\n", jsonEscape(r.run_name).c_str());
+        std::fprintf(out, "      \"run_type\": \"%s\",\n", r.aggregate.empty() ? "iteration" : "aggregate");
+        std::fprintf(out, "      \"repetitions\": %d,\n", settings().repetitions);
+        std::fprintf(out, "      \"repetition_index\": %d,\n", r.repetition_index);
+        if (!r.aggregate.empty()) {
+            std::fprintf(out, "      \"aggregate_name\": \"%s\",\n", r.aggregate.c_str());
+        }
+        if (!r.error.empty()) {
+            std::fprintf(out, "      \"error_occurred\": true,\n");
+            std::fprintf(out, "      \"error_message\": \"%s\",\n", jsonEscape(r.error).c_str());
+        }
+        std::fprintf(out, "      \"iterations\": %lld,\n", (long long)r.iterations);
+        std::fprintf(out, "      \"real_time\": %.6e,\n", r.real_ns);
+        std::fprintf(out, "      \"cpu_time\": %.6e,\n", r.cpu_ns);
+        std::fprintf(out, "      \"time_unit\": \"ns\"\n    }");
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+}
+
+} // namespace
+
+State::Iterator State::begin() {
+    ResumeTiming();
+    return Iterator(this, iterations_);
+}
+
+void State::PauseTiming() {
+    if (running_) {
+        real_ns_ += realNs() - real_start_;
+        cpu_ns_ += cpuNs() - cpu_start_;
+        running_ = false;
+    }
+}
+
+void State::ResumeTiming() {
+    if (!running_) {
+        real_start_ = realNs();
+        cpu_start_ = cpuNs();
+        running_ = true;
+    }
+}
+
+void State::stopTiming() {
+    PauseTiming();
+}
+
+void State::SkipWithError(const std::string& message) {
+    error_ = message.empty() ? "skipped" : message;
+    PauseTiming();
+}
+
+void RegisterBenchmark(const std::string& name, Function function) {
+    registry().push_back(Benchmark{name, std::move(function)});
+}
+
+std::string Option(const std::string& key, const std::string& fallback) {
+    auto it = settings().options.find(key);
+    return it == settings().options.end() ? fallback : it->second;
+}
+
+bool Initialize(int argc, char** argv) {
+    Settings& s = settings();
+    s.executable = argc > 0 ? argv[0] : "";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i], value;
+        if (startsWith(arg, "--benchmark_filter=", &value)) {
+            s.filter = value;
+        } else if (startsWith(arg, "--benchmark_min_time=", &value)) {
+            s.min_time = std::atof(value.c_str());     // 允许 "0.5s"
+        } else if (startsWith(arg, "--benchmark_repetitions=", &value)) {
+            s.repetitions = std::max(1, std::atoi(value.c_str()));
+        } else if (startsWith(arg, "--benchmark_out=", &value)) {
+            s.out = value;
+        } else if (startsWith(arg, "--benchmark_format=", &value)) {
+            s.json_stdout = value == "json";
+        } else if (arg == "--benchmark_list_tests") {
+            s.list = true;
+        } else if (arg.size() > 2 && arg.compare(0, 2, "--") == 0 && arg.find('=') != std::string::npos) {
+            size_t eq = arg.find('=');
+            s.options[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+        } else {
+            std::fprintf(stderr, "未知参数 %s\n", arg.c_str());
+            std::fprintf(stderr, "用法：%s [--benchmark_filter=正则] [--benchmark_min_time=秒] [--benchmark_repetitions=N]\n"
+                                 "       [--benchmark_out=结果.json] [--benchmark_format=console|json] [--benchmark_list_tests]\n"
+                                 "       [--data=图片目录] [--config=参数文件] [--model=onnx模型]\n", s.executable.c_str());
+            return false;
+        }
+    }
+    if (s.min_time <= 0) {
+        s.min_time = 0.5;
+    }
+    return true;
+}
+
+int RunSpecifiedBenchmarks() {
+    const Settings& s = settings();
+    std::regex filter;
+    try {
+        filter = std::regex(s.filter);
+    } catch (const std::regex_error&) {
+        std::fprintf(stderr, "无效的过滤正则 %s\n", s.filter.c_str());
+        return 0;
+    }
+
+    std::vector<Run> runs;
+    int count = 0;
+    if (!s.list && !s.json_stdout) {
+        std::printf("%-44s %14s %14s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+        std::printf("%s\n", std::string(87, '-').c_str());
+    }
+    for (size_t index = 0; index < registry().size(); ++index) {
+        const Benchmark& benchmark = registry()[index];
+        if (!std::regex_search(benchmark.name, filter)) {
+            continue;
+        }
+        ++count;
+        if (s.list) {
+            std::printf("%s\n", benchmark.name.c_str());
+            continue;
+        }
+        std::vector<Run> repeats;
+        for (int rep = 0; rep < s.repetitions; ++rep) {
+            Run run = runOnce(benchmark, (int)index, rep);
+            if (!s.json_stdout) {
+                printConsole(run);
+            }
+            runs.push_back(run);
+            if (!run.error.empty()) {
+                break;
+            }
+            repeats.push_back(run);
+        }
+        if (repeats.size() > 1) {
+            for (const char* name : {"mean", "median", "stddev"}) {
+                runs.push_back(aggregate(repeats, name));
+                if (!s.json_stdout) {
+                    printConsole(runs.back());
+                }
+            }
+        }
+    }
+
+    if (s.json_stdout) {
+        writeJson(stdout, runs);
+    }
+    if (!s.out.empty() && !s.list) {
+        FILE* out = std::fopen(s.out.c_str(), "w");
+        if (out == nullptr) {
+            std::perror(s.out.c_str());
+        } else {
+            writeJson(out, runs);
+            std::fclose(out);
+        }
+    }
+    return count;
+}
+
+} // namespace bench
+} // namespace robot
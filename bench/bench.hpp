@@ -0,0 +1,111 @@
+#ifndef ROBOT_BENCH_HPP
+#define ROBOT_BENCH_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace robot {
+namespace bench {
+
+/**
+ * @brief 单个基准的计时状态
+ *
+ * 写法与 Google Benchmark 相同，被测代码放在 for (auto _ : state) 循环中；循环外的准备工作不计时，
+ * 循环内需要排除的部分用 PauseTiming() / ResumeTiming() 包围。框架自动增加迭代次数直到累计时间
+ * 达到 --benchmark_min_time。
+ */
+class State {
+public:
+    struct __attribute__((unused)) Value {};   ///< for (auto _ : state) 中的 _ 不触发未使用警告
+
+    class Iterator {
+    public:
+        Iterator(State* state, int64_t remaining) : state_(state), remaining_(remaining) {}
+        Value operator*() const { return Value(); }
+        void operator++() { --remaining_; }
+        bool operator!=(const Iterator&) {
+            if (remaining_ > 0) {
+                return true;
+            }
+            state_->stopTiming();
+            return false;
+        }
+
+    private:
+        State* state_;
+        int64_t remaining_;
+    };
+
+    explicit State(int64_t iterations) : iterations_(iterations) {}
+
+    Iterator begin();
+    Iterator end() { return Iterator(this, 0); }
+
+    void PauseTiming();
+    void ResumeTiming();
+
+    /// 标记本基准无法运行（例如缺少模型文件），之后应直接 return，结果中记录错误信息
+    void SkipWithError(const std::string& message);
+
+    int64_t iterations() const { return iterations_; }
+    bool error_occurred() const { return !error_.empty(); }
+    const std::string& error_message() const { return error_; }
+    double real_ns() const { return real_ns_; }
+    double cpu_ns() const { return cpu_ns_; }
+
+private:
+    void stopTiming();
+
+    int64_t iterations_;
+    bool running_ = false;
+    int64_t real_start_ = 0;
+    int64_t cpu_start_ = 0;
+    double real_ns_ = 0;
+    double cpu_ns_ = 0;
+    std::string error_;
+};
+
+using Function = std::function<void(State&)>;
+
+/**
+ * @brief 注册一个基准，名称按 "被测函数/输入" 组织，--benchmark_filter 按名称正则匹配
+ */
+void RegisterBenchmark(const std::string& name, Function function);
+
+/**
+ * @brief 读取 --key=value 形式的自定义参数（例如 --data、--model），没有时返回 fallback
+ */
+std::string Option(const std::string& key, const std::string& fallback = "");
+
+/**
+ * @brief 解析命令行参数，必须在注册和 RunSpecifiedBenchmarks 之前调用
+ * @return 参数有误时返回 false
+ */
+bool Initialize(int argc, char** argv);
+
+/**
+ * @brief 运行匹配的基准，控制台输出表格，--benchmark_out 指定时另存 JSON
+ * @return 运行的基准数
+ */
+int RunSpecifiedBenchmarks();
+
+/// 阻止编译器优化掉结果
+template <typename T>
+inline void DoNotOptimize(T& value) {
+    asm volatile("" : "+m"(value) : : "memory");
+}
+
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "m"(value) : "memory");
+}
+
+inline void ClobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+} // namespace bench
+} // namespace robot
+
+#endif // ROBOT_BENCH_HPP
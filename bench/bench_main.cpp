@@ -0,0 +1,27 @@
+// 视觉与控制核基准
+// 每个被测函数单独计时，输入取自 bench/data 下的赛道图；结果 JSON 与 Google Benchmark 格式一致，
+// 保存每次提交的结果后用 bench/compare.py 比较：
+//   ./bench --benchmark_repetitions=5 --benchmark_out=bench_$(git rev-parse --short HEAD).json
+//   python3 bench/compare.py bench_old.json bench_new.json
+// 构建见 bench/CMakeLists.txt（主机单独构建，或主工程 -DBUILD_BENCH=ON 交叉编译）
+#include "bench.hpp"
+#include <cstdio>
+
+void register_control_benchmarks();
+bool register_vision_benchmarks();
+
+int main(int argc, char** argv)
+{
+    if (!robot::bench::Initialize(argc, argv)) {
+        return 2;
+    }
+    register_control_benchmarks();
+    if (!register_vision_benchmarks()) {
+        return 2;
+    }
+    if (robot::bench::RunSpecifiedBenchmarks() == 0) {
+        fprintf(stderr, "没有匹配 --benchmark_filter 的基准\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+# 比较两次基准结果（bench --benchmark_out 输出的 JSON）
+# 有重复运行时用中位数，否则用各次运行的平均值；变慢超过阈值的项标记出来，存在时返回 1
+# 用法：python3 bench/compare.py old.json new.json [--threshold 5]
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    runs, medians = {}, {}
+    for b in data.get("benchmarks", []):
+        if b.get("error_occurred"):
+            continue
+        name = b.get("run_name", b["name"])
+        if b.get("run_type") == "aggregate":
+            if b.get("aggregate_name") == "median":
+                medians[name] = b["cpu_time"]
+        else:
+            runs.setdefault(name, []).append(b["cpu_time"])
+    result = {name: sum(times) / len(times) for name, times in runs.items()}
+    result.update(medians)
+    return data.get("context", {}), result
+
+
+def fmt(ns):
+    if ns < 1e4:
+        return "%.1f ns" % ns
+    if ns < 1e7:
+        return "%.2f us" % (ns / 1e3)
+    return "%.2f ms" % (ns / 1e6)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="比较两次基准结果")
+    parser.add_argument("old")
+    parser.add_argument("new")
+    parser.add_argument("--threshold", type=float, default=5.0, help="变慢超过该百分比时标记（默认 5）")
+    args = parser.parse_args()
+
+    old_ctx, old = load(args.old)
+    new_ctx, new = load(args.new)
+    print("old: %s %s" % (old_ctx.get("git_revision", ""), old_ctx.get("date", "")))
+    print("new: %s %s" % (new_ctx.get("git_revision", ""), new_ctx.get("date", "")))
+    if old_ctx.get("arch") != new_ctx.get("arch"):
+        print("注意：两次结果来自不同架构（%s / %s）" % (old_ctx.get("arch"), new_ctx.get("arch")))
+
+    print("\n%-44s %12s %12s %9s" % ("Benchmark", "Old", "New", "Change"))
+    print("-" * 80)
+    regressions = 0
+    for name in [n for n in new if n in old]:
+        change = (new[name] - old[name]) / old[name] * 100 if old[name] > 0 else 0.0
+        mark = ""
+        if change > args.threshold:
+            mark = "  <-- 变慢"
+            regressions += 1
+        print("%-44s %12s %12s %+8.1f%%%s" % (name, fmt(old[name]), fmt(new[name]), change, mark))
+    for name in sorted(set(old) ^ set(new)):
+        print("%-44s %s" % (name, "只在旧结果中" if name in old else "只在新结果中"))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
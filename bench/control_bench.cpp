@@ -0,0 +1,63 @@
+// 控制核基准：PID 单次计算（原 PIDCalculate 与控制任务使用的固定周期 PIDCalculateFixed）
+#include "bench.hpp"
+#include "PID.h"
+
+using robot::bench::State;
+
+static void init_pid(PID& pid)
+{
+    pid.Kp = 1.2f;
+    pid.Ki = 0.4f;
+    pid.Kd = 0.05f;
+    pid.Plimit = 100;
+    pid.Ilimit = 50;
+    pid.Dlimit = 50;
+    pid.Reslimit = 100;
+    pid.Dtau = 0.02f;
+}
+
+static void BM_PIDCalculate(State& state)
+{
+    PID pid;
+    PIDStatus status = {};
+    init_pid(pid);
+    status.target = 50;
+    float present = 0;
+    double time = 0;
+    for (auto _ : state) {
+        // 测量值与时间每次变化，避免整段计算被常量折叠
+        present += 0.37f;
+        if (present > 100) {
+            present = 0;
+        }
+        time += 0.01;
+        status.present = present;
+        status.time_present = time;
+        PIDCalculate(pid, &status);
+        robot::bench::DoNotOptimize(status.Res);
+    }
+}
+
+static void BM_PIDCalculateFixed(State& state)
+{
+    PID pid;
+    PIDStatus status = {};
+    init_pid(pid);
+    status.target = 50;
+    float present = 0;
+    for (auto _ : state) {
+        present += 0.37f;
+        if (present > 100) {
+            present = 0;
+        }
+        status.present = present;
+        PIDCalculateFixed(pid, &status, 0.01f);
+        robot::bench::DoNotOptimize(status.Res);
+    }
+}
+
+void register_control_benchmarks()
+{
+    robot::bench::RegisterBenchmark("PIDCalculate", BM_PIDCalculate);
+    robot::bench::RegisterBenchmark("PIDCalculateFixed", BM_PIDCalculateFixed);
+}
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+# 生成基准测试用的合成赛道图（320x240 彩色 PNG）：直道、左右弯、十字、左圆环
+# 只依赖标准库，修改赛道形状后重新运行：python3 bench/data/make_track_images.py
+import math
+import os
+import struct
+import zlib
+
+W, H = 320, 240
+HORIZON = 40                    # 赛道最远处所在行
+ROAD = (228, 228, 222)          # 白色赛道
+FLOOR = (46, 70, 128)           # 蓝色场地
+
+
+def half_width(y):
+    return 18 + 0.56 * (y - HORIZON)
+
+
+def straight(x, y):
+    return y >= HORIZON and abs(x - 160) <= half_width(y)
+
+
+def curve(sign):
+    def road(x, y):
+        if y < HORIZON:
+            return False
+        center = 160 + sign * 0.002 * (H - y) ** 2
+        return abs(x - center) <= half_width(y)
+    return road
+
+
+def cross(x, y):
+    return straight(x, y) or 96 <= y <= 132
+
+
+def circle_left(x, y):
+    if straight(x, y):
+        return True
+    r = math.hypot(x - 84, y - 112)
+    return 34 <= r <= 72 and y >= HORIZON
+
+
+def shade(color, y):
+    # 远处略暗，避免整幅图只有两种灰度
+    k = 0.85 + 0.15 * y / (H - 1)
+    return bytes(int(c * k) for c in color)
+
+
+def write_png(path, road):
+    rows = bytearray()
+    for y in range(H):
+        rows.append(0)
+        road_px, floor_px = shade(ROAD, y), shade(FLOOR, y)
+        for x in range(W):
+            rows += road_px if road(x, y) else floor_px
+    chunk = lambda tag, data: (struct.pack(">I", len(data)) + tag + data +
+                               struct.pack(">I", zlib.crc32(tag + data) & 0xffffffff))
+    png = b"\x89PNG\r\n\x1a\n"
+    png += chunk(b"IHDR", struct.pack(">IIBBBBB", W, H, 8, 2, 0, 0, 0))
+    png += chunk(b"IDAT", zlib.compress(bytes(rows), 9))
+    png += chunk(b"IEND", b"")
+    with open(path, "wb") as f:
+        f.write(png)
+
+
+if __name__ == "__main__":
+    here = os.path.dirname(os.path.abspath(__file__))
+    scenes = {
+        "straight": straight,
+        "curve_left": curve(-1),
+        "curve_right": curve(1),
+        "cross": cross,
+        "circle_left": circle_left,
+    }
+    for name, road in scenes.items():
+        write_png(os.path.join(here, "track_%s.png" % name), road)
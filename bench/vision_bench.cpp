@@ -0,0 +1,245 @@
+// 视觉核基准：输入为 bench/data 下的合成赛道图（make_track_images.py 生成），寻线相关的核按赛道场景分别计时。
+// 各核在 Img_Store::Draw_EN = false 下运行（不含 Img_Track 绘制），被测核之前的步骤在计时循环外完成。
+#include "bench.hpp"
+#include "common_system.h"
+#include "common_program.h"
+#include "display_show.h"
+#include "inference.h"
+#include "myacross.h"
+
+#include <cstring>
+#include <memory>
+
+using robot::bench::State;
+
+#ifndef BENCH_DATA_DIR
+#define BENCH_DATA_DIR "bench/data"
+#endif
+#ifndef BENCH_CONFIG_FILE
+#define BENCH_CONFIG_FILE "config/config_0.json"
+#endif
+
+struct TrackScene {
+    std::string name;
+    cv::Mat color;
+};
+
+static const char* SCENE_NAMES[] = {"straight", "curve_left", "curve_right", "cross", "circle_left"};
+
+static std::vector<TrackScene> g_scenes;
+static std::vector<JSON_TrackConfigData> g_track_config;
+static std::vector<JSON_FunctionConfigData> g_function_config;
+static double g_perspective[3][3];
+static ImgProcess g_imgProcess;
+static Judge g_judge;
+
+/*
+    每个基准独立的一份图像与路径数据（Img_Store、Data_Path 较大，放在堆上）
+*/
+struct TrackContext {
+    std::unique_ptr<Img_Store> img{new Img_Store()};
+    std::unique_ptr<Data_Path> path{new Data_Path()};
+    std::unique_ptr<Function_EN> fn{new Function_EN()};
+
+    /// 载入场景并完成预处理与八邻域寻线，之后的核直接使用其结果
+    explicit TrackContext(const TrackScene& scene) {
+        path->JSON_TrackConfigData_v = g_track_config;
+        fn->JSON_FunctionConfigData_v = g_function_config;
+        fn->Loop_Kind_EN = CAMERA_CATCH_LOOP;
+        img->Draw_EN = false;
+        scene.color.copyTo(img->Img_Color);
+        g_imgProcess.imgPreProc(img.get(), path.get(), fn.get());
+        imgSearch_l_r(img.get(), path.get());
+    }
+};
+
+/*
+    俯视变换：结果图（RESULT_COL x RESULT_ROW）映射到原图中的梯形区域，与车上标定得到的矩阵形式相同
+*/
+static void init_perspective()
+{
+    std::vector<cv::Point2f> result = {{0, 0}, {RESULT_COL - 1, 0}, {RESULT_COL - 1, RESULT_ROW - 1}, {0, RESULT_ROW - 1}};
+    std::vector<cv::Point2f> source = {{100, 60}, {220, 60}, {image_w - 1, image_h - 1}, {0, image_h - 1}};
+    cv::Mat matrix = cv::getPerspectiveTransform(result, source);
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            g_perspective[i][j] = matrix.at<double>(i, j);
+        }
+    }
+}
+
+static void BM_imgPreProc(State& state, const TrackScene& scene)
+{
+    TrackContext ctx(scene);
+    for (auto _ : state) {
+        g_imgProcess.imgPreProc(ctx.img.get(), ctx.path.get(), ctx.fn.get());
+    }
+}
+
+static void BM_imgSearch_l_r(State& state, const TrackScene& scene)
+{
+    TrackContext ctx(scene);
+    for (auto _ : state) {
+        imgSearch_l_r(ctx.img.get(), ctx.path.get());
+    }
+}
+
+static void BM_ImgPathSearch(State& state, const TrackScene& scene)
+{
+    TrackContext ctx(scene);
+    for (auto _ : state) {
+        ImgPathSearch(ctx.img.get(), ctx.path.get());
+    }
+}
+
+static void BM_ImgSideSearch(State& state, const TrackScene& scene)
+{
+    TrackContext ctx(scene);
+    for (auto _ : state) {
+        ImgSideSearch(ctx.img.get(), ctx.path.get());
+    }
+}
+
+static void BM_InflectionPointSearch(State& state, const TrackScene& scene)
+{
+    TrackContext ctx(scene);
+    for (auto _ : state) {
+        g_judge.InflectionPointSearch(ctx.img.get(), ctx.path.get());
+    }
+}
+
+static void BM_BendPointSearch(State& state, const TrackScene& scene)
+{
+    TrackContext ctx(scene);
+    for (auto _ : state) {
+        g_judge.BendPointSearch(ctx.img.get(), ctx.path.get());
+    }
+}
+
+static void BM_ApplyInversePerspective(State& state, const TrackScene& scene)
+{
+    TrackContext ctx(scene);
+    ImagePerspective_Init(ctx.img.get(), g_perspective);
+    for (auto _ : state) {
+        ApplyInversePerspective(ctx.img.get());
+    }
+}
+
+static void BM_ImagePerspective_Init(State& state)
+{
+    std::unique_ptr<Img_Store> img(new Img_Store());
+    for (auto _ : state) {
+        ImagePerspective_Init(img.get(), g_perspective);
+    }
+}
+
+// cross_fill 直接在二值图上补线，每次迭代前恢复（不计时）
+static void BM_cross_fill(State& state, const TrackScene& scene)
+{
+    TrackContext ctx(scene);
+    Data_Path* path = ctx.path.get();
+    std::vector<uint8> original(&ctx.img->bin_image[0][0], &ctx.img->bin_image[0][0] + image_h * image_w);
+    for (auto _ : state) {
+        state.PauseTiming();
+        memcpy(ctx.img->bin_image[0], original.data(), original.size());
+        state.ResumeTiming();
+        cross_fill(ctx.img->bin_image, path->l_border, path->r_border, (uint16)path->NumSearch[0],
+                   (uint16)path->NumSearch[1], path->dir_l, path->dir_r, path->points_l, path->points_r);
+    }
+}
+
+// 显存用普通内存代替（与 test/ips200_fb_test.cpp 相同）
+static void BM_displayMatOnIPS200(State& state, const cv::Mat& image)
+{
+    static std::vector<uint16> screen(240 * 320);
+    ips200_attach(screen.data(), 240, 320, 240);
+    for (auto _ : state) {
+        displayMatOnIPS200(image);
+    }
+}
+
+static void BM_runInference(State& state, const TrackScene& scene)
+{
+    static std::unique_ptr<Inference> inference;
+    std::string model = robot::bench::Option("model");
+    if (model.empty()) {
+        state.SkipWithError("需要 --model=<onnx 模型>");
+        return;
+    }
+    if (!inference) {
+        inference.reset(new Inference(model, cv::Size(160, 160), "", false));
+    }
+    for (auto _ : state) {
+        std::vector<Detection> detections = inference->runInference(scene.color);
+        robot::bench::DoNotOptimize(detections);
+    }
+}
+
+/*
+    读取赛道图与参数文件并注册视觉基准
+    @返回值说明
+    图片或参数文件缺失时返回 false
+*/
+bool register_vision_benchmarks()
+{
+    using robot::bench::RegisterBenchmark;
+    std::string data_dir = robot::bench::Option("data", BENCH_DATA_DIR);
+    std::string config = robot::bench::Option("config", BENCH_CONFIG_FILE);
+
+    for (const char* name : SCENE_NAMES) {
+        std::string path = data_dir + "/track_" + name + ".png";
+        TrackScene scene;
+        scene.name = name;
+        scene.color = cv::imread(path, cv::IMREAD_COLOR);
+        if (scene.color.empty() || scene.color.cols != CAMERA_W || scene.color.rows != CAMERA_H) {
+            fprintf(stderr, "无法读取 %dx%d 的赛道图 %s（--data 指定目录）\n", CAMERA_W, CAMERA_H, path.c_str());
+            return false;
+        }
+        g_scenes.push_back(scene);
+    }
+
+    std::unique_ptr<Data_Path> path(new Data_Path());
+    std::unique_ptr<Function_EN> fn(new Function_EN());
+    JSON_PIDConfigData pid;
+    SYNC sync;
+    if (!sync.ConfigData_Load(config.c_str(), path.get(), fn.get(), &pid)) {
+        return false;
+    }
+    g_track_config = path->JSON_TrackConfigData_v;
+    g_function_config = fn->JSON_FunctionConfigData_v;
+    init_perspective();
+
+    // 按被测函数分组，组内按场景
+    using SceneBenchmark = void (*)(State&, const TrackScene&);
+    const std::pair<const char*, SceneBenchmark> per_scene[] = {
+        {"imgPreProc", BM_imgPreProc},
+        {"imgSearch_l_r", BM_imgSearch_l_r},
+        {"ImgPathSearch", BM_ImgPathSearch},
+        {"ImgSideSearch", BM_ImgSideSearch},
+        {"InflectionPointSearch", BM_InflectionPointSearch},
+        {"BendPointSearch", BM_BendPointSearch},
+        {"ApplyInversePerspective", BM_ApplyInversePerspective},
+        {"cross_fill", BM_cross_fill},
+    };
+    for (const auto& entry : per_scene) {
+        for (const TrackScene& scene : g_scenes) {
+            SceneBenchmark function = entry.second;
+            const TrackScene* s = &scene;
+            RegisterBenchmark(std::string(entry.first) + "/" + scene.name, [function, s](State& state) {
+                function(state, *s);
+            });
+        }
+    }
+    RegisterBenchmark("ImagePerspective_Init", BM_ImagePerspective_Init);
+
+    // 显示：车上显示的是 320x240 彩色图，也测灰度输入
+    static cv::Mat gray;
+    cv::cvtColor(g_scenes[0].color, gray, cv::COLOR_BGR2GRAY);
+    const cv::Mat* color = &g_scenes[0].color;
+    RegisterBenchmark("displayMatOnIPS200/bgr", [color](State& state) { BM_displayMatOnIPS200(state, *color); });
+    RegisterBenchmark("displayMatOnIPS200/gray", [](State& state) { BM_displayMatOnIPS200(state, gray); });
+
+    const TrackScene* scene = &g_scenes[0];
+    RegisterBenchmark("runInference", [scene](State& state) { BM_runInference(state, *scene); });
+    return true;
+}
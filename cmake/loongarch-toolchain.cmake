@@ -0,0 +1,14 @@
+# 龙芯 2K0300 交叉编译工具链（主工程未指定工具链且不是主机构建时默认使用）
+#   cmake --preset loongarch   或   cmake -S . -B build -DCMAKE_TOOLCHAIN_FILE=cmake/loongarch-toolchain.cmake
+
+set(CMAKE_SYSTEM_NAME Linux)
+set(CMAKE_SYSTEM_PROCESSOR loongarch64)
+
+if(NOT DEFINED LOONGARCH_TOOLCHAIN_ROOT)
+    set(LOONGARCH_TOOLCHAIN_ROOT /opt/loongarch-gnu-toolchain)
+endif()
+
+# 设置C语言编译器、C++编译器的路径和名称
+set(CMAKE_C_COMPILER ${LOONGARCH_TOOLCHAIN_ROOT}/bin/loongarch64-linux-gnu-gcc)
+set(CMAKE_CXX_COMPILER ${LOONGARCH_TOOLCHAIN_ROOT}/bin/loongarch64-linux-gnu-g++)
+set(LOONGARCH_SYSROOT_INCLUDE ${LOONGARCH_TOOLCHAIN_ROOT}/loongarch64-linux-gnu/sysroot/usr/include)
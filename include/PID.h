@@ -14,6 +14,11 @@ struct PIDStatus
   double time_departure;
 
   float Res;					            //执行量
+
+  float feedforward = 0;          //前馈量（直接叠加到输出）
+  float d_filtered = 0;           //低通滤波后的微分项
+  bool saturated = false;         //本次输出是否被限幅
+  bool started = false;           //是否已有上一次测量值（首次计算不求微分）
 };
 
 struct PID
@@ -32,10 +37,20 @@ struct PID
   float Dlimit = 100;
   float Reslimit = 100;
 
+  float Dtau = 0;                 //微分项一阶低通时间常数（秒），0 不滤波
+
 
 };
 
 void MaxMinf(float * val,float absval);
 void PIDCalculate(PID &pid,PIDStatus *pidstatus);
 
+/*
+    固定周期PID：dt 由调用者按固定频率给出，不读取 time_present
+    微分作用于测量值（目标突变时无微分冲击）并经一阶低通；
+    条件积分抗饱和：输出已限幅且偏差会使其更饱和时暂停积分；输出叠加 feedforward
+*/
+void PIDCalculateFixed(PID &pid,PIDStatus *pidstatus,float dt);
+void PIDReset(PID &pid,PIDStatus *pidstatus);
+
 
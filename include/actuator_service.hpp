@@ -0,0 +1,155 @@
+#ifndef ROBOT_ACTUATOR_SERVICE_HPP
+#define ROBOT_ACTUATOR_SERVICE_HPP
+
+#include <semaphore.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "frame_pipeline.hpp"
+#include "latency_histogram.hpp"
+
+namespace robot {
+
+/**
+ * @brief 执行器服务线程选项
+ */
+struct ActuatorServiceOptions {
+    int cpu = -1;               ///< 服务线程绑定的CPU，-1 不绑定
+    int rt_priority = 0;        ///< 服务线程的 SCHED_FIFO 优先级，0 保持普通调度
+};
+
+/**
+ * @brief 单个通道的统计
+ */
+struct ActuatorChannelStats {
+    uint64_t commands = 0;                      ///< set() 次数
+    uint64_t writes = 0;                        ///< 实际写设备次数
+    uint64_t unchanged = 0;                     ///< 与已写入值相同而省去的命令
+    uint64_t coalesced = 0;                     ///< 写入前被新命令覆盖的命令
+    uint64_t errors = 0;                        ///< 写设备失败次数
+    uint32_t value = 0;                         ///< 最近写入的值
+    LatencyHistogram::Snapshot latency_us;      ///< 命令到写入完成的延迟（μs）
+};
+
+/**
+ * @brief 舵机、电机 PWM 与方向 GPIO 的写入服务
+ *
+ * 服务线程持有所有执行器的设备句柄。控制任务通过 set() 无锁提交每个通道的目标值
+ * （原子量保存最新值，信号量唤醒线程），服务线程只写最新值：
+ * - 与上次写入的值相同则不写；
+ * - 同一通道两次写入至少间隔一个 PWM 周期（舵机 50Hz 时 20ms），期间的命令合并为最后一个；
+ * - 记录每次写入从命令到写入完成的延迟；
+ * - 以 setFrame() 标记命令所属的帧时，该帧的命令全部写入设备后记录 glass-to-PWM 延迟。
+ *
+ * 通道在 start() 之前通过 addPwm()/addGpio() 添加，start() 之后通道表不再改变。
+ * 以 ZF_DRIVER_MMIO 编译时，start() 前已用 mmio_bind_pwm/mmio_bind_gpio 绑定的路径直接写寄存器。
+ */
+class ActuatorService {
+public:
+    static const int MAX_CHANNELS = 8;
+
+    ActuatorService();
+    ~ActuatorService();
+
+    ActuatorService(const ActuatorService&) = delete;
+    ActuatorService& operator=(const ActuatorService&) = delete;
+
+    /**
+     * @brief 添加 PWM 通道（写入 uint16 占空比，与 pwm_set_duty 相同）
+     * @param period_ns 最小写入间隔，一般为 PWM 周期；0 表示不限制
+     * @return 通道号，通道已满或已启动时返回 -1
+     */
+    int addPwm(const char* path, uint32_t period_ns);
+
+    /**
+     * @brief 添加 GPIO 通道（写入 ASCII '0'/'1'，与 gpio_set_level 相同），不限制写入间隔
+     * @return 通道号，通道已满或已启动时返回 -1
+     */
+    int addGpio(const char* path);
+
+    /**
+     * @brief 打开所有通道的设备并启动服务线程
+     * @return 已在运行或任一设备无法打开时返回false
+     */
+    bool start(const ActuatorServiceOptions& options = ActuatorServiceOptions());
+
+    /**
+     * @brief 写出未完成的命令后停止服务线程
+     */
+    void stop();
+
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 提交通道目标值（无锁，可在控制任务中调用；多个线程写同一通道时以最后一次为准）
+     */
+    void set(int channel, uint32_t value);
+
+    /**
+     * @brief 标记此前提交的命令所属的帧（在该帧各通道的 set() 之后调用）
+     *
+     * 服务线程处理完这些命令（写入设备，或与已写入的值相同），且没有因写入间隔暂缓的命令时，
+     * 以该时刻调用 FrameTracer::recordFrameActuated，每帧一次。命令在写入前被下一帧合并时，
+     * 记录的是下一帧命令写入的时刻，延迟不会偏小
+     */
+    void setFrame(uint64_t frame_id, int64_t sensor_ns);
+
+    /**
+     * @brief 通道统计（可在任意线程调用）
+     */
+    ActuatorChannelStats stats(int channel) const;
+
+    int channelCount() const { return channel_count_; }
+
+private:
+    struct Channel {
+        const char* path = nullptr;
+        bool gpio = false;
+        uint32_t period_ns = 0;
+        int fd = -1;
+        int mmio = -1;                          ///< 寄存器直写绑定号（ZF_DRIVER_MMIO），-1 写设备文件
+
+        // 控制任务写，服务线程读
+        std::atomic<uint64_t> command{0};       ///< 高32位命令序号，低32位目标值
+        std::atomic<int64_t> command_ns{0};     ///< 最新命令的提交时间
+
+        // 只由服务线程写
+        uint32_t written_seq = 0;
+        uint32_t written_value = 0;
+        bool has_written = false;
+        int64_t written_ns = 0;
+
+        std::atomic<uint64_t> writes{0};
+        std::atomic<uint64_t> unchanged{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<uint32_t> value{0};
+        LatencyHistogram latency_us;
+    };
+
+    struct FrameTag {
+        uint64_t frame_id;
+        int64_t sensor_ns;
+    };
+
+    int addChannel(const char* path, bool gpio, uint32_t period_ns);
+    void run(ActuatorServiceOptions options);
+    int64_t service(int64_t now_ns, bool flush);
+    bool writeChannel(Channel& channel, uint32_t value);
+
+    Channel channels_[MAX_CHANNELS];
+    int channel_count_ = 0;
+    LatestValue<FrameTag> frame_;               ///< 控制任务写，服务线程读
+    uint64_t actuated_frame_ = 0;               ///< 已记录 glass-to-PWM 的帧（只由服务线程访问）
+    bool has_actuated_ = false;
+    sem_t wakeup_;
+    std::atomic<bool> pending_{false};
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+} // namespace robot
+
+#endif // ROBOT_ACTUATOR_SERVICE_HPP
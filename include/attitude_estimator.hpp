@@ -0,0 +1,143 @@
+#ifndef ROBOT_ATTITUDE_ESTIMATOR_HPP
+#define ROBOT_ATTITUDE_ESTIMATOR_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "frame_pipeline.hpp"
+#include "zf_device_imu_core.h"
+
+namespace robot {
+
+/**
+ * @brief 姿态滤波算法
+ */
+enum class AttitudeFilter {
+    MADGWICK,           ///< Madgwick 梯度下降（六轴，无磁力计）
+    COMPLEMENTARY,      ///< 四元数互补滤波：加速度方向误差按比例修正陀螺仪（Mahony 比例项）
+};
+
+/**
+ * @brief 姿态解算选项
+ */
+struct AttitudeOptions {
+    AttitudeFilter filter = AttitudeFilter::MADGWICK;
+    float madgwick_beta = 0.033f;                   ///< Madgwick 收敛增益，越大加速度修正越强、越易受振动干扰
+    float complementary_tau_s = 1.0f;               ///< 互补滤波时间常数（秒），加速度修正增益为 1/tau
+    int64_t calibration_ns = 1000000000LL;          ///< 零偏标定时长，0 表示不标定（零偏为0）
+    float calibration_max_range = 0.05f;            ///< 标定期间陀螺仪任一轴的波动超过该值（rad/s）视为在运动，重新标定
+    int64_t max_gap_ns = 500000000LL;               ///< 相邻样本间隔超过该值时不积分（数据中断后重新开始）
+};
+
+/**
+ * @brief 姿态解算结果
+ */
+struct AttitudeState {
+    int64_t timestamp_ns = 0;       ///< 最新样本时间（CLOCK_MONOTONIC 纳秒）
+    float q[4] = {1, 0, 0, 0};      ///< 姿态四元数 (w, x, y, z)
+    float roll = 0;                 ///< 横滚角（rad）
+    float pitch = 0;                ///< 俯仰角（rad）
+    float yaw = 0;                  ///< 偏航角（rad，-π ~ π）
+    double heading = 0;             ///< 展开后的航向角（rad，连续累计，不在 ±π 处跳变）
+    float yaw_rate = 0;             ///< 去零偏后的 z 轴角速度（rad/s）
+    float gyro_bias[3] = {0, 0, 0}; ///< 陀螺仪零偏（原始值 LSB）
+};
+
+/**
+ * @brief IMU 姿态解算：零偏标定 + Madgwick/互补滤波 + 航向展开 + 转角触发
+ *
+ * update() 逐样本调用（单写者，通常挂在 ImuStream 的采集线程上），结果通过 state() 在任意线程读取。
+ * 启动后先静止标定 calibration_ns 时长的陀螺仪零偏，同时由平均加速度确定初始横滚与俯仰，
+ * 标定完成前不输出姿态。
+ *
+ * 转角触发：armYawTrigger(N) 以下一个样本的航向为基准，航向变化达到 ±N 度时置位触发标志，
+ * 判断在每个样本上进行，触发延迟不超过一个 IMU 采样周期（加上缓冲区模式下的批量读取延迟）。
+ */
+class AttitudeEstimator {
+public:
+    /**
+     * @param gyro_scale 陀螺仪原始值到 rad/s 的比例（IMUDevice::get_gyro_scale）
+     */
+    explicit AttitudeEstimator(double gyro_scale = 1.0, const AttitudeOptions& options = AttitudeOptions());
+
+    /**
+     * @brief 修改选项与比例（不能与 update 并发调用），之后重新标定
+     */
+    void configure(double gyro_scale, const AttitudeOptions& options);
+
+    /**
+     * @brief 处理一个样本（单写者）
+     * @return 标定完成并更新了姿态时返回true
+     */
+    bool update(const imu_sample_t& sample);
+
+    /**
+     * @brief 请求重新标定零偏（任意线程，下一个样本开始生效，标定期间需保持静止）
+     */
+    void requestCalibration();
+
+    bool isCalibrated() const { return calibrated_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 读取最新姿态（不自旋，可在高于采集线程优先级的控制任务中调用）
+     * @return 标定完成前，或采集线程持续更新使重读超过上限时返回false，out 保持不变
+     */
+    bool state(AttitudeState& out) const { return state_.load(out); }
+
+    /**
+     * @brief 设置转角触发（任意线程）：从下一个样本起航向变化绝对值达到 degrees 时触发
+     */
+    void armYawTrigger(double degrees);
+
+    /**
+     * @brief 取消转角触发并清除触发标志（任意线程）
+     */
+    void disarmYawTrigger();
+
+    /**
+     * @brief 转角触发是否已触发
+     * @param trigger_ns 非空时返回触发样本的时间戳
+     */
+    bool yawTriggered(int64_t* trigger_ns = nullptr) const;
+
+private:
+    void resetFilter();
+    void calibrate(const imu_sample_t& sample);
+    void integrate(const float gyro[3], const float acc[3], float dt);
+    void publish(const imu_sample_t& sample, float yaw_rate);
+    void checkYawTrigger(int64_t timestamp_ns);
+
+    AttitudeOptions options_;
+    double gyro_scale_;
+
+    // 只由写者访问
+    bool have_last_ = false;
+    int64_t last_ns_ = 0;
+    float q_[4] = {1, 0, 0, 0};
+    float bias_[3] = {0, 0, 0};
+    float last_yaw_ = 0;
+    double heading_ = 0;
+    int64_t calib_start_ns_ = 0;
+    int64_t calib_count_ = 0;
+    double calib_gyro_sum_[3] = {0, 0, 0};
+    double calib_acc_sum_[3] = {0, 0, 0};
+    int16_t calib_min_[3] = {0, 0, 0};
+    int16_t calib_max_[3] = {0, 0, 0};
+    uint32_t seen_calib_gen_ = 0;
+    uint32_t seen_trigger_gen_ = 0;
+    bool trigger_active_ = false;
+    double trigger_ref_ = 0;
+
+    // 跨线程
+    std::atomic<bool> calibrated_{false};
+    std::atomic<uint32_t> calib_gen_{0};
+    std::atomic<uint32_t> trigger_gen_{0};
+    std::atomic<double> trigger_target_{0};     // rad，0 表示未设置
+    std::atomic<uint32_t> triggered_gen_{~0u};  // 触发时所属的 trigger_gen_，与当前不同表示未触发
+    std::atomic<int64_t> trigger_ns_{0};
+    LatestValue<AttitudeState> state_;
+};
+
+} // namespace robot
+
+#endif // ROBOT_ATTITUDE_ESTIMATOR_HPP
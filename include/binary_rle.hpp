@@ -0,0 +1,45 @@
+#ifndef ROBOT_BINARY_RLE_HPP
+#define ROBOT_BINARY_RLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace robot {
+
+/**
+ * @brief 二值图像的 1 位/像素游程编码（调试视频流用）
+ *
+ * 输入每像素 1 字节（0 为黑，非 0 为白），按行优先把整幅图看作一串 1 位像素，记录黑白交替的游程长度。
+ * 格式（小端）：
+ *   字节 0    'B'
+ *   字节 1    模式：1 为游程，0 为按位打包（游程比打包更大时使用，保证最坏情况不超过 1 位/像素）
+ *   字节 2-3  宽度
+ *   字节 4-5  高度
+ *   之后      游程：从黑色开始黑白交替，每个长度为 LEB128 变长整数（第一个黑游程可以为 0）；
+ *             打包：每字节 8 个像素，最高位在前，最后一个字节不足 8 位时低位补 0
+ * 寻线二值图每行只有几段黑白交替，320x200 的帧通常在 2KB 以内（原始 64KB，打包 8KB）。
+ * 浏览器端的解码见 web/index.html（调试图像）。
+ */
+
+/**
+ * @brief 编码
+ * @param src       首行
+ * @param width     宽度（1-65535）
+ * @param height    高度（1-65535）
+ * @param stride    每行字节数
+ * @param out       输出（覆盖原内容）
+ * @return 尺寸无效时返回 false
+ */
+bool encodeBinaryRle(const uint8_t* src, int width, int height, int stride, std::string* out);
+
+/**
+ * @brief 解码为每像素 1 字节（0 / 255）
+ * @return 数据不完整或格式错误时返回 false
+ */
+bool decodeBinaryRle(const std::string& data, std::vector<uint8_t>* dst, int* width, int* height);
+
+} // namespace robot
+
+#endif // ROBOT_BINARY_RLE_HPP
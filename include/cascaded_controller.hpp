@@ -0,0 +1,120 @@
+#ifndef ROBOT_CASCADED_CONTROLLER_HPP
+#define ROBOT_CASCADED_CONTROLLER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "PID.h"
+#include "latency_histogram.hpp"
+
+namespace robot {
+
+/**
+ * @brief 控制器选项
+ */
+struct ControllerOptions {
+    int rate_hz = 100;                  ///< 执行频率，step() 必须按该频率调用，积分与微分按 1/rate_hz 计算
+    bool cascade_steering = false;      ///< true：像素偏差 → 角速度目标 → 舵机（串级）；false：像素偏差直接 → 舵机（单环）
+    float motor_kff = 0;                ///< 电机速度前馈：输出叠加 kff × 目标速度
+    float d_tau = 0.02f;                ///< 各环微分项低通时间常数（秒）
+    int max_missed_periods = 5;         ///< 两次调用间隔超过该周期数时复位积分（数据已过时）
+};
+
+/**
+ * @brief 每周期的控制输入
+ */
+struct ControllerInput {
+    int64_t timestamp_ns = 0;       ///< 本周期开始时间（steady_clock 纳秒），用于检查执行频率
+    float pixel_error = 0;          ///< 前瞻行中线相对图像中心的偏差（像素，偏右为正）
+    float yaw_rate = 0;             ///< 实测偏航角速度（度/秒，左转为正），串级时使用
+    float speed_target = 0;         ///< 目标速度（每控制周期脉冲数）
+    float speed_present = 0;        ///< 实测速度（每控制周期脉冲数）
+    bool enable = true;             ///< false 时输出清零并复位各环
+};
+
+/**
+ * @brief 每周期的控制输出
+ */
+struct ControllerOutput {
+    float yaw_rate_target = 0;      ///< 串级外环输出的角速度目标（度/秒），单环时为0
+    float servo = 0;                ///< 舵机角度（度，相对中位，左转为正）
+    float motor = 0;                ///< 电机输出（±motorpid.Reslimit，正为前进）
+    bool servo_saturated = false;
+    bool motor_saturated = false;
+};
+
+/**
+ * @brief 执行频率统计
+ */
+struct ControllerStats {
+    uint64_t steps = 0;                     ///< 执行次数
+    uint64_t late = 0;                      ///< 间隔超过 1.5 个周期的次数
+    uint64_t resets = 0;                    ///< 因间隔过长复位积分的次数
+    LatencyHistogram::Snapshot interval_us; ///< 相邻两次执行的间隔（μs）
+};
+
+/**
+ * @brief 串级转向与速度控制器
+ *
+ * 转向：外环 anglespeedpid 把像素偏差转换为偏航角速度目标，内环 servopid 用陀螺仪角速度
+ * 闭环输出舵机角度；内环抑制车身动态与舵机滞后，外环只需处理视觉偏差。
+ * 速度：motorpid 闭环加目标速度前馈，前馈提供稳态输出，PID 只修正偏差。
+ *
+ * 各环使用 PIDCalculateFixed：固定 dt、测量值微分并低通、条件积分抗饱和。
+ * 执行频率约定：调用者按 rate_hz 固定频率调用 step()，控制器统计实际间隔，
+ * 间隔过长（调度停顿）时复位积分，避免用过时的积分量输出。
+ * PID 参数（含积分状态）保存在调用者提供的 PID 结构中，与 JSON_PIDConfigData 共用。
+ */
+class CascadedController {
+public:
+    /**
+     * @param angle_rate 外环：像素偏差 → 角速度目标（anglespeedpid）
+     * @param servo      内环（单环时直接作用于像素偏差）：servopid
+     * @param motor      速度环：motorpid
+     */
+    CascadedController(PID& angle_rate, PID& servo, PID& motor, const ControllerOptions& options = ControllerOptions());
+
+    /**
+     * @brief 修改选项（不能与 step 并发调用），各环复位
+     */
+    void configure(const ControllerOptions& options);
+
+    /**
+     * @brief 复位各环的积分、微分状态；下一周期不计入周期间隔统计
+     */
+    void reset();
+
+    /**
+     * @brief 执行一个控制周期
+     */
+    ControllerOutput step(const ControllerInput& input);
+
+    /**
+     * @brief 执行频率统计（可在其他线程调用）
+     */
+    ControllerStats stats() const;
+
+    const ControllerOptions& options() const { return options_; }
+
+private:
+    void checkInterval(int64_t timestamp_ns);
+
+    PID& angle_rate_pid_;
+    PID& servo_pid_;
+    PID& motor_pid_;
+    PIDStatus angle_rate_status_{};
+    PIDStatus servo_status_{};
+    PIDStatus motor_status_{};
+    ControllerOptions options_;
+    float dt_ = 0.01f;
+    int64_t last_ns_ = 0;
+
+    std::atomic<uint64_t> steps_{0};
+    std::atomic<uint64_t> late_{0};
+    std::atomic<uint64_t> resets_{0};
+    LatencyHistogram interval_us_;
+};
+
+} // namespace robot
+
+#endif // ROBOT_CASCADED_CONTROLLER_HPP
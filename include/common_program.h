@@ -3,6 +3,7 @@
 
 // src
 #include "path.h"
+#include "track_process.h"
 
 // lib
 #include "libdata_process.h"
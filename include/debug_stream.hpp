@@ -0,0 +1,310 @@
+#ifndef ROBOT_DEBUG_STREAM_HPP
+#define ROBOT_DEBUG_STREAM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "latency_histogram.hpp"
+#include "rt_thread.hpp"
+#include "triple_buffer.hpp"
+
+namespace robot {
+
+/**
+ * @brief 一帧编码后的数据
+ */
+struct StreamPacket {
+    uint64_t seq = 0;           ///< 从1开始递增
+    std::string data;
+};
+
+/**
+ * @brief 编码帧的分发点：编码线程发布，每个 HTTP 连接等待比自己上次发送更新的一帧
+ *
+ * 只保留最新一帧（shared_ptr，发送过程中不会被覆盖）。连接发送完一帧再来取下一帧时计为"等待中"，
+ * 编码线程只在有连接等待时编码，因此编码帧率跟随最快的连接的发送速度，没有连接时不编码。
+ */
+class StreamHub {
+public:
+    explicit StreamHub(const char* content_type) : content_type_(content_type) {}
+
+    StreamHub(const StreamHub&) = delete;
+    StreamHub& operator=(const StreamHub&) = delete;
+
+    /// 每帧的 Content-Type
+    const char* contentType() const { return content_type_; }
+
+    /// 连接建立 / 断开时调用
+    void connect() { clients_.fetch_add(1, std::memory_order_relaxed); }
+    void disconnect() { clients_.fetch_sub(1, std::memory_order_relaxed); }
+    int clients() const { return clients_.load(std::memory_order_relaxed); }
+
+    /// 是否有连接已发送完最新一帧、在等待下一帧
+    bool hasWaiting() const { return waiting_.load(std::memory_order_acquire) > 0; }
+
+    /**
+     * @brief 等待比 after_seq 更新的一帧
+     * @return 超时或 close() 后返回空指针
+     */
+    std::shared_ptr<const StreamPacket> wait(uint64_t after_seq, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 发布一帧并唤醒所有等待的连接
+     */
+    void publish(std::string data);
+
+    /**
+     * @brief 唤醒所有等待的连接并让之后的 wait() 立即返回空，用于退出
+     */
+    void close();
+
+    /// 重新允许 wait()
+    void open();
+
+    bool isClosed() const;
+
+    uint64_t published() const { return seq_.load(std::memory_order_relaxed); }
+
+private:
+    const char* content_type_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::shared_ptr<const StreamPacket> packet_;
+    bool closed_ = false;
+    std::atomic<uint64_t> seq_{0};
+    std::atomic<int> clients_{0};
+    std::atomic<int> waiting_{0};
+};
+
+/**
+ * @brief 调试视频流格式
+ */
+enum class StreamFormat {
+    Jpeg = 0,       ///< 合成调试图像，JPEG
+    BinaryRle = 1,  ///< 二值图，1 位/像素游程编码（见 binary_rle.hpp）
+};
+
+/**
+ * @brief 调试视频流选项
+ */
+struct DebugStreamOptions {
+    double max_fps = 15.0;          ///< 编码帧率上限
+    size_t frame_bytes = 24 * 1024; ///< 每帧 JPEG 的大小预算，超出时降低质量，远低于预算时提高质量
+    int quality = 70;               ///< JPEG 初始质量
+    int min_quality = 20;
+    int max_quality = 90;
+    int cpu = -1;                   ///< 编码线程绑定的CPU，-1 不绑定
+    int nice = 15;                  ///< 编码线程的 nice 值（低于显示线程），0 保持不变
+};
+
+/**
+ * @brief 调试视频流统计，直方图单位为微秒
+ */
+struct DebugStreamStats {
+    uint64_t published = 0;         ///< 视觉线程发布的帧数（只在有连接时发布）
+    uint64_t encoded = 0;           ///< 编码的帧数（两种格式合计）
+    uint64_t dropped = 0;           ///< 没有编码就被覆盖的帧数
+    uint64_t bytes = 0;             ///< 编码输出的总字节数
+    double fps = 0.0;               ///< 启动以来的编码帧率
+    int quality = 0;                ///< 当前 JPEG 质量
+    int clients = 0;                ///< 当前连接数
+    LatencyHistogram::Snapshot encode_us;
+};
+
+/**
+ * @brief 调试视频流：视觉线程发布帧，低优先级的编码线程按需编码，HTTP 连接以 multipart/x-mixed-replace 推送
+ *
+ * 视觉线程只在 wanted() 为真（有连接）时准备并 publish() 一帧，publish() 与 DisplayService 相同，
+ * 只做一次拷贝和一次原子交换。编码线程每个周期（max_fps）检查两种格式的 StreamHub，只为有连接在等待的格式
+ * 从三缓冲邮箱取最新一帧编码，连接发送慢时编码帧率随之降低，周期之间的帧直接丢弃。
+ * JPEG 质量按每帧大小预算自动调整。编码不在视觉线程和控制线程中进行。
+ *
+ * @tparam Frame 帧类型，需可默认构造与拷贝赋值，拷贝应当廉价（例如引用计数的 cv::Mat）
+ */
+template <typename Frame>
+class DebugStream {
+public:
+    /**
+     * @brief 编码函数：按格式把帧编码到 out，JPEG 使用给定质量；返回 false 表示该帧没有这种格式的数据
+     */
+    using EncodeFunction = std::function<bool(const Frame& frame, StreamFormat format, int quality, std::string* out)>;
+
+    explicit DebugStream(EncodeFunction encode)
+        : encode_(std::move(encode)), jpeg_hub_("image/jpeg"), binary_hub_("application/x-binary-rle") {}
+
+    ~DebugStream() { stop(); }
+
+    DebugStream(const DebugStream&) = delete;
+    DebugStream& operator=(const DebugStream&) = delete;
+
+    /**
+     * @brief 启动编码线程
+     * @return 已在运行或选项无效时返回false
+     */
+    bool start(const DebugStreamOptions& options = DebugStreamOptions()) {
+        if (running_ || options.max_fps <= 0 || options.min_quality > options.max_quality) {
+            std::cerr << "DebugStream: 无法启动" << std::endl;
+            return false;
+        }
+        options_ = options;
+        quality_ = std::min(std::max(options.quality, options.min_quality), options.max_quality);
+        jpeg_hub_.open();
+        binary_hub_.open();
+        stop_ = false;
+        running_ = true;
+        start_ns_ = nowNs();
+        thread_ = std::thread(&DebugStream::run, this);
+        return true;
+    }
+
+    /**
+     * @brief 停止编码线程，并让所有连接结束
+     */
+    void stop() {
+        if (!running_) {
+            return;
+        }
+        stop_ = true;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        jpeg_hub_.close();
+        binary_hub_.close();
+        running_ = false;
+    }
+
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 是否有连接，视觉线程据此决定是否准备帧
+     */
+    bool wanted() const {
+        return running_.load(std::memory_order_relaxed) && (jpeg_hub_.clients() > 0 || binary_hub_.clients() > 0);
+    }
+
+    /**
+     * @brief 发布一帧（只能由一个线程调用，不阻塞）
+     */
+    void publish(const Frame& frame) {
+        mailbox_.writeBuffer() = frame;
+        mailbox_.publish();
+    }
+
+    StreamHub& hub(StreamFormat format) { return format == StreamFormat::Jpeg ? jpeg_hub_ : binary_hub_; }
+
+    /**
+     * @brief 统计（可在任意线程调用）
+     */
+    DebugStreamStats stats() const {
+        DebugStreamStats stats;
+        stats.published = mailbox_.published();
+        stats.encoded = encoded_.load(std::memory_order_relaxed);
+        uint64_t handled = mailbox_.consumed() + (mailbox_.pending() ? 1 : 0);
+        stats.dropped = stats.published > handled ? stats.published - handled : 0;
+        stats.bytes = bytes_.load(std::memory_order_relaxed);
+        int64_t elapsed_ns = nowNs() - start_ns_.load(std::memory_order_relaxed);
+        if (elapsed_ns > 0) {
+            stats.fps = (double)stats.encoded * 1e9 / (double)elapsed_ns;
+        }
+        stats.quality = quality_.load(std::memory_order_relaxed);
+        stats.clients = jpeg_hub_.clients() + binary_hub_.clients();
+        stats.encode_us = encode_hist_.snapshot();
+        return stats;
+    }
+
+private:
+    static int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 按上一帧的大小调整质量：超出预算时按超出比例降低，低于预算 60% 时小步提高
+    void adaptQuality(size_t size) {
+        int quality = quality_.load(std::memory_order_relaxed);
+        if (size > options_.frame_bytes) {
+            quality -= std::max(2, (int)(10 * (size - options_.frame_bytes) / options_.frame_bytes) + 2);
+        } else if (size * 10 < options_.frame_bytes * 6) {
+            quality += 2;
+        }
+        quality_.store(std::min(std::max(quality, options_.min_quality), options_.max_quality),
+                       std::memory_order_relaxed);
+    }
+
+    void encode(const Frame& frame, StreamFormat format) {
+        int64_t begin_ns = nowNs();
+        std::string data;
+        if (!encode_(frame, format, quality_.load(std::memory_order_relaxed), &data) || data.empty()) {
+            return;
+        }
+        encode_hist_.record((uint64_t)(nowNs() - begin_ns) / 1000);
+        encoded_.fetch_add(1, std::memory_order_relaxed);
+        bytes_.fetch_add(data.size(), std::memory_order_relaxed);
+        if (format == StreamFormat::Jpeg) {
+            adaptQuality(data.size());
+        }
+        hub(format).publish(std::move(data));
+    }
+
+    void run() {
+        setThreadName("debug_stream");
+        if (options_.cpu >= 0) {
+            setThreadAffinity(options_.cpu);
+        }
+        if (options_.nice != 0) {
+            setCurrentThreadNice(options_.nice);
+        }
+        auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / options_.max_fps));
+        auto next = std::chrono::steady_clock::now();
+        while (!stop_.load(std::memory_order_acquire)) {
+            bool jpeg = jpeg_hub_.hasWaiting();
+            bool binary = binary_hub_.hasWaiting();
+            // 没有连接在等待时不取帧，邮箱里的帧留到有连接发送完上一帧后再编码
+            if ((jpeg || binary) && mailbox_.update()) {
+                const Frame& frame = mailbox_.readBuffer();
+                if (jpeg) {
+                    encode(frame, StreamFormat::Jpeg);
+                }
+                if (binary) {
+                    encode(frame, StreamFormat::BinaryRle);
+                }
+            } else if (!wanted()) {
+                // 没有连接时释放编码线程持有的帧
+                mailbox_.readBuffer() = Frame();
+            }
+            next += period;
+            auto now = std::chrono::steady_clock::now();
+            if (next < now) {
+                next = now;
+            }
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    EncodeFunction encode_;
+    DebugStreamOptions options_;
+    TripleBuffer<Frame> mailbox_;
+    StreamHub jpeg_hub_;
+    StreamHub binary_hub_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stop_{false};
+    std::atomic<int64_t> start_ns_{0};
+    std::atomic<int> quality_{70};
+    std::atomic<uint64_t> encoded_{0};
+    std::atomic<uint64_t> bytes_{0};
+    LatencyHistogram encode_hist_;
+};
+
+} // namespace robot
+
+#endif // ROBOT_DEBUG_STREAM_HPP
@@ -0,0 +1,177 @@
+#ifndef ROBOT_DISPLAY_SERVICE_HPP
+#define ROBOT_DISPLAY_SERVICE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+#include "latency_histogram.hpp"
+#include "rt_thread.hpp"
+#include "triple_buffer.hpp"
+
+namespace robot {
+
+/**
+ * @brief 显示线程选项
+ */
+struct DisplayServiceOptions {
+    double fps = 15.0;          ///< 刷新帧率上限
+    int cpu = -1;               ///< 显示线程绑定的CPU，-1 不绑定
+    int nice = 10;              ///< 显示线程的 nice 值（普通调度，低于视觉与控制线程），0 保持不变
+};
+
+/**
+ * @brief 显示统计，直方图单位均为微秒
+ */
+struct DisplayServiceStats {
+    uint64_t published = 0;                 ///< 发布的帧数
+    uint64_t rendered = 0;                  ///< 显示的帧数
+    uint64_t dropped = 0;                   ///< 显示前被更新的帧覆盖的帧数
+    double fps = 0.0;                       ///< 启动以来的显示帧率
+    LatencyHistogram::Snapshot render_us;   ///< 渲染耗时
+    LatencyHistogram::Snapshot wait_us;     ///< 发布到开始渲染的时间
+};
+
+/**
+ * @brief 异步显示服务
+ *
+ * 显示线程以较低的优先级、按固定帧率运行，每个周期从三缓冲邮箱取最新一帧交给渲染函数，
+ * 周期之间发布的旧帧直接丢弃；没有新帧时不渲染。视觉线程只在 publish() 中把帧拷入自己的缓冲区
+ * 并做一次原子交换，不等待屏幕写入。Frame 应当是廉价拷贝的句柄（例如引用计数的 cv::Mat 加少量状态），
+ * 邮箱中的三个缓冲区会一直持有最近的帧。
+ *
+ * @tparam Frame 帧类型，需可默认构造与拷贝赋值
+ */
+template <typename Frame>
+class DisplayService {
+public:
+    using RenderFunction = std::function<void(const Frame&)>;
+
+    explicit DisplayService(RenderFunction render) : render_(std::move(render)) {}
+
+    ~DisplayService() { stop(); }
+
+    DisplayService(const DisplayService&) = delete;
+    DisplayService& operator=(const DisplayService&) = delete;
+
+    /**
+     * @brief 启动显示线程
+     * @return 已在运行或帧率无效时返回false
+     */
+    bool start(const DisplayServiceOptions& options = DisplayServiceOptions()) {
+        if (running_ || options.fps <= 0) {
+            std::cerr << "DisplayService: 无法启动" << std::endl;
+            return false;
+        }
+        stop_ = false;
+        running_ = true;
+        start_ns_ = nowNs();
+        thread_ = std::thread(&DisplayService::run, this, options);
+        return true;
+    }
+
+    /**
+     * @brief 停止显示线程（当前帧渲染完后退出）
+     */
+    void stop() {
+        if (!running_) {
+            return;
+        }
+        stop_ = true;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        running_ = false;
+    }
+
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 发布一帧（只能由一个线程调用，不阻塞）
+     */
+    void publish(const Frame& frame) {
+        Slot& slot = mailbox_.writeBuffer();
+        slot.frame = frame;
+        slot.publish_ns = nowNs();
+        mailbox_.publish();
+    }
+
+    /**
+     * @brief 显示统计（可在任意线程调用）
+     */
+    DisplayServiceStats stats() const {
+        DisplayServiceStats stats;
+        stats.published = mailbox_.published();
+        stats.rendered = rendered_.load(std::memory_order_relaxed);
+        // 还在邮箱中等待显示的一帧不算丢弃
+        uint64_t handled = mailbox_.consumed() + (mailbox_.pending() ? 1 : 0);
+        stats.dropped = stats.published > handled ? stats.published - handled : 0;
+        int64_t elapsed_ns = nowNs() - start_ns_.load(std::memory_order_relaxed);
+        if (elapsed_ns > 0) {
+            stats.fps = (double)stats.rendered * 1e9 / (double)elapsed_ns;
+        }
+        stats.render_us = render_hist_.snapshot();
+        stats.wait_us = wait_hist_.snapshot();
+        return stats;
+    }
+
+private:
+    struct Slot {
+        Frame frame;
+        int64_t publish_ns = 0;
+    };
+
+    static int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void run(DisplayServiceOptions options) {
+        setThreadName("display");
+        if (options.cpu >= 0) {
+            setThreadAffinity(options.cpu);
+        }
+        if (options.nice != 0) {
+            setCurrentThreadNice(options.nice);
+        }
+        auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / options.fps));
+        auto next = std::chrono::steady_clock::now();
+        while (!stop_.load(std::memory_order_acquire)) {
+            if (mailbox_.update()) {
+                const Slot& slot = mailbox_.readBuffer();
+                int64_t begin_ns = nowNs();
+                if (begin_ns > slot.publish_ns) {
+                    wait_hist_.record((uint64_t)(begin_ns - slot.publish_ns) / 1000);
+                }
+                render_(slot.frame);
+                render_hist_.record((uint64_t)(nowNs() - begin_ns) / 1000);
+                rendered_.fetch_add(1, std::memory_order_relaxed);
+            }
+            // 渲染超时后不补帧，从当前时刻重新计时
+            next += period;
+            auto now = std::chrono::steady_clock::now();
+            if (next < now) {
+                next = now;
+            }
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    RenderFunction render_;
+    TripleBuffer<Slot> mailbox_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stop_{false};
+    std::atomic<int64_t> start_ns_{0};
+    std::atomic<uint64_t> rendered_{0};
+    LatencyHistogram render_hist_;
+    LatencyHistogram wait_hist_;
+};
+
+} // namespace robot
+
+#endif // ROBOT_DISPLAY_SERVICE_HPP
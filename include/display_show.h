@@ -10,10 +10,21 @@
 /**
  * @brief 将OpenCV的Mat图像显示到IPS200屏幕上
  * @param img 输入的图像（支持BGR或灰度格式）
- * @note 图像将被自动缩放以适应屏幕分辨率（假设屏幕分辨率为 IPS200_WIDTH x IPS200_HEIGHT）
+ * @note 图像缩放到 240x180 后显示在屏幕左上角
  */
 void displayMatOnIPS200(const cv::Mat& img);
 
+#define DISPLAY_STATUS_Y        (197)   // 状态文字的起始行（图像 0~179，IP 地址 181~196）
+#define DISPLAY_STATUS_LINES    (4)
+
+/**
+ * @brief 在图像下方显示一行状态文字
+ * @param line 行号 [0, DISPLAY_STATUS_LINES)，每行 16 像素
+ * @param text 文字
+ * @note 与该行上次显示的内容相同时不重绘；只写入后台缓冲，由下一次刷新显示
+ */
+void display_status_line(int line, const char *text);
+
 void display_data(int y,const char dat[],int data,int num);
 
 void display_dataf(int y,const char dat[],float data,int num1,int num2);
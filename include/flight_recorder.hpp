@@ -0,0 +1,343 @@
+#ifndef ROBOT_FLIGHT_RECORDER_HPP
+#define ROBOT_FLIGHT_RECORDER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "latency_histogram.hpp"
+#include "spsc_ring.hpp"
+#include "telemetry_bus.hpp"
+
+namespace robot {
+
+/*
+ * 飞行记录文件格式（小端，所有结构按自然对齐、没有隐式填充）
+ *
+ *   0     FlightLogHeader，占一页（4096 字节）
+ *   4096  数据区，capacity 字节的环形缓冲区
+ *
+ * 数据区中每条记录以 FlightRecordHeader 开始，负载紧随其后，整条记录按 32 字节对齐。记录不跨越数据区末尾：
+ * 剩余空间放不下时写一条 Pad 记录填满到末尾，从数据区开头继续。写满后覆盖最旧的记录。
+ * 文件头中的 head / tail 是单调递增的字节位置（对 capacity 取模得到数据区偏移），tail 为最旧的完整记录。
+ * 每条记录带负载的 CRC32（与 zlib.crc32 相同），读取时据此丢弃写了一半的记录。
+ */
+
+/// 记录类型
+enum class FlightRecordType : uint16_t {
+    Pad = 0,            ///< 填充到数据区末尾，没有意义
+    BinaryFrame = 1,    ///< FlightFrameInfo + 二值图游程编码（见 binary_rle.hpp）
+    GrayFrame = 2,      ///< FlightFrameInfo + 原始灰度图（width * height 字节）
+    Path = 3,           ///< FlightPath + 左边线、右边线、中线（各 rows 个 uint16）
+    Telemetry = 4,      ///< 若干条 TelemetryRecord（每条 64 字节）
+};
+
+/// 文件头
+struct FlightLogHeader {
+    char magic[8];                  ///< "RBFLIGHT"
+    uint32_t version;               ///< FLIGHT_LOG_VERSION
+    uint32_t data_offset;           ///< 数据区在文件中的偏移
+    uint64_t capacity;              ///< 数据区字节数
+    uint64_t head;                  ///< 下一条记录的字节位置
+    uint64_t tail;                  ///< 最旧的完整记录的字节位置
+    uint64_t records;               ///< 写入的记录总数（含已被覆盖的），也是下一条记录的序号
+    uint64_t wraps;                 ///< 数据区回绕次数
+    int64_t start_realtime_ns;      ///< 开始记录时的 CLOCK_REALTIME，用于换算成日期时间
+    int64_t start_steady_ns;        ///< 同一时刻的 steady_clock，记录时间戳都是 steady_clock
+};
+
+/// 记录头
+struct FlightRecordHeader {
+    uint32_t magic;                 ///< FLIGHT_RECORD_MAGIC
+    uint16_t type;                  ///< FlightRecordType
+    uint16_t reserved;
+    uint32_t size;                  ///< 负载字节数（不含记录头与对齐填充）
+    uint32_t crc;                   ///< 负载的 CRC32
+    uint64_t sequence;              ///< 记录序号，连续递增
+    int64_t timestamp_ns;           ///< steady_clock 纳秒
+};
+
+/// 图像记录的帧信息
+struct FlightFrameInfo {
+    uint64_t frame_id;
+    int64_t sensor_ns;              ///< 采集时刻
+    uint16_t width;
+    uint16_t height;
+    uint32_t reserved;
+};
+
+/// 边线上的一个点（拐点、弯点）
+struct FlightPoint {
+    int16_t x;
+    int16_t y;
+};
+
+/// 寻线结果摘要，记录中其后是 rows 行的左边线、右边线、中线
+struct FlightPath {
+    static constexpr int MAX_POINTS = 8;   ///< 每侧最多记录的拐点、弯点数
+
+    uint64_t frame_id;
+    int64_t sensor_ns;
+    double distance;                ///< 累计行驶距离（米）
+    float speed;                    ///< 车速（米/秒）
+    float speed_limit;              ///< 速度规划的允许车速，未启用时为0
+    int16_t track_kind;
+    int16_t circle_step;
+    int16_t servo_dir;
+    int16_t servo_angle;
+    int32_t motor_speed;
+    uint16_t hightest;              ///< 寻线最高点所在行
+    uint16_t rows;                  ///< 边线数组的行数
+    uint8_t inflection_num[2];      ///< 左、右边线拐点数（原始数量，超过 MAX_POINTS 的部分不记录坐标）
+    uint8_t bend_num[2];            ///< 左、右边线弯点数
+    uint32_t reserved;
+    FlightPoint inflection[2][MAX_POINTS];
+    FlightPoint bend[2][MAX_POINTS];
+};
+
+static constexpr uint32_t FLIGHT_LOG_VERSION = 1;
+static constexpr uint32_t FLIGHT_RECORD_MAGIC = 0x43455246;    // "FREC"
+static constexpr size_t FLIGHT_LOG_DATA_OFFSET = 4096;
+static constexpr size_t FLIGHT_RECORD_ALIGN = 32;
+
+static_assert(sizeof(FlightLogHeader) == 72 && sizeof(FlightRecordHeader) == 32 && sizeof(FlightFrameInfo) == 24 &&
+              sizeof(FlightPath) == 184, "飞行记录布局与回放工具不一致");
+
+/// CRC32（多项式 0xEDB88320，与 zlib.crc32 相同）
+uint32_t flightCrc32(const void* data, size_t size, uint32_t crc = 0);
+
+/**
+ * @brief 一帧待记录的数据，由视觉线程填写
+ *
+ * 各缓冲区在 start() 时按最大尺寸预先分配，set*() 只做逐行拷贝，不分配内存。
+ */
+struct FlightFrame {
+    FlightPath path = {};
+    int width = 0;
+    int height = 0;
+    bool want_gray = false;         ///< 这一帧按 gray_every 需要记录灰度图（acquire() 设置）
+    bool has_gray = false;          ///< setGray() 成功后为 true
+    std::vector<uint8_t> binary;    ///< width * height，0 为黑，非 0 为白
+    std::vector<uint8_t> gray;      ///< width * height
+    std::vector<uint16_t> borders;  ///< 3 * path.rows：左边线、右边线、中线
+
+    /// 拷贝二值图；尺寸超过预分配的大小时返回 false
+    bool setBinary(const uint8_t* src, int width, int height, int stride);
+    /// 拷贝灰度图，尺寸须与二值图相同
+    bool setGray(const uint8_t* src, int width, int height, int stride);
+    /// 拷贝边线数组
+    bool setBorders(const uint16_t* left, const uint16_t* right, const uint16_t* center, int rows);
+};
+
+/**
+ * @brief 飞行记录选项
+ */
+struct FlightRecorderOptions {
+    std::string path = "log/flight.rbl";    ///< 记录文件
+    size_t capacity = 128u << 20;   ///< 数据区字节数，向上取整到 4096 的倍数
+    bool keep_previous = true;      ///< 启动时把已有的记录文件改名为 path + ".prev"，保留上一次运行的记录
+    int max_width = 320;            ///< 图像最大尺寸，用于预分配帧缓冲区
+    int max_height = 240;
+    int gray_every = 0;             ///< 每隔多少帧记录一帧原始灰度图，0 不记录
+    int slots = 8;                  ///< 帧缓冲区数量（不超过 MAX_SLOTS），记录线程来不及处理时新帧丢弃并计数
+    int poll_ms = 10;               ///< 记录线程的轮询周期
+    int sync_ms = 500;              ///< 把脏页写回存储的间隔（批量 msync）
+    int cpu = -1;                   ///< 记录线程绑定的CPU，-1 不绑定
+    int nice = 10;                  ///< 记录线程的 nice 值，0 保持不变
+};
+
+/**
+ * @brief 飞行记录统计，直方图单位为微秒
+ */
+struct FlightRecorderStats {
+    uint64_t frames = 0;            ///< 写入的帧数
+    uint64_t dropped = 0;           ///< 没有空闲帧缓冲区而丢弃的帧数
+    uint64_t telemetry = 0;         ///< 写入的遥测记录条数
+    uint64_t telemetry_lost = 0;    ///< 记录线程读得慢、在遥测总线中被覆盖的条数
+    uint64_t bytes = 0;             ///< 写入的总字节数（含记录头与填充）
+    uint64_t wraps = 0;             ///< 数据区回绕次数
+    uint64_t syncs = 0;             ///< 写回次数
+    LatencyHistogram::Snapshot write_us;    ///< 记录线程每帧编码与写入的时间
+    LatencyHistogram::Snapshot sync_us;     ///< 每次写回的时间
+};
+
+/**
+ * @brief 飞行记录器（黑匣子）：把每帧的二值图、可选的灰度图、寻线摘要和遥测总线上的记录写入预分配的环形记录文件
+ *
+ * 记录文件在 start() 时按容量预分配并以 MAP_SHARED 映射，写入就是内存拷贝，写满后覆盖最旧的记录，
+ * 文件大小固定，长时间运行不会占满存储。视觉线程只调用 acquire() / commit()：从空闲队列取一个预分配的帧缓冲区、
+ * 拷贝图像与摘要、放入待写队列，不编码、不做系统调用；没有空闲缓冲区时丢弃该帧并计数，不会阻塞。
+ * 低优先级的记录线程对图像做游程编码、追加记录、读取遥测总线，每 sync_ms 用一次 msync 把脏页批量写回存储，
+ * 程序崩溃时已写入映射的数据仍由内核写回；stop() 写完队列中的帧后同步写回。
+ * 记录文件可以从 Web 接口（/api/flight）下载，用 FlightLogReader 读取。
+ */
+class FlightRecorder {
+public:
+    static constexpr int MAX_SLOTS = 16;
+
+    FlightRecorder() = default;
+    ~FlightRecorder() { stop(); }
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    /**
+     * @brief 创建记录文件并启动记录线程
+     * @param options 选项
+     * @param telemetry 同时记录的遥测总线（可为空），从调用时的位置开始记录
+     * @return 已在运行、选项无效或文件无法创建时返回false
+     */
+    bool start(const FlightRecorderOptions& options = FlightRecorderOptions(), const TelemetryBus* telemetry = nullptr);
+
+    /**
+     * @brief 写完队列中的帧和遥测记录，同步写回并关闭文件
+     */
+    void stop();
+
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 取一个空闲的帧缓冲区（只能由一个线程调用）
+     * @return 未运行或没有空闲缓冲区时返回空指针（后者计入丢弃）
+     */
+    FlightFrame* acquire();
+
+    /**
+     * @brief 提交 acquire() 得到的帧缓冲区，由记录线程写入
+     */
+    void commit(FlightFrame* frame);
+
+    /// 记录文件路径
+    const std::string& path() const { return options_.path; }
+
+    /**
+     * @brief 统计（可在任意线程调用）
+     */
+    FlightRecorderStats stats() const;
+
+private:
+    void run();
+    void drain();
+    bool writeFrame(FlightFrame* frame);
+    void writeTelemetry();
+    void append(FlightRecordType type, int64_t timestamp_ns, const void* part1, size_t size1,
+                const void* part2 = nullptr, size_t size2 = 0);
+    void makeRoom(uint64_t size);
+    void sync();
+
+    FlightRecorderOptions options_;
+    const TelemetryBus* telemetry_ = nullptr;
+    uint64_t telemetry_cursor_ = 0;
+    std::vector<TelemetryRecord> telemetry_batch_;
+    std::string encoded_;
+
+    int fd_ = -1;
+    uint8_t* map_ = nullptr;
+    size_t map_size_ = 0;
+    FlightLogHeader* header_ = nullptr;
+    uint8_t* data_ = nullptr;
+    uint64_t synced_head_ = 0;          ///< 上次写回时的 head
+
+    FlightFrame slots_[MAX_SLOTS];
+    SpscRing<int, MAX_SLOTS> free_;     ///< 记录线程 → 视觉线程
+    SpscRing<int, MAX_SLOTS> ready_;    ///< 视觉线程 → 记录线程
+    uint64_t frame_count_ = 0;          ///< 视觉线程提交的帧数，用于 gray_every
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> telemetry_count_{0};
+    std::atomic<uint64_t> telemetry_lost_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> wraps_{0};
+    std::atomic<uint64_t> syncs_{0};
+    LatencyHistogram write_hist_;
+    LatencyHistogram sync_hist_;
+};
+
+/**
+ * @brief 读取出的一条记录，payload 指向映射的文件内容，读取器关闭前有效
+ */
+struct FlightRecordView {
+    FlightRecordHeader header;
+    const uint8_t* payload = nullptr;
+    uint64_t position = 0;          ///< 记录的字节位置
+};
+
+/**
+ * @brief 飞行记录文件读取器（只读映射）
+ *
+ * 从最旧的记录开始按序号顺序读取，跳过填充记录，遇到校验失败或序号不连续的记录即停止。
+ * 文件头之后还继续向前查找序号连续、校验正确的记录，因此文件头没来得及更新时（例如断电前只写回了数据页）
+ * 也能读到最后写入的记录。记录过程中下载的文件，文件头之后写入的新记录可能已覆盖最旧的一段，
+ * 此时从被覆盖部分之后的第一条完整记录开始读。
+ */
+class FlightLogReader {
+public:
+    FlightLogReader() = default;
+    ~FlightLogReader() { close(); }
+
+    FlightLogReader(const FlightLogReader&) = delete;
+    FlightLogReader& operator=(const FlightLogReader&) = delete;
+
+    /**
+     * @brief 打开记录文件
+     * @return 文件不存在、文件头无效或版本不符时返回false
+     */
+    bool open(const std::string& path);
+    void close();
+
+    const FlightLogHeader& header() const { return header_; }
+
+    /**
+     * @brief 读取下一条记录
+     * @return 没有更多有效记录时返回false
+     */
+    bool next(FlightRecordView* out);
+
+    /// 回到最旧的记录
+    void rewind();
+
+    /// 文件头之后额外找回的记录数
+    uint64_t recovered() const { return recovered_; }
+
+    /**
+     * @brief 解析路径记录
+     * @param borders 输出 3 * rows 个值：左边线、右边线、中线（可为空）
+     */
+    static bool parsePath(const FlightRecordView& record, FlightPath* path, std::vector<uint16_t>* borders);
+
+    /**
+     * @brief 解析图像记录，二值图解码为每像素 1 字节（0 / 255）
+     */
+    static bool parseFrame(const FlightRecordView& record, FlightFrameInfo* info, std::vector<uint8_t>* pixels);
+
+    /**
+     * @brief 解析遥测记录
+     */
+    static bool parseTelemetry(const FlightRecordView& record, std::vector<TelemetryRecord>* out);
+
+private:
+    bool readAt(uint64_t position, FlightRecordView* out) const;
+    uint64_t findStart() const;
+
+    int fd_ = -1;
+    const uint8_t* map_ = nullptr;
+    size_t map_size_ = 0;
+    const uint8_t* data_ = nullptr;
+    FlightLogHeader header_ = {};
+    uint64_t start_ = 0;            ///< 最旧的有效记录的字节位置
+    uint64_t position_ = 0;
+    uint64_t sequence_ = 0;
+    bool first_ = true;
+    uint64_t recovered_ = 0;
+};
+
+} // namespace robot
+
+#endif // ROBOT_FLIGHT_RECORDER_HPP
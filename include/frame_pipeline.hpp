@@ -0,0 +1,241 @@
+#ifndef ROBOT_FRAME_PIPELINE_HPP
+#define ROBOT_FRAME_PIPELINE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <semaphore.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "latency_histogram.hpp"
+#include "spsc_ring.hpp"
+
+namespace robot {
+
+/**
+ * @brief 随帧在流水线中传递的信息
+ */
+struct FrameInfo {
+    uint64_t frame_id = 0;                                  ///< 帧序号，由第一阶段（采集）分配，单调递增
+    std::chrono::steady_clock::time_point capture_time;     ///< 采集完成时间
+    uint32_t slot = 0;                                      ///< 帧槽编号，用于索引调用者预分配的帧数据
+};
+
+/**
+ * @brief 流水线阶段选项
+ */
+struct PipelineStageOptions {
+    bool keep_latest = true;    ///< 积压时只处理最新一帧，丢弃较旧的帧（第一阶段忽略）
+    int cpu = -1;               ///< 阶段线程绑定的CPU，-1 不绑定
+    int rt_priority = 0;        ///< 阶段线程的 SCHED_FIFO 优先级，0 保持普通调度
+};
+
+/**
+ * @brief 单个阶段的统计，直方图单位均为微秒
+ * - exec_us: 阶段函数执行耗时
+ * - wait_us: 上一阶段完成到本阶段开始的排队时间
+ * - age_us:  本阶段完成时帧距采集完成的时间（最后一阶段即端到端延迟）
+ */
+struct PipelineStageStats {
+    std::string name;
+    uint64_t processed = 0;     ///< 处理完成的帧数
+    uint64_t dropped = 0;       ///< 因积压或下游已满被丢弃的帧数
+    double fps = 0.0;           ///< 自启动或上次清空统计以来的处理帧率
+    LatencyHistogram::Snapshot exec_us;
+    LatencyHistogram::Snapshot wait_us;
+    LatencyHistogram::Snapshot age_us;
+};
+
+/**
+ * @brief 多阶段帧流水线
+ *
+ * 每个阶段运行在自己的线程中，阶段之间通过有界 SPSC 无锁环形队列传递帧槽编号，
+ * 帧数据由调用者按 slotCount() 预分配，流水线只负责帧槽的所有权流转：
+ * 同一时刻一个帧槽只属于一个阶段，阶段函数可以无锁访问该槽的数据。
+ *
+ * 吞吐量由最慢的阶段决定而不是各阶段之和。下游跟不上时：
+ * - 第一阶段没有空闲帧槽时仍然执行（使用备用槽）以消费相机数据，结果直接丢弃
+ * - keep_latest 阶段一次取空输入队列，只处理最新一帧
+ * - 输出队列已满时丢弃该帧
+ */
+class FramePipeline {
+public:
+    /**
+     * @brief 阶段函数
+     * @return 返回 false 时丢弃该帧（例如采集失败），不传给下一阶段
+     */
+    using StageFunction = std::function<bool(const FrameInfo&)>;
+
+    /**
+     * @brief 构造函数
+     * @param slot_count 流转中的帧槽数量（至少为阶段数），另有一个第一阶段专用的备用槽
+     */
+    explicit FramePipeline(size_t slot_count = 4);
+
+    /**
+     * @brief 析构函数（会停止流水线）
+     */
+    ~FramePipeline();
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    /**
+     * @brief 追加一个阶段（start() 前调用），第一个阶段为数据源
+     * @return 运行中或阶段数超出上限时返回false
+     */
+    bool addStage(const std::string& name, StageFunction function,
+                  const PipelineStageOptions& options = PipelineStageOptions());
+
+    /**
+     * @brief 调用者需要预分配的帧数据数量（含备用槽）
+     */
+    size_t slotCount() const { return slot_count_ + 1; }
+
+    /**
+     * @brief 启动所有阶段线程
+     * @return 已在运行、没有阶段或帧槽数少于阶段数时返回false
+     */
+    bool start();
+
+    /**
+     * @brief 停止并等待所有阶段线程退出（阶段函数执行完当前帧后退出）
+     */
+    void stop();
+
+    bool isRunning() const { return running_; }
+
+    /**
+     * @brief 获取各阶段统计（无锁）
+     */
+    std::vector<PipelineStageStats> getStats() const;
+
+    /**
+     * @brief 打印各阶段的延迟分解
+     */
+    void printStats() const;
+
+    /**
+     * @brief 清空统计
+     */
+    void resetStats();
+
+private:
+    static constexpr size_t MAX_STAGES = 8;
+    static constexpr size_t RING_CAPACITY = 16;
+    using Ring = SpscRing<uint32_t, RING_CAPACITY>;
+
+    struct Stage {
+        Stage() { sem_init(&wakeup, 0, 0); }
+        ~Stage() { sem_destroy(&wakeup); }
+        Stage(const Stage&) = delete;
+        Stage& operator=(const Stage&) = delete;
+
+        std::string name;
+        StageFunction function;
+        PipelineStageOptions options;
+        std::thread thread;
+        std::atomic<uint64_t> processed{0};
+        std::atomic<uint64_t> dropped{0};
+        LatencyHistogram exec_hist;
+        LatencyHistogram wait_hist;
+        LatencyHistogram age_hist;
+        sem_t wakeup;                                   // 输入队列有新帧或停止时由上游 post
+    };
+
+    struct SlotState {
+        FrameInfo info;
+        std::chrono::steady_clock::time_point last_done;   // 上一阶段完成时间（随所有权转移）
+        std::atomic<bool> in_use{false};
+    };
+
+    void sourceLoop();
+    void stageLoop(size_t index);
+    void applyThreadOptions(const Stage& stage);
+    int acquireSlot();
+    void releaseSlot(uint32_t slot);
+    void finishStage(size_t index, uint32_t slot,
+                     std::chrono::steady_clock::time_point start,
+                     std::chrono::steady_clock::time_point end);
+
+    size_t slot_count_;
+    std::vector<std::unique_ptr<Stage>> stages_;
+    std::vector<std::unique_ptr<Ring>> rings_;          // rings_[i]: 阶段 i -> 阶段 i+1
+    std::unique_ptr<SlotState[]> slots_;
+    uint32_t next_slot_ = 0;                            // 只由第一阶段访问
+    uint64_t next_frame_id_ = 0;                        // 只由第一阶段访问
+
+    std::atomic<bool> running_{false};
+    std::atomic<int64_t> stats_start_ns_{0};
+};
+
+/**
+ * @brief 单写多读的"最新值"邮箱（双缓冲 + 每缓冲区顺序锁）
+ *
+ * 写者从不阻塞，总是写入未发布的缓冲区，写完再发布；读者只读已发布的缓冲区，
+ * 因此写者在写入中途被抢占（单核上低优先级写者、高优先级读者）时读者不受影响，不会自旋等待。
+ * 只有写者在一次读取期间连续完成两次写入时读者才需要重读，重读次数有上限，超过时返回false。
+ * 用于把流水线的最新结果交给控制任务。
+ * @tparam T 可平凡拷贝的类型
+ */
+template <typename T>
+class LatestValue {
+    static_assert(std::is_trivially_copyable<T>::value, "LatestValue 只支持可平凡拷贝的类型");
+
+public:
+    static const int MAX_READ_RETRIES = 8;
+
+    void store(const T& value) {
+        uint64_t count = count_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[count & 1];                     // 未发布的缓冲区
+        uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+        slot.seq.store(seq + 1, std::memory_order_relaxed); // 奇数：写入中
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.value = value;
+        slot.seq.store(seq + 2, std::memory_order_release);
+        count_.store(count + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief 读取最新值，失败时 out 保持不变
+     * @return 从未写入过，或写者持续更新使重读超过 MAX_READ_RETRIES 次时返回false
+     */
+    bool load(T& out) const {
+        for (int attempt = 0; attempt < MAX_READ_RETRIES; ++attempt) {
+            uint64_t count = count_.load(std::memory_order_acquire);
+            if (count == 0) {
+                return false;
+            }
+            const Slot& slot = slots_[(count - 1) & 1];
+            uint64_t before = slot.seq.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;                                   // 该缓冲区已被下一次写入占用
+            }
+            T copy = slot.value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) == before) {
+                out = copy;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        T value{};
+    };
+
+    std::atomic<uint64_t> count_{0};    // 已完成的写入次数，最新值在 slots_[(count_ - 1) & 1]
+    Slot slots_[2];
+};
+
+} // namespace robot
+
+#endif // ROBOT_FRAME_PIPELINE_HPP
@@ -0,0 +1,179 @@
+#ifndef ROBOT_FRAME_TRACE_HPP
+#define ROBOT_FRAME_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "latency_histogram.hpp"
+
+namespace robot {
+
+/**
+ * @brief 一条追踪记录
+ * - 普通区间：某个线程上一段处理的起止时间，带所属帧序号
+ * - 帧生命周期：从采集（传感器时间戳）到执行器写入，在 Chrome trace 中显示为按帧分组的异步区间
+ */
+struct TraceSpan {
+    uint64_t frame_id = 0;
+    const char* name = nullptr;     ///< 必须指向静态字符串（通常是字面量）
+    int64_t start_ns = 0;           ///< steady_clock 时间（纳秒）
+    int64_t end_ns = 0;
+    bool frame_lifetime = false;
+};
+
+/**
+ * @brief 逐帧追踪器（进程内单例）
+ *
+ * 每个线程第一次记录时注册一个自己的环形缓冲区，之后只有该线程写入，写入路径无锁、不分配内存；
+ * 缓冲区写满后覆盖最旧的记录。导出时逐条校验序号，跳过正在被覆盖的记录。
+ *
+ * 除追踪记录外还维护"采集到执行器写入"的延迟直方图（glass-to-PWM），可随时读取 p99。
+ * 时间戳统一使用 steady_clock（Linux 上即 CLOCK_MONOTONIC，与 V4L2 缓冲区时间戳同源）。
+ */
+class FrameTracer {
+public:
+    static constexpr size_t DEFAULT_SPANS_PER_THREAD = 8192;
+
+    /// 区间监听函数，在记录区间的线程中调用，不能阻塞
+    using SpanListener = void (*)(const TraceSpan& span);
+
+    static FrameTracer& instance();
+
+    FrameTracer(const FrameTracer&) = delete;
+    FrameTracer& operator=(const FrameTracer&) = delete;
+
+    /**
+     * @brief 打开或关闭追踪，关闭时 record 与 FRAME_TRACE_SCOPE 不读时钟、不写缓冲区
+     */
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 设置区间监听（例如转发到遥测总线），nullptr 取消；追踪关闭时不调用
+     */
+    void setSpanListener(SpanListener listener) { listener_.store(listener, std::memory_order_release); }
+
+    /**
+     * @brief 设置之后新注册线程的缓冲区大小（向上取整为 2 的幂）
+     */
+    void setSpansPerThread(size_t spans);
+
+    /**
+     * @brief 设置当前线程在追踪文件中显示的名称（默认使用线程名）
+     */
+    void setThreadName(const std::string& name);
+
+    /**
+     * @brief 在当前线程的缓冲区中记录一个区间
+     */
+    void record(uint64_t frame_id, const char* name, int64_t start_ns, int64_t end_ns);
+
+    /**
+     * @brief 帧的执行器写入完成：记录帧生命周期并更新 glass-to-PWM 延迟
+     * @param capture_ns 该帧的采集时间（传感器时间戳）
+     * @param actuate_ns 执行器写入完成时间
+     */
+    void recordFrameActuated(uint64_t frame_id, int64_t capture_ns, int64_t actuate_ns);
+
+    /**
+     * @brief glass-to-PWM 延迟快照（微秒），不受 setEnabled 影响
+     */
+    LatencyHistogram::Snapshot glassToActuatorSnapshot() const { return glass_to_actuator_.snapshot(); }
+    void resetLatency() { glass_to_actuator_.reset(); }
+
+    /**
+     * @brief 导出为 Chrome trace JSON（chrome://tracing 与 ui.perfetto.dev 均可打开）
+     */
+    std::string chromeTraceJson() const;
+
+    /**
+     * @brief 写入 Chrome trace 文件
+     * @return 文件无法写入时返回false
+     */
+    bool writeChromeTrace(const std::string& path) const;
+
+    /**
+     * @brief 清空所有线程的缓冲区（调用时其他线程应停止记录）
+     */
+    void clear();
+
+    static int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static int64_t toNs(std::chrono::steady_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};   // 2n+1：第 n 条写入中，2n+2：第 n 条写入完成
+        TraceSpan span;
+    };
+
+    struct ThreadBuffer {
+        uint32_t tid = 0;
+        std::string name;
+        size_t mask = 0;
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<uint64_t> head{0};
+    };
+
+    FrameTracer() = default;
+
+    ThreadBuffer& localBuffer();
+    void append(const TraceSpan& span);
+
+    std::atomic<bool> enabled_{true};
+    std::atomic<SpanListener> listener_{nullptr};
+    std::atomic<size_t> spans_per_thread_{DEFAULT_SPANS_PER_THREAD};
+    LatencyHistogram glass_to_actuator_;
+
+    mutable std::mutex registry_mutex_;                     // 只在线程注册与导出时使用
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;    // 线程退出后保留，供导出
+};
+
+/**
+ * @brief 作用域追踪：构造时记录开始时间，析构时写入区间
+ */
+class ScopedFrameTrace {
+public:
+    ScopedFrameTrace(uint64_t frame_id, const char* name)
+        : frame_id_(frame_id)
+        , name_(name)
+        , start_ns_(FrameTracer::instance().enabled() ? FrameTracer::nowNs() : 0) {}
+
+    ~ScopedFrameTrace() {
+        if (start_ns_ != 0) {
+            FrameTracer::instance().record(frame_id_, name_, start_ns_, FrameTracer::nowNs());
+        }
+    }
+
+    ScopedFrameTrace(const ScopedFrameTrace&) = delete;
+    ScopedFrameTrace& operator=(const ScopedFrameTrace&) = delete;
+
+private:
+    uint64_t frame_id_;
+    const char* name_;
+    int64_t start_ns_;
+};
+
+} // namespace robot
+
+#define FRAME_TRACE_CONCAT_INNER(a, b) a##b
+#define FRAME_TRACE_CONCAT(a, b) FRAME_TRACE_CONCAT_INNER(a, b)
+
+/**
+ * @brief 追踪当前作用域，name 必须是字符串字面量
+ * 例：FRAME_TRACE_SCOPE(info.frame_id, "imgPreProc");
+ */
+#define FRAME_TRACE_SCOPE(frame_id, name) \
+    ::robot::ScopedFrameTrace FRAME_TRACE_CONCAT(frame_trace_scope_, __LINE__)((frame_id), (name))
+
+#endif // ROBOT_FRAME_TRACE_HPP
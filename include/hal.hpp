@@ -0,0 +1,255 @@
+#ifndef ROBOT_HAL_HPP
+#define ROBOT_HAL_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "zf_device_imu_core.h"
+#include "zf_driver_pwm.h"
+
+namespace robot {
+namespace hal {
+
+/**
+ * 硬件抽象层
+ *
+ * 每类设备一个接口，三种后端：
+ * - Device*：车上的设备，直接调用 zf_* 驱动；
+ * - Memory*：进程内的假设备，值由测试或仿真直接读写，不经过文件；
+ * - SimDeviceTree：在普通目录下生成与车上相同路径的设备文件并重定向 zf_* 驱动（file_set_device_root），
+ *   SensorSampler、ActuatorService、IMUDevice 等直接持有设备句柄的模块不需修改即可在台式机上运行。
+ * 摄像头接口依赖 OpenCV，见 hal_camera.hpp。
+ */
+
+/**
+ * @brief 编码器，read() 返回一个采样周期的计数（与 encoder_get_count 相同）
+ */
+class Encoder {
+public:
+    virtual ~Encoder() = default;
+    virtual int16_t read() = 0;
+};
+
+/**
+ * @brief PWM 输出
+ */
+class Pwm {
+public:
+    virtual ~Pwm() = default;
+    /// 读取频率、占空比上限等参数，取不到时返回 false
+    virtual bool info(pwm_info& out) = 0;
+    virtual void setDuty(uint16_t duty) = 0;
+};
+
+/**
+ * @brief GPIO 引脚，电平为 0/1
+ */
+class Gpio {
+public:
+    virtual ~Gpio() = default;
+    virtual void set(uint8_t level) = 0;
+    virtual uint8_t get() = 0;
+};
+
+/**
+ * @brief IMU 原始数据
+ */
+class Imu {
+public:
+    virtual ~Imu() = default;
+    virtual bool initialize() = 0;
+    /// 读取最新数据，没有新数据或读取失败时返回 false
+    virtual bool read(imu_raw_data_t& out) = 0;
+    /// 陀螺仪原始值到 rad/s 的比例
+    virtual double gyroScale() const = 0;
+};
+
+/**
+ * @brief 显示屏，open() 之后 ips200_* 绘制函数输出到该设备
+ */
+class Framebuffer {
+public:
+    virtual ~Framebuffer() = default;
+    virtual bool open() = 0;
+};
+
+// ---------------------------------------------------------------- 车上设备（zf_* 驱动）
+
+class DeviceEncoder : public Encoder {
+public:
+    explicit DeviceEncoder(const char* path) : path_(path) {}
+    int16_t read() override;
+
+private:
+    const char* path_;
+};
+
+class DevicePwm : public Pwm {
+public:
+    explicit DevicePwm(const char* path) : path_(path) {}
+    bool info(pwm_info& out) override;
+    void setDuty(uint16_t duty) override;
+
+private:
+    const char* path_;
+};
+
+class DeviceGpio : public Gpio {
+public:
+    explicit DeviceGpio(const char* path) : path_(path) {}
+    void set(uint8_t level) override;
+    uint8_t get() override;
+
+private:
+    const char* path_;
+};
+
+/**
+ * @brief 包装 IMUDevice（ImuStream 等仍直接使用同一个 IMUDevice）
+ */
+class DeviceImu : public Imu {
+public:
+    explicit DeviceImu(IMUDevice* imu) : imu_(imu) {}
+    bool initialize() override;
+    bool read(imu_raw_data_t& out) override;
+    double gyroScale() const override;
+
+private:
+    IMUDevice* imu_;
+};
+
+/**
+ * @brief Linux framebuffer（ips200_init 映射显存）
+ */
+class DeviceFramebuffer : public Framebuffer {
+public:
+    explicit DeviceFramebuffer(const char* path) : path_(path) {}
+    bool open() override;
+
+private:
+    const char* path_;
+};
+
+// ---------------------------------------------------------------- 进程内假设备
+
+class MemoryEncoder : public Encoder {
+public:
+    int16_t read() override { return count_.load(std::memory_order_relaxed); }
+    void set(int16_t count) { count_.store(count, std::memory_order_relaxed); }
+
+private:
+    std::atomic<int16_t> count_{0};
+};
+
+class MemoryPwm : public Pwm {
+public:
+    explicit MemoryPwm(const pwm_info& info) : info_(info) {}
+    bool info(pwm_info& out) override;
+    void setDuty(uint16_t duty) override;
+
+    uint16_t duty() const { return duty_.load(std::memory_order_relaxed); }
+    uint64_t writes() const { return writes_.load(std::memory_order_relaxed); }
+
+private:
+    pwm_info info_;
+    std::atomic<uint16_t> duty_{0};
+    std::atomic<uint64_t> writes_{0};
+};
+
+class MemoryGpio : public Gpio {
+public:
+    void set(uint8_t level) override { level_.store(level ? 1 : 0, std::memory_order_relaxed); }
+    uint8_t get() override { return level_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint8_t> level_{0};
+};
+
+class MemoryImu : public Imu {
+public:
+    explicit MemoryImu(double gyro_scale) : gyro_scale_(gyro_scale) {}
+    bool initialize() override { return true; }
+    bool read(imu_raw_data_t& out) override;
+    double gyroScale() const override { return gyro_scale_; }
+
+    /// 写入一个新样本，下一次 read() 返回该样本
+    void set(const imu_raw_data_t& data);
+
+private:
+    double gyro_scale_;
+    std::mutex mutex_;
+    imu_raw_data_t data_{};
+    bool fresh_ = false;
+};
+
+/**
+ * @brief 内存中的 RGB565 显存，ips200_attach 到该缓冲区
+ */
+class MemoryFramebuffer : public Framebuffer {
+public:
+    MemoryFramebuffer(int width, int height);
+    bool open() override;
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    const uint16_t* pixels() const { return pixels_.data(); }
+    uint16_t pixel(int x, int y) const { return pixels_[(size_t)y * width_ + x]; }
+
+    /// 当前画面保存为 PPM 图片（调用前先 ips200_update_screen）
+    bool savePpm(const std::string& path) const;
+
+private:
+    int width_;
+    int height_;
+    std::vector<uint16_t> pixels_;
+};
+
+// ---------------------------------------------------------------- 文件仿真的设备树
+
+/**
+ * @brief 在 root 目录下生成设备文件，格式与车上驱动读写的格式相同
+ *
+ * - 编码器：int16 二进制计数；
+ * - PWM：创建时写入 pwm_info，之后驱动在偏移 0 处写 uint16 占空比
+ *   （与字符设备不同，普通文件中占空比覆盖 pwm_info 的前两个字节，所以 pwm_get_dev_info 应在第一次写入之前调用）；
+ * - GPIO：ASCII '0'/'1'；
+ * - IMU：sysfs 的 name、in_anglvel_scale 与各轴 in_*_raw（不创建 IIO 缓冲区，IMUDevice 使用 sysfs 方式读取）。
+ *
+ * activate() 把 zf_* 驱动的设备根目录设为 root，需要在第一次访问设备之前调用。
+ * 仿真的另一端（被控对象模型）通过 setEncoder()/pwmDuty()/gpioLevel()/setImu() 读写同一批文件。
+ */
+class SimDeviceTree {
+public:
+    explicit SimDeviceTree(const std::string& root) : root_(root) {}
+
+    bool addEncoder(const char* path);
+    bool addPwm(const char* path, const pwm_info& info);
+    bool addGpio(const char* path, uint8_t level = 0);
+    /// @param name 写入 name 文件的型号（IMU660RA / IMU660RB / IMU963RA）
+    bool addImu(const char* name, double gyro_scale);
+
+    void activate();
+
+    bool setEncoder(const char* path, int16_t count);
+    bool pwmDuty(const char* path, uint16_t* duty) const;
+    bool gpioLevel(const char* path, uint8_t* level) const;
+    bool setImu(const imu_raw_data_t& data);
+
+    const std::string& root() const { return root_; }
+
+private:
+    std::string resolve(const char* path) const { return root_ + path; }
+    bool writeFile(const std::string& path, const void* data, size_t size) const;
+    bool readFile(const std::string& path, void* data, size_t size) const;
+
+    std::string root_;
+    bool imu9_ = false;
+};
+
+} // namespace hal
+} // namespace robot
+
+#endif // ROBOT_HAL_HPP
@@ -0,0 +1,79 @@
+#ifndef ROBOT_HAL_CAMERA_HPP
+#define ROBOT_HAL_CAMERA_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <opencv2/videoio.hpp>
+
+namespace robot {
+namespace hal {
+
+/**
+ * @brief 摄像头（硬件抽象层中唯一依赖 OpenCV 的接口）
+ */
+class Camera {
+public:
+    virtual ~Camera() = default;
+    virtual bool open() = 0;
+    /**
+     * @brief 读取下一帧，阻塞到帧到来
+     * @param sensor_ns 该帧的采集时刻（steady_clock 纳秒）
+     * @return 没有更多帧或读取失败时返回 false
+     */
+    virtual bool read(cv::Mat& frame, int64_t& sensor_ns) = 0;
+    virtual void close() = 0;
+};
+
+/**
+ * @brief V4L2 摄像头（MJPG），参数与 CameraInit 相同
+ */
+class V4l2Camera : public Camera {
+public:
+    V4l2Camera(const char* device, int width, int height, int fps)
+        : device_(device), width_(width), height_(height), fps_(fps) {}
+
+    bool open() override;
+    bool read(cv::Mat& frame, int64_t& sensor_ns) override;
+    void close() override { capture_.release(); }
+
+private:
+    const char* device_;
+    int width_;
+    int height_;
+    int fps_;
+    cv::VideoCapture capture_;
+};
+
+/**
+ * @brief 从文件读取的仿真摄像头
+ *
+ * path 为视频文件、图片目录（按文件名排序）或 glob 模式（如 "frames/*.png"）。
+ * fps > 0 时按该帧率节拍输出（模拟摄像头的阻塞读取），0 时尽快读取；loop 时读完从头开始。
+ * 采集时刻取读取完成的时间。
+ */
+class FileCamera : public Camera {
+public:
+    FileCamera(const std::string& path, double fps, bool loop) : path_(path), fps_(fps), loop_(loop) {}
+
+    bool open() override;
+    bool read(cv::Mat& frame, int64_t& sensor_ns) override;
+    void close() override;
+
+private:
+    bool readNext(cv::Mat& frame);
+
+    std::string path_;
+    double fps_;
+    bool loop_;
+    cv::VideoCapture video_;
+    std::vector<std::string> images_;
+    size_t next_image_ = 0;
+    int64_t next_frame_ns_ = 0;
+};
+
+} // namespace hal
+} // namespace robot
+
+#endif // ROBOT_HAL_CAMERA_HPP
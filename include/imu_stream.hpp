@@ -0,0 +1,140 @@
+#ifndef ROBOT_IMU_STREAM_HPP
+#define ROBOT_IMU_STREAM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include "zf_device_imu_core.h"
+
+namespace robot {
+
+/**
+ * @brief IMU 流式采集选项
+ */
+struct ImuStreamOptions {
+    int rate_hz = 1000;         ///< sysfs 模式下的采样频率（缓冲区模式由设备输出频率决定）
+    size_t capacity = 4096;     ///< 环形缓冲区样本数（向上取整为 2 的幂），决定可回溯的时间长度
+    int cpu = -1;               ///< 采集线程绑定的CPU，-1 不绑定
+    int rt_priority = 0;        ///< 采集线程的 SCHED_FIFO 优先级，0 保持普通调度
+};
+
+/**
+ * @brief IMU 流式采集与按时间戳查询
+ *
+ * 独立线程持续读取 IMUDevice，把带时间戳的样本写入单写多读的无锁环形缓冲区，
+ * 同时累计陀螺仪积分角（梯形积分）。查询按时间戳二分查找，复杂度 O(log n)：
+ * - sampleAt(t)：t 时刻的线性插值样本（例如图像帧的采集时刻）
+ * - integrateGyro(t0, t1)：t0 到 t1 之间陀螺仪积分得到的转角
+ *
+ * 每个槽带序号，读者读到正在被覆盖的槽时查询失败而不是返回错误数据；
+ * 查询范围限制在最旧的 7/8 以内，留出余量避免与写入竞争。
+ * 没有设备时可以用 push() 直接写入样本（测试与回放）。
+ */
+class ImuStream {
+public:
+    /**
+     * @param imu IMU设备（可为空，此时只能通过 push() 写入）
+     */
+    explicit ImuStream(IMUDevice* imu = nullptr);
+    ~ImuStream();
+
+    ImuStream(const ImuStream&) = delete;
+    ImuStream& operator=(const ImuStream&) = delete;
+
+    /**
+     * @brief 分配环形缓冲区并启动采集线程
+     * @return 已在运行或设备未初始化时返回false
+     */
+    bool start(const ImuStreamOptions& options = ImuStreamOptions());
+
+    /**
+     * @brief 停止并等待采集线程退出（缓冲区中的数据保留）
+     */
+    void stop();
+
+    bool isRunning() const { return running_; }
+
+    /**
+     * @brief 清空并按容量重新分配缓冲区（不能与 push 或采集线程并发调用）
+     */
+    void reset(size_t capacity);
+
+    /**
+     * @brief 设置陀螺仪比例（rad/s 每 LSB），start() 时从设备读取
+     */
+    void setGyroScale(double rad_per_lsb) { gyro_scale_ = rad_per_lsb; }
+
+    /**
+     * @brief 设置样本回调：每个样本写入缓冲区后在写者线程中调用（用于姿态解算等逐样本处理）
+     *
+     * 回调运行在采集线程中，必须足够快；需在 start() 之前设置
+     */
+    void setSampleListener(std::function<void(const imu_sample_t&)> listener) { listener_ = std::move(listener); }
+
+    /**
+     * @brief 写入一个样本（单写者：采集线程或没有启动采集时的调用者）
+     * @return 时间戳不晚于上一个样本时丢弃并返回false
+     */
+    bool push(const imu_sample_t& sample);
+
+    /**
+     * @brief 最新样本
+     */
+    bool latest(imu_sample_t& out) const;
+
+    /**
+     * @brief t_ns 时刻的插值样本
+     * @return t_ns 超出缓冲区覆盖的时间范围时返回false
+     */
+    bool sampleAt(int64_t t_ns, imu_sample_t& out) const;
+
+    /**
+     * @brief t0_ns 到 t1_ns 之间的陀螺仪积分转角（rad，依次为 x/y/z 轴）
+     * @return 任一时刻超出缓冲区覆盖的时间范围时返回false
+     */
+    bool integrateGyro(int64_t t0_ns, int64_t t1_ns, double angle_rad[3]) const;
+
+    /**
+     * @brief 写入过的样本总数
+     */
+    uint64_t sampleCount() const { return head_.load(std::memory_order_acquire); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};   // 2n+1：第 n 个样本写入中，2n+2：写入完成
+        imu_sample_t sample;
+        double angle[3];                // 从第一个样本起的累计积分角（rad）
+    };
+
+    struct Entry {
+        imu_sample_t sample;
+        double angle[3];
+    };
+
+    void captureLoop(ImuStreamOptions options);
+    bool readEntry(uint64_t n, Entry& out) const;
+    bool locate(int64_t t_ns, Entry& out) const;
+
+    IMUDevice* imu_;
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    std::atomic<uint64_t> head_{0};
+    double gyro_scale_;
+    std::function<void(const imu_sample_t&)> listener_;
+
+    // 只由写者访问
+    bool has_last_ = false;
+    imu_sample_t last_sample_{};
+    double last_angle_[3] = {0, 0, 0};
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+} // namespace robot
+
+#endif // ROBOT_IMU_STREAM_HPP
@@ -0,0 +1,157 @@
+#ifndef ROBOT_LATENCY_HISTOGRAM_HPP
+#define ROBOT_LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace robot {
+
+/**
+ * @brief HDR 风格的对数分桶直方图（单位由调用者决定，调度器中统一使用微秒）
+ *
+ * 数值按 2 的幂划分量级，每个量级再线性细分为 SUB_BUCKETS 个子桶，
+ * 相对误差约为 1/SUB_BUCKETS。所有计数器使用 relaxed 原子操作，
+ * record() 可以在任意线程无锁调用，snapshot() 不会阻塞记录方。
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 4;                                   ///< 每个量级的子桶位数
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;                    ///< 每个量级的子桶数量
+    static constexpr int MAX_VALUE_BITS = 32;                                   ///< 可记录的最大数值位宽（超出部分饱和）
+    static constexpr int MAGNITUDES = MAX_VALUE_BITS - SUB_BUCKET_BITS + 1;     ///< 量级数量
+    static constexpr int BUCKET_COUNT = MAGNITUDES * SUB_BUCKETS;               ///< 总桶数
+    static constexpr uint64_t MAX_VALUE = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+
+    /**
+     * @brief 直方图快照（普通数据，可自由拷贝）
+     */
+    struct Snapshot {
+        uint64_t count = 0;     ///< 样本总数
+        uint64_t sum = 0;       ///< 样本总和
+        uint64_t max = 0;       ///< 最大值
+        std::array<uint64_t, BUCKET_COUNT> buckets{};
+
+        /**
+         * @brief 计算百分位数
+         * @param p 百分位（0-100）
+         * @return 对应桶的上界（不超过记录到的最大值），无样本时返回0
+         */
+        uint64_t percentile(double p) const {
+            if (count == 0) {
+                return 0;
+            }
+            if (p <= 0.0) {
+                p = 0.0;
+            }
+            if (p >= 100.0) {
+                return max;
+            }
+            uint64_t target = static_cast<uint64_t>(p / 100.0 * static_cast<double>(count) + 0.5);
+            if (target == 0) {
+                target = 1;
+            }
+            uint64_t seen = 0;
+            for (int i = 0; i < BUCKET_COUNT; ++i) {
+                seen += buckets[i];
+                if (seen >= target) {
+                    uint64_t upper = bucketUpper(i);
+                    return upper < max ? upper : max;
+                }
+            }
+            return max;
+        }
+
+        /**
+         * @brief 平均值
+         */
+        double mean() const {
+            return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+        }
+    };
+
+    LatencyHistogram() { reset(); }
+
+    // 原子计数器不可拷贝
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief 记录一个样本（无锁，relaxed）
+     * @param value 样本值，超过 MAX_VALUE 时饱和到最后一个桶
+     */
+    void record(uint64_t value) noexcept {
+        if (value > MAX_VALUE) {
+            value = MAX_VALUE;
+        }
+        buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t current_max = max_.load(std::memory_order_relaxed);
+        while (value > current_max &&
+               !max_.compare_exchange_weak(current_max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief 获取快照
+     *
+     * 计数直接由各桶累加得到，保证快照内部 count 与 buckets 一致；
+     * 与并发的 record() 之间只存在单个样本级别的误差。
+     */
+    Snapshot snapshot() const noexcept {
+        Snapshot s;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            s.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+            s.count += s.buckets[i];
+        }
+        s.sum = sum_.load(std::memory_order_relaxed);
+        s.max = max_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    /**
+     * @brief 清空直方图（与并发 record() 同时调用时可能丢失少量样本）
+     */
+    void reset() noexcept {
+        for (auto& b : buckets_) {
+            b.store(0, std::memory_order_relaxed);
+        }
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 数值 -> 桶序号
+     */
+    static int bucketIndex(uint64_t value) noexcept {
+        if (value < static_cast<uint64_t>(SUB_BUCKETS)) {
+            return static_cast<int>(value);
+        }
+        int msb = 63 - __builtin_clzll(value);
+        int magnitude = msb - SUB_BUCKET_BITS + 1;
+        int sub = static_cast<int>(value >> (msb - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+        return magnitude * SUB_BUCKETS + sub;
+    }
+
+    /**
+     * @brief 桶序号 -> 该桶可表示的最大数值
+     */
+    static uint64_t bucketUpper(int index) noexcept {
+        if (index < SUB_BUCKETS) {
+            return static_cast<uint64_t>(index);
+        }
+        int magnitude = index / SUB_BUCKETS;
+        uint64_t sub = static_cast<uint64_t>(index % SUB_BUCKETS);
+        return ((SUB_BUCKETS + sub + 1) << (magnitude - 1)) - 1;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_;
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+} // namespace robot
+
+#endif // ROBOT_LATENCY_HISTOGRAM_HPP
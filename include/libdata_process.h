@@ -47,9 +47,8 @@ class Judge
         */
         void Protect_Thread(Data_Path * Data_Path_p);
     
-    private:
         /*
-            边线拐点寻找
+            边线拐点寻找（由 TrackKind_Judge 调用，公开以便基准测试单独计时）
             @ 参数说明
             Img_Store_p 图像存储指针
             Data_Path_p 路径相关数据指针
@@ -65,6 +64,7 @@ class Judge
         */
         void BendPointSearch(Img_Store* Img_Store_p,Data_Path *Data_Path_p);
 
+    private:
 
         /*
             霍夫圆环识别
@@ -86,6 +86,17 @@ class SYNC
             Data_Path_p 路径相关数据指针
         */
         void ConfigData_SYNC(Data_Path *Data_Path_p,Function_EN *Function_EN_p,JSON_PIDConfigData *JSON_PIDConfigData_p);
+
+        /*
+            从指定参数文件读取设置（不询问参数文件编号）
+            @参数说明
+            ConfigFilePath 参数文件路径
+            Function_EN_p 函数使能指针
+            Data_Path_p 路径相关数据指针
+            @返回值说明
+            文件打不开时返回 false
+        */
+        bool ConfigData_Load(const char* ConfigFilePath,Data_Path *Data_Path_p,Function_EN *Function_EN_p,JSON_PIDConfigData *JSON_PIDConfigData_p);
 };
 
 
@@ -75,6 +75,13 @@ typedef struct JSON_PIDConfigData
     int speedl;
     int speedr;
 
+    double encoder_meters_per_count;   // 每个编码器脉冲对应的行进距离（米）
+    double wheel_track_width;          // 左右轮距（米）
+
+    float motor_kff;        // 电机速度前馈系数：输出叠加 kff × 目标速度
+    bool cascade_steer;     // 串级转向：像素偏差 → 角速度目标（anglespeedpid）→ 舵机（servopid）
+    float pid_d_tau;        // 各环微分项低通时间常数（秒）
+
 }JSON_PIDConfigData;
 
 
@@ -88,6 +95,9 @@ typedef struct JSON_FunctionConfigData
     CameraKind Camera_EN;   // 相机使能
     bool VideoShow_EN;  // 图像显示使能
     bool ImageSave_EN;  // 图像存储使能
+    bool FlightRecord_EN = false;   // 飞行记录使能：二值图、寻线摘要与遥测写入环形记录文件
+    int FlightRecord_Gray_Every = 0;    // 每隔多少帧同时记录一帧原始灰度图，0 不记录
+    int FlightRecord_MB = 128;  // 记录文件数据区大小（MB）
     bool DataPrint_EN;  // 数据显示使能
     bool AcrossIdentify_EN;    // 十字特征点识别使能
     bool CircleIdentify_EN;    // 圆环特征点识别使能
@@ -103,6 +113,10 @@ typedef struct JSON_TrackConfigData
 {
     int Forward;    // 前瞻点
     int Default_Forward;    // 默认前瞻点，用于前瞻点初始化
+    int Lookahead_Window = 0;   // 前瞻拟合窗口行数，0 为只读前瞻点一行
+    bool Lookahead_Quadratic = true;    // 前瞻拟合：true 二次拟合，false 直线拟合
+    float Lookahead_Speed_Ref = 1.0f;   // 前瞻点对应的参考车速（m/s）
+    float Lookahead_Rows_Per_Mps = 0;   // 车速每高于参考 1 m/s 前瞻点上移的行数
     int Path_Search_Start;  // 寻路径起始点
     int Path_Search_End;    // 寻路径结束点
     int Side_Search_Start; // 寻边线起始点
@@ -118,6 +132,14 @@ typedef struct JSON_TrackConfigData
     int BridgeZoneMotorSpeed = 0;   // 桥梁区域电机速度
     int CrosswalkZoneMotorSpeed = 0;    // 斑马线区域电机准备停车速度
     int Circle_In_Prepare_Time = 0;    // 准备入环限定时间
+    int Circle_Out_Gyro_Angle = 0;     // 入环后陀螺仪积分达到该角度（度）时出环
+    bool SpeedPlan_EN = false;          // 曲率速度规划使能：电机速度作为上限，按前方曲率与加减速度限制连续调整
+    float SpeedPlan_Lateral_Acc = 3.0f; // 允许的侧向加速度（m/s²）
+    float SpeedPlan_Acc = 2.0f;         // 加速度限制（m/s²）
+    float SpeedPlan_Dec = 4.0f;         // 减速度限制（m/s²）
+    float SpeedPlan_Min_Speed = 0.5f;   // 弯道限速下限（m/s）
+    float SpeedPlan_Horizon_Speed = 1.2f;   // 视野末端须能减速到的速度（m/s）
+    float Birdeye_Meters_Per_Pixel = 0.005f;    // 俯视图每像素对应的距离（米）
 
 }JSON_TrackConfigData;
 
@@ -147,6 +169,7 @@ typedef struct Img_Store
     cv::Mat Dilate_Kernel = getStructuringElement(cv::MORPH_CROSS,cv::Size(2,2));  // 边线形态学膨胀核大小
     cv::Mat Erode_Kernel = getStructuringElement(cv::MORPH_CROSS,cv::Size(2,2));  // 边线形态学腐蚀核大小
     int ImgNum = 0;
+    bool Draw_EN = true;    // 在 Img_Track 上绘制边线、补线等显示内容；离线回放关闭以免影响耗时
     uint8 original_image[image_h][image_w];
     uint8 bin_image[image_h][image_w];
     uint8 PerImg_ip[RESULT_ROW][RESULT_COL];    
@@ -226,6 +249,8 @@ typedef struct Data_Path
     int ServoDir = 0;  // 舵机方向
     int ServoAngle = 0;    // 舵机角度
     int MotorSpeed = 0;    // 电机速度
+    double Distance = 0;   // 当前帧采集时刻的累计行驶距离（米），用于按距离计时
+    float Speed = 0;       // 当前车速（米/秒），用于前瞻随车速调整
 
     int findrow;
 
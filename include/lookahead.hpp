@@ -0,0 +1,62 @@
+#ifndef ROBOT_LOOKAHEAD_HPP
+#define ROBOT_LOOKAHEAD_HPP
+
+#include <cstdint>
+
+namespace robot {
+
+/**
+ * @brief 前瞻选项
+ */
+struct LookaheadOptions {
+    int window = 20;                ///< 拟合窗口行数（以前瞻行为中心），小于 min_rows 时退回单行
+    bool quadratic = true;          ///< true：加权二次拟合（可得曲率）；false：加权直线最小二乘
+    int min_rows = 5;               ///< 窗口内有效行少于该值时退回单行读取
+    float speed_ref = 0;            ///< 参考车速（m/s），该车速下前瞻行为配置的 Forward
+    float rows_per_mps = 0;         ///< 车速每高于参考 1 m/s 前瞻行向远处移动的行数，0 表示不随车速调整
+    int origin_row = -1;            ///< 车辆位置对应的行（可在图像下方），<0 时取图像高度
+};
+
+/**
+ * @brief 前瞻结果
+ */
+struct LookaheadResult {
+    bool valid = false;             ///< 是否有可用的中线
+    int row = 0;                    ///< 实际使用的前瞻行
+    int rows_used = 0;              ///< 参与拟合的行数（1 表示单行读取）
+    float offset = 0;               ///< 拟合中线在前瞻行相对图像中心的偏差（像素，偏右为正）
+    float slope = 0;                ///< 拟合中线在前瞻行的斜率 dx/drow（行号向下增大）
+    float curvature = 0;            ///< 拟合二次项系数 d²x/drow²/2，直线拟合时为0
+    float steer = 0;                ///< 纯追踪转向量，折算为 Forward 行处的等效偏差（像素，偏右为正）
+};
+
+/**
+ * @brief 多行加权前瞻与纯追踪转向
+ *
+ * 在中线有效行 [valid_top, valid_bottom) 内，以前瞻行为中心取 window 行做加权最小二乘拟合
+ * （权重按到前瞻行的距离线性递减），用拟合值代替单行读数，抑制单行中线的跳动。
+ * 前瞻行由 forward_row 按车速调整：车速越高看得越远。
+ *
+ * 纯追踪：目标点为拟合中线在前瞻行的位置，车辆位于 origin_row，前瞻距离 L 以行数计，
+ * 曲率 κ = 2e / (L² + e²)。为了与原单行偏差的 PID 参数兼容，steer 把曲率折算回
+ * Forward 行处的等效偏差 κ·L0²/2（L0 为 Forward 行的前瞻距离）：车速等于参考车速、
+ * 偏差远小于前瞻距离时 steer 约等于原单行偏差，前瞻变远时同样的偏差对应更小的转向。
+ * 前瞻距离按行数近似，未做逆透视换算。
+ *
+ * O(window)，不分配内存，只读 center_line。
+ *
+ * @param center_line   中线数组（按行索引，行号向下增大）
+ * @param image_height  图像高度
+ * @param image_width   图像宽度
+ * @param valid_top     中线最远的有效行（hightest）
+ * @param valid_bottom  中线有效行的下界（不含）
+ * @param forward_row   配置的前瞻行
+ * @param speed         当前车速（m/s）
+ */
+LookaheadResult computeLookahead(const uint16_t* center_line, int image_height, int image_width,
+                                 int valid_top, int valid_bottom, int forward_row, float speed,
+                                 const LookaheadOptions& options);
+
+} // namespace robot
+
+#endif // ROBOT_LOOKAHEAD_HPP
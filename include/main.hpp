@@ -36,6 +36,13 @@
 #define MOTOR2_DIR              "/dev/zf_driver_gpio_motor_2"
 #define MOTOR2_PWM              "/dev/zf_device_pwm_motor_2"
 
+// 寄存器直写后端（ZF_DRIVER_MMIO）中各设备对应的 PWM 通道号与 GPIO 引脚号，须与设备树一致
+#define SERVO_MOTOR1_PWM_CH     (0)
+#define MOTOR1_PWM_CH           (1)
+#define MOTOR2_PWM_CH           (2)
+#define MOTOR1_DIR_PIN          (74)
+#define MOTOR2_DIR_PIN          (75)
+
 #define ENCODER_1               "/dev/zf_encoder_1"
 #define ENCODER_2               "/dev/zf_encoder_2"
 
@@ -0,0 +1,126 @@
+#ifndef ROBOT_ODOMETRY_HPP
+#define ROBOT_ODOMETRY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "frame_pipeline.hpp"
+
+namespace robot {
+
+/**
+ * @brief 里程计选项
+ */
+struct OdometryOptions {
+    double meters_per_count = 0.000193;     ///< 每个编码器脉冲对应的轮子行进距离（米）
+    double track_width_m = 0.155;           ///< 左右轮距（米），用于差速角速度
+    float alpha = 0.5f;                     ///< α-β 滤波位置修正系数（0~1，越大越信任测量）
+    float beta = 0.15f;                     ///< α-β 滤波速度修正系数（一般取 α²/(2-α) 附近）
+    int64_t max_gap_ns = 200000000LL;       ///< 相邻采样间隔超过该值时速度按本次增量重新初始化
+    size_t history = 1024;                  ///< 距离历史样本数（向上取整为 2 的幂），用于按时间戳查询
+};
+
+/**
+ * @brief 里程计快照
+ */
+struct OdometryState {
+    int64_t timestamp_ns = 0;       ///< 最新采样时间（steady_clock 纳秒）
+    uint64_t samples = 0;           ///< 采样次数
+    int64_t left_count = 0;         ///< 左轮累计脉冲
+    int64_t right_count = 0;        ///< 右轮累计脉冲
+    float left_cps = 0;             ///< 左轮滤波速度（脉冲/秒）
+    float right_cps = 0;            ///< 右轮滤波速度（脉冲/秒）
+    float left_speed = 0;           ///< 左轮速度（米/秒）
+    float right_speed = 0;          ///< 右轮速度（米/秒）
+    float speed = 0;                ///< 车体速度：两轮平均（米/秒）
+    float yaw_rate = 0;             ///< 差速角速度（rad/s，左转为正）
+    double distance = 0;            ///< 累计行驶距离：两轮平均（米，后退为负）
+    double heading = 0;             ///< 差速积分航向（rad，连续累计）
+};
+
+/**
+ * @brief 编码器里程计与速度估计
+ *
+ * update() 在固定频率的采样任务中调用（单写者），输入两个编码器自上次读取以来的脉冲增量
+ * （逐飞编码器驱动读后清零）。每个轮子对累计脉冲做 α-β 滤波：预测位置 = 上次位置 + 速度×dt，
+ * 按测量残差修正位置与速度。相比直接用单周期脉冲数，量化噪声小且不引入一阶低通的相位滞后。
+ *
+ * 结果通过 state() 无锁读取（LatestValue，读者不等待写者），控制任务每周期读取一次即可；
+ * distanceAt() 按时间戳查询行驶距离（线性插值），用于按图像采集时刻对齐的距离计时。
+ */
+class Odometry {
+public:
+    explicit Odometry(const OdometryOptions& options = OdometryOptions());
+
+    Odometry(const Odometry&) = delete;
+    Odometry& operator=(const Odometry&) = delete;
+
+    /**
+     * @brief 修改选项并清零（不能与 update 并发调用）
+     */
+    void configure(const OdometryOptions& options);
+
+    /**
+     * @brief 清零距离、航向与滤波状态（不能与 update 并发调用）
+     */
+    void reset();
+
+    /**
+     * @brief 输入一次采样（单写者）
+     * @param timestamp_ns 采样时间（steady_clock 纳秒）
+     * @param left_delta   左编码器本周期脉冲数
+     * @param right_delta  右编码器本周期脉冲数
+     * @return 时间戳不晚于上一次采样时丢弃并返回false
+     */
+    bool update(int64_t timestamp_ns, int left_delta, int right_delta);
+
+    /**
+     * @brief 读取最新快照（不自旋，可在高于写者优先级的线程中调用）
+     * @return 尚未采样，或写者持续更新使重读超过上限时返回false，out 保持不变
+     */
+    bool state(OdometryState& out) const { return state_.load(out); }
+
+    /**
+     * @brief 查询 t_ns 时刻的累计行驶距离（米）
+     * @return t_ns 超出历史覆盖的时间范围时返回false
+     */
+    bool distanceAt(int64_t t_ns, double& meters) const;
+
+private:
+    struct WheelFilter {
+        double position = 0;    // 脉冲
+        double velocity = 0;    // 脉冲/秒
+    };
+
+    struct Slot {
+        std::atomic<uint64_t> seq{0};   // 2n+1：第 n 条写入中，2n+2：写入完成
+        int64_t timestamp_ns = 0;
+        double distance = 0;
+    };
+
+    void filterWheel(WheelFilter& wheel, int64_t count, double dt, bool restart);
+    bool readSlot(uint64_t n, int64_t& timestamp_ns, double& distance) const;
+
+    OdometryOptions options_;
+
+    // 只由写者访问
+    bool has_last_ = false;
+    int64_t last_ns_ = 0;
+    int64_t left_count_ = 0;
+    int64_t right_count_ = 0;
+    double heading_ = 0;
+    uint64_t samples_ = 0;
+    WheelFilter left_;
+    WheelFilter right_;
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    std::atomic<uint64_t> head_{0};
+    LatestValue<OdometryState> state_;
+};
+
+} // namespace robot
+
+#endif // ROBOT_ODOMETRY_HPP
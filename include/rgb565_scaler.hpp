@@ -0,0 +1,76 @@
+#ifndef ROBOT_RGB565_SCALER_HPP
+#define ROBOT_RGB565_SCALER_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace robot {
+
+/**
+ * @brief 输入像素格式
+ */
+enum class PixelFormat {
+    Bgr,        ///< 3 字节 BGR（OpenCV CV_8UC3）
+    Gray,       ///< 1 字节灰度
+    Binary,     ///< 1 字节二值图：0 为黑，非 0 为白
+};
+
+/**
+ * @brief 最近邻缩放并转换为 RGB565，一次遍历完成
+ *
+ * configure() 按源/目标尺寸预先算好每个目标列、目标行对应的源列、源行。缩放比例在一行内按周期重复时
+ * （例如 320→240 每 4 个源像素取 3 个、等宽时每 16 个取 16 个），每个周期用一次向量 shuffle 取出
+ * 所需像素的 B/G/R 分量，再打包成 RGB565，每次处理 16 字节宽的窗口；其余比例和行尾按列表逐像素处理。
+ * 向量部分使用 GCC 向量扩展，编译目标支持 128 位 shuffle（SSSE3、LSX、NEON）时才启用，否则全部走逐像素路径。
+ *
+ * RGB565 与原 displayMatOnIPS200 相同：R 取高 5 位、G 取高 6 位、B 取高 5 位。
+ */
+class Rgb565Scaler {
+public:
+    /**
+     * @brief 设置尺寸与格式
+     * @return 尺寸无效时返回 false
+     */
+    bool configure(int src_width, int src_height, int dst_width, int dst_height, PixelFormat format);
+
+    /**
+     * @brief 缩放并转换一帧
+     * @param src           源图像首行
+     * @param src_stride    源图像每行字节数
+     * @param dst           目标首行（可以直接是显示缓冲区）
+     * @param dst_stride    目标每行像素数
+     */
+    void convert(const uint8_t* src, int src_stride, uint16_t* dst, int dst_stride) const;
+
+    /**
+     * @brief 是否使用向量路径（编译目标支持、缩放比例在一行内周期重复且图像宽度够一组）
+     */
+    bool vectorized() const { return vector_columns_ > 0; }
+
+    bool matches(int src_width, int src_height, int dst_width, int dst_height, PixelFormat format) const {
+        return src_width == src_width_ && src_height == src_height_ && dst_width == dst_width_ &&
+               dst_height == dst_height_ && format == format_;
+    }
+
+private:
+    void convertRow(const uint8_t* src, uint16_t* dst) const;
+
+    int src_width_ = 0;
+    int src_height_ = 0;
+    int dst_width_ = 0;
+    int dst_height_ = 0;
+    PixelFormat format_ = PixelFormat::Bgr;
+    std::vector<int> x_index_;          ///< 目标列对应的源列
+    std::vector<int> y_index_;          ///< 目标行对应的源行
+
+    // 向量路径：每组 group_ 个目标像素来自从组首源列开始的 16 像素窗口
+    int group_ = 0;                     ///< 每组目标像素数，0 表示不使用向量路径
+    int group_span_ = 0;                ///< 每组前进的源像素数
+    int vector_columns_ = 0;            ///< 向量路径处理的目标列数，其余逐像素处理
+    uint8_t shuffle_[3][3][16];         ///< [分量][窗口中的第几个 16 字节][目标像素]：在该 16 字节中的位置
+    uint8_t select_[3][3][16];          ///< 0xFF 表示该目标像素的分量来自这 16 字节（BGR 窗口为 48 字节）
+};
+
+} // namespace robot
+
+#endif // ROBOT_RGB565_SCALER_HPP
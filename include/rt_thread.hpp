@@ -0,0 +1,41 @@
+#ifndef ROBOT_RT_THREAD_HPP
+#define ROBOT_RT_THREAD_HPP
+
+#include <pthread.h>
+
+namespace robot {
+
+/**
+ * @brief 将线程切换到 SCHED_FIFO 实时调度
+ * @param thread 目标线程（默认当前线程）
+ * @param rt_priority 实时优先级 1-99
+ * @return 成功返回true；失败时打印原因（通常是缺少 root / CAP_SYS_NICE）
+ */
+bool setThreadRealtimePriority(int rt_priority, pthread_t thread = pthread_self());
+
+/**
+ * @brief 将线程绑定到指定CPU
+ * @param cpu CPU编号（从0开始）
+ * @param thread 目标线程（默认当前线程）
+ * @return 成功返回true
+ */
+bool setThreadAffinity(int cpu, pthread_t thread = pthread_self());
+
+/**
+ * @brief 设置线程名（显示在 top -H、gdb 与追踪文件中），超过15个字符的部分被截断
+ * @param name 线程名
+ * @param thread 目标线程（默认当前线程）
+ * @return 成功返回true
+ */
+bool setThreadName(const char* name, pthread_t thread = pthread_self());
+
+/**
+ * @brief 设置当前线程的 nice 值（普通调度下的优先级，越大越低）
+ * @param nice -20 到 19；降低优先级不需要权限
+ * @return 成功返回true
+ */
+bool setCurrentThreadNice(int nice);
+
+} // namespace robot
+
+#endif // ROBOT_RT_THREAD_HPP
@@ -0,0 +1,66 @@
+#ifndef ROBOT_SENSOR_SAMPLER_HPP
+#define ROBOT_SENSOR_SAMPLER_HPP
+
+#include <cstdint>
+
+#include "zf_device_imu_core.h"
+
+namespace robot {
+
+class ImuStream;
+
+/**
+ * @brief 一次批量采样的结果，所有数据在同一次调用中读取
+ */
+struct SensorSample {
+    int16_t encoder_left = 0;
+    int16_t encoder_right = 0;
+    imu_raw_data_t imu{};
+    bool imu_valid = false;         ///< IMU 未初始化或读取失败时为false
+    int64_t timestamp_ns = 0;       ///< 采样开始时间（steady_clock 纳秒）
+};
+
+/**
+ * @brief 编码器与IMU的批量采样
+ *
+ * open() 时一次性取得所有设备文件句柄，之后每次 sample() 只有每个通道一次 pread，
+ * 不再按路径 open/lseek/close（原来每个编码器3次系统调用，IMU每轴2次）。
+ */
+class SensorSampler {
+public:
+    /**
+     * @param encoder_left_path  左编码器设备文件
+     * @param encoder_right_path 右编码器设备文件
+     * @param imu IMU设备（可为空，需已初始化）
+     */
+    SensorSampler(const char* encoder_left_path, const char* encoder_right_path, IMUDevice* imu = nullptr);
+
+    /**
+     * @brief 取得编码器设备句柄
+     * @return 任一编码器无法打开时返回false
+     */
+    bool open();
+
+    /**
+     * @brief IMU 由 ImuStream 的采集线程读取时，改为从流中取最新样本（不再直接读设备）
+     */
+    void setImuStream(const ImuStream* stream) { imu_stream_ = stream; }
+
+    /**
+     * @brief 读取所有编码器和IMU
+     * @return 编码器读取失败时返回false（IMU失败只清除 imu_valid）
+     */
+    bool sample(SensorSample& out);
+
+private:
+    const char* encoder_left_path_;
+    const char* encoder_right_path_;
+    IMUDevice* imu_;
+    const ImuStream* imu_stream_ = nullptr;
+    int encoder_left_fd_ = -1;
+    int encoder_right_fd_ = -1;
+};
+
+} // namespace robot
+
+#endif // ROBOT_SENSOR_SAMPLER_HPP
@@ -0,0 +1,85 @@
+#ifndef ROBOT_SPEED_PLANNER_HPP
+#define ROBOT_SPEED_PLANNER_HPP
+
+#include "lookahead.hpp"
+
+namespace robot {
+
+/**
+ * @brief 速度规划选项（单位均为米、秒）
+ */
+struct SpeedPlannerOptions {
+    float max_lateral_accel = 3.0f;     ///< 允许的最大侧向加速度（m/s²），决定弯道限速 v = sqrt(a / |κ|)
+    float max_accel = 2.0f;             ///< 加速斜率限制（m/s²）
+    float max_decel = 4.0f;             ///< 减速斜率限制（m/s²），也用于提前为前方弯道减速
+    float min_speed = 0.5f;             ///< 弯道限速下限（m/s），预设上限更低时以预设为准
+    float horizon_speed = 1.2f;         ///< 视野之外按最急的弯考虑：视野末端须能减速到该速度（m/s），0 关闭
+};
+
+/**
+ * @brief 前方弯道估计：有效行由近到远分段，每段一个曲率
+ */
+struct CurvatureEstimate {
+    static const int MAX_SEGMENTS = 4;
+    int count = 0;                          ///< 有效分段数，0 表示没有可用的估计
+    float curvature[MAX_SEGMENTS] = {0};    ///< 各段曲率（1/m，符号同像素拟合的二次项）
+    float distance[MAX_SEGMENTS] = {0};     ///< 各段近端距车辆的距离（米），最近一段视为车辆已在段内，为0
+    float visible = -1;                     ///< 中线可见的最远距离（米），<0 表示未知
+};
+
+/**
+ * @brief 按俯视图中线估计前方曲率
+ *
+ * 把中线有效行由近到远等分为 segments 段，每段做二次拟合（computeLookahead，窗口覆盖整段），
+ * 在段中心按 κ = 2c / (1 + b²)^(3/2) 计算曲率并换算为 1/m；近处盲区按与最近一段相同的曲率考虑。分段是为了在直道末端
+ * 及早看到远处的弯道：整体拟合会被近处的直线部分平均掉。
+ */
+CurvatureEstimate estimateCurvature(const uint16_t* center_line, int image_height, int image_width,
+                                    int valid_top, int valid_bottom, float meters_per_pixel, int segments = 2);
+
+/**
+ * @brief 曲率限速与加减速斜率限制
+ *
+ * limit()：每帧调用，按前方曲率计算允许车速。弯道处限速 v_c = sqrt(a_lat / |κ|)，
+ * 弯道在前方 d 米处时，按最大减速度提前减速所允许的当前车速为 sqrt(v_c² + 2·a_dec·d)，
+ * 取各分段中最小者。视野之外的赛道未知，按视野末端须能减速到 horizon_speed 再限一次速：
+ * 中线在弯道中很快离开视野，此时可用的分段很少，由可见距离保证不会加速。
+ * 结果不超过预设速度（原 MotorSpeed_Judge 的速度作为上限）。
+ *
+ * step()：在控制任务中按固定周期调用，目标车速向 limit 以加减速斜率逼近，输出连续的速度目标。
+ * limit() 不修改状态可在任意线程调用；step()/reset() 只能由一个线程调用。
+ */
+class SpeedPlanner {
+public:
+    explicit SpeedPlanner(const SpeedPlannerOptions& options = SpeedPlannerOptions());
+
+    void configure(const SpeedPlannerOptions& options);
+
+    /**
+     * @brief 允许车速（m/s）
+     * @param cap       预设速度上限（m/s）
+     * @param estimate  前方曲率，没有分段时只受预设上限约束
+     */
+    float limit(float cap, const CurvatureEstimate& estimate) const;
+
+    /**
+     * @brief 推进一个周期，返回斜率限制后的目标车速（m/s）
+     */
+    float step(float limit, float dt);
+
+    /**
+     * @brief 目标车速复位为 speed（停车或重新发车时调用）
+     */
+    void reset(float speed = 0);
+
+    float speed() const { return speed_; }
+    const SpeedPlannerOptions& options() const { return options_; }
+
+private:
+    SpeedPlannerOptions options_;
+    float speed_ = 0;
+};
+
+} // namespace robot
+
+#endif // ROBOT_SPEED_PLANNER_HPP
@@ -0,0 +1,67 @@
+#ifndef ROBOT_SPSC_RING_HPP
+#define ROBOT_SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+
+namespace robot {
+
+/**
+ * @brief 有界单生产者单消费者无锁环形队列
+ *
+ * 只能有一个线程 push、一个线程 pop。head/tail 单调递增，按 Capacity 取模，
+ * 分别放在独立的缓存行上避免伪共享。push 满时与 pop 空时立即返回 false，不阻塞。
+ * @tparam T 元素类型（建议为帧槽编号等小型可拷贝类型）
+ * @tparam Capacity 容量，必须是 2 的幂
+ */
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity 必须是 2 的幂");
+
+public:
+    /**
+     * @brief 生产者入队
+     * @return 队列已满返回false
+     */
+    bool push(const T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        buffer_[head & (Capacity - 1)] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 消费者出队
+     * @return 队列为空返回false
+     */
+    bool pop(T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = buffer_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 当前元素数量（仅供统计，并发下是近似值）
+     */
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    alignas(64) std::atomic<size_t> head_{0};   // 生产者写
+    alignas(64) std::atomic<size_t> tail_{0};   // 消费者写
+    alignas(64) T buffer_[Capacity];
+};
+
+} // namespace robot
+
+#endif // ROBOT_SPSC_RING_HPP
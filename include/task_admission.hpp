@@ -0,0 +1,68 @@
+#ifndef ROBOT_TASK_ADMISSION_HPP
+#define ROBOT_TASK_ADMISSION_HPP
+
+#include <string>
+#include <vector>
+
+namespace robot {
+
+/**
+ * @brief 任务准入策略
+ */
+enum class AdmissionPolicy {
+    None,     ///< 不做准入检查（旧行为）
+    Reject,   ///< 不可调度时拒绝新任务
+    Degrade   ///< 不可调度时依次降低低优先级任务的频率，仍不可调度则拒绝
+};
+
+/**
+ * @brief 参与可调度性分析的任务描述
+ */
+struct AdmissionTask {
+    std::string name;
+    double period_us = 0.0;     ///< 周期（μs），0 表示单次任务，不参与分析
+    double wcet_us = 0.0;       ///< 最坏执行时间估计（μs），取声明预算与实测 p99 的较大值
+    int priority = 0;           ///< 优先级，数值越小越优先（与 robot::Priority 一致）
+    bool degradable = false;    ///< 是否允许在 Degrade 策略下被降频
+    bool critical = false;      ///< 关键任务：运行时其他可让路任务不会长时间阻塞它
+    bool sheddable = false;     ///< 可让路任务：会阻塞关键任务时运行时跳过本周期
+};
+
+/**
+ * @brief 可调度性分析结果
+ */
+struct AdmissionResult {
+    bool schedulable = true;
+    double utilization = 0.0;            ///< 总利用率 ΣC/T
+    double bound = 0.0;                  ///< 所用判据的利用率上界（单核 RTA 时为 1.0）
+    std::string reason;                  ///< 不可调度时的原因说明
+    std::vector<double> response_us;     ///< 单核时各任务的最坏响应时间（与输入顺序一致，多核时为空）
+};
+
+/**
+ * @brief 固定优先级（速率单调）可调度性分析
+ *
+ * - 单核：非抢占式响应时间分析（RTA），阻塞项取低优先级任务的最大执行时间，
+ *   截止期等于周期。关键任务受运行时让路保护，可让路任务对它的阻塞
+ *   以让路阈值（松弛量的一半）计。
+ * - 多核：全局固定优先级利用率上界 U ≤ m/2·(1−u_max) + u_max，偏保守。
+ *
+ * @param tasks 任务集合
+ * @param cores 工作线程数量
+ */
+AdmissionResult analyzeSchedulability(const std::vector<AdmissionTask>& tasks, int cores);
+
+/**
+ * @brief 按 Degrade 策略降频直到可调度
+ *
+ * 每轮把优先级最低且仍可降频的任务周期加倍（频率减半），频率最低降到 min_hz。
+ * @param tasks 任务集合（会被就地修改 period_us）
+ * @param cores 工作线程数量
+ * @param min_hz 允许的最低频率
+ * @return 最终分析结果，仍不可调度时 schedulable 为 false
+ */
+AdmissionResult degradeUntilSchedulable(std::vector<AdmissionTask>& tasks, int cores, double min_hz = 1.0);
+
+} // namespace robot
+
+#endif // ROBOT_TASK_ADMISSION_HPP
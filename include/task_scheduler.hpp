@@ -12,6 +12,9 @@
 #include <thread>
 #include <vector>
 
+#include "latency_histogram.hpp"
+#include "task_admission.hpp"
+
 namespace robot {
 
 /**
@@ -25,78 +28,221 @@ enum class Priority {
     BACKGROUND = 4  ///< 后台任务（统计更新、UI）
 };
 
+/**
+ * @brief 错过周期时的处理策略
+ */
+enum class MissPolicy {
+    CatchUp,  ///< 保持相位：next += period，丢弃已经错过的周期（计入 missed_deadlines）
+    Skip      ///< 重新对齐：next = now + period，避免补执行造成的堆积和抖动
+};
+
+/**
+ * @brief 任务可选参数
+ */
+struct TaskOptions {
+    MissPolicy miss_policy = MissPolicy::CatchUp;
+    std::chrono::microseconds period{0};  ///< 非0时覆盖 frequency_hz，用于非整数频率（如 0.5Hz）
+    int time_budget_us = 0;               ///< 非0时覆盖 time_budget_ms，用于亚毫秒级预算
+    int rank = 0;                         ///< 同优先级内的细分，数值越大越先执行
+
+    bool dedicated_thread = false;        ///< 独占线程：阻塞型任务（相机采集、Web服务）不占用工作线程
+    int cpu = -1;                         ///< 独占线程绑定的CPU，-1 不绑定
+    int rt_priority = 0;                  ///< 独占线程的 SCHED_FIFO 优先级，0 保持普通调度
+    std::function<void()> on_stop;        ///< stop() 时调用，用于唤醒阻塞在独占线程中的任务
+
+    bool skip_after_overrun = false;      ///< 超出预算后跳过下一周期
+    /// 超出预算回调（参数为超出量），返回 true 时同样跳过下一周期
+    std::function<bool(const std::string&, std::chrono::microseconds)> on_overrun;
+};
+
+/**
+ * @brief 单个任务的统计快照
+ *
+ * 由 getTaskSnapshots() 返回，直方图单位均为微秒：
+ * - exec_us: 任务函数执行耗时
+ * - latency_us: 实际开始执行时间相对计划释放时间的延迟
+ */
+struct TaskStatsSnapshot {
+    std::string name;
+    int frequency_hz = 0;
+    Priority priority = Priority::MEDIUM;
+    int time_budget_ms = 0;
+    int actual_frequency_hz = 0;
+    int missed_deadlines = 0;
+    int shed_count = 0;
+    int budget_overruns = 0;
+    int64_t period_us = 0;       ///< 当前周期（Degrade 降频后会变长），0 表示单次任务
+    uint64_t total_executions = 0;
+    LatencyHistogram::Snapshot exec_us;
+    LatencyHistogram::Snapshot latency_us;
+};
+
 /**
  * @brief 任务调度器类
- * 
+ *
  * 提供实时、可靠的周期性任务调度功能，支持多优先级、时间预算监控和运行时统计。
+ * 两种运行方式：
+ * - 多线程：worker_threads > 0，start() 启动工作线程，stop() 停止
+ * - 单核协作式：worker_threads == 0，在调用线程中 run(stop_flag) 逐个执行任务
+ * 独占线程任务（TaskOptions::dedicated_thread）在两种方式下都各自运行在自己的线程中。
  */
 class TaskScheduler {
 public:
     /**
      * @brief 构造函数
-     * @param worker_threads 工作线程数量（建议设置为CPU核心数-1）
+     * @param worker_threads 工作线程数量（建议设置为CPU核心数-1），0 表示单核协作式
      */
     explicit TaskScheduler(int worker_threads = 4);
-    
+
     /**
      * @brief 析构函数
      */
     ~TaskScheduler();
-    
+
     // 禁止拷贝和移动
     TaskScheduler(const TaskScheduler&) = delete;
     TaskScheduler& operator=(const TaskScheduler&) = delete;
     TaskScheduler(TaskScheduler&&) = delete;
     TaskScheduler& operator=(TaskScheduler&&) = delete;
-    
+
     /**
      * @brief 添加周期性任务
      * @param name 任务唯一标识符
      * @param task_function 要执行的任务函数（无参数、无返回值）
      * @param frequency_hz 目标频率（Hz），0表示单次任务
      * @param priority 任务优先级（默认MEDIUM）
-     * @param time_budget_ms 时间预算（ms），超时会被记录（默认0-不限制）
-     * @return 添加成功返回true，失败返回false
+     * @param time_budget_ms 时间预算（ms），超时会被记录（默认0-不限制），同时作为准入分析的执行时间估计
+     * @return 添加成功返回true，失败（参数错误或准入检查不通过）返回false
      */
-    bool addTask(const std::string& name, 
+    bool addTask(const std::string& name,
                  std::function<void()> task_function,
-                 int frequency_hz, 
+                 int frequency_hz,
                  Priority priority = Priority::MEDIUM,
                  int time_budget_ms = 0);
-    
+
+    /**
+     * @brief 添加任务（带可选参数）
+     * @param options 错过策略、独占线程、CPU绑定、实时优先级、超时处理等
+     */
+    bool addTask(const std::string& name,
+                 std::function<void()> task_function,
+                 int frequency_hz,
+                 Priority priority,
+                 int time_budget_ms,
+                 const TaskOptions& options);
+
     /**
      * @brief 移除任务
      * @param name 要移除的任务名称
      * @return 成功返回true，任务不存在返回false
      */
     bool removeTask(const std::string& name);
-    
+
+    /**
+     * @brief 修改任务优先级
+     * @return 任务不存在返回false
+     */
+    bool setTaskPriority(const std::string& name, Priority priority);
+
+    /**
+     * @brief 修改任务时间预算（会重新做准入检查）
+     * @param budget 新预算
+     * @return 任务不存在或准入检查不通过返回false
+     */
+    bool setTaskBudget(const std::string& name, std::chrono::microseconds budget);
+
     /**
-     * @brief 启动调度器
+     * @brief 启动调度器（协作式下只启动独占线程任务和统计线程）
      * @return 启动成功返回true，已经运行中返回false
      */
     bool start();
-    
+
+    /**
+     * @brief 在调用线程中运行调度循环（单核协作式，worker_threads == 0）
+     *
+     * 阻塞直到 stop_flag 返回 true 或调用 stop()；统计信息在循环内每秒更新一次。
+     * @param stop_flag 返回 true 时停止
+     * @return 非协作式调度器调用时返回false
+     */
+    bool run(const std::function<bool()>& stop_flag);
+
     /**
      * @brief 停止调度器（阻塞直到所有任务完成）
      */
     void stop();
-    
+
+    /**
+     * @brief 设置工作线程绑定的CPU（start() 前调用），第 i 个工作线程绑定 cpus[i % cpus.size()]
+     */
+    void setWorkerCpus(const std::vector<int>& cpus);
+
+    /**
+     * @brief 设置工作线程的 SCHED_FIFO 优先级（start()/run() 前调用，0 为普通调度）
+     */
+    void setWorkerRealtimePriority(int rt_priority);
+
     /**
      * @brief 获取所有任务统计信息
      * @return 任务名 -> 统计信息 的映射
      */
     std::map<std::string, std::map<std::string, int>> getTasksStats() const;
-    
+
+    /**
+     * @brief 获取所有任务的直方图快照
+     *
+     * 只读取无锁直方图和写时复制的任务列表，不会占用调度用的 tasks_mutex_
+     * @return 按优先级排序的任务快照
+     */
+    std::vector<TaskStatsSnapshot> getTaskSnapshots() const;
+
+    /**
+     * @brief 以JSON字符串形式导出统计信息（供Web面板使用）
+     * @return JSON数组字符串，每个元素对应一个任务
+     */
+    std::string getStatsJson() const;
+
+    /**
+     * @brief 以CSV字符串形式导出统计信息（表头一行，每个任务一行）
+     */
+    std::string getStatsCsv() const;
+
+    /**
+     * @brief 将统计信息导出为CSV文件（内容同 getStatsCsv）
+     * @param path 输出文件路径
+     * @return 写入成功返回true
+     */
+    bool dumpStatsCsv(const std::string& path) const;
+
+    /**
+     * @brief 清空所有任务的直方图与计数
+     */
+    void resetStats();
+
+    /**
+     * @brief 设置准入控制策略（默认 Reject）
+     *
+     * addTask 时以 max(声明预算, 实测执行时间p99) 估计各任务执行时间，
+     * 按当前工作线程数做速率单调可调度性分析；不可调度时按策略拒绝或降频。
+     * 独占线程任务不参与分析。
+     * @param policy 准入策略
+     * @param shed_for_critical 运行时是否为 CRITICAL 任务让路（推迟 MEDIUM 及以下任务，推迟满一个周期则跳过）
+     */
+    void setAdmissionPolicy(AdmissionPolicy policy, bool shed_for_critical = true);
+
+    /**
+     * @brief 按当前任务集合与实测执行时间重新做一次可调度性分析
+     */
+    AdmissionResult checkAdmission() const;
+
     /**
      * @brief 检查调度器是否正在运行
      * @return 正在运行返回true，否则返回false
      */
     bool isRunning() const { return running_; }
-    
+
     /**
      * @brief 获取工作线程数量
-     * @return 工作线程数量
+     * @return 工作线程数量（0 表示协作式）
      */
     int getWorkerThreads() const { return worker_threads_count_; }
 
@@ -107,60 +253,158 @@ private:
     struct TaskInfo {
         std::string name;
         std::function<void()> function;
-        int frequency_hz;
-        Priority priority;
-        int time_budget_ms;
-        std::chrono::microseconds period;
+        std::atomic<int> frequency_hz;   // Degrade 策略下可能被降频
+        Priority priority;                      // 只在 start() 前通过 setTaskPriority 修改
+        std::atomic<int> time_budget_us{0};
+        TaskOptions options;
+        std::atomic<int64_t> period_us{0};      // 周期（μs），0 表示单次任务；Degrade 策略下可能被加长
         std::chrono::steady_clock::time_point next_run_time;
         std::atomic<bool> is_running{false};
+        std::atomic<bool> skip_next{false};     // 超出预算后跳过下一周期
+        std::atomic<bool> removed{false};       // 独占线程任务被移除
         std::atomic<int> actual_frequency{0};
         std::atomic<int> execution_time_us{0};
         std::atomic<int> missed_deadlines{0};
+        std::atomic<int> budget_overruns{0};
         std::atomic<int> execution_count{0};
+        std::atomic<int> shed_count{0};          // 为 CRITICAL 任务让路（推迟执行）的次数
+        std::atomic<int> wcet_estimate_us{0};    // 实测执行时间p99，由统计线程每秒刷新
+        bool deferred = false;                   // 本次释放是否已被推迟（受 tasks_mutex_ 保护）
         std::chrono::steady_clock::time_point last_stat_update;
         std::chrono::steady_clock::time_point last_execution_time;
         std::atomic<int> max_interval_us{0};
         std::atomic<int> min_interval_us{0};
-        std::atomic<int> total_interval_us{0};
-        std::atomic<int> interval_count{0};
-        
-        TaskInfo(const std::string& name, 
+        std::atomic<uint64_t> total_interval_us{0};   // 64位累加，避免约35分钟后溢出
+        std::atomic<uint64_t> interval_count{0};
+        std::atomic<uint64_t> total_executions{0};
+        std::chrono::steady_clock::time_point release_time;  // 本次执行的计划释放时间（调度时写入）
+        LatencyHistogram exec_hist;       // 执行耗时直方图（μs）
+        LatencyHistogram latency_hist;    // 启动延迟直方图（μs）
+
+        TaskInfo(const std::string& name,
                  std::function<void()> func,
                  int freq_hz,
                  Priority prio,
-                 int budget_ms);
+                 int budget_ms,
+                 const TaskOptions& opts);
+
+        std::chrono::microseconds period() const {
+            return std::chrono::microseconds(period_us.load(std::memory_order_relaxed));
+        }
+        bool periodic() const { return period_us.load(std::memory_order_relaxed) > 0; }
     };
-    
+
     /**
      * @brief 工作线程函数
      */
     void workerThread(int thread_id);
-    
+
+    /**
+     * @brief 独占线程任务的运行循环
+     */
+    void dedicatedThread(std::shared_ptr<TaskInfo> task);
+
+    /**
+     * @brief 启动独占线程任务（调用者需持有 tasks_mutex_）
+     */
+    void launchDedicated(const std::shared_ptr<TaskInfo>& task);
+
+    /**
+     * @brief 选出一个就绪任务并执行；没有就绪任务时最多等待到 wait_limit
+     * @return 执行了任务返回true
+     */
+    bool dispatchOnce(std::chrono::steady_clock::time_point wait_limit);
+
+    /**
+     * @brief 按错过策略推进任务的下次执行时间（周期任务），单次任务设为永不执行
+     */
+    static void advanceNextRun(TaskInfo& task, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief 将工作线程配置（CPU绑定、实时优先级）应用到当前线程
+     */
+    void applyWorkerThreadConfig(int thread_id);
+
     /**
      * @brief 执行单个任务
      * @param task 任务信息
      */
     void executeTask(std::shared_ptr<TaskInfo> task);
-    
+
     /**
      * @brief 更新任务统计信息
      */
     void updateTaskStats();
-    
+
+    /**
+     * @brief 重新发布写时复制的任务列表（调用者需持有 tasks_mutex_）
+     */
+    void publishTaskView();
+
+    /**
+     * @brief 无锁获取当前任务列表
+     */
+    std::shared_ptr<const std::vector<std::shared_ptr<TaskInfo>>> taskView() const;
+
+    /**
+     * @brief 按优先级、细分等级排序任务列表（调用者需持有 tasks_mutex_）
+     */
+    void sortTasks();
+
+    /**
+     * @brief 对候选任务集合做准入，通过时把降频结果写回 tasks_（调用者需持有 tasks_mutex_）
+     * @param candidates 与 tasks_ 中参与分析的任务顺序一致，可在末尾追加新任务
+     * @param name 触发检查的任务名（用于日志）
+     */
+    bool admit(std::vector<AdmissionTask>& candidates, const std::string& name);
+
+    /**
+     * @brief 任务执行时间估计（μs）：max(声明预算, 实测p99)
+     */
+    static int estimateWcetUs(const TaskInfo& task);
+
+    /**
+     * @brief 可调度性分析使用的核数（协作式按1核计）
+     */
+    int analysisCores() const { return worker_threads_count_ > 0 ? worker_threads_count_ : 1; }
+
+    /**
+     * @brief 生成准入分析用的任务列表（独占线程任务除外）
+     */
+    std::vector<AdmissionTask> admissionTasks(const std::vector<std::shared_ptr<TaskInfo>>& tasks) const;
+
+    /**
+     * @brief 判断候选任务是否应为即将释放的 CRITICAL 任务让路（调用者需持有 tasks_mutex_）
+     */
+    bool shouldShed(const TaskInfo& candidate, std::chrono::steady_clock::time_point now) const;
+
     // 成员变量
     int worker_threads_count_;
     std::atomic<bool> running_{false};
     std::atomic<bool> stop_requested_{false};
-    
+
     std::vector<std::thread> worker_threads_;
+    std::vector<std::thread> dedicated_threads_;
     std::vector<std::shared_ptr<TaskInfo>> tasks_;
-    
+    // 任务列表的只读副本，统计线程与外部查询通过 std::atomic_load 访问，不与调度线程争锁
+    std::shared_ptr<const std::vector<std::shared_ptr<TaskInfo>>> tasks_view_;
+
     mutable std::mutex tasks_mutex_;
     std::condition_variable condition_;
-    
+
+    // 工作线程配置
+    std::vector<int> worker_cpus_;
+    int worker_rt_priority_ = 0;
+
+    // 准入控制（受 tasks_mutex_ 保护）
+    AdmissionPolicy admission_policy_ = AdmissionPolicy::Reject;
+    std::atomic<bool> shed_for_critical_{true};
+    std::atomic<int> busy_workers_{0};          // 正在执行任务的工作线程数
+    std::atomic<bool> schedulable_{true};       // 最近一次运行时分析结果
+
     std::thread stats_thread_;
     std::atomic<bool> stats_running_{false};
-    
+
     // 统计信息
     mutable std::mutex stats_mutex_;
     std::map<std::string, std::map<std::string, int>> tasks_stats_;
@@ -168,4 +412,4 @@ private:
 
 } // namespace robot
 
-#endif // ROBOT_TASK_SCHEDULER_HPP
\ No newline at end of file
+#endif // ROBOT_TASK_SCHEDULER_HPP
@@ -0,0 +1,169 @@
+#ifndef ROBOT_TELEMETRY_BUS_HPP
+#define ROBOT_TELEMETRY_BUS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace robot {
+
+/**
+ * @brief 遥测记录类型
+ */
+enum class TelemetryType : uint16_t {
+    Imu = 1,        ///< TelemetryImu
+    Encoder = 2,    ///< TelemetryEncoder
+    Control = 3,    ///< TelemetryControl
+    Track = 4,      ///< TelemetryTrack
+    Stage = 5,      ///< TelemetryStage
+};
+
+/*
+ * 各类型的负载布局。所有字段按自然对齐排列、没有隐式填充，记录按小端原样发送，
+ * 浏览器端按相同偏移解码（web/index.html 中的 decodeTelemetry），修改布局时两边同步修改。
+ */
+
+/// IMU 原始值与姿态解算结果（IMU 采集线程，每样本一条）
+struct TelemetryImu {
+    int16_t acc[3];
+    int16_t gyro[3];
+    float yaw_rate;         ///< 去零偏后的 z 轴角速度（度/秒）
+    float heading;          ///< 展开后的航向角（度）
+};
+
+/// 编码器与里程计（控制任务，每周期一条）
+struct TelemetryEncoder {
+    int32_t left;           ///< 本周期左轮脉冲
+    int32_t right;          ///< 本周期右轮脉冲
+    float left_cps;         ///< 左轮滤波速度（脉冲/秒）
+    float right_cps;
+    float speed;            ///< 车速（米/秒）
+    float distance;         ///< 累计距离（米）
+};
+
+/// 控制器输入输出（控制任务，每周期一条）
+struct TelemetryControl {
+    float pixel_error;
+    float yaw_rate;         ///< 度/秒
+    float speed_target;     ///< 每控制周期脉冲数
+    float speed_present;
+    float servo;            ///< 舵机角度（度，相对中位）
+    float motor;            ///< 电机输出
+    uint16_t servo_duty;
+    uint16_t motor_duty;
+    uint8_t dir;
+    uint8_t saturated;      ///< 位0：舵机饱和，位1：电机饱和
+    uint16_t reserved;
+};
+
+/// 寻线与决策结果（寻线阶段，每帧一条）
+struct TelemetryTrack {
+    uint64_t frame_id;
+    int16_t track_kind;
+    int16_t circle_step;
+    int16_t servo_dir;
+    int16_t servo_angle;
+    int32_t motor_speed;
+    float speed_limit;      ///< 速度规划的允许车速（m/s），未启用时为0
+    uint32_t age_us;        ///< 采集到寻线结束的时间
+    uint32_t reserved;
+};
+
+/// 处理阶段耗时（来自 FrameTracer 的每个区间），记录时间为区间开始时间
+struct TelemetryStage {
+    uint64_t frame_id;
+    uint32_t duration_us;
+    char name[20];          ///< 以 0 结尾，超长截断
+};
+
+/**
+ * @brief 一条遥测记录，固定 64 字节
+ */
+struct TelemetryRecord {
+    uint16_t type = 0;              ///< TelemetryType
+    uint16_t size = 0;              ///< 负载字节数
+    uint32_t sequence = 0;          ///< 记录序号的低 32 位，客户端据此发现丢失
+    int64_t timestamp_ns = 0;       ///< steady_clock 纳秒
+    uint8_t payload[48] = {0};
+
+    template <typename T>
+    bool get(T& out) const {
+        if (size != sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&out, payload, sizeof(T));
+        return true;
+    }
+};
+
+static_assert(sizeof(TelemetryRecord) == 64, "TelemetryRecord 必须是 64 字节");
+static_assert(sizeof(TelemetryImu) == 20 && sizeof(TelemetryEncoder) == 24 && sizeof(TelemetryControl) == 32 &&
+              sizeof(TelemetryTrack) == 32 && sizeof(TelemetryStage) == 32, "遥测负载布局与网页解码不一致");
+
+/**
+ * @brief 遥测总线：多生产者、任意多读者的无锁广播环形缓冲区
+ *
+ * 生产者 push() 用一次 fetch_add 占一个位置，写入 64 字节记录，用位置序号标记完成（2n+1 写入中，
+ * 2n+2 完成，与 FrameTracer 相同），不加锁、不分配内存、不等待读者，1kHz 写入的开销在百纳秒以内。
+ * 缓冲区写满后覆盖最旧的记录。
+ *
+ * 每个读者（例如一个 HTTP 连接）持有自己的游标，read() 从游标处复制到当前位置为止的记录并前移游标；
+ * 读得慢被覆盖时跳到最旧的有效记录并计入丢失数，不影响生产者和其他读者。
+ */
+class TelemetryBus {
+public:
+    static constexpr size_t PAYLOAD_SIZE = sizeof(TelemetryRecord::payload);
+
+    /**
+     * @param capacity 记录条数，向上取整为 2 的幂
+     */
+    explicit TelemetryBus(size_t capacity = 8192);
+
+    TelemetryBus(const TelemetryBus&) = delete;
+    TelemetryBus& operator=(const TelemetryBus&) = delete;
+
+    /**
+     * @brief 写入一条记录（任意线程）
+     */
+    template <typename T>
+    void push(TelemetryType type, const T& payload, int64_t timestamp_ns) {
+        static_assert(std::is_trivially_copyable<T>::value && sizeof(T) <= PAYLOAD_SIZE, "负载必须可平凡拷贝且不超过 48 字节");
+        pushRaw(type, &payload, sizeof(T), timestamp_ns);
+    }
+
+    void pushRaw(TelemetryType type, const void* payload, size_t size, int64_t timestamp_ns);
+
+    /**
+     * @brief 下一条记录的序号，新读者从这里开始读
+     */
+    uint64_t head() const { return head_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 从游标处读取记录
+     * @param cursor    读者游标，读取后前移
+     * @param out       输出
+     * @param max       最多读取条数
+     * @param lost      累加被覆盖而跳过的记录数（可为空）
+     * @return 读取的条数；正在写入的记录留到下次读取
+     */
+    size_t read(uint64_t* cursor, TelemetryRecord* out, size_t max, uint64_t* lost = nullptr) const;
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        TelemetryRecord record;
+    };
+
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
+
+} // namespace robot
+
+#endif // ROBOT_TELEMETRY_BUS_HPP
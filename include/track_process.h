@@ -0,0 +1,21 @@
+#include "common_system.h"
+#include "libdata_store.h"
+
+#ifndef _TRACK_PROCESS_H_
+#define _TRACK_PROCESS_H_
+
+/*
+    单帧寻线与决策
+    八邻域寻线 → 赛道类型决策与补线（圆环、十字补线后重新寻线）→ 舵机方向角度与电机速度决策，
+    结果写入 Data_Path_p（ServoDir、ServoAngle、MotorSpeed、Track_Kind 等）。
+    车上的寻线阶段与离线回放工具共用，保证两边处理完全一致；赛道状态机的状态保存在 Data_Path
+    和 TrackKind_Judge 的静态变量中并跨帧延续，因此必须按帧顺序、在同一线程调用
+    @参数说明
+    Img_Store_p 图像存储指针（Img_OTSU 为预处理后的二值图，补线直接画在上面）
+    Data_Path_p 路径数据指针
+    Function_EN_p 函数使能指针
+    frame_id 帧号，用于 FrameTracer 的阶段耗时
+*/
+void TrackProcess(Img_Store *Img_Store_p,Data_Path *Data_Path_p,Function_EN *Function_EN_p,uint64_t frame_id);
+
+#endif
@@ -0,0 +1,278 @@
+#ifndef ROBOT_TRACK_SIM_HPP
+#define ROBOT_TRACK_SIM_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace robot {
+
+/**
+ * 闭环赛道仿真的被控对象部分（不依赖 OpenCV）：
+ * 俯视赛道地图、由透视矩阵反推的摄像头成像、自行车模型车辆与圈速统计。
+ * 感知与控制使用车上的代码，见 test/track_sim.cpp。
+ * 坐标：世界坐标系 x 向右、y 向上，航向逆时针为正（左转为正，与控制器约定相同），单位米、弧度。
+ */
+
+/**
+ * @brief 赛道元素，按描述文件中的顺序首尾相接
+ */
+struct TrackElement {
+    enum Kind {
+        Straight,       ///< 直道：length
+        Left,           ///< 左弯：radius、angle（度）
+        Right,          ///< 右弯：radius、angle（度）
+        CircleLeft,     ///< 左圆环：与直道在当前位置相切、位于左侧的整圆，行驶路线绕环一周后回到直道
+        CircleRight,    ///< 右圆环
+        Cross,          ///< 十字：长 length 的直道，中点处有垂直穿过的道路
+    };
+    Kind kind = Straight;
+    float length = 0;
+    float radius = 0;
+    float angle = 0;
+};
+
+/**
+ * @brief 中线上的一个采样点
+ */
+struct TrackPoint {
+    float x = 0;
+    float y = 0;
+    float heading = 0;
+};
+
+/**
+ * @brief 俯视赛道地图：中线采样与路面栅格
+ *
+ * 描述文件每行一个元素（# 开头为注释）：
+ *   width 0.45            赛道宽度（米，须在第一个元素之前）
+ *   straight 2.0          直道长度
+ *   left 1.0 90           左弯半径、角度（度）
+ *   right 0.6 45          右弯
+ *   circle_left 0.5       左圆环半径（中线）
+ *   circle_right 0.5      右圆环
+ *   cross 1.0             十字（长度，可省略，默认 1.0）
+ * 路线从原点沿 x 轴正方向出发。终点回到起点（误差小于 5cm）时为闭合赛道，可以连续跑多圈。
+ */
+class TrackMap {
+public:
+    static const char* const DEFAULT_TRACK;     ///< 默认赛道：直道、十字、S 弯、左右圆环与两个 180° 弯，约 25 米
+
+    /**
+     * @brief 解析描述文本并生成地图
+     * @param cell_m 栅格边长（米）
+     * @return 描述有误时返回 false 并写入 error
+     */
+    bool build(const std::string& text, float cell_m, std::string* error);
+
+    /// 读取描述文件并生成地图
+    bool load(const std::string& path, float cell_m, std::string* error);
+
+    float width() const { return width_; }
+    float length() const { return (float)points_.size() * step_; }
+    float step() const { return step_; }
+    bool closed() const { return closed_; }
+    const std::vector<TrackPoint>& points() const { return points_; }
+    const std::vector<TrackElement>& elements() const { return elements_; }
+
+    /// 终点与起点的位置误差（米），首尾相接的赛道接近 0
+    float closureError() const { return closure_; }
+
+    /// 世界坐标处是否为路面（地图范围之外为否）
+    bool road(float x, float y) const {
+        int col = (int)((x - origin_x_) * inv_cell_);
+        int row = (int)((y - origin_y_) * inv_cell_);
+        if ((unsigned)col >= (unsigned)cols_ || (unsigned)row >= (unsigned)rows_) {
+            return false;
+        }
+        return cells_[(size_t)row * cols_ + col] != 0;
+    }
+
+    /**
+     * @brief 在中线采样点 hint 前后 window 个点内找最近点（闭合赛道按环形索引）
+     * @param lateral 相对中线的横向偏差（米，左侧为正）
+     * @return 最近点的索引
+     */
+    int project(float x, float y, int hint, int window, float* lateral) const;
+
+private:
+    void addArc(float radius, float angle, std::vector<TrackPoint>* path);
+    void addStraight(float length, std::vector<TrackPoint>* path);
+    void rasterize(const std::vector<std::vector<TrackPoint>>& roads, float cell_m);
+
+    float width_ = 0.45f;
+    float step_ = 0.01f;
+    std::vector<TrackElement> elements_;
+    std::vector<TrackPoint> points_;
+    TrackPoint cursor_;
+    float closure_ = 0;
+    bool closed_ = false;
+
+    float origin_x_ = 0;
+    float origin_y_ = 0;
+    float inv_cell_ = 1;
+    int cols_ = 0;
+    int rows_ = 0;
+    std::vector<uint8_t> cells_;
+};
+
+/**
+ * @brief 车辆位姿（后轴中心）
+ */
+struct VehiclePose {
+    float x = 0;
+    float y = 0;
+    float yaw = 0;
+};
+
+/**
+ * @brief 摄像头模型
+ *
+ * 透视矩阵与 ImagePerspective_Init 的参数相同：俯视图坐标（列 i、行 j）→ 原图坐标。
+ * 俯视图每像素 meters_per_pixel 米，最下一行距后轴 near_m 米，中间一列为车辆中轴线。
+ * 成像时对原图每个像素用逆矩阵求出俯视图坐标，再换算为车辆坐标系中的地面点（预先计算），
+ * 地平线以上或超出 max_range_m 的像素为背景。
+ */
+struct CameraModelOptions {
+    double homography[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    int image_width = 320;              ///< 原图尺寸（CAMERA_W × CAMERA_H）
+    int image_height = 240;
+    int result_cols = 320;              ///< 俯视图尺寸（RESULT_COL × RESULT_ROW）
+    int result_rows = 180;
+    float meters_per_pixel = 0.005f;    ///< 与 Birdeye_Meters_Per_Pixel 相同
+    float near_m = 0.20f;
+    float max_range_m = 3.0f;
+};
+
+class TrackCamera {
+public:
+    /**
+     * @brief 按四组对应点求透视矩阵（src → dst），与 cv::getPerspectiveTransform 相同
+     * @return 点共线等退化情况返回 false
+     */
+    static bool perspectiveFromPoints(const float src[4][2], const float dst[4][2], double out[3][3]);
+
+    /**
+     * @brief 默认矩阵：俯视图四角对应原图中的梯形（车上标定前的近似值，与 bench 相同）
+     */
+    static void defaultHomography(int image_width, int image_height, int result_cols, int result_rows,
+                                  double out[3][3]);
+
+    /**
+     * @return 矩阵不可逆时返回 false
+     */
+    bool configure(const CameraModelOptions& options);
+
+    /**
+     * @brief 按车辆位姿成像为灰度图（路面 road、背景 background），noise > 0 时叠加 ±noise 的均匀噪声
+     */
+    void render(const TrackMap& map, const VehiclePose& pose, uint8_t road, uint8_t background, int noise,
+                uint8_t* out, int stride);
+
+    const CameraModelOptions& options() const { return options_; }
+
+private:
+    CameraModelOptions options_;
+    std::vector<float> forward_;        ///< 各像素对应地面点的前向距离（米），<0 为背景
+    std::vector<float> left_;           ///< 左向距离（米）
+    uint32_t noise_state_ = 2463534242u;
+};
+
+/**
+ * @brief 车辆参数（需按车模标定，默认值为 C 车模的量级）
+ */
+struct VehicleParams {
+    float wheelbase = 0.20f;            ///< 轴距（米）
+    float track_width = 0.155f;         ///< 轮距（米），用于左右轮速
+    float steer_ratio = 0.5f;           ///< 前轮转角 / 舵机角度
+    float max_steer_deg = 30;           ///< 前轮最大转角（度）
+    float servo_tau = 0.04f;            ///< 舵机一阶滞后时间常数（秒）
+    float max_speed = 4.0f;             ///< 占空比 100% 时的稳态车速（米/秒）
+    float motor_tau = 0.15f;            ///< 电机一阶时间常数（秒）
+    float max_lateral_accel = 6.0f;     ///< 轮胎可提供的侧向加速度（m/s²），超过后按该值转向（推头）
+};
+
+/**
+ * @brief 运动学自行车模型
+ */
+class VehicleModel {
+public:
+    explicit VehicleModel(const VehicleParams& params = VehicleParams()) : params_(params) {}
+
+    void reset(const VehiclePose& pose);
+
+    /**
+     * @param servo_deg     舵机角度（度，相对中位，左转为正）
+     * @param motor_percent 电机占空比（-1 ~ 1）
+     */
+    void step(float servo_deg, float motor_percent, float dt);
+
+    const VehiclePose& pose() const { return pose_; }
+    float speed() const { return speed_; }              ///< 米/秒
+    float yawRate() const { return yaw_rate_; }         ///< rad/s，左转为正
+    float steer() const { return steer_; }              ///< 前轮转角（rad）
+    /// 左右轮速（米/秒）
+    float leftSpeed() const { return speed_ - yaw_rate_ * params_.track_width / 2; }
+    float rightSpeed() const { return speed_ + yaw_rate_ * params_.track_width / 2; }
+
+private:
+    VehicleParams params_;
+    VehiclePose pose_;
+    float speed_ = 0;
+    float yaw_rate_ = 0;
+    float steer_ = 0;
+};
+
+/**
+ * @brief 单圈结果
+ */
+struct LapResult {
+    int lap = 0;
+    double time_s = 0;
+    double mean_speed = 0;          ///< 米/秒
+    float max_lateral = 0;          ///< 最大横向偏差（米）
+    double rms_lateral = 0;
+    bool completed = false;         ///< false：冲出赛道或超时
+};
+
+/**
+ * @brief 沿中线的行驶进度与圈速
+ *
+ * 每个控制周期用车辆位置更新，中线投影只在上一次位置附近查找（圆环与直道在切点重合，靠连续性区分）。
+ * 后轴中心偏离中线超过半个赛道宽度视为冲出赛道。
+ */
+class LapTracker {
+public:
+    explicit LapTracker(const TrackMap* map) : map_(map) {}
+
+    void reset(double time_s);
+
+    /**
+     * @return 本次更新完成一圈或冲出赛道时返回 true，结果写入 result
+     */
+    bool update(const VehiclePose& pose, double time_s, LapResult* result);
+
+    bool offTrack() const { return off_track_; }
+    float lateral() const { return lateral_; }
+    int lap() const { return lap_; }
+    /// 当前圈已行驶的中线长度（米）
+    float progress() const { return (float)progress_ * map_->step(); }
+
+private:
+    LapResult finish(double time_s, bool completed);
+
+    const TrackMap* map_;
+    int index_ = 0;
+    long progress_ = 0;
+    int lap_ = 0;
+    double lap_start_s_ = 0;
+    float lateral_ = 0;
+    float max_lateral_ = 0;
+    double sum_lateral2_ = 0;
+    long samples_ = 0;
+    bool off_track_ = false;
+};
+
+} // namespace robot
+
+#endif // ROBOT_TRACK_SIM_HPP
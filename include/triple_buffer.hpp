@@ -0,0 +1,78 @@
+#ifndef ROBOT_TRIPLE_BUFFER_HPP
+#define ROBOT_TRIPLE_BUFFER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace robot {
+
+/**
+ * @brief 单生产者单消费者的"最新帧"邮箱（三缓冲）
+ *
+ * 三个缓冲区分别属于生产者、消费者和中间交换位。生产者写好自己的缓冲区后 publish()，
+ * 用一次原子交换把它和中间位对调；消费者 update() 时若中间位有新数据，同样用一次原子交换取走。
+ * 两边都不阻塞、不拷贝数据，任一时刻每个缓冲区只属于一方，因此 T 可以是 cv::Mat 等非平凡类型。
+ * 消费者来不及取走的旧帧被下一次 publish() 覆盖（丢弃），消费者总是拿到最新的一帧。
+ *
+ * writeBuffer()/publish() 只能由一个线程调用，update()/readBuffer() 只能由另一个线程调用。
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    /**
+     * @brief 生产者当前可写的缓冲区（内容是之前某次发布的旧帧）
+     */
+    T& writeBuffer() { return buffers_[write_]; }
+
+    /**
+     * @brief 发布 writeBuffer()，之后 writeBuffer() 返回另一个缓冲区
+     */
+    void publish() {
+        unsigned previous = middle_.exchange(write_ | FRESH, std::memory_order_acq_rel);
+        write_ = previous & INDEX;
+        published_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 消费者取最新帧
+     * @return 有新发布的帧时返回 true，readBuffer() 随之更新；否则 readBuffer() 不变
+     */
+    bool update() {
+        if ((middle_.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        unsigned previous = middle_.exchange(read_, std::memory_order_acq_rel);
+        read_ = previous & INDEX;
+        consumed_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief 消费者当前持有的帧
+     */
+    T& readBuffer() { return buffers_[read_]; }
+    const T& readBuffer() const { return buffers_[read_]; }
+
+    /**
+     * @brief 中间位是否有尚未取走的新帧
+     */
+    bool pending() const { return (middle_.load(std::memory_order_relaxed) & FRESH) != 0; }
+
+    uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+    uint64_t consumed() const { return consumed_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr unsigned INDEX = 3;
+    static constexpr unsigned FRESH = 4;
+
+    T buffers_[3];
+    unsigned write_ = 0;                        // 生产者独占
+    unsigned read_ = 1;                         // 消费者独占
+    alignas(64) std::atomic<unsigned> middle_{2};
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> consumed_{0};
+};
+
+} // namespace robot
+
+#endif // ROBOT_TRIPLE_BUFFER_HPP
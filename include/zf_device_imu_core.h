@@ -5,6 +5,7 @@
 
 #include "zf_common_typedef.h"
 #include <stdint.h>
+#include <vector>
 
 //===================================================================================================================
 // IMU设备类型枚举
@@ -33,6 +34,36 @@ typedef struct
     int16_t mag_z;      // 磁力计Z轴
 } imu_raw_data_t;
 
+//===================================================================================================================
+// 带时间戳的IMU样本
+//===================================================================================================================
+typedef struct
+{
+    imu_raw_data_t data;
+    int64_t timestamp_ns;   // 采样时间（CLOCK_MONOTONIC 纳秒，与 steady_clock 同源）
+} imu_sample_t;
+
+//===================================================================================================================
+// 数据读取方式
+//===================================================================================================================
+typedef enum
+{
+    IMU_BACKEND_NONE   = 0,    // 未初始化
+    IMU_BACKEND_SYSFS  = 1,    // 逐轴读取 in_*_raw 文件（各轴不同时刻采样）
+    IMU_BACKEND_BUFFER = 2     // IIO 缓冲区：/dev/iio:deviceN 批量读取打包的二进制样本，各轴同一时刻采样并带内核时间戳
+} imu_backend_t;
+
+//===================================================================================================================
+// IIO 缓冲区配置（initialize 之前设置）
+//===================================================================================================================
+typedef struct
+{
+    bool        enable;         // 是否尝试缓冲区模式（失败时退回 sysfs）
+    uint32_t    length;         // 内核缓冲区长度（样本数）
+    uint32_t    watermark;      // 缓冲区中样本数达到该值时 poll 才唤醒
+    const char* trigger;        // 写入 trigger/current_trigger 的触发器名称，NULL 时保持不变
+} imu_buffer_config_t;
+
 //===================================================================================================================
 // IMU设备类
 //===================================================================================================================
@@ -48,7 +79,9 @@ private:
     int sensor_fds_[9];                // 9个传感器文件句柄
     
     // 路径常量（基于1.0内核）
+    static constexpr const char* DEVICE_DIR = "/sys/bus/iio/devices/iio:device1";
     static constexpr const char* DEVICE_NAME_PATH = "/sys/bus/iio/devices/iio:device1/name";
+    static constexpr const char* BUFFER_DEV_PATH = "/dev/iio:device1";
     
     static constexpr const char* SENSOR_PATHS[9] = {
         "/sys/bus/iio/devices/iio:device1/in_accel_x_raw",
@@ -74,12 +107,40 @@ private:
         SENSOR_MAG_Y,
         SENSOR_MAG_Z
     } sensor_index_t;
+
+    // IIO 缓冲区中一个通道的位置与格式（来自 scan_elements/in_*_type，如 "le:s16/16>>0"）
+    typedef struct {
+        int  sensor;        // sensor_index_t，时间戳通道为 -1
+        int  index;         // 扫描顺序
+        int  location;      // 在一个样本中的字节偏移
+        int  bytes;         // 存储字节数
+        int  bits;          // 有效位数
+        int  shift;         // 右移位数
+        bool is_signed;
+        bool big_endian;
+    } scan_channel_t;
+
+    imu_backend_t backend_;
+    imu_buffer_config_t buffer_config_;
+    int buffer_fd_;
+    scan_channel_t scan_channels_[10];
+    int scan_channel_count_;
+    size_t scan_size_;                  // 一个样本的字节数
+    std::vector<uint8_t> read_buffer_;
+    size_t read_pending_;               // read_buffer_ 中不足一个样本的残留字节
+    int64_t timestamp_ns_;              // 最新样本时间
+    double gyro_scale_;                 // 陀螺仪原始值到 rad/s 的比例（in_anglvel_scale）
     
     // 私有方法
     bool open_sensor_files();
     void close_sensor_files();
     int16_t read_sensor_data(sensor_index_t index);
     bool check_device_type(const char* device_name);
+    bool open_buffer();
+    void close_buffer();
+    bool parse_scan_channel(const char* channel, int sensor, scan_channel_t& out);
+    void decode_sample(const uint8_t* scan, imu_sample_t& out) const;
+    int read_buffer_samples(imu_sample_t* out, int max_samples, int timeout_ms);
     
     // 禁用拷贝构造和赋值
     IMUDevice(const IMUDevice&) = delete;
@@ -94,10 +155,18 @@ public:
     bool initialize();                          // 初始化设备
     imu_device_type_t get_device_type() const;  // 获取设备类型
     bool is_initialized() const;                // 检查是否初始化
+    void set_buffer_config(const imu_buffer_config_t& config);  // 设置缓冲区配置（initialize 之前）
+    imu_backend_t get_backend() const;          // 当前数据读取方式
     
     // 数据读取接口
-    bool update_all_data();                     // 更新所有数据
+    bool update_all_data();                     // 更新为最新数据（缓冲区模式下取走所有已到达的样本，没有新样本时返回false）
     const imu_raw_data_t& get_raw_data() const; // 获取原始数据
+    int64_t get_timestamp_ns() const;           // 最新数据的采样时间
+    double get_gyro_scale() const;              // 陀螺仪原始值到 rad/s 的比例
+
+    // 批量读取：缓冲区模式下等待最多 timeout_ms（poll 唤醒）并一次读出所有已到达的样本；
+    // sysfs 模式下读取一次当前值。返回读到的样本数，出错返回-1
+    int read_samples(imu_sample_t* out, int max_samples, int timeout_ms);
     
     // 单个数据读取（可选）
     int16_t get_acc_x() const;
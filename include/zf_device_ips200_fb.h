@@ -7,11 +7,14 @@
 #define IPS200_DEFAULT_BGCOLOR          (RGB565_WHITE  )                        // 默认的背景颜色
 
 
+// 所有绘制函数写入后台缓冲并记录脏矩形，调用 ips200_update_screen() 后才显示到屏幕上
+
 void    ips200_clear            (void);
 void    ips200_full             (const uint16 color);
 void    ips200_draw_point       (uint16 x, uint16 y, const uint16 color);
 void    ips200_draw_line        (uint16 x_start, uint16 y_start, uint16 x_end, uint16 y_end, const uint16 color);
 
+void    ips200_set_color        (const uint16 pencolor, const uint16 bgcolor);
 void    ips200_show_char        (uint16 x, uint16 y, const char dat);
 void    ips200_show_string      (uint16 x, uint16 y, const char dat[]);
 void    ips200_show_int         (uint16 x, uint16 y, const int32 dat, uint8 num);
@@ -19,8 +22,11 @@ void    ips200_show_uint        (uint16 x, uint16 y, const uint32 dat, uint8 num
 void    ips200_show_float       (uint16 x, uint16 y, const double dat, uint8 num, uint8 pointnum);
 
 void    ips200_show_gray_image  (uint16 x, uint16 y, const uint8 *image, uint16 width, uint16 height);
+void    ips200_show_rgb565_image(uint16 x, uint16 y, const uint16 *image, uint16 width, uint16 height, uint16 stride);
+uint16 *ips200_buffer           (uint16 x, uint16 y, uint16 width, uint16 height, int *stride);
 
 void    ips200_init             (const char *path);
+void    ips200_attach           (uint16 *base, int width, int height, int stride);
 
 void    ips200_update_screen    (void);
 #endif
\ No newline at end of file
@@ -4,6 +4,24 @@
 
 #include "zf_common_typedef.h"
 
+// 设备文件句柄缓存
+// 每个 (路径, 读/写) 只 open 一次，之后用 pread/pwrite 在偏移0处读写，不再 open/lseek/close。
+// 句柄由缓存持有，进程退出前一直有效；可以在任意线程使用（pread/pwrite 不共享文件偏移）。
+#define FILE_HANDLE_MAX             (32)        // 最多缓存的设备文件数
+#define FILE_HANDLE_PATH_MAX        (96)        // 缓存键（原始路径）的最大长度
+
+int  file_handle_get(const char *path, int flags);
+int  file_handle_read(int fd, uint8 *buf, size_t size);
+int  file_handle_write(int fd, const uint8 *buf, size_t size);
+void file_handle_close_all(void);
+
+// 设备根目录重定向（仿真设备后端）
+// 设置后所有设备路径都加上该前缀，例如 "/tmp/fakedev" 时 "/dev/zf_encoder_1" 实际访问
+// "/tmp/fakedev/dev/zf_encoder_1"，可在 tmpfs 上用普通文件模拟设备节点。
+// 未调用时读取环境变量 ZF_DEVICE_ROOT；需要在第一次访问设备之前设置。
+void file_set_device_root(const char *root);
+const char *file_resolve_path(const char *path, char *buf, size_t size);
+
 int file_io_operation(const char *path, int flags, uint8 *buf, size_t size);
 int8 file_read_string(const char *path, char *str);
 
@@ -11,6 +29,9 @@ int8 file_read_string(const char *path, char *str);
 #define file_write_dat(path, value)                 file_io_operation(path, O_WRONLY, (uint8 *)&(value), sizeof(value))
 #define file_read_dat(path, ret_value)              file_io_operation(path, O_RDONLY, (uint8 *)(ret_value), sizeof(*(ret_value)))
 
+// 已取得句柄时的读写（热路径上省去按路径查找缓存）
+#define fd_write_dat(fd, value)                     file_handle_write(fd, (const uint8 *)&(value), sizeof(value))
+#define fd_read_dat(fd, ret_value)                  file_handle_read(fd, (uint8 *)(ret_value), sizeof(*(ret_value)))
 
-#endif
 
+#endif
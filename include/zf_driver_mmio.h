@@ -0,0 +1,63 @@
+#ifndef _zf_driver_mmio_h
+#define _zf_driver_mmio_h
+
+
+#include "zf_common_typedef.h"
+
+// 寄存器直写后端
+// 把 PWM / GPIO 控制器的寄存器映射到用户空间，pwm_set_duty / gpio_set_level 对已绑定的设备路径
+// 直接写寄存器（一次 store），不再经过字符设备的 write 系统调用。未绑定的路径仍走设备文件。
+// 编译时定义 ZF_DRIVER_MMIO 才会接入驱动（CMake 选项 ZF_DRIVER_MMIO），否则本模块只是未被调用的代码。
+//
+// 使用方法：
+//   1. mmio_map(物理地址, 长度) 映射寄存器窗口（需要 root 权限访问 /dev/mem）；
+//      在台式机上测试时用 mmio_map_mock(长度) 得到一块匿名内存作为假的寄存器窗口；
+//   2. 内核驱动照常完成 PWM 周期、使能和 GPIO 方向的配置，之后用 mmio_bind_pwm / mmio_bind_gpio
+//      把设备路径绑定到窗口内的寄存器；
+//   3. 之后对该路径的 pwm_set_duty / gpio_set_level 都直接写寄存器。
+// 绑定需在控制任务开始前完成，之后绑定表不再改变，查找无锁。
+
+// LS2K0300 寄存器布局：PWM 各寄存器偏移参照 Linux pwm-loongson 驱动。
+// GPIO 使用控制器的按字节模式：每个引脚独占一个输出字节寄存器，写入只改变该引脚；
+// 不对同组 32 个引脚共享的输出寄存器做读-改-写，不会覆盖内核 gpiolib 或其他写者对同组引脚的修改。
+// 控制器基地址（ZF_MMIO_PWM_BASE / ZF_MMIO_GPIO_BASE）与按字节输出寄存器的起始偏移（ZF_MMIO_GPIO_OUT）
+// 没有默认值，需按数据手册在编译时给出（CMake 变量同名）；以 ZF_DRIVER_MMIO 编译主程序而缺少这些地址时编译失败
+#ifndef ZF_MMIO_PWM_STRIDE
+#define ZF_MMIO_PWM_STRIDE          (0x10u)         // 相邻通道寄存器组的间隔
+#endif
+#define ZF_MMIO_PWM_LOW             (0x04u)         // 低电平缓冲寄存器（占空比计数）
+#define ZF_MMIO_PWM_FULL            (0x08u)         // 周期缓冲寄存器（周期计数）
+#define ZF_MMIO_PWM_CTRL            (0x0Cu)         // 控制寄存器
+
+#define ZF_MMIO_GPIO_PINS           (128)           // 映射的按字节输出寄存器个数（引脚号 0~127）
+
+#define MMIO_WINDOW_MAX             (4)             // 最多映射的寄存器窗口数
+#define MMIO_BIND_MAX               (16)            // 最多绑定的设备路径数
+
+// 映射寄存器窗口，成功返回窗口号，失败返回 -1（不会退出进程）
+int     mmio_map                (uint32 physical_address, size_t size);
+// 以匿名内存作为假的寄存器窗口（测试用），成功返回窗口号，失败返回 -1
+int     mmio_map_mock           (size_t size);
+// 窗口的起始地址（测试时检查写入的寄存器值），窗口号无效时返回 NULL
+vuint32 *mmio_window     (int window);
+// 解除所有绑定并取消映射
+void    mmio_unmap_all          (void);
+
+// 把 PWM 设备路径绑定到窗口内 offset 处的占空比寄存器
+// period_count 为一个 PWM 周期的计数值，duty_max 为 pwm_set_duty 的满占空比（pwm_info.duty_max），
+// 写入时换算为 duty * period_count / duty_max
+int8    mmio_bind_pwm           (const char *path, int window, uint32 offset, uint32 period_count, uint32 duty_max);
+// 把 GPIO 设备路径绑定到窗口内 offset 处该引脚的输出字节寄存器（按字节模式，写 0/1 只影响该引脚）
+int8    mmio_bind_gpio          (const char *path, int window, uint32 offset);
+
+// 写已绑定的路径：成功返回 0，路径未绑定返回 -1（调用方退回设备文件）
+int8    mmio_pwm_set_duty       (const char *path, uint16 duty);
+int8    mmio_gpio_set_level     (const char *path, uint8 dat);
+
+// 按路径查找绑定，返回绑定号（-1 未绑定）；热路径上可先查好绑定号再用 mmio_write
+int     mmio_find               (const char *path);
+// 按绑定号写入：PWM 为占空比，GPIO 为电平（0 / 非 0）
+void    mmio_write              (int binding, uint32 value);
+
+
+#endif
@@ -1,30 +1,783 @@
 #include "main.hpp"
+#include "attitude_estimator.hpp"
+#include "actuator_service.hpp"
+#include "binary_rle.hpp"
+#include "cascaded_controller.hpp"
+#include "debug_stream.hpp"
+#include "display_service.hpp"
+#include "flight_recorder.hpp"
+#include "speed_planner.hpp"
+#include "frame_pipeline.hpp"
+#include "frame_trace.hpp"
+#include "hal.hpp"
+#include "hal_camera.hpp"
+#include "imu_stream.hpp"
+#include "odometry.hpp"
+#include "sensor_sampler.hpp"
+#include "task_scheduler.hpp"
+#include "telemetry_bus.hpp"
+#include "web_server.h"
+#include "zf_driver_mmio.h"
 
 using namespace std;
 using namespace cv;
 
 IMUDevice imu;
 
+JSON_PIDConfigData  JSON_PIDConfigData_c;
+JSON_PIDConfigData  *JSON_PIDConfigData_p = &JSON_PIDConfigData_c;
 
-int main() {
-    if (main_init_task() == 1) { 
-        cout << "初始化成功" << endl; 
-    } else { 
-        cout << "初始化失败" << endl; return -1; 
+Function_EN         Function_EN_c;
+Function_EN         *Function_EN_p = &Function_EN_c;
+
+Data_Path           Data_Path_c;
+Data_Path           *Data_Path_p = &Data_Path_c;
+
+ImgProcess imgProcess;
+SYNC Sync;
+
+// 遥测总线：IMU、编码器、控制、寻线结果与各阶段耗时以固定格式的二进制记录写入，Web 连接各自读取
+static robot::TelemetryBus telemetry;
+
+struct pwm_info servo_pwm_info;
+struct pwm_info motor1_pwm_info;
+struct pwm_info motor2_pwm_info;
+
+// 舵机与电机：执行器服务启动失败时控制任务通过这些接口直接写设备
+static robot::hal::DevicePwm servo_pwm(SERVO_MOTOR1_PWM);
+static robot::hal::DevicePwm motor1_pwm(MOTOR1_PWM);
+static robot::hal::DevicePwm motor2_pwm(MOTOR2_PWM);
+static robot::hal::DeviceGpio motor1_dir(MOTOR1_DIR);
+static robot::hal::DeviceGpio motor2_dir(MOTOR2_DIR);
+
+// 摄像头与显示屏：车上为 V4L2 摄像头与 /dev/fb0，仿真时为文件中的帧与内存显存
+static std::unique_ptr<robot::hal::Camera> camera;
+static std::unique_ptr<robot::hal::Framebuffer> screen;
+
+// 仿真运行（--sim）：设备文件生成在 sim_root 下，zf_* 驱动读写其中的普通文件，帧来自 sim_frames
+static bool sim_mode = false;
+static std::string sim_root = "/tmp/robot_sim";
+static std::string sim_frames = "img/test_4.mp4";
+static std::unique_ptr<robot::hal::SimDeviceTree> sim_devices;
+static robot::hal::MemoryFramebuffer* sim_screen = nullptr;
+
+// 编码器与IMU批量采样（设备句柄只打开一次）
+static robot::SensorSampler sensor_sampler(ENCODER_1, ENCODER_2, &imu);
+
+// 编码器里程计：控制任务每周期采样一次，滤波后的轮速作为电机PID反馈
+static const int CONTROL_HZ = 100;
+static robot::Odometry odometry;
+
+// IMU 独立线程连续采集，每个样本在采集线程中送入姿态解算（零偏标定、航向展开、出环转角触发）
+static robot::ImuStream imu_stream(&imu);
+static robot::AttitudeEstimator attitude;
+static bool circle_gyro_armed = false;
+
+// 视觉流水线：采集 → 预处理 → 寻线与决策 → 显示，各阶段在自己的线程中运行
+// 每个帧槽一份图像存储，阶段之间只传递帧槽编号，同一帧槽同一时刻只属于一个阶段
+static robot::FramePipeline vision_pipeline(4);
+static std::vector<Img_Store> frame_slots;
+static std::vector<int64_t> frame_sensor_ns;        // 各帧槽的传感器时间戳（steady_clock 纳秒）
+
+// 视觉决策结果，控制任务总是读取最新一帧的结果
+struct ControlTarget {
+    uint64_t frame_id;
+    std::chrono::steady_clock::time_point capture_time;
+    int64_t sensor_ns;
+    int servo_dir;
+    int servo_angle;
+    int motor_speed;
+    float speed_limit;      // 速度规划的允许车速（m/s），未启用速度规划时不使用
+};
+static robot::LatestValue<ControlTarget> control_target;
+static robot::LatencyHistogram control_frame_age;   // 控制任务使用的结果距采集完成的时间（μs）
+
+static std::atomic<bool> g_stop(false);
+
+// 任务调度器：单核协作式，除Web服务外的任务都在主线程中依次执行，彼此之间不需要加锁
+static robot::TaskScheduler scheduler(0);
+
+// 转向与速度控制器，PID参数与积分状态保存在 JSON_PIDConfigData 中
+static robot::CascadedController controller(JSON_PIDConfigData_c.anglespeedpid,
+                                            JSON_PIDConfigData_c.servopid,
+                                            JSON_PIDConfigData_c.motorpid);
+// 曲率速度规划：寻线阶段按前方曲率计算允许车速，控制任务按加减速度斜率输出连续的速度目标
+static robot::SpeedPlanner speed_planner;
+static bool speed_plan_enabled = false;
+
+// 执行器服务线程：持有舵机、电机PWM与方向GPIO句柄，只写变化的值且每通道每个PWM周期最多写一次
+static robot::ActuatorService actuators;
+static int servo_channel = -1;
+static int motor1_channel = -1;
+static int motor2_channel = -1;
+static int motor1_dir_channel = -1;
+static int motor2_dir_channel = -1;
+
+// 显示帧：寻线阶段叠加了标注的图像（cv::Mat 引用计数，发布时不拷贝像素；下一帧 clone 出新的图像）与赛道状态
+struct DisplayFrame {
+    cv::Mat image;
+    int track_kind = 0;
+    int circle_step = 0;
+};
+static void render_display_frame(const DisplayFrame& frame);
+// 显示线程：低优先级、15fps，只显示最新一帧，屏幕写入不占用视觉流水线
+static robot::DisplayService<DisplayFrame> display_service(render_display_frame);
+
+// 调试视频流帧：寻线标注图像与二值图（二值图所在的帧槽会被后续帧复用，发布时拷贝一份）
+struct StreamFrame {
+    cv::Mat image;
+    cv::Mat binary;
+};
+static bool encode_stream_frame(const StreamFrame& frame, robot::StreamFormat format, int quality, std::string* out);
+// 调试视频流：只在有浏览器连接时发布帧，编码在低优先级的编码线程中进行，帧率随连接的接收速度调整
+static robot::DebugStream<StreamFrame> debug_stream(encode_stream_frame);
+
+// 飞行记录器：每帧的二值图、寻线摘要和遥测总线写入预分配的环形记录文件，寻线阶段只做拷贝，编码与写入在记录线程
+static robot::FlightRecorder flight_recorder;
+static const char* FLIGHT_LOG_PATH = "log/flight.rbl";
+/*
+    采集阶段
+    读取阻塞到下一帧到来，采集时刻由摄像头后端给出（V4L2 为驱动填写的缓冲区时间戳）
+*/
+static bool capture_stage(const robot::FrameInfo& info)
+{
+    FRAME_TRACE_SCOPE(info.frame_id, "capture");
+    int64_t sensor_ns = 0;
+    bool ok = camera->read(frame_slots[info.slot].Img_Color, sensor_ns);
+    frame_sensor_ns[info.slot] = sensor_ns;
+    return ok;
+}
+
+/*
+    预处理阶段
+*/
+static bool preprocess_stage(const robot::FrameInfo& info)
+{
+    FRAME_TRACE_SCOPE(info.frame_id, "imgPreProc");
+    Img_Store *Img_Store_p = &frame_slots[info.slot];
+    imgProcess.imgPreProc(Img_Store_p,Data_Path_p,Function_EN_p); // 图像预处理
+    // 寻线时 imgSearch_l_r 从 Img_OTSU 重新生成 bin_image，补线也直接画在 Img_OTSU 上；
+    // 这里保留补线前的二值图，飞行记录据此回放时与车上的寻线输入一致
+    memcpy(Img_Store_p->original_image[0], Img_Store_p->Img_OTSU.data, image_h * image_w * sizeof(uint8));
+    return true;
+}
+
+/*
+    圆环出环判断的陀螺仪转角
+    入环后在姿态解算上设置转角触发，航向变化达到配置角度时由IMU采集线程逐样本判断并置位；
+    只采用不晚于当前帧采集时刻的触发，保证同一帧的图像与陀螺仪判断对应同一时刻
+*/
+static void circle_gyro_update(int64_t frame_ns)
+{
+    CircleTrackStep step = Data_Path_p -> Circle_Track_Step;
+    if (step == IN_PREPARE || step == OUT_2_STRIGHT || step == INIT) {
+        if (circle_gyro_armed) {
+            attitude.disarmYawTrigger();
+            circle_gyro_armed = false;
+        }
+        Function_EN_p -> Gyroscope_EN = false;
+        return;
+    }
+    if (!circle_gyro_armed) {
+        attitude.armYawTrigger(Data_Path_p -> JSON_TrackConfigData_v[0].Circle_Out_Gyro_Angle);
+        circle_gyro_armed = true;
     }
-    // VideoCapture Camera; CameraInit(Camera,CameraKind::VIDEO_0,320,240,60);
-    
 
+    int64_t trigger_ns = 0;
+    Function_EN_p -> Gyroscope_EN = attitude.yawTriggered(&trigger_ns) && trigger_ns <= frame_ns;
+}
+
+/*
+    IMU 遥测：原始值与姿态解算的角速度、航向
+*/
+static void publish_imu_telemetry(const imu_raw_data_t& data, int64_t timestamp_ns)
+{
+    robot::TelemetryImu record;
+    record.acc[0] = data.acc_x;
+    record.acc[1] = data.acc_y;
+    record.acc[2] = data.acc_z;
+    record.gyro[0] = data.gyro_x;
+    record.gyro[1] = data.gyro_y;
+    record.gyro[2] = data.gyro_z;
+    robot::AttitudeState att;
+    bool has_attitude = attitude.isCalibrated() && attitude.state(att);
+    record.yaw_rate = has_attitude ? att.yaw_rate * 180.0f / (float)M_PI : 0;
+    record.heading = has_attitude ? (float)(att.heading * 180.0 / M_PI) : 0;
+    telemetry.push(robot::TelemetryType::Imu, record, timestamp_ns);
+}
+
+/*
+    处理阶段耗时遥测（FrameTracer 的每个区间）
+*/
+static void publish_stage_telemetry(const robot::TraceSpan& span)
+{
+    robot::TelemetryStage record = {};
+    record.frame_id = span.frame_id;
+    record.duration_us = span.end_ns > span.start_ns ? (uint32_t)((span.end_ns - span.start_ns) / 1000) : 0;
+    strncpy(record.name, span.name ? span.name : "", sizeof(record.name) - 1);
+    telemetry.push(robot::TelemetryType::Stage, record, span.start_ns);
+}
+
+/*
+    飞行记录
+    拷贝补线前的二值图（灰度图按配置间隔）、边线数组与寻线结果，拐点与弯点每侧最多记录 MAX_POINTS 个
+*/
+static void record_flight_frame(robot::FlightFrame* record, const robot::FrameInfo& info, Img_Store* Img_Store_p,
+                                const ControlTarget& target)
+{
+    record -> setBinary(Img_Store_p -> original_image[0], image_w, image_h, image_w);
+    if (record -> want_gray) {
+        const cv::Mat& gray = Img_Store_p -> Img_Gray;
+        record -> setGray(gray.data, gray.cols, gray.rows, (int)gray.step);
+    }
+    record -> setBorders(Data_Path_p -> l_border, Data_Path_p -> r_border, Data_Path_p -> center_line, image_h);
+
+    robot::FlightPath& path = record -> path;
+    path.frame_id = info.frame_id;
+    path.sensor_ns = target.sensor_ns;
+    path.distance = Data_Path_p -> Distance;
+    path.speed = Data_Path_p -> Speed;
+    path.speed_limit = target.speed_limit;
+    path.track_kind = (int16_t)Data_Path_p -> Track_Kind;
+    path.circle_step = (int16_t)Data_Path_p -> Circle_Track_Step;
+    path.servo_dir = (int16_t)target.servo_dir;
+    path.servo_angle = (int16_t)target.servo_angle;
+    path.motor_speed = target.motor_speed;
+    path.hightest = Data_Path_p -> hightest;
+    for (int side = 0; side < 2; ++side) {
+        path.inflection_num[side] = (uint8_t)std::min(Data_Path_p -> InflectionPointNum[side], 255);
+        path.bend_num[side] = (uint8_t)std::min(Data_Path_p -> BendPointNum[side], 255);
+        int inflections = std::min(Data_Path_p -> InflectionPointNum[side], (int)robot::FlightPath::MAX_POINTS);
+        int bends = std::min(Data_Path_p -> BendPointNum[side], (int)robot::FlightPath::MAX_POINTS);
+        for (int i = 0; i < inflections; ++i) {
+            path.inflection[side][i].x = (int16_t)Data_Path_p -> InflectionPointCoordinate[i][side * 2];
+            path.inflection[side][i].y = (int16_t)Data_Path_p -> InflectionPointCoordinate[i][side * 2 + 1];
+        }
+        for (int i = 0; i < bends; ++i) {
+            path.bend[side][i].x = (int16_t)Data_Path_p -> BendPointCoordinate[i][side * 2];
+            path.bend[side][i].y = (int16_t)Data_Path_p -> BendPointCoordinate[i][side * 2 + 1];
+        }
+    }
+}
 
-    // Camera.release();
+/*
+    寻线与决策阶段
+    赛道状态机的状态保存在 Data_Path 中并跨帧延续，因此寻线、补线和舵机电机决策放在同一阶段，
+    Data_Path 只由该阶段访问
+*/
+static bool track_stage(const robot::FrameInfo& info)
+{
+    Img_Store *Img_Store_p = &frame_slots[info.slot];
+
+    circle_gyro_update(frame_sensor_ns[info.slot]);
+
+    // 当前帧采集时刻的行驶距离，赛道元素可按距离而不是帧数计时；车速用于前瞻随车速调整
+    double distance = 0;
+    robot::OdometryState odom;
+    bool has_odom = odometry.state(odom);
+    if (odometry.distanceAt(frame_sensor_ns[info.slot], distance)) {
+        Data_Path_p -> Distance = distance;
+    } else if (has_odom) {
+        Data_Path_p -> Distance = odom.distance;
+    }
+    if (has_odom) {
+        Data_Path_p -> Speed = odom.speed;
+    }
+
+    TrackProcess(Img_Store_p,Data_Path_p,Function_EN_p,info.frame_id);
+
+    ControlTarget target;
+    target.frame_id = info.frame_id;
+    target.capture_time = info.capture_time;
+    target.sensor_ns = frame_sensor_ns[info.slot];
+    target.servo_dir = Data_Path_p -> ServoDir;
+    target.servo_angle = Data_Path_p -> ServoAngle;
+    target.motor_speed = Data_Path_p -> MotorSpeed;
+    target.speed_limit = 0;
+    if (speed_plan_enabled) {
+        const JSON_TrackConfigData& track_config = Data_Path_p -> JSON_TrackConfigData_v[0];
+        // MotorSpeed_Judge 的速度（每控制周期脉冲数）作为上限
+        float cap = Data_Path_p -> MotorSpeed * CONTROL_HZ * (float)JSON_PIDConfigData_p -> encoder_meters_per_count;
+        robot::CurvatureEstimate estimate = robot::estimateCurvature(Data_Path_p -> center_line, image_h, image_w,
+            Data_Path_p -> hightest, image_h - track_config.Path_Search_Start, track_config.Birdeye_Meters_Per_Pixel);
+        target.speed_limit = speed_planner.limit(cap, estimate);
+    }
+    control_target.store(target);
+
+    robot::TelemetryTrack track_record = {};
+    track_record.frame_id = info.frame_id;
+    track_record.track_kind = (int16_t)Data_Path_p -> Track_Kind;
+    track_record.circle_step = (int16_t)Data_Path_p -> Circle_Track_Step;
+    track_record.servo_dir = (int16_t)target.servo_dir;
+    track_record.servo_angle = (int16_t)target.servo_angle;
+    track_record.motor_speed = target.motor_speed;
+    track_record.speed_limit = target.speed_limit;
+    int64_t track_end_ns = robot::FrameTracer::nowNs();
+    track_record.age_us = (uint32_t)((track_end_ns - target.sensor_ns) / 1000);
+    telemetry.push(robot::TelemetryType::Track, track_record, track_end_ns);
+
+    DisplayFrame display_frame;
+    display_frame.image = Img_Store_p -> Img_Track;
+    display_frame.track_kind = (int)Data_Path_p -> Track_Kind;
+    display_frame.circle_step = (int)Data_Path_p -> Circle_Track_Step;
+    display_service.publish(display_frame);
+
+    if (debug_stream.wanted()) {
+        StreamFrame stream_frame;
+        stream_frame.image = Img_Store_p -> Img_Track;
+        stream_frame.binary = Img_Store_p -> Img_OTSU.clone();
+        debug_stream.publish(stream_frame);
+    }
+
+    if (robot::FlightFrame* record = flight_recorder.acquire()) {
+        FRAME_TRACE_SCOPE(info.frame_id, "flight_record");
+        record_flight_frame(record, info, Img_Store_p, target);
+        flight_recorder.commit(record);
+    }
+    return true;
+}
+
+/*
+    显示（显示线程）
+    状态文字只在变化时重绘，与图像一起刷新到屏幕
+*/
+static void render_display_frame(const DisplayFrame& frame)
+{
+    const int track_kinds = sizeof(imgProcess.TextTrackKind) / sizeof(imgProcess.TextTrackKind[0]);
+    const int circle_steps = sizeof(imgProcess.TextCircleTrackStep) / sizeof(imgProcess.TextCircleTrackStep[0]);
+    display_status_line(0, frame.track_kind >= 0 && frame.track_kind < track_kinds
+                           ? imgProcess.TextTrackKind[frame.track_kind].c_str() : "-");
+    display_status_line(1, frame.circle_step >= 0 && frame.circle_step < circle_steps
+                           ? imgProcess.TextCircleTrackStep[frame.circle_step].c_str() : "-");
+    displayMatOnIPS200(frame.image);
+}
+
+/*
+    调试视频流编码（编码线程）
+    JPEG 为寻线标注图像与二值图左右拼接的合成图；二值图单独以 1 位/像素游程编码发送
+*/
+static bool encode_stream_frame(const StreamFrame& frame, robot::StreamFormat format, int quality, std::string* out)
+{
+    if (format == robot::StreamFormat::BinaryRle) {
+        if (frame.binary.empty() || frame.binary.type() != CV_8UC1) {
+            return false;
+        }
+        return robot::encodeBinaryRle(frame.binary.data, frame.binary.cols, frame.binary.rows,
+                                      (int)frame.binary.step, out);
+    }
+    if (frame.image.empty()) {
+        return false;
+    }
+    static cv::Mat composite;
+    const cv::Mat* view = &frame.image;
+    if (!frame.binary.empty() && frame.binary.rows == frame.image.rows && frame.image.type() == CV_8UC3) {
+        cv::Mat binary_color;
+        cvtColor(frame.binary, binary_color, COLOR_GRAY2BGR);
+        hconcat(frame.image, binary_color, composite);
+        view = &composite;
+    }
+    std::vector<uchar> buffer;
+    if (!imencode(".jpg", *view, buffer, {IMWRITE_JPEG_QUALITY, quality})) {
+        return false;
+    }
+    out->assign((const char*)buffer.data(), buffer.size());
+    return true;
+}
+
+/*
+    控制任务
+    批量读取编码器与IMU，转向与速度控制器输出舵机和电机，目标值交给执行器服务线程写入
+    glass-to-PWM 延迟（传感器时间戳到该帧的命令写入PWM）：执行器服务运行时由服务线程在命令全部写入后记录，
+    包含舵机写入间隔造成的等待；否则在控制任务直接写设备后记录
+*/
+static void control_task()
+{
+    static bool has_actuated = false;
+    static uint64_t last_actuated_frame = 0;
+
+    pit_callback();
+
+    // 读取失败（写者持续更新时重读超过上限）时沿用上一次读到的结果
+    static ControlTarget target = {};
+    static bool has_target = false;
+    has_target = control_target.load(target) || has_target;
+    if (has_target) {
+        auto age = std::chrono::steady_clock::now() - target.capture_time;
+        control_frame_age.record((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(age).count());
+    }
+
+    // 陀螺仪零偏标定期间车辆需保持静止，标定完成后才开始比赛（只启动一次）
+    // IMU 采集线程未运行时姿态解算收不到样本、不会标定，此时不等待
+    static bool started = false;
+    if (!started && (attitude.isCalibrated() || !imu_stream.isRunning())) {
+        Function_EN_p -> Game_EN = true;
+        started = true;
+        printf(attitude.isCalibrated() ? "陀螺仪零偏标定完成，开始比赛\n" : "IMU 采集线程未运行，不等待标定，开始比赛\n");
+    }
+
+    int64_t pid_start_ns = robot::FrameTracer::nowNs();
+
+    // 偏航角速度优先用陀螺仪（姿态解算去零偏后），标定完成前用里程计差速
+    // 读取失败时沿用上一次的快照（写者在其他线程持续更新时读取次数有上限，不会自旋等待）
+    static robot::OdometryState odom;
+    odometry.state(odom);
+    static robot::AttitudeState att;
+    static bool has_att = false;
+    has_att = attitude.isCalibrated() && (attitude.state(att) || has_att);
+    float yaw_rate = has_att ? att.yaw_rate : odom.yaw_rate;
+
+    // 转向目标为中线偏差为0；速度目标为速度决策结果（每个控制周期的脉冲数），未开始比赛时停车
+    // 速度反馈用里程计滤波后的两轮平均速度，换算为每周期脉冲数，与速度配置单位一致
+    robot::ControllerInput input;
+    input.timestamp_ns = pid_start_ns;
+    input.pixel_error = (float)(-target.servo_dir * target.servo_angle);
+    input.yaw_rate = yaw_rate * 180.0f / (float)M_PI;
+    input.speed_target = (Function_EN_p -> Game_EN && has_target) ? (float)target.motor_speed : 0;
+    if (speed_plan_enabled) {
+        if (Function_EN_p -> Game_EN && has_target) {
+            float speed = speed_planner.step(target.speed_limit, 1.0f / CONTROL_HZ);
+            input.speed_target = speed / (CONTROL_HZ * (float)JSON_PIDConfigData_p -> encoder_meters_per_count);
+        } else {
+            speed_planner.reset();
+        }
+    }
+    input.speed_present = (odom.left_cps + odom.right_cps) / 2 / CONTROL_HZ;
+    robot::ControllerOutput output;
+    if (Function_EN_p -> Game_EN) {
+        output = controller.step(input);
+    } else {
+        // 未开始比赛：舵机回中、电机零占空比，控制器保持复位
+        controller.reset();
+    }
+
+    int64_t pwm_start_ns = robot::FrameTracer::nowNs();
+    uint16 servo_duty = (uint16)SERVO_MOTOR_DUTY(90 + output.servo);
+    float percent = output.motor / JSON_PIDConfigData_p -> motorpid.Reslimit;
+    uint8 dir = percent >= 0 ? 1 : 0;
+    uint16 motor1_duty = (uint16)(fabs(percent) * motor1_pwm_info.duty_max);
+    uint16 motor2_duty = (uint16)(fabs(percent) * motor2_pwm_info.duty_max);
+    if (actuators.isRunning()) {
+        // 提交目标值后立即返回，由执行器服务线程写设备
+        actuators.set(servo_channel, servo_duty);
+        actuators.set(motor1_dir_channel, dir);
+        actuators.set(motor2_dir_channel, dir);
+        actuators.set(motor1_channel, motor1_duty);
+        actuators.set(motor2_channel, motor2_duty);
+        if (has_target) {
+            actuators.setFrame(target.frame_id, target.sensor_ns);
+        }
+    } else {
+        servo_pwm.setDuty(servo_duty);
+        motor1_dir.set(dir);
+        motor2_dir.set(dir);
+        motor1_pwm.setDuty(motor1_duty);
+        motor2_pwm.setDuty(motor2_duty);
+    }
+    int64_t pwm_end_ns = robot::FrameTracer::nowNs();
+
+    robot::TelemetryControl control_record = {};
+    control_record.pixel_error = input.pixel_error;
+    control_record.yaw_rate = input.yaw_rate;
+    control_record.speed_target = input.speed_target;
+    control_record.speed_present = input.speed_present;
+    control_record.servo = output.servo;
+    control_record.motor = output.motor;
+    control_record.servo_duty = servo_duty;
+    control_record.motor_duty = motor1_duty;
+    control_record.dir = dir;
+    control_record.saturated = (output.servo_saturated ? 1 : 0) | (output.motor_saturated ? 2 : 0);
+    telemetry.push(robot::TelemetryType::Control, control_record, pid_start_ns);
+
+    if (has_target && (!has_actuated || target.frame_id != last_actuated_frame)) {
+        robot::FrameTracer& tracer = robot::FrameTracer::instance();
+        tracer.record(target.frame_id, "PIDCalculate", pid_start_ns, pwm_start_ns);
+        if (actuators.isRunning()) {
+            tracer.record(target.frame_id, "actuator_set", pwm_start_ns, pwm_end_ns);
+        } else {
+            tracer.record(target.frame_id, "pwm_set_duty", pwm_start_ns, pwm_end_ns);
+            tracer.recordFrameActuated(target.frame_id, target.sensor_ns, pwm_end_ns);
+        }
+        has_actuated = true;
+        last_actuated_frame = target.frame_id;
+    }
+}
+
+/*
+    视觉流水线统计
+    各阶段耗时、排队与帧龄，控制任务拿到结果时的帧龄，以及采集到PWM写入的端到端延迟
+*/
+static void pipeline_stats_task()
+{
+    vision_pipeline.printStats();
+    auto age = control_frame_age.snapshot();
+    printf("%-12s %7llu %7s %6s %9s %9s %9s %9llu %9llu\n", "control",
+           (unsigned long long)age.count, "-", "-", "-", "-", "-",
+           (unsigned long long)age.percentile(50), (unsigned long long)age.percentile(99));
+    auto glass = robot::FrameTracer::instance().glassToActuatorSnapshot();
+    printf("%-12s %7llu %7s %6s %9s %9s %9s %9llu %9llu\n", "glass-to-pwm",
+           (unsigned long long)glass.count, "-", "-", "-", "-", "-",
+           (unsigned long long)glass.percentile(50), (unsigned long long)glass.percentile(99));
+    robot::ControllerStats ctrl = controller.stats();
+    printf("%-12s %7llu %7llu %6s %9s %9s %9s %9llu %9llu\n", "ctrl-period",
+           (unsigned long long)ctrl.steps, (unsigned long long)ctrl.late, "-", "-", "-", "-",
+           (unsigned long long)ctrl.interval_us.percentile(50), (unsigned long long)ctrl.interval_us.percentile(99));
+    // 执行器写入：frames 列为实际写入次数，drops 列为合并或相同值省去的命令，延迟为命令到写入完成
+    const struct { const char* name; int channel; } pwm_rows[] = {
+        {"pwm-servo", servo_channel}, {"pwm-motor1", motor1_channel}, {"pwm-motor2", motor2_channel},
+    };
+    for (const auto& row : pwm_rows) {
+        if (row.channel < 0) {
+            continue;
+        }
+        robot::ActuatorChannelStats pwm = actuators.stats(row.channel);
+        printf("%-12s %7llu %7llu %6s %9s %9s %9s %9llu %9llu\n", row.name,
+               (unsigned long long)pwm.writes, (unsigned long long)(pwm.coalesced + pwm.unchanged), "-", "-", "-", "-",
+               (unsigned long long)pwm.latency_us.percentile(50), (unsigned long long)pwm.latency_us.percentile(99));
+    }
+    // 显示线程：wait 列为发布到开始显示的时间
+    robot::DisplayServiceStats display = display_service.stats();
+    printf("%-12s %7llu %7llu %6.1f %9llu %9llu %9llu %9s %9s\n", "display",
+           (unsigned long long)display.rendered, (unsigned long long)display.dropped, display.fps,
+           (unsigned long long)display.render_us.percentile(50), (unsigned long long)display.render_us.percentile(99),
+           (unsigned long long)display.wait_us.percentile(99), "-", "-");
+    // 调试视频流：只在有连接时输出；drops 列为未编码就被覆盖的帧
+    robot::DebugStreamStats stream = debug_stream.stats();
+    if (stream.clients > 0) {
+        printf("%-12s %7llu %7llu %6.1f %9llu %9llu %9s %9s %9s  q=%d clients=%d %.1f KB/frame\n", "stream",
+               (unsigned long long)stream.encoded, (unsigned long long)stream.dropped, stream.fps,
+               (unsigned long long)stream.encode_us.percentile(50), (unsigned long long)stream.encode_us.percentile(99),
+               "-", "-", "-", stream.quality, stream.clients,
+               stream.encoded ? stream.bytes / 1024.0 / stream.encoded : 0.0);
+    }
+    // 飞行记录：frames 列为写入的帧，drops 列为没有空闲缓冲区丢弃的帧，耗时为记录线程每帧编码与写入
+    if (flight_recorder.isRunning()) {
+        robot::FlightRecorderStats flight = flight_recorder.stats();
+        printf("%-12s %7llu %7llu %6s %9llu %9llu %9s %9s %9s  %.1f MB wraps=%llu sync p99=%lluus lost=%llu\n", "flight",
+               (unsigned long long)flight.frames, (unsigned long long)flight.dropped, "-",
+               (unsigned long long)flight.write_us.percentile(50), (unsigned long long)flight.write_us.percentile(99),
+               "-", "-", "-", flight.bytes / 1048576.0, (unsigned long long)flight.wraps,
+               (unsigned long long)flight.sync_us.percentile(99), (unsigned long long)flight.telemetry_lost);
+    }
+}
+
+/*
+    退出前让车辆进入安全状态：舵机回中、两路电机零占空比
+    控制任务已随调度器停止，执行器服务停止前写出这些命令（忽略写入间隔）；之后再直接写一次设备，
+    保证服务未启动或写入失败时 PWM 也不会保持最后的占空比。zf PWM 设备没有单独的关闭接口，零占空比即停止输出
+*/
+static void park_actuators()
+{
+    uint16 servo_center = (uint16)SERVO_MOTOR_DUTY(90);
+    if (actuators.isRunning()) {
+        actuators.set(servo_channel, servo_center);
+        actuators.set(motor1_channel, 0);
+        actuators.set(motor2_channel, 0);
+        actuators.stop();
+    }
+    servo_pwm.setDuty(servo_center);
+    motor1_pwm.setDuty(0);
+    motor2_pwm.setDuty(0);
+}
+
+/*
+    注册所有任务
+    优先级：控制 > 统计；Web服务为阻塞型任务，运行在独占线程中
+*/
+static bool register_tasks()
+{
+    bool ok = true;
+
+    ok = scheduler.addTask("control", control_task, CONTROL_HZ, robot::Priority::CRITICAL, 1) && ok;
+
+    robot::TaskOptions stats_options;
+    stats_options.period = std::chrono::seconds(5);
+    ok = scheduler.addTask("pipeline_stats", pipeline_stats_task, 0, robot::Priority::BACKGROUND, 0, stats_options) && ok;
+
+    // Web服务：单次任务，listen 阻塞直到服务器停止；调试用的服务器启动失败或停止只结束本任务，不影响控制环
+    // 退出由 SIGINT（sigint_handler）触发，调度器停止时通过 on_stop 关闭服务器
+    robot::TaskOptions web_options;
+    web_options.dedicated_thread = true;
+    web_options.on_stop = stop_web_server;
+    ok = scheduler.addTask("web", []() {
+        if (start_web_server(false) != 0) {
+            printf("Web服务启动失败，控制环继续运行\n");
+        }
+    }, 0, robot::Priority::BACKGROUND, 0, web_options) && ok;
+
+    web_server_attach_scheduler(&scheduler);
+    web_server_attach_telemetry(&telemetry);
+    web_server_attach_stream(&debug_stream.hub(robot::StreamFormat::Jpeg),
+                             &debug_stream.hub(robot::StreamFormat::BinaryRle));
+    web_server_attach_flight(FLIGHT_LOG_PATH);
+    return ok;
+}
+
+/*
+    启动视觉流水线
+    积压时预处理和寻线阶段都只处理最新一帧；多核平台上可通过 cpu 字段把各阶段分到不同核心
+    寻线结果发布给显示线程，显示不再是流水线的一个阶段
+*/
+static bool start_vision_pipeline()
+{
+    frame_slots.resize(vision_pipeline.slotCount());
+    frame_sensor_ns.assign(vision_pipeline.slotCount(), 0);
+
+    bool ok = vision_pipeline.addStage("capture", capture_stage);
+    ok = vision_pipeline.addStage("preprocess", preprocess_stage) && ok;
+    ok = vision_pipeline.addStage("track", track_stage) && ok;
+    return ok && vision_pipeline.start();
+}
+
+#ifdef ZF_DRIVER_MMIO
+#if !defined(ZF_MMIO_PWM_BASE) || !defined(ZF_MMIO_GPIO_BASE) || !defined(ZF_MMIO_GPIO_OUT)
+#error "ZF_DRIVER_MMIO 需要按数据手册给出 ZF_MMIO_PWM_BASE / ZF_MMIO_GPIO_BASE / ZF_MMIO_GPIO_OUT（见 include/zf_driver_mmio.h）"
+#endif
+
+// PWM 周期计数：内核驱动已按 period_ns 配置周期，寄存器中的占空比以控制器时钟计数
+static uint32 pwm_period_count(const struct pwm_info& info)
+{
+    return (uint32)((uint64_t)info.period_ns * info.clk_freq / 1000000000ULL);
+}
+
+/*
+    寄存器直写后端
+    映射 PWM 与 GPIO 控制器，把舵机、电机 PWM 和方向引脚绑定到寄存器，之后 pwm_set_duty / gpio_set_level
+    与执行器服务对这些路径直接写寄存器；映射或绑定失败的设备仍走设备文件
+*/
+static void mmio_backend_init()
+{
+    int pwm_window = mmio_map(ZF_MMIO_PWM_BASE, ZF_MMIO_PWM_STRIDE * 4);
+    int gpio_window = mmio_map(ZF_MMIO_GPIO_BASE, ZF_MMIO_GPIO_OUT + ZF_MMIO_GPIO_PINS);
+    if (pwm_window >= 0) {
+        mmio_bind_pwm(SERVO_MOTOR1_PWM, pwm_window, SERVO_MOTOR1_PWM_CH * ZF_MMIO_PWM_STRIDE + ZF_MMIO_PWM_LOW,
+                      pwm_period_count(servo_pwm_info), servo_pwm_info.duty_max);
+        mmio_bind_pwm(MOTOR1_PWM, pwm_window, MOTOR1_PWM_CH * ZF_MMIO_PWM_STRIDE + ZF_MMIO_PWM_LOW,
+                      pwm_period_count(motor1_pwm_info), motor1_pwm_info.duty_max);
+        mmio_bind_pwm(MOTOR2_PWM, pwm_window, MOTOR2_PWM_CH * ZF_MMIO_PWM_STRIDE + ZF_MMIO_PWM_LOW,
+                      pwm_period_count(motor2_pwm_info), motor2_pwm_info.duty_max);
+    }
+    if (gpio_window >= 0) {
+        mmio_bind_gpio(MOTOR1_DIR, gpio_window, ZF_MMIO_GPIO_OUT + MOTOR1_DIR_PIN);
+        mmio_bind_gpio(MOTOR2_DIR, gpio_window, ZF_MMIO_GPIO_OUT + MOTOR2_DIR_PIN);
+    }
+    printf("Register backend: PWM %s, GPIO %s\n", pwm_window >= 0 ? "mapped" : "device files",
+           gpio_window >= 0 ? "mapped" : "device files");
+}
+#endif
+
+
+/*
+    仿真设备：车上访问的设备文件全部在 sim_root 下生成，之后所有驱动读写这些文件
+    PWM 参数取设备树的默认值（舵机 50Hz、电机 20kHz，占空比上限 10000），IMU 为 IMU660RA（±2000dps）
+*/
+static bool sim_devices_init()
+{
+    sim_devices.reset(new robot::hal::SimDeviceTree(sim_root));
+    struct pwm_info servo = {50, 0, 10000, 0, 20000000, 0};
+    struct pwm_info motor = {20000, 0, 10000, 0, 50000, 0};
+    bool ok = sim_devices->addPwm(SERVO_MOTOR1_PWM, servo) &&
+              sim_devices->addPwm(MOTOR1_PWM, motor) &&
+              sim_devices->addPwm(MOTOR2_PWM, motor) &&
+              sim_devices->addGpio(MOTOR1_DIR) &&
+              sim_devices->addGpio(MOTOR2_DIR) &&
+              sim_devices->addEncoder(ENCODER_1) &&
+              sim_devices->addEncoder(ENCODER_2) &&
+              sim_devices->addImu("IMU660RA", 0.001065264);
+    // 按键与拨码开关为上拉输入，未按下时为高电平
+    for (const char* path : {KEY_0, KEY_1, KEY_2, KEY_3, SWITCH_0, SWITCH_1}) {
+        ok = ok && sim_devices->addGpio(path, 1);
+    }
+    if (ok) {
+        sim_devices->activate();
+        printf("Simulated devices in %s, frames from %s\n", sim_root.c_str(), sim_frames.c_str());
+    }
+    return ok;
+}
+
+/*
+    命令行参数
+    --sim[=目录]     在台式机上运行：设备文件生成在该目录下（默认 /tmp/robot_sim），退出时屏幕保存为 screen.ppm
+    --frames=路径    仿真时的摄像头输入：视频、图片目录或 glob 模式（默认 img/test_4.mp4）
+*/
+static bool parse_args(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--sim") {
+            sim_mode = true;
+        } else if (arg.compare(0, 6, "--sim=") == 0) {
+            sim_mode = true;
+            sim_root = arg.substr(6);
+        } else if (arg.compare(0, 9, "--frames=") == 0) {
+            sim_frames = arg.substr(9);
+        } else {
+            printf("用法: %s [--sim[=目录]] [--frames=视频或图片目录]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (!parse_args(argc, argv)) {
+        return -1;
+    }
+    if (main_init_task() == 1) {
+        cout << "初始化成功" << endl;
+    } else {
+        cout << "初始化失败" << endl; return -1;
+    }
+
+    // 各处理阶段的追踪区间同时写入遥测总线
+    robot::FrameTracer::instance().setSpanListener(publish_stage_telemetry);
+    if (!register_tasks() || !start_vision_pipeline()) {
+        cout << "任务注册失败" << endl; return -1;
+    }
+    display_service.start();
+    debug_stream.start();
+
+    // 飞行记录从这里开始，遥测总线上之后的记录一并写入；上一次运行的记录保留为 .prev
+    const JSON_FunctionConfigData& function_config = Function_EN_p -> JSON_FunctionConfigData_v[0];
+    if (function_config.FlightRecord_EN) {
+        robot::FlightRecorderOptions flight_options;
+        flight_options.path = FLIGHT_LOG_PATH;
+        flight_options.capacity = (size_t)function_config.FlightRecord_MB << 20;
+        flight_options.gray_every = function_config.FlightRecord_Gray_Every;
+        flight_options.max_width = image_w;
+        flight_options.max_height = image_h;
+        if (!flight_recorder.start(flight_options, &telemetry)) {
+            cout << "飞行记录启动失败" << endl;
+        }
+    }
+
+    // 控制环所在的调度线程使用实时优先级（需要root权限，失败时以普通优先级运行）
+    scheduler.setWorkerRealtimePriority(80);
+    scheduler.run([]() { return g_stop.load(); });
+
+    vision_pipeline.stop();
+    display_service.stop();
+    debug_stream.stop();
+    flight_recorder.stop();
+    park_actuators();
+    imu_stream.stop();
+    camera->close();
+    if (sim_screen) {
+        ips200_update_screen();
+        sim_screen->savePpm(sim_root + "/screen.ppm");
+    }
+    robot::FrameTracer::instance().setSpanListener(nullptr);
+    robot::FrameTracer::instance().writeChromeTrace("/tmp/robot_trace.json");
+    web_server_attach_scheduler(nullptr);
+    web_server_attach_telemetry(nullptr);
+    web_server_attach_stream(nullptr, nullptr);
+    web_server_attach_flight(nullptr);
     return 0;
 }
 
-void sigint_handler(int signum) 
+void sigint_handler(int signum)
 {
-    printf("收到Ctrl+C，程序即将退出\n");
-    
-    exit(0);
+    // 只设置退出标志，由调度器停止各任务后在主线程中退出
+    g_stop = true;
 }
 
 void cleanup()
@@ -38,8 +791,18 @@ int main_init_task()
     atexit(cleanup);
     signal(SIGINT, sigint_handler);
     setbuf(stdout, NULL);
-    ips200_init("/dev/fb0");
-    
+    if (sim_mode && !sim_devices_init()) {
+        printf("Failed to create simulated devices in %s\n", sim_root.c_str());
+        return -1;
+    }
+    if (sim_mode) {
+        sim_screen = new robot::hal::MemoryFramebuffer(240, 320);
+        screen.reset(sim_screen);
+    } else {
+        screen.reset(new robot::hal::DeviceFramebuffer("/dev/fb0"));
+    }
+    screen->open();
+
     // 显示IP地址
     display_ip_address(0, 181);
     printf("IP address displayed on screen.\n");
@@ -52,28 +815,116 @@ int main_init_task()
     imu_device_type_t type = imu.get_device_type();
     printf("IMU Device Type: %d\n", type);
 
-    for (int i = 0; i < 10; i++) {
-        // 更新所有数据
-        if (imu.update_all_data()) {
-            // 获取完整数据
-            const imu_raw_data_t& data = imu.get_raw_data();
-            
-            printf("Sample %d:\n", i + 1);
-            printf("  Acc: X=%6d, Y=%6d, Z=%6d\n", data.acc_x, data.acc_y, data.acc_z);
-            printf("  Gyro: X=%6d, Y=%6d, Z=%6d\n", data.gyro_x, data.gyro_y, data.gyro_z);
-            
-            printf("\n");
-        }
-        
-        // 延时100ms
-        usleep(100000);
+    if (!sensor_sampler.open()) {
+        printf("Failed to open encoder devices\n");
+        return -1;
+    }
+
+    // IMU 采集线程：缓冲区模式随设备数据唤醒，sysfs 模式 1kHz 轮询
+    // 缓冲区保留约 14 秒的样本，足够覆盖一次完整的绕环
+    // 启动后约1秒标定陀螺仪零偏，期间车辆需保持静止
+    robot::ImuStreamOptions imu_options;
+    imu_options.capacity = 16384;
+    imu_options.rt_priority = 70;
+    attitude.configure(imu.get_gyro_scale(), robot::AttitudeOptions());
+    imu_stream.setSampleListener([](const imu_sample_t& sample) {
+        attitude.update(sample);
+        publish_imu_telemetry(sample.data, sample.timestamp_ns);
+    });
+    if (imu_stream.start(imu_options)) {
+        sensor_sampler.setImuStream(&imu_stream);
+    } else {
+        printf("Failed to start IMU stream, sampling IMU directly\n");
+    }
+
+    // 读取配置文件
+    Sync.ConfigData_SYNC(Data_Path_p,Function_EN_p,JSON_PIDConfigData_p);
+    JSON_FunctionConfigData JSON_FunctionConfigData = Function_EN_p -> JSON_FunctionConfigData_v[0];
+
+    robot::OdometryOptions odometry_options;
+    odometry_options.meters_per_count = JSON_PIDConfigData_p -> encoder_meters_per_count;
+    odometry_options.track_width_m = JSON_PIDConfigData_p -> wheel_track_width;
+    odometry.configure(odometry_options);
+
+    robot::ControllerOptions controller_options;
+    controller_options.rate_hz = CONTROL_HZ;
+    controller_options.cascade_steering = JSON_PIDConfigData_p -> cascade_steer;
+    controller_options.motor_kff = JSON_PIDConfigData_p -> motor_kff;
+    controller_options.d_tau = JSON_PIDConfigData_p -> pid_d_tau;
+    controller.configure(controller_options);
+
+    const JSON_TrackConfigData& track_config = Data_Path_p -> JSON_TrackConfigData_v[0];
+    robot::SpeedPlannerOptions planner_options;
+    planner_options.max_lateral_accel = track_config.SpeedPlan_Lateral_Acc;
+    planner_options.max_accel = track_config.SpeedPlan_Acc;
+    planner_options.max_decel = track_config.SpeedPlan_Dec;
+    planner_options.min_speed = track_config.SpeedPlan_Min_Speed;
+    planner_options.horizon_speed = track_config.SpeedPlan_Horizon_Speed;
+    speed_planner.configure(planner_options);
+    speed_plan_enabled = track_config.SpeedPlan_EN;
+
+    servo_pwm.info(servo_pwm_info);
+    motor1_pwm.info(motor1_pwm_info);
+    motor2_pwm.info(motor2_pwm_info);
+#ifdef ZF_DRIVER_MMIO
+    if (!sim_mode) {
+        mmio_backend_init();
     }
+#endif
+
+    // 执行器服务：每通道写入间隔不小于PWM周期（舵机50Hz时20ms），启动失败时控制任务直接写设备
+    servo_channel = actuators.addPwm(SERVO_MOTOR1_PWM, servo_pwm_info.period_ns);
+    motor1_channel = actuators.addPwm(MOTOR1_PWM, motor1_pwm_info.period_ns);
+    motor2_channel = actuators.addPwm(MOTOR2_PWM, motor2_pwm_info.period_ns);
+    motor1_dir_channel = actuators.addGpio(MOTOR1_DIR);
+    motor2_dir_channel = actuators.addGpio(MOTOR2_DIR);
+    robot::ActuatorServiceOptions actuator_options;
+    actuator_options.rt_priority = 75;
+    if (!actuators.start(actuator_options)) {
+        printf("Failed to start actuator service, writing PWM from the control task\n");
+    }
+
+    if (sim_mode) {
+        camera.reset(new robot::hal::FileCamera(sim_frames, 60, true));
+    } else if (JSON_FunctionConfigData.Camera_EN == DEMO_VIDEO) {
+        camera.reset(new robot::hal::FileCamera("img/test_4.mp4", 0, false));
+    } else {
+        camera.reset(new robot::hal::V4l2Camera("/dev/video0", 320, 240, 60));
+    }
+    if (!camera->open()) {
+        printf("Failed to open camera\n");
+        return -1;
+    }
+    // 比赛由控制任务在陀螺仪零偏标定完成后开始，之前舵机回中、电机停转
+    Function_EN_p -> Game_EN = false;
+    Function_EN_p -> Loop_Kind_EN = CAMERA_CATCH_LOOP;
 
     return 1;
 }
 
+/*
+    编码器与IMU一次批量采样，编码器增量送入里程计，并写入遥测总线
+    IMU 采集线程运行时 IMU 遥测由采集线程逐样本写入
+*/
 void pit_callback()
 {
-    encoder_get_count(ENCODER_1);
-    encoder_get_count(ENCODER_2);
+    robot::SensorSample sample;
+    if (sensor_sampler.sample(sample)) {
+        odometry.update(sample.timestamp_ns, sample.encoder_left, sample.encoder_right);
+    }
+
+    robot::OdometryState odom;
+    odometry.state(odom);
+    robot::TelemetryEncoder encoder_record;
+    encoder_record.left = sample.encoder_left;
+    encoder_record.right = sample.encoder_right;
+    encoder_record.left_cps = odom.left_cps;
+    encoder_record.right_cps = odom.right_cps;
+    encoder_record.speed = odom.speed;
+    encoder_record.distance = (float)odom.distance;
+    telemetry.push(robot::TelemetryType::Encoder, encoder_record, sample.timestamp_ns);
+
+    if (sample.imu_valid && !imu_stream.isRunning()) {
+        publish_imu_telemetry(sample.imu, sample.timestamp_ns);
+    }
 }
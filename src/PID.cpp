@@ -31,3 +31,52 @@ void PIDCalculate(PID &pid,PIDStatus *pidstatus)
   }
 }
 
+void PIDCalculateFixed(PID &pid,PIDStatus *pidstatus,float dt)
+{
+  if (dt <= 0) return;
+
+  pidstatus->departure = (pidstatus->target) - (pidstatus->present);
+
+  pid.P = pidstatus->departure * pid.Kp;
+  MaxMinf(&(pid.P),pid.Plimit);
+
+  // 微分作用于测量值，经一阶低通
+  float d_raw = 0;
+  if (pidstatus->started) {
+    d_raw = -(pidstatus->present - pidstatus->before) / dt * pid.Kd;
+  }
+  float alpha = (pid.Dtau > 0) ? dt / (pid.Dtau + dt) : 1.0f;
+  pidstatus->d_filtered += alpha * (d_raw - pidstatus->d_filtered);
+  pid.D = pidstatus->d_filtered;
+  MaxMinf(&(pid.D),pid.Dlimit);
+
+  // 条件积分：输出饱和且偏差与输出同向时不再累积
+  float unclamped = pid.P + pid.I + pid.D + pidstatus->feedforward;
+  bool winding = (unclamped > pid.Reslimit && pidstatus->departure > 0) ||
+                 (unclamped < -pid.Reslimit && pidstatus->departure < 0);
+  if (!winding) {
+    pid.I += pidstatus->departure * dt * pid.Ki;
+    MaxMinf(&(pid.I),pid.Ilimit);
+  }
+
+  float res = pid.P + pid.I + pid.D + pidstatus->feedforward;
+  pidstatus->saturated = (res > pid.Reslimit || res < -pid.Reslimit);
+  pidstatus->Res = res;
+  MaxMinf(&(pidstatus->Res),pid.Reslimit);
+
+  pidstatus->before = pidstatus->present;
+  pidstatus->prev_departure = pidstatus->departure;
+  pidstatus->started = true;
+}
+
+void PIDReset(PID &pid,PIDStatus *pidstatus)
+{
+  pid.P = 0;
+  pid.I = 0;
+  pid.D = 0;
+  pidstatus->Res = 0;
+  pidstatus->d_filtered = 0;
+  pidstatus->prev_departure = 0;
+  pidstatus->saturated = false;
+  pidstatus->started = false;
+}
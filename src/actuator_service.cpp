@@ -0,0 +1,233 @@
+#include "actuator_service.hpp"
+#include <cerrno>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include "frame_trace.hpp"
+#include "rt_thread.hpp"
+#include "zf_driver_file.h"
+#include "zf_driver_mmio.h"
+
+namespace robot {
+
+static int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ActuatorService::ActuatorService() {
+    sem_init(&wakeup_, 0, 0);
+}
+
+ActuatorService::~ActuatorService() {
+    stop();
+    sem_destroy(&wakeup_);
+}
+
+int ActuatorService::addChannel(const char* path, bool gpio, uint32_t period_ns) {
+    if (running_ || channel_count_ >= MAX_CHANNELS) {
+        std::cerr << "ActuatorService: 无法添加通道 " << path << std::endl;
+        return -1;
+    }
+    Channel& channel = channels_[channel_count_];
+    channel.path = path;
+    channel.gpio = gpio;
+    channel.period_ns = period_ns;
+    return channel_count_++;
+}
+
+int ActuatorService::addPwm(const char* path, uint32_t period_ns) {
+    return addChannel(path, false, period_ns);
+}
+
+int ActuatorService::addGpio(const char* path) {
+    return addChannel(path, true, 0);
+}
+
+bool ActuatorService::start(const ActuatorServiceOptions& options) {
+    if (running_) {
+        std::cerr << "ActuatorService: 已经在运行" << std::endl;
+        return false;
+    }
+    for (int i = 0; i < channel_count_; ++i) {
+#ifdef ZF_DRIVER_MMIO
+        // 已绑定寄存器的通道直接写寄存器，不需要设备句柄
+        channels_[i].mmio = mmio_find(channels_[i].path);
+        if (channels_[i].mmio >= 0) {
+            continue;
+        }
+#endif
+        channels_[i].fd = file_handle_get(channels_[i].path, O_WRONLY);
+        if (channels_[i].fd < 0) {
+            std::cerr << "ActuatorService: 无法打开设备 " << channels_[i].path << std::endl;
+            return false;
+        }
+    }
+    stop_ = false;
+    running_ = true;
+    thread_ = std::thread(&ActuatorService::run, this, options);
+    return true;
+}
+
+void ActuatorService::stop() {
+    if (!running_) {
+        return;
+    }
+    stop_ = true;
+    sem_post(&wakeup_);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    running_ = false;
+}
+
+void ActuatorService::set(int channel, uint32_t value) {
+    if (channel < 0 || channel >= channel_count_) {
+        return;
+    }
+    Channel& c = channels_[channel];
+    c.command_ns.store(steady_now_ns(), std::memory_order_relaxed);
+    uint64_t old = c.command.load(std::memory_order_relaxed);
+    uint64_t next;
+    do {
+        next = ((old >> 32) + 1) << 32 | value;
+    } while (!c.command.compare_exchange_weak(old, next, std::memory_order_release, std::memory_order_relaxed));
+    if (!pending_.exchange(true, std::memory_order_acq_rel)) {
+        sem_post(&wakeup_);
+    }
+}
+
+void ActuatorService::setFrame(uint64_t frame_id, int64_t sensor_ns) {
+    frame_.store(FrameTag{frame_id, sensor_ns});
+    // 服务线程可能已处理完本帧的命令，唤醒它以记录本帧
+    if (!pending_.exchange(true, std::memory_order_acq_rel)) {
+        sem_post(&wakeup_);
+    }
+}
+
+bool ActuatorService::writeChannel(Channel& channel, uint32_t value) {
+#ifdef ZF_DRIVER_MMIO
+    if (channel.mmio >= 0) {
+        mmio_write(channel.mmio, value);
+        return true;
+    }
+#endif
+    if (channel.gpio) {
+        uint8 level = value ? 0x31 : 0x30;
+        return fd_write_dat(channel.fd, level) == 0;
+    }
+    uint16 duty = (uint16)value;
+    return fd_write_dat(channel.fd, duty) == 0;
+}
+
+// 处理所有通道的最新命令，返回距下一个可写时刻的纳秒数（没有等待中的命令时返回 -1）
+// flush 为 true 时忽略写入间隔（停止前写出最后的命令）
+int64_t ActuatorService::service(int64_t now_ns, bool flush) {
+    // 先取帧标记再读命令：读到的命令不早于该帧提交的命令
+    FrameTag frame = {0, 0};
+    bool has_frame = frame_.load(frame);
+    bool caught_up = true;
+    int64_t next_ns = -1;
+    for (int i = 0; i < channel_count_; ++i) {
+        Channel& c = channels_[i];
+        uint64_t command = c.command.load(std::memory_order_acquire);
+        uint32_t seq = (uint32_t)(command >> 32);
+        uint32_t value = (uint32_t)command;
+        if (seq == c.written_seq) {
+            continue;
+        }
+        if (c.has_written && value == c.written_value) {
+            c.written_seq = seq;
+            c.unchanged.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (!flush && c.has_written && c.period_ns > 0) {
+            int64_t elapsed = now_ns - c.written_ns;
+            if (elapsed < (int64_t)c.period_ns) {
+                int64_t wait = c.period_ns - elapsed;
+                next_ns = next_ns < 0 || wait < next_ns ? wait : next_ns;
+                caught_up = false;
+                continue;
+            }
+        }
+
+        int64_t command_ns = c.command_ns.load(std::memory_order_relaxed);
+        bool ok = writeChannel(c, value);
+        int64_t done_ns = steady_now_ns();
+        c.written_seq = seq;
+        if (!ok) {
+            c.errors.fetch_add(1, std::memory_order_relaxed);
+            caught_up = false;
+            continue;
+        }
+        c.written_value = value;
+        c.has_written = true;
+        c.written_ns = done_ns;
+        c.value.store(value, std::memory_order_relaxed);
+        c.writes.fetch_add(1, std::memory_order_relaxed);
+        if (done_ns > command_ns) {
+            c.latency_us.record((uint64_t)(done_ns - command_ns) / 1000);
+        }
+    }
+
+    // 该帧的命令已全部生效
+    if (has_frame && caught_up && (!has_actuated_ || frame.frame_id != actuated_frame_)) {
+        FrameTracer::instance().recordFrameActuated(frame.frame_id, frame.sensor_ns, steady_now_ns());
+        actuated_frame_ = frame.frame_id;
+        has_actuated_ = true;
+    }
+    return next_ns;
+}
+
+// 服务线程：有新命令时由 set() 唤醒；命令因写入间隔暂缓时定时唤醒
+void ActuatorService::run(ActuatorServiceOptions options) {
+    setThreadName("actuator");
+    if (options.cpu >= 0) {
+        setThreadAffinity(options.cpu);
+    }
+    if (options.rt_priority > 0) {
+        setThreadRealtimePriority(options.rt_priority);
+    }
+
+    for (;;) {
+        // 先清除唤醒标志再读取命令，之后提交的命令会重新唤醒
+        pending_.store(false, std::memory_order_seq_cst);
+        bool stopping = stop_.load(std::memory_order_acquire);
+        int64_t wait_ns = service(steady_now_ns(), stopping);
+        if (stopping) {
+            break;
+        }
+        if (wait_ns < 0) {
+            while (sem_wait(&wakeup_) != 0 && errno == EINTR) {
+            }
+            continue;
+        }
+        // 截止时刻取单调时钟：系统时间被 NTP/手动校时跳变时不会睡过头或提前醒来
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        int64_t nsec = deadline.tv_nsec + wait_ns;
+        deadline.tv_sec += nsec / 1000000000LL;
+        deadline.tv_nsec = nsec % 1000000000LL;
+        while (sem_clockwait(&wakeup_, CLOCK_MONOTONIC, &deadline) != 0 && errno == EINTR) {
+        }
+    }
+}
+
+ActuatorChannelStats ActuatorService::stats(int channel) const {
+    ActuatorChannelStats stats;
+    if (channel < 0 || channel >= channel_count_) {
+        return stats;
+    }
+    const Channel& c = channels_[channel];
+    stats.commands = c.command.load(std::memory_order_acquire) >> 32;
+    stats.writes = c.writes.load(std::memory_order_relaxed);
+    stats.unchanged = c.unchanged.load(std::memory_order_relaxed);
+    stats.errors = c.errors.load(std::memory_order_relaxed);
+    uint64_t handled = stats.writes + stats.unchanged + stats.errors;
+    stats.coalesced = stats.commands > handled ? stats.commands - handled : 0;
+    stats.value = c.value.load(std::memory_order_relaxed);
+    stats.latency_us = c.latency_us.snapshot();
+    return stats;
+}
+
+} // namespace robot
@@ -0,0 +1,254 @@
+#include "attitude_estimator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace robot {
+
+static const float PI_F = 3.14159265358979f;
+
+static float wrap_pi(float angle) {
+    while (angle > PI_F) {
+        angle -= 2 * PI_F;
+    }
+    while (angle <= -PI_F) {
+        angle += 2 * PI_F;
+    }
+    return angle;
+}
+
+AttitudeEstimator::AttitudeEstimator(double gyro_scale, const AttitudeOptions& options) {
+    configure(gyro_scale, options);
+}
+
+void AttitudeEstimator::configure(double gyro_scale, const AttitudeOptions& options) {
+    gyro_scale_ = gyro_scale;
+    options_ = options;
+    bias_[0] = bias_[1] = bias_[2] = 0;
+    heading_ = 0;
+    resetFilter();
+    seen_calib_gen_ = calib_gen_.load(std::memory_order_acquire);
+    calibrated_.store(false, std::memory_order_release);
+}
+
+void AttitudeEstimator::resetFilter() {
+    have_last_ = false;
+    q_[0] = 1;
+    q_[1] = q_[2] = q_[3] = 0;
+    last_yaw_ = 0;
+    calib_count_ = 0;
+}
+
+void AttitudeEstimator::requestCalibration() {
+    calib_gen_.fetch_add(1, std::memory_order_release);
+}
+
+void AttitudeEstimator::armYawTrigger(double degrees) {
+    trigger_target_.store(std::fabs(degrees) * M_PI / 180.0, std::memory_order_relaxed);
+    trigger_gen_.fetch_add(1, std::memory_order_release);
+}
+
+void AttitudeEstimator::disarmYawTrigger() {
+    trigger_target_.store(0, std::memory_order_relaxed);
+    trigger_gen_.fetch_add(1, std::memory_order_release);
+}
+
+bool AttitudeEstimator::yawTriggered(int64_t* trigger_ns) const {
+    uint32_t fired = triggered_gen_.load(std::memory_order_acquire);
+    if (fired != trigger_gen_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    if (trigger_ns) {
+        *trigger_ns = trigger_ns_.load(std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool AttitudeEstimator::update(const imu_sample_t& sample) {
+    uint32_t calib_gen = calib_gen_.load(std::memory_order_acquire);
+    if (calib_gen != seen_calib_gen_) {
+        seen_calib_gen_ = calib_gen;
+        calibrated_.store(false, std::memory_order_release);
+        resetFilter();
+    }
+
+    if (!calibrated_.load(std::memory_order_relaxed)) {
+        calibrate(sample);
+        return false;
+    }
+
+    const imu_raw_data_t& raw = sample.data;
+    float gyro[3] = {
+        static_cast<float>((raw.gyro_x - bias_[0]) * gyro_scale_),
+        static_cast<float>((raw.gyro_y - bias_[1]) * gyro_scale_),
+        static_cast<float>((raw.gyro_z - bias_[2]) * gyro_scale_),
+    };
+    float acc[3] = {static_cast<float>(raw.acc_x), static_cast<float>(raw.acc_y), static_cast<float>(raw.acc_z)};
+
+    int64_t gap = sample.timestamp_ns - last_ns_;
+    if (have_last_ && gap > 0 && gap <= options_.max_gap_ns) {
+        integrate(gyro, acc, gap / 1e9f);
+    }
+    have_last_ = true;
+    last_ns_ = sample.timestamp_ns;
+
+    publish(sample, gyro[2]);
+    checkYawTrigger(sample.timestamp_ns);
+    return true;
+}
+
+// 静止时累计陀螺仪均值作为零偏，平均加速度方向确定初始横滚与俯仰（偏航从0开始）
+void AttitudeEstimator::calibrate(const imu_sample_t& sample) {
+    const imu_raw_data_t& raw = sample.data;
+    const int16_t gyro[3] = {raw.gyro_x, raw.gyro_y, raw.gyro_z};
+    const int16_t acc[3] = {raw.acc_x, raw.acc_y, raw.acc_z};
+
+    if (calib_count_ == 0) {
+        calib_start_ns_ = sample.timestamp_ns;
+        for (int i = 0; i < 3; ++i) {
+            calib_gyro_sum_[i] = 0;
+            calib_acc_sum_[i] = 0;
+            calib_min_[i] = calib_max_[i] = gyro[i];
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        calib_gyro_sum_[i] += gyro[i];
+        calib_acc_sum_[i] += acc[i];
+        calib_min_[i] = std::min(calib_min_[i], gyro[i]);
+        calib_max_[i] = std::max(calib_max_[i], gyro[i]);
+    }
+    calib_count_++;
+
+    if (options_.calibration_ns > 0 && sample.timestamp_ns - calib_start_ns_ < options_.calibration_ns) {
+        return;
+    }
+
+    if (options_.calibration_ns > 0) {
+        for (int i = 0; i < 3; ++i) {
+            if ((calib_max_[i] - calib_min_[i]) * gyro_scale_ > options_.calibration_max_range) {
+                std::cerr << "AttitudeEstimator: 标定期间检测到运动，重新标定" << std::endl;
+                calib_count_ = 0;
+                return;
+            }
+        }
+        for (int i = 0; i < 3; ++i) {
+            bias_[i] = static_cast<float>(calib_gyro_sum_[i] / calib_count_);
+        }
+    }
+
+    double ax = calib_acc_sum_[0] / calib_count_;
+    double ay = calib_acc_sum_[1] / calib_count_;
+    double az = calib_acc_sum_[2] / calib_count_;
+    float roll = static_cast<float>(std::atan2(ay, az));
+    float pitch = static_cast<float>(std::atan2(-ax, std::sqrt(ay * ay + az * az)));
+    float cr = std::cos(roll / 2), sr = std::sin(roll / 2);
+    float cp = std::cos(pitch / 2), sp = std::sin(pitch / 2);
+    q_[0] = cr * cp;
+    q_[1] = sr * cp;
+    q_[2] = cr * sp;
+    q_[3] = -sr * sp;
+    last_yaw_ = 0;
+    have_last_ = true;
+    last_ns_ = sample.timestamp_ns;
+    calibrated_.store(true, std::memory_order_release);
+    publish(sample, 0);
+}
+
+// 四元数积分，并按所选滤波器用加速度方向修正横滚与俯仰（偏航只由陀螺仪决定）
+void AttitudeEstimator::integrate(const float gyro[3], const float acc[3], float dt) {
+    float q0 = q_[0], q1 = q_[1], q2 = q_[2], q3 = q_[3];
+    float gx = gyro[0], gy = gyro[1], gz = gyro[2];
+    float ax = acc[0], ay = acc[1], az = acc[2];
+    float acc_norm = std::sqrt(ax * ax + ay * ay + az * az);
+
+    if (options_.filter == AttitudeFilter::COMPLEMENTARY && acc_norm > 0) {
+        ax /= acc_norm;
+        ay /= acc_norm;
+        az /= acc_norm;
+        // 估计的重力方向与测量方向的叉积即姿态误差
+        float vx = 2 * (q1 * q3 - q0 * q2);
+        float vy = 2 * (q0 * q1 + q2 * q3);
+        float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+        float kp = 1.0f / options_.complementary_tau_s;
+        gx += kp * (ay * vz - az * vy);
+        gy += kp * (az * vx - ax * vz);
+        gz += kp * (ax * vy - ay * vx);
+    }
+
+    float qdot0 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    float qdot1 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    float qdot2 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    float qdot3 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    if (options_.filter == AttitudeFilter::MADGWICK && acc_norm > 0) {
+        ax /= acc_norm;
+        ay /= acc_norm;
+        az /= acc_norm;
+        float _2q0 = 2 * q0, _2q1 = 2 * q1, _2q2 = 2 * q2, _2q3 = 2 * q3;
+        float _4q0 = 4 * q0, _4q1 = 4 * q1, _4q2 = 4 * q2;
+        float _8q1 = 8 * q1, _8q2 = 8 * q2;
+        float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+        float s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+        float s1 = _4q1 * q3q3 - _2q3 * ax + 4 * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+        float s2 = 4 * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+        float s3 = 4 * q1q1 * q3 - _2q1 * ax + 4 * q2q2 * q3 - _2q2 * ay;
+        float s_norm = std::sqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+        if (s_norm > 0) {
+            float k = options_.madgwick_beta / s_norm;
+            qdot0 -= k * s0;
+            qdot1 -= k * s1;
+            qdot2 -= k * s2;
+            qdot3 -= k * s3;
+        }
+    }
+
+    q0 += qdot0 * dt;
+    q1 += qdot1 * dt;
+    q2 += qdot2 * dt;
+    q3 += qdot3 * dt;
+    float norm = std::sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q_[0] = q0 / norm;
+    q_[1] = q1 / norm;
+    q_[2] = q2 / norm;
+    q_[3] = q3 / norm;
+}
+
+void AttitudeEstimator::publish(const imu_sample_t& sample, float yaw_rate) {
+    const float q0 = q_[0], q1 = q_[1], q2 = q_[2], q3 = q_[3];
+    AttitudeState state;
+    state.timestamp_ns = sample.timestamp_ns;
+    for (int i = 0; i < 4; ++i) {
+        state.q[i] = q_[i];
+    }
+    state.roll = std::atan2(2 * (q0 * q1 + q2 * q3), 1 - 2 * (q1 * q1 + q2 * q2));
+    state.pitch = std::asin(std::max(-1.0f, std::min(1.0f, 2 * (q0 * q2 - q3 * q1))));
+    state.yaw = std::atan2(2 * (q0 * q3 + q1 * q2), 1 - 2 * (q2 * q2 + q3 * q3));
+
+    // 航向展开：累加相邻两次偏航角之差（差值折回 ±π 以内）
+    heading_ += wrap_pi(state.yaw - last_yaw_);
+    last_yaw_ = state.yaw;
+    state.heading = heading_;
+    state.yaw_rate = yaw_rate;
+    for (int i = 0; i < 3; ++i) {
+        state.gyro_bias[i] = bias_[i];
+    }
+    state_.store(state);
+}
+
+void AttitudeEstimator::checkYawTrigger(int64_t timestamp_ns) {
+    uint32_t gen = trigger_gen_.load(std::memory_order_acquire);
+    if (gen != seen_trigger_gen_) {
+        seen_trigger_gen_ = gen;
+        double target = trigger_target_.load(std::memory_order_relaxed);
+        trigger_active_ = target > 0;
+        trigger_ref_ = heading_;
+        return;
+    }
+    if (trigger_active_ && std::fabs(heading_ - trigger_ref_) >= trigger_target_.load(std::memory_order_relaxed)) {
+        trigger_active_ = false;
+        trigger_ns_.store(timestamp_ns, std::memory_order_relaxed);
+        triggered_gen_.store(gen, std::memory_order_release);
+    }
+}
+
+} // namespace robot
@@ -0,0 +1,161 @@
+#include "binary_rle.hpp"
+
+#include <cstring>
+
+namespace robot {
+
+static const size_t HEADER_SIZE = 6;
+static const uint8_t MODE_PACKED = 0;
+static const uint8_t MODE_RLE = 1;
+
+static void putHeader(std::string* out, uint8_t mode, int width, int height) {
+    out->push_back('B');
+    out->push_back((char)mode);
+    out->push_back((char)(width & 0xFF));
+    out->push_back((char)(width >> 8));
+    out->push_back((char)(height & 0xFF));
+    out->push_back((char)(height >> 8));
+}
+
+static void putVarint(std::string* out, uint32_t value) {
+    while (value >= 0x80) {
+        out->push_back((char)(value | 0x80));
+        value >>= 7;
+    }
+    out->push_back((char)value);
+}
+
+// 从 x 开始找第一个颜色不是 white 的位置；二值化结果只有 0 和 255，整 8 字节相同时一次跳过
+static int runEnd(const uint8_t* row, int x, int width, bool white) {
+    const uint64_t same = white ? ~0ULL : 0ULL;
+    while (x + 8 <= width) {
+        uint64_t word;
+        std::memcpy(&word, row + x, sizeof(word));
+        if (word != same) {
+            break;
+        }
+        x += 8;
+    }
+    while (x < width && (row[x] != 0) == white) {
+        x++;
+    }
+    return x;
+}
+
+static void encodePacked(const uint8_t* src, int width, int height, int stride, std::string* out) {
+    out->clear();
+    putHeader(out, MODE_PACKED, width, height);
+    uint8_t byte = 0;
+    int bits = 0;
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = src + (size_t)y * stride;
+        for (int x = 0; x < width; ++x) {
+            byte = (uint8_t)((byte << 1) | (row[x] != 0));
+            if (++bits == 8) {
+                out->push_back((char)byte);
+                byte = 0;
+                bits = 0;
+            }
+        }
+    }
+    if (bits > 0) {
+        out->push_back((char)(byte << (8 - bits)));
+    }
+}
+
+bool encodeBinaryRle(const uint8_t* src, int width, int height, int stride, std::string* out) {
+    if (src == nullptr || out == nullptr || width <= 0 || height <= 0 || width > 0xFFFF || height > 0xFFFF ||
+        stride < width) {
+        return false;
+    }
+    const size_t packed_size = HEADER_SIZE + ((size_t)width * height + 7) / 8;
+    out->clear();
+    out->reserve(packed_size);
+    putHeader(out, MODE_RLE, width, height);
+
+    // 游程跨行连续，只在颜色变化时输出
+    bool white = false;
+    uint32_t run = 0;
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = src + (size_t)y * stride;
+        int x = 0;
+        while (x < width) {
+            int end = runEnd(row, x, width, white);
+            run += (uint32_t)(end - x);
+            x = end;
+            if (x < width) {
+                putVarint(out, run);
+                white = !white;
+                run = 0;
+            }
+        }
+        if (out->size() >= packed_size) {
+            encodePacked(src, width, height, stride, out);
+            return true;
+        }
+    }
+    putVarint(out, run);
+    if (out->size() > packed_size) {
+        encodePacked(src, width, height, stride, out);
+    }
+    return true;
+}
+
+bool decodeBinaryRle(const std::string& data, std::vector<uint8_t>* dst, int* width, int* height) {
+    if (data.size() < HEADER_SIZE || data[0] != 'B' || dst == nullptr) {
+        return false;
+    }
+    const uint8_t* p = (const uint8_t*)data.data();
+    int w = p[2] | (p[3] << 8);
+    int h = p[4] | (p[5] << 8);
+    size_t total = (size_t)w * h;
+    dst->assign(total, 0);
+    const uint8_t* end = p + data.size();
+    p += HEADER_SIZE;
+
+    if (data[1] == (char)MODE_PACKED) {
+        if ((size_t)(end - p) < (total + 7) / 8) {
+            return false;
+        }
+        for (size_t i = 0; i < total; ++i) {
+            (*dst)[i] = (p[i / 8] >> (7 - i % 8)) & 1 ? 255 : 0;
+        }
+    } else if (data[1] == (char)MODE_RLE) {
+        size_t pos = 0;
+        bool white = false;
+        while (pos < total) {
+            uint32_t run = 0;
+            int shift = 0;
+            for (;;) {
+                if (p == end || shift > 28) {
+                    return false;
+                }
+                uint8_t byte = *p++;
+                run |= (uint32_t)(byte & 0x7F) << shift;
+                shift += 7;
+                if ((byte & 0x80) == 0) {
+                    break;
+                }
+            }
+            if (run > total - pos) {
+                return false;
+            }
+            if (white) {
+                std::memset(dst->data() + pos, 255, run);
+            }
+            pos += run;
+            white = !white;
+        }
+    } else {
+        return false;
+    }
+    if (width) {
+        *width = w;
+    }
+    if (height) {
+        *height = h;
+    }
+    return true;
+}
+
+} // namespace robot
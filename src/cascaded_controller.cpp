@@ -0,0 +1,96 @@
+#include "cascaded_controller.hpp"
+
+namespace robot {
+
+CascadedController::CascadedController(PID& angle_rate, PID& servo, PID& motor, const ControllerOptions& options)
+    : angle_rate_pid_(angle_rate)
+    , servo_pid_(servo)
+    , motor_pid_(motor) {
+    configure(options);
+}
+
+void CascadedController::configure(const ControllerOptions& options) {
+    options_ = options;
+    if (options_.rate_hz <= 0) {
+        options_.rate_hz = 100;
+    }
+    dt_ = 1.0f / options_.rate_hz;
+    angle_rate_pid_.Dtau = options_.d_tau;
+    servo_pid_.Dtau = options_.d_tau;
+    motor_pid_.Dtau = options_.d_tau;
+    reset();
+}
+
+void CascadedController::reset() {
+    PIDReset(angle_rate_pid_, &angle_rate_status_);
+    PIDReset(servo_pid_, &servo_status_);
+    PIDReset(motor_pid_, &motor_status_);
+    last_ns_ = 0;
+}
+
+void CascadedController::checkInterval(int64_t timestamp_ns) {
+    if (timestamp_ns <= 0) {
+        return;
+    }
+    if (last_ns_ > 0 && timestamp_ns > last_ns_) {
+        int64_t interval = timestamp_ns - last_ns_;
+        int64_t period = 1000000000LL / options_.rate_hz;
+        interval_us_.record((uint64_t)(interval / 1000));
+        if (interval * 2 > period * 3) {
+            late_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (interval > period * options_.max_missed_periods) {
+            resets_.fetch_add(1, std::memory_order_relaxed);
+            reset();
+        }
+    }
+    last_ns_ = timestamp_ns;
+}
+
+ControllerOutput CascadedController::step(const ControllerInput& input) {
+    steps_.fetch_add(1, std::memory_order_relaxed);
+    checkInterval(input.timestamp_ns);
+
+    ControllerOutput output;
+    if (!input.enable) {
+        reset();
+        return output;
+    }
+
+    // 转向：目标为中线偏差为0
+    if (options_.cascade_steering) {
+        angle_rate_status_.target = 0;
+        angle_rate_status_.present = input.pixel_error;
+        PIDCalculateFixed(angle_rate_pid_, &angle_rate_status_, dt_);
+        output.yaw_rate_target = angle_rate_status_.Res;
+
+        servo_status_.target = output.yaw_rate_target;
+        servo_status_.present = input.yaw_rate;
+    } else {
+        servo_status_.target = 0;
+        servo_status_.present = input.pixel_error;
+    }
+    PIDCalculateFixed(servo_pid_, &servo_status_, dt_);
+    output.servo = servo_status_.Res;
+    output.servo_saturated = servo_status_.saturated;
+
+    // 速度：PID 闭环 + 目标速度前馈
+    motor_status_.target = input.speed_target;
+    motor_status_.present = input.speed_present;
+    motor_status_.feedforward = options_.motor_kff * input.speed_target;
+    PIDCalculateFixed(motor_pid_, &motor_status_, dt_);
+    output.motor = motor_status_.Res;
+    output.motor_saturated = motor_status_.saturated;
+    return output;
+}
+
+ControllerStats CascadedController::stats() const {
+    ControllerStats stats;
+    stats.steps = steps_.load(std::memory_order_relaxed);
+    stats.late = late_.load(std::memory_order_relaxed);
+    stats.resets = resets_.load(std::memory_order_relaxed);
+    stats.interval_us = interval_us_.snapshot();
+    return stats;
+}
+
+} // namespace robot
@@ -0,0 +1,50 @@
+#include "debug_stream.hpp"
+
+namespace robot {
+
+std::shared_ptr<const StreamPacket> StreamHub::wait(uint64_t after_seq, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto ready = [&]() { return closed_ || (packet_ && packet_->seq > after_seq); };
+    if (!ready()) {
+        waiting_.fetch_add(1, std::memory_order_release);
+        cv_.wait_for(lock, timeout, ready);
+        waiting_.fetch_sub(1, std::memory_order_release);
+    }
+    if (closed_ || !packet_ || packet_->seq <= after_seq) {
+        return nullptr;
+    }
+    return packet_;
+}
+
+void StreamHub::publish(std::string data) {
+    auto packet = std::make_shared<StreamPacket>();
+    packet->data = std::move(data);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        packet->seq = seq_.load(std::memory_order_relaxed) + 1;
+        seq_.store(packet->seq, std::memory_order_relaxed);
+        packet_ = std::move(packet);
+    }
+    cv_.notify_all();
+}
+
+void StreamHub::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        packet_.reset();
+    }
+    cv_.notify_all();
+}
+
+void StreamHub::open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = false;
+}
+
+bool StreamHub::isClosed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_;
+}
+
+} // namespace robot
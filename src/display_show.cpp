@@ -1,4 +1,5 @@
 #include "display_show.h"
+#include "rgb565_scaler.hpp"
 #include <sys/socket.h>
 #include <netdb.h>
 #include <ifaddrs.h>
@@ -9,45 +10,58 @@
 /**
  * @brief 将OpenCV的Mat图像显示到IPS200屏幕上
  * @param img 输入的图像（支持BGR或灰度格式）
- * @note 图像将被自动缩放以适应屏幕分辨率（假设屏幕分辨率为IPS200_WIDTH x IPS200_HEIGHT）
+ * @note 图像按最近邻缩放到 240x180，缩放与 RGB565 转换一次遍历直接写入显示缓冲，再把改动的区域刷新到屏幕
  */
 void displayMatOnIPS200(const cv::Mat& img) {
     
     // 检查输入图像是否有效
-    if (img.empty()) {
+    if (img.empty() || img.depth() != CV_8U || (img.channels() != 3 && img.channels() != 1)) {
         return;
     }
-    
-    // 转换图像颜色空间（BGR -> RGB565）并缩放尺寸
-    cv::Mat resizedImg;
-    cv::resize(img, resizedImg, cv::Size(240, 180));
-    
-    // 根据输入图像类型处理
-    for (uint16_t y = 0; y < 180; ++y) {
-        for (uint16_t x = 0; x < 240; ++x) {
-            cv::Vec3b pixel = resizedImg.at<cv::Vec3b>(y, x);
-            
-            // 将BGR转换为RGB565 (5-6-5格式)
-            uint16_t color = ((pixel[2] >> 3) << 11) |  // R
-                             ((pixel[1] >> 2) << 5)  |  // G
-                             (pixel[0] >> 3);           // B
-            
-            // 绘制像素点
-            ips200_draw_point(x, y, color);
-        }
+
+    // 缩放表按输入尺寸缓存（只在显示阶段调用）
+    static robot::Rgb565Scaler scaler;
+    robot::PixelFormat format = img.channels() == 3 ? robot::PixelFormat::Bgr : robot::PixelFormat::Gray;
+    if (!scaler.matches(img.cols, img.rows, 240, 180, format)) {
+        scaler.configure(img.cols, img.rows, 240, 180, format);
+    }
+
+    int stride = 0;
+    uint16 *dst = ips200_buffer(0, 0, 240, 180, &stride);
+    if (dst == NULL) {
+        return;
+    }
+    scaler.convert(img.data, (int)img.step, dst, stride);
+    ips200_update_screen();
+}
+
+void display_status_line(int line, const char *text)
+{
+    // 每行上次显示的内容，相同则跳过；变短时用空格覆盖多出的旧字符
+    static std::string shown[DISPLAY_STATUS_LINES];
+    if (line < 0 || line >= DISPLAY_STATUS_LINES || shown[line] == text) {
+        return;
+    }
+    std::string padded = text;
+    if (padded.size() < shown[line].size()) {
+        padded.append(shown[line].size() - padded.size(), ' ');
     }
+    ips200_show_string(0, DISPLAY_STATUS_Y + 16 * line, padded.c_str());
+    shown[line] = text;
 }
 
 void display_data(int y,const char dat[],int data,int num)
 {
     ips200_show_string(0,16*y,dat);
     ips200_show_int(8*(strlen(dat)),16*y,int32(data),num);
+    ips200_update_screen();
 }
 
 void display_dataf(int y,const char dat[],float data,int num1,int num2)
 {
     ips200_show_string(0,16*y,dat);
     ips200_show_float(8*(strlen(dat)),16*y,data,num1,num2);
+    ips200_update_screen();
 }
 
 std::string get_local_ip_address() {
@@ -105,4 +119,5 @@ void display_ip_address(uint16 x, uint16 y) {
     
     // 在屏幕上显示
     ips200_show_string(x, y, display_str.c_str());
+    ips200_update_screen();
 }
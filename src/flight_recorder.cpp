@@ -0,0 +1,611 @@
+#include "flight_recorder.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "binary_rle.hpp"
+#include "rt_thread.hpp"
+
+namespace robot {
+
+namespace {
+
+const char LOG_MAGIC[8] = {'R', 'B', 'F', 'L', 'I', 'G', 'H', 'T'};
+const size_t PAGE = 4096;
+
+int64_t steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t realtimeNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+uint64_t alignRecord(uint64_t size) {
+    return (size + FLIGHT_RECORD_ALIGN - 1) & ~(uint64_t)(FLIGHT_RECORD_ALIGN - 1);
+}
+
+struct CrcTable {
+    uint32_t value[256];
+    CrcTable() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            value[i] = c;
+        }
+    }
+};
+
+// 创建记录文件所在的目录（只创建最后一级）
+void makeParentDir(const std::string& path) {
+    size_t slash = path.rfind('/');
+    if (slash != std::string::npos && slash > 0) {
+        mkdir(path.substr(0, slash).c_str(), 0755);
+    }
+}
+
+} // namespace
+
+uint32_t flightCrc32(const void* data, size_t size, uint32_t crc) {
+    static const CrcTable table;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table.value[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// ---------------------------------------------------------------------------
+// FlightFrame
+
+bool FlightFrame::setBinary(const uint8_t* src, int w, int h, int stride) {
+    if (!src || w <= 0 || h <= 0 || stride < w || (size_t)w * h > binary.size()) {
+        return false;
+    }
+    for (int y = 0; y < h; ++y) {
+        std::memcpy(&binary[(size_t)y * w], src + (size_t)y * stride, w);
+    }
+    width = w;
+    height = h;
+    return true;
+}
+
+bool FlightFrame::setGray(const uint8_t* src, int w, int h, int stride) {
+    if (!src || w != width || h != height || stride < w || (size_t)w * h > gray.size()) {
+        return false;
+    }
+    for (int y = 0; y < h; ++y) {
+        std::memcpy(&gray[(size_t)y * w], src + (size_t)y * stride, w);
+    }
+    has_gray = true;
+    return true;
+}
+
+bool FlightFrame::setBorders(const uint16_t* left, const uint16_t* right, const uint16_t* center, int rows) {
+    if (!left || !right || !center || rows < 0 || (size_t)rows * 3 > borders.size()) {
+        return false;
+    }
+    std::memcpy(&borders[0], left, rows * sizeof(uint16_t));
+    std::memcpy(&borders[rows], right, rows * sizeof(uint16_t));
+    std::memcpy(&borders[2 * rows], center, rows * sizeof(uint16_t));
+    path.rows = (uint16_t)rows;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// FlightRecorder
+
+bool FlightRecorder::start(const FlightRecorderOptions& options, const TelemetryBus* telemetry) {
+    if (running_ || options.path.empty() || options.capacity == 0 || options.slots < 1 ||
+        options.slots > MAX_SLOTS || options.max_width <= 0 || options.max_height <= 0 || options.poll_ms <= 0) {
+        std::cerr << "FlightRecorder: 无法启动" << std::endl;
+        return false;
+    }
+    options_ = options;
+    options_.capacity = (options.capacity + PAGE - 1) / PAGE * PAGE;
+
+    makeParentDir(options_.path);
+    if (options_.keep_previous && access(options_.path.c_str(), F_OK) == 0) {
+        std::string previous = options_.path + ".prev";
+        if (rename(options_.path.c_str(), previous.c_str()) != 0) {
+            std::cerr << "FlightRecorder: 无法保留上一次的记录 " << previous << ": " << strerror(errno) << std::endl;
+        }
+    }
+
+    // 先截断为 0 再扩展，旧内容清零，读取时不会把上一次运行的记录当成本次的
+    map_size_ = FLIGHT_LOG_DATA_OFFSET + options_.capacity;
+    fd_ = open(options_.path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0 || ftruncate(fd_, 0) != 0 || ftruncate(fd_, (off_t)map_size_) != 0) {
+        std::cerr << "FlightRecorder: 无法创建 " << options_.path << ": " << strerror(errno) << std::endl;
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+        return false;
+    }
+    // 预分配存储块，记录过程中不会因为空间不足而在写回时失败（文件系统不支持时退回稀疏文件）
+    int err = posix_fallocate(fd_, 0, (off_t)map_size_);
+    if (err == ENOSPC) {
+        std::cerr << "FlightRecorder: 存储空间不足 " << map_size_ << " 字节" << std::endl;
+        close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    void* map = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "FlightRecorder: mmap 失败: " << strerror(errno) << std::endl;
+        close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    map_ = static_cast<uint8_t*>(map);
+    header_ = reinterpret_cast<FlightLogHeader*>(map_);
+    data_ = map_ + FLIGHT_LOG_DATA_OFFSET;
+
+    std::memset(header_, 0, sizeof(FlightLogHeader));
+    std::memcpy(header_->magic, LOG_MAGIC, sizeof(LOG_MAGIC));
+    header_->version = FLIGHT_LOG_VERSION;
+    header_->data_offset = FLIGHT_LOG_DATA_OFFSET;
+    header_->capacity = options_.capacity;
+    header_->start_realtime_ns = realtimeNs();
+    header_->start_steady_ns = steadyNs();
+    synced_head_ = 0;
+
+    // 帧缓冲区按最大尺寸预分配；上一次运行留在队列中的编号先清空
+    int index = 0;
+    while (free_.pop(index)) {
+    }
+    while (ready_.pop(index)) {
+    }
+    size_t pixels = (size_t)options_.max_width * options_.max_height;
+    for (int i = 0; i < options_.slots; ++i) {
+        FlightFrame& frame = slots_[i];
+        frame.binary.assign(pixels, 0);
+        frame.gray.assign(options_.gray_every > 0 ? pixels : 0, 0);
+        frame.borders.assign((size_t)options_.max_height * 3, 0);
+        free_.push(i);
+    }
+    frame_count_ = 0;
+
+    telemetry_ = telemetry;
+    telemetry_cursor_ = telemetry ? telemetry->head() : 0;
+    telemetry_batch_.resize(256);
+
+    stop_ = false;
+    running_ = true;
+    thread_ = std::thread(&FlightRecorder::run, this);
+    return true;
+}
+
+void FlightRecorder::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+    stop_ = true;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    munmap(map_, map_size_);
+    close(fd_);
+    map_ = nullptr;
+    header_ = nullptr;
+    data_ = nullptr;
+    fd_ = -1;
+}
+
+FlightFrame* FlightRecorder::acquire() {
+    if (!running_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    int index = 0;
+    if (!free_.pop(index)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    FlightFrame* frame = &slots_[index];
+    frame->path = FlightPath();
+    frame->width = 0;
+    frame->height = 0;
+    frame->want_gray = options_.gray_every > 0 && frame_count_ % options_.gray_every == 0;
+    frame->has_gray = false;
+    frame_count_++;
+    return frame;
+}
+
+void FlightRecorder::commit(FlightFrame* frame) {
+    ready_.push((int)(frame - slots_));
+}
+
+FlightRecorderStats FlightRecorder::stats() const {
+    FlightRecorderStats stats;
+    stats.frames = frames_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.telemetry = telemetry_count_.load(std::memory_order_relaxed);
+    stats.telemetry_lost = telemetry_lost_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_.load(std::memory_order_relaxed);
+    stats.wraps = wraps_.load(std::memory_order_relaxed);
+    stats.syncs = syncs_.load(std::memory_order_relaxed);
+    stats.write_us = write_hist_.snapshot();
+    stats.sync_us = sync_hist_.snapshot();
+    return stats;
+}
+
+void FlightRecorder::run() {
+    setThreadName("flight_rec");
+    if (options_.cpu >= 0) {
+        setThreadAffinity(options_.cpu);
+    }
+    if (options_.nice != 0) {
+        setCurrentThreadNice(options_.nice);
+    }
+    auto period = std::chrono::milliseconds(options_.poll_ms);
+    auto sync_period = std::chrono::milliseconds(std::max(options_.sync_ms, options_.poll_ms));
+    auto next = std::chrono::steady_clock::now();
+    auto next_sync = next + sync_period;
+    while (!stop_.load(std::memory_order_acquire)) {
+        drain();
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_sync) {
+            sync();
+            next_sync = now + sync_period;
+        }
+        next += period;
+        now = std::chrono::steady_clock::now();
+        if (next < now) {
+            next = now;
+        }
+        std::this_thread::sleep_until(next);
+    }
+    drain();
+    sync();
+}
+
+void FlightRecorder::drain() {
+    int index = 0;
+    while (ready_.pop(index)) {
+        writeFrame(&slots_[index]);
+        free_.push(index);
+    }
+    writeTelemetry();
+}
+
+bool FlightRecorder::writeFrame(FlightFrame* frame) {
+    int64_t begin_ns = steadyNs();
+    int64_t timestamp = frame->path.sensor_ns;
+    FlightFrameInfo info = {};
+    info.frame_id = frame->path.frame_id;
+    info.sensor_ns = frame->path.sensor_ns;
+    info.width = (uint16_t)frame->width;
+    info.height = (uint16_t)frame->height;
+    if (frame->width > 0 && encodeBinaryRle(frame->binary.data(), frame->width, frame->height, frame->width, &encoded_)) {
+        append(FlightRecordType::BinaryFrame, timestamp, &info, sizeof(info), encoded_.data(), encoded_.size());
+    }
+    if (frame->has_gray) {
+        append(FlightRecordType::GrayFrame, timestamp, &info, sizeof(info), frame->gray.data(),
+               (size_t)frame->width * frame->height);
+    }
+    append(FlightRecordType::Path, timestamp, &frame->path, sizeof(FlightPath), frame->borders.data(),
+           (size_t)frame->path.rows * 3 * sizeof(uint16_t));
+    frames_.fetch_add(1, std::memory_order_relaxed);
+    write_hist_.record((uint64_t)(steadyNs() - begin_ns) / 1000);
+    return true;
+}
+
+void FlightRecorder::writeTelemetry() {
+    if (!telemetry_) {
+        return;
+    }
+    uint64_t lost = 0;
+    size_t n;
+    while ((n = telemetry_->read(&telemetry_cursor_, telemetry_batch_.data(), telemetry_batch_.size(), &lost)) > 0) {
+        append(FlightRecordType::Telemetry, telemetry_batch_[0].timestamp_ns, telemetry_batch_.data(),
+               n * sizeof(TelemetryRecord));
+        telemetry_count_.fetch_add(n, std::memory_order_relaxed);
+    }
+    if (lost) {
+        telemetry_lost_.fetch_add(lost, std::memory_order_relaxed);
+    }
+}
+
+// 前移 tail，直到数据区能再放下 size 字节。每条记录都完整写在 tail 之后，按记录头里的长度跳过即可
+void FlightRecorder::makeRoom(uint64_t size) {
+    uint64_t capacity = header_->capacity;
+    while (header_->head + size - header_->tail > capacity) {
+        const FlightRecordHeader* record =
+            reinterpret_cast<const FlightRecordHeader*>(data_ + header_->tail % capacity);
+        header_->tail += alignRecord(sizeof(FlightRecordHeader) + record->size);
+    }
+}
+
+void FlightRecorder::append(FlightRecordType type, int64_t timestamp_ns, const void* part1, size_t size1,
+                            const void* part2, size_t size2) {
+    uint64_t capacity = header_->capacity;
+    uint64_t total = alignRecord(sizeof(FlightRecordHeader) + size1 + size2);
+    if (total > capacity) {
+        return;
+    }
+    uint64_t offset = header_->head % capacity;
+    if (offset + total > capacity) {
+        // 放不下时用填充记录占满到末尾，从数据区开头继续
+        uint64_t pad = capacity - offset;
+        makeRoom(pad);
+        FlightRecordHeader record = {};
+        record.magic = FLIGHT_RECORD_MAGIC;
+        record.type = (uint16_t)FlightRecordType::Pad;
+        record.size = (uint32_t)(pad - sizeof(FlightRecordHeader));
+        record.sequence = header_->records;
+        record.timestamp_ns = timestamp_ns;
+        std::memcpy(data_ + offset, &record, sizeof(record));
+        header_->records++;
+        header_->head += pad;
+        header_->wraps++;
+        wraps_.fetch_add(1, std::memory_order_relaxed);
+        bytes_.fetch_add(pad, std::memory_order_relaxed);
+        offset = 0;
+    }
+    // tail 先越过将被覆盖的记录，再写入数据，中途退出时文件头不会指向写了一半的记录
+    makeRoom(total);
+    uint8_t* dst = data_ + offset;
+    std::memcpy(dst + sizeof(FlightRecordHeader), part1, size1);
+    if (size2) {
+        std::memcpy(dst + sizeof(FlightRecordHeader) + size1, part2, size2);
+    }
+    FlightRecordHeader record = {};
+    record.magic = FLIGHT_RECORD_MAGIC;
+    record.type = (uint16_t)type;
+    record.size = (uint32_t)(size1 + size2);
+    record.crc = flightCrc32(part2, size2, flightCrc32(part1, size1));
+    record.sequence = header_->records;
+    record.timestamp_ns = timestamp_ns;
+    std::memcpy(dst, &record, sizeof(record));
+    header_->records++;
+    header_->head += total;
+    bytes_.fetch_add(total, std::memory_order_relaxed);
+}
+
+// 把上次写回以来写过的数据页和文件头同步写回存储（在记录线程中，不影响视觉线程）
+void FlightRecorder::sync() {
+    uint64_t head = header_->head;
+    if (head == synced_head_) {
+        return;
+    }
+    int64_t begin_ns = steadyNs();
+    uint64_t capacity = header_->capacity;
+    auto syncRange = [&](uint64_t begin, uint64_t end) {
+        uint64_t first = begin / PAGE * PAGE;
+        uint64_t last = (end + PAGE - 1) / PAGE * PAGE;
+        msync(data_ + first, (size_t)(last - first), MS_SYNC);
+    };
+    if (head - synced_head_ >= capacity) {
+        syncRange(0, capacity);
+    } else {
+        uint64_t begin = synced_head_ % capacity;
+        uint64_t end = head % capacity;
+        if (begin < end) {
+            syncRange(begin, end);
+        } else {
+            syncRange(begin, capacity);
+            if (end > 0) {
+                syncRange(0, end);
+            }
+        }
+    }
+    msync(map_, PAGE, MS_SYNC);
+    synced_head_ = head;
+    syncs_.fetch_add(1, std::memory_order_relaxed);
+    sync_hist_.record((uint64_t)(steadyNs() - begin_ns) / 1000);
+}
+
+// ---------------------------------------------------------------------------
+// FlightLogReader
+
+bool FlightLogReader::open(const std::string& path) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        std::cerr << "FlightLogReader: 无法打开 " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || (size_t)st.st_size < FLIGHT_LOG_DATA_OFFSET) {
+        std::cerr << "FlightLogReader: 文件过小 " << path << std::endl;
+        close();
+        return false;
+    }
+    map_size_ = (size_t)st.st_size;
+    void* map = mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "FlightLogReader: mmap 失败: " << strerror(errno) << std::endl;
+        map_size_ = 0;
+        close();
+        return false;
+    }
+    map_ = static_cast<const uint8_t*>(map);
+    std::memcpy(&header_, map_, sizeof(header_));
+    if (std::memcmp(header_.magic, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0 || header_.version != FLIGHT_LOG_VERSION ||
+        header_.capacity == 0 || header_.capacity % FLIGHT_RECORD_ALIGN != 0 ||
+        header_.data_offset + header_.capacity > map_size_ || header_.tail > header_.head ||
+        header_.head - header_.tail > header_.capacity) {
+        std::cerr << "FlightLogReader: 不是有效的飞行记录文件 " << path << std::endl;
+        close();
+        return false;
+    }
+    data_ = map_ + header_.data_offset;
+    start_ = findStart();
+    rewind();
+    return true;
+}
+
+void FlightLogReader::close() {
+    if (map_) {
+        munmap(const_cast<uint8_t*>(map_), map_size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    map_ = nullptr;
+    data_ = nullptr;
+    map_size_ = 0;
+    fd_ = -1;
+}
+
+bool FlightLogReader::readAt(uint64_t position, FlightRecordView* out) const {
+    uint64_t capacity = header_.capacity;
+    uint64_t offset = position % capacity;
+    if (offset + sizeof(FlightRecordHeader) > capacity) {
+        return false;
+    }
+    FlightRecordHeader record;
+    std::memcpy(&record, data_ + offset, sizeof(record));
+    if (record.magic != FLIGHT_RECORD_MAGIC || record.type > (uint16_t)FlightRecordType::Telemetry ||
+        offset + sizeof(FlightRecordHeader) + record.size > capacity) {
+        return false;
+    }
+    const uint8_t* payload = data_ + offset + sizeof(FlightRecordHeader);
+    if (record.type == (uint16_t)FlightRecordType::Pad) {
+        // 填充记录总是占满到数据区末尾，没有校验
+        if (offset + sizeof(FlightRecordHeader) + record.size != capacity) {
+            return false;
+        }
+    } else if (flightCrc32(payload, record.size) != record.crc) {
+        return false;
+    }
+    out->header = record;
+    out->payload = payload;
+    out->position = position;
+    return true;
+}
+
+/*
+    确定最旧的有效记录
+    通常就是文件头中的 tail。记录过程中复制出的文件，文件头之后写入的新记录可能已覆盖 tail 之后的一段，
+    这时从 tail 顺序读到的是新记录，接着是一段校验失败或序号不连续的数据；旧记录从这段数据之后开始，
+    一直连续到 head，并在 head（与 tail 同一位置）处接上新记录。
+*/
+uint64_t FlightLogReader::findStart() const {
+    uint64_t position = header_.tail;
+    uint64_t expected = 0;
+    bool first = true;
+    FlightRecordView view;
+    while (position < header_.head) {
+        if (!readAt(position, &view)) {
+            break;
+        }
+        if (!first && view.header.sequence != expected) {
+            return position;    // 新旧记录的边界恰好对齐，这里就是最旧的完整记录
+        }
+        first = false;
+        expected = view.header.sequence + 1;
+        position += alignRecord(sizeof(FlightRecordHeader) + view.header.size);
+    }
+    if (position >= header_.head) {
+        return header_.tail;
+    }
+    // 被覆盖的部分之后的第一条完整记录；记录按 32 字节对齐，逐个对齐位置查找
+    for (uint64_t p = position + FLIGHT_RECORD_ALIGN; p < header_.head; p += FLIGHT_RECORD_ALIGN) {
+        if (readAt(p, &view)) {
+            return p;
+        }
+    }
+    return header_.tail;
+}
+
+void FlightLogReader::rewind() {
+    position_ = start_;
+    sequence_ = 0;
+    first_ = true;
+    recovered_ = 0;
+}
+
+bool FlightLogReader::next(FlightRecordView* out) {
+    if (!map_) {
+        return false;
+    }
+    for (;;) {
+        FlightRecordView view;
+        if (!readAt(position_, &view) || (!first_ && view.header.sequence != sequence_)) {
+            return false;
+        }
+        uint64_t end = position_ + alignRecord(sizeof(FlightRecordHeader) + view.header.size);
+        if (end > start_ + header_.capacity) {
+            return false;   // 已读完一整圈
+        }
+        if (position_ >= header_.head) {
+            recovered_++;
+        }
+        first_ = false;
+        sequence_ = view.header.sequence + 1;
+        position_ = end;
+        if (view.header.type != (uint16_t)FlightRecordType::Pad) {
+            *out = view;
+            return true;
+        }
+    }
+}
+
+bool FlightLogReader::parsePath(const FlightRecordView& record, FlightPath* path, std::vector<uint16_t>* borders) {
+    if (record.header.type != (uint16_t)FlightRecordType::Path || record.header.size < sizeof(FlightPath)) {
+        return false;
+    }
+    std::memcpy(path, record.payload, sizeof(FlightPath));
+    size_t values = (size_t)path->rows * 3;
+    if (record.header.size != sizeof(FlightPath) + values * sizeof(uint16_t)) {
+        return false;
+    }
+    if (borders) {
+        borders->resize(values);
+        if (values) {
+            std::memcpy(borders->data(), record.payload + sizeof(FlightPath), values * sizeof(uint16_t));
+        }
+    }
+    return true;
+}
+
+bool FlightLogReader::parseFrame(const FlightRecordView& record, FlightFrameInfo* info, std::vector<uint8_t>* pixels) {
+    if (record.header.size < sizeof(FlightFrameInfo)) {
+        return false;
+    }
+    std::memcpy(info, record.payload, sizeof(FlightFrameInfo));
+    const uint8_t* data = record.payload + sizeof(FlightFrameInfo);
+    size_t size = record.header.size - sizeof(FlightFrameInfo);
+    if (record.header.type == (uint16_t)FlightRecordType::GrayFrame) {
+        if (size != (size_t)info->width * info->height) {
+            return false;
+        }
+        pixels->assign(data, data + size);
+        return true;
+    }
+    int width = 0, height = 0;
+    return record.header.type == (uint16_t)FlightRecordType::BinaryFrame &&
+           decodeBinaryRle(std::string(reinterpret_cast<const char*>(data), size), pixels, &width, &height) &&
+           width == info->width && height == info->height;
+}
+
+bool FlightLogReader::parseTelemetry(const FlightRecordView& record, std::vector<TelemetryRecord>* out) {
+    if (record.header.type != (uint16_t)FlightRecordType::Telemetry || record.header.size % sizeof(TelemetryRecord)) {
+        return false;
+    }
+    out->resize(record.header.size / sizeof(TelemetryRecord));
+    if (!out->empty()) {
+        std::memcpy(out->data(), record.payload, record.header.size);
+    }
+    return true;
+}
+
+} // namespace robot
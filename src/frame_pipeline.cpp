@@ -0,0 +1,275 @@
+#include "frame_pipeline.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include "rt_thread.hpp"
+
+using namespace std::chrono;
+
+namespace robot {
+
+static uint64_t elapsed_us(steady_clock::time_point from, steady_clock::time_point to) {
+    auto us = duration_cast<microseconds>(to - from).count();
+    return us > 0 ? static_cast<uint64_t>(us) : 0;
+}
+
+FramePipeline::FramePipeline(size_t slot_count)
+    : slot_count_(slot_count > 0 ? slot_count : 1)
+    , slots_(new SlotState[slot_count_ + 1]) {
+    for (size_t i = 0; i <= slot_count_; ++i) {
+        slots_[i].info.slot = static_cast<uint32_t>(i);
+    }
+}
+
+FramePipeline::~FramePipeline() {
+    stop();
+}
+
+bool FramePipeline::addStage(const std::string& name, StageFunction function,
+                             const PipelineStageOptions& options) {
+    if (running_) {
+        std::cerr << "FramePipeline: 运行中不能添加阶段" << std::endl;
+        return false;
+    }
+    if (!function || stages_.size() >= MAX_STAGES) {
+        std::cerr << "FramePipeline: 无效的阶段 '" << name << "'" << std::endl;
+        return false;
+    }
+    auto stage = std::make_unique<Stage>();
+    stage->name = name;
+    stage->function = std::move(function);
+    stage->options = options;
+    stages_.push_back(std::move(stage));
+    return true;
+}
+
+bool FramePipeline::start() {
+    if (running_) {
+        std::cerr << "FramePipeline: 流水线已经在运行" << std::endl;
+        return false;
+    }
+    if (stages_.empty() || slot_count_ < stages_.size()) {
+        std::cerr << "FramePipeline: 帧槽数 " << slot_count_ << " 少于阶段数 " << stages_.size() << std::endl;
+        return false;
+    }
+
+    rings_.clear();
+    for (size_t i = 0; i + 1 < stages_.size(); ++i) {
+        rings_.push_back(std::make_unique<Ring>());
+    }
+    for (size_t i = 0; i <= slot_count_; ++i) {
+        slots_[i].in_use.store(false);
+    }
+
+    resetStats();
+    running_ = true;
+    stages_[0]->thread = std::thread(&FramePipeline::sourceLoop, this);
+    for (size_t i = 1; i < stages_.size(); ++i) {
+        stages_[i]->thread = std::thread(&FramePipeline::stageLoop, this, i);
+    }
+
+    std::cout << "FramePipeline: 启动 " << stages_.size() << " 个阶段，帧槽数 " << slot_count_ << std::endl;
+    return true;
+}
+
+void FramePipeline::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+    // 唤醒阻塞在空队列上的阶段
+    for (auto& stage : stages_) {
+        sem_post(&stage->wakeup);
+    }
+    for (auto& stage : stages_) {
+        if (stage->thread.joinable()) {
+            stage->thread.join();
+        }
+    }
+    std::cout << "FramePipeline: 已停止" << std::endl;
+}
+
+void FramePipeline::applyThreadOptions(const Stage& stage) {
+    setThreadName(stage.name.c_str());
+    if (stage.options.cpu >= 0) {
+        setThreadAffinity(stage.options.cpu);
+    }
+    if (stage.options.rt_priority > 0) {
+        setThreadRealtimePriority(stage.options.rt_priority);
+    }
+}
+
+// 取一个空闲帧槽（只由第一阶段调用），没有时返回-1
+int FramePipeline::acquireSlot() {
+    for (size_t n = 0; n < slot_count_; ++n) {
+        uint32_t slot = next_slot_;
+        next_slot_ = static_cast<uint32_t>((next_slot_ + 1) % slot_count_);
+        if (!slots_[slot].in_use.load(std::memory_order_acquire)) {
+            slots_[slot].in_use.store(true, std::memory_order_relaxed);
+            return static_cast<int>(slot);
+        }
+    }
+    return -1;
+}
+
+// 归还帧槽（任意阶段都可能调用）
+void FramePipeline::releaseSlot(uint32_t slot) {
+    if (slot < slot_count_) {
+        slots_[slot].in_use.store(false, std::memory_order_release);
+    }
+}
+
+// 记录阶段统计，并把帧交给下一阶段或归还
+void FramePipeline::finishStage(size_t index, uint32_t slot, steady_clock::time_point start,
+                                steady_clock::time_point end) {
+    Stage& stage = *stages_[index];
+    SlotState& state = slots_[slot];
+
+    stage.exec_hist.record(elapsed_us(start, end));
+    stage.age_hist.record(elapsed_us(state.info.capture_time, end));
+    stage.processed.fetch_add(1, std::memory_order_relaxed);
+    state.last_done = end;
+
+    if (index + 1 == stages_.size()) {
+        releaseSlot(slot);
+    } else if (rings_[index]->push(slot)) {
+        sem_post(&stages_[index + 1]->wakeup);
+    } else {
+        stage.dropped.fetch_add(1, std::memory_order_relaxed);
+        releaseSlot(slot);
+    }
+}
+
+// 第一阶段：分配帧槽、帧序号和时间戳
+void FramePipeline::sourceLoop() {
+    Stage& stage = *stages_[0];
+    applyThreadOptions(stage);
+
+    while (running_) {
+        int acquired = acquireSlot();
+        // 下游全部占满：仍然执行采集以免相机缓冲积压，结果写入备用槽后丢弃
+        uint32_t slot = acquired >= 0 ? static_cast<uint32_t>(acquired) : static_cast<uint32_t>(slot_count_);
+        SlotState& state = slots_[slot];
+        state.info.frame_id = next_frame_id_;
+
+        auto start = steady_clock::now();
+        bool ok = false;
+        try {
+            ok = stage.function(state.info);
+        } catch (const std::exception& e) {
+            std::cerr << "FramePipeline: 阶段 '" << stage.name << "' 抛出异常: " << e.what() << std::endl;
+        }
+        auto end = steady_clock::now();
+
+        if (!ok || acquired < 0) {
+            if (ok) {
+                stage.dropped.fetch_add(1, std::memory_order_relaxed);
+                next_frame_id_++;
+            }
+            releaseSlot(slot);
+            continue;
+        }
+
+        next_frame_id_++;
+        state.info.capture_time = end;
+        finishStage(0, slot, start, end);
+    }
+}
+
+// 后续阶段
+void FramePipeline::stageLoop(size_t index) {
+    Stage& stage = *stages_[index];
+    Ring& input = *rings_[index - 1];
+    applyThreadOptions(stage);
+
+    while (running_) {
+        uint32_t slot;
+        if (!input.pop(slot)) {
+            // 阻塞到上游入队或 stop()；信号量计数不会丢失先于等待的 post
+            while (sem_wait(&stage.wakeup) != 0 && errno == EINTR) {
+            }
+            continue;
+        }
+
+        // 积压时只保留最新一帧
+        if (stage.options.keep_latest) {
+            uint32_t newer;
+            while (input.pop(newer)) {
+                stage.dropped.fetch_add(1, std::memory_order_relaxed);
+                releaseSlot(slot);
+                slot = newer;
+            }
+        }
+
+        SlotState& state = slots_[slot];
+        auto start = steady_clock::now();
+        stage.wait_hist.record(elapsed_us(state.last_done, start));
+
+        bool ok = false;
+        try {
+            ok = stage.function(state.info);
+        } catch (const std::exception& e) {
+            std::cerr << "FramePipeline: 阶段 '" << stage.name << "' 抛出异常: " << e.what() << std::endl;
+        }
+
+        if (!ok) {
+            stage.dropped.fetch_add(1, std::memory_order_relaxed);
+            releaseSlot(slot);
+            continue;
+        }
+        finishStage(index, slot, start, steady_clock::now());
+    }
+
+    // 退出时归还队列中剩余的帧槽
+    uint32_t slot;
+    while (input.pop(slot)) {
+        releaseSlot(slot);
+    }
+}
+
+std::vector<PipelineStageStats> FramePipeline::getStats() const {
+    double seconds = (duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() -
+                      stats_start_ns_.load()) / 1e9;
+    std::vector<PipelineStageStats> result;
+    result.reserve(stages_.size());
+    for (const auto& stage : stages_) {
+        PipelineStageStats stats;
+        stats.name = stage->name;
+        stats.processed = stage->processed.load(std::memory_order_relaxed);
+        stats.dropped = stage->dropped.load(std::memory_order_relaxed);
+        stats.fps = seconds > 0 ? stats.processed / seconds : 0.0;
+        stats.exec_us = stage->exec_hist.snapshot();
+        stats.wait_us = stage->wait_hist.snapshot();
+        stats.age_us = stage->age_hist.snapshot();
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+void FramePipeline::printStats() const {
+    std::printf("%-12s %7s %7s %6s %9s %9s %9s %9s %9s\n", "stage", "frames", "drops", "fps",
+                "exec p50", "exec p99", "wait p99", "age p50", "age p99");
+    for (const auto& s : getStats()) {
+        std::printf("%-12s %7llu %7llu %6.1f %9llu %9llu %9llu %9llu %9llu\n", s.name.c_str(),
+                    static_cast<unsigned long long>(s.processed),
+                    static_cast<unsigned long long>(s.dropped), s.fps,
+                    static_cast<unsigned long long>(s.exec_us.percentile(50)),
+                    static_cast<unsigned long long>(s.exec_us.percentile(99)),
+                    static_cast<unsigned long long>(s.wait_us.percentile(99)),
+                    static_cast<unsigned long long>(s.age_us.percentile(50)),
+                    static_cast<unsigned long long>(s.age_us.percentile(99)));
+    }
+}
+
+void FramePipeline::resetStats() {
+    for (auto& stage : stages_) {
+        stage->processed.store(0, std::memory_order_relaxed);
+        stage->dropped.store(0, std::memory_order_relaxed);
+        stage->exec_hist.reset();
+        stage->wait_hist.reset();
+        stage->age_hist.reset();
+    }
+    stats_start_ns_.store(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace robot
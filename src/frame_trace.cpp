@@ -0,0 +1,229 @@
+#include "frame_trace.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace robot {
+
+static size_t round_up_pow2(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// JSON 字符串转义（线程名可能包含任意字符）
+static std::string json_escape(const char* text) {
+    std::string out;
+    for (const char* p = text; p && *p; ++p) {
+        char c = *p;
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+FrameTracer& FrameTracer::instance() {
+    static FrameTracer tracer;
+    return tracer;
+}
+
+void FrameTracer::setSpansPerThread(size_t spans) {
+    spans_per_thread_.store(round_up_pow2(spans > 0 ? spans : 1), std::memory_order_relaxed);
+}
+
+FrameTracer::ThreadBuffer& FrameTracer::localBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer) {
+        return *buffer;
+    }
+
+    auto created = std::make_unique<ThreadBuffer>();
+    created->tid = static_cast<uint32_t>(syscall(SYS_gettid));
+    char name[16] = {0};
+    if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0 && name[0] != '\0') {
+        created->name = name;
+    } else {
+        created->name = "thread-" + std::to_string(created->tid);
+    }
+    size_t capacity = round_up_pow2(spans_per_thread_.load(std::memory_order_relaxed));
+    created->mask = capacity - 1;
+    created->slots.reset(new Slot[capacity]);
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    buffer = created.get();
+    buffers_.push_back(std::move(created));
+    return *buffer;
+}
+
+void FrameTracer::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    buffer.name = name;
+}
+
+void FrameTracer::append(const TraceSpan& span) {
+    ThreadBuffer& buffer = localBuffer();
+    uint64_t n = buffer.head.load(std::memory_order_relaxed);
+    Slot& slot = buffer.slots[n & buffer.mask];
+    slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.span = span;
+    slot.seq.store(2 * n + 2, std::memory_order_release);
+    buffer.head.store(n + 1, std::memory_order_release);
+
+    SpanListener listener = listener_.load(std::memory_order_acquire);
+    if (listener) {
+        listener(span);
+    }
+}
+
+void FrameTracer::record(uint64_t frame_id, const char* name, int64_t start_ns, int64_t end_ns) {
+    if (!enabled()) {
+        return;
+    }
+    TraceSpan span;
+    span.frame_id = frame_id;
+    span.name = name;
+    span.start_ns = start_ns;
+    span.end_ns = end_ns;
+    append(span);
+}
+
+void FrameTracer::recordFrameActuated(uint64_t frame_id, int64_t capture_ns, int64_t actuate_ns) {
+    int64_t latency_ns = actuate_ns - capture_ns;
+    glass_to_actuator_.record(latency_ns > 0 ? static_cast<uint64_t>(latency_ns / 1000) : 0);
+    if (!enabled()) {
+        return;
+    }
+    TraceSpan span;
+    span.frame_id = frame_id;
+    span.name = "glass_to_pwm";
+    span.start_ns = capture_ns;
+    span.end_ns = actuate_ns;
+    span.frame_lifetime = true;
+    append(span);
+}
+
+std::string FrameTracer::chromeTraceJson() const {
+    struct Entry {
+        uint32_t tid;
+        TraceSpan span;
+    };
+    std::vector<Entry> entries;
+    std::vector<std::pair<uint32_t, std::string>> threads;
+
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        for (const auto& buffer : buffers_) {
+            threads.emplace_back(buffer->tid, buffer->name);
+            uint64_t head = buffer->head.load(std::memory_order_acquire);
+            uint64_t capacity = buffer->mask + 1;
+            uint64_t first = head > capacity ? head - capacity : 0;
+            for (uint64_t n = first; n < head; ++n) {
+                const Slot& slot = buffer->slots[n & buffer->mask];
+                uint64_t before = slot.seq.load(std::memory_order_acquire);
+                if (before != 2 * n + 2) {
+                    continue;   // 已被覆盖或正在写入
+                }
+                TraceSpan span = slot.span;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) != before) {
+                    continue;
+                }
+                entries.push_back({buffer->tid, span});
+            }
+        }
+    }
+
+    // 时间戳相对最早一条记录，便于阅读
+    int64_t origin = std::numeric_limits<int64_t>::max();
+    for (const auto& entry : entries) {
+        origin = std::min(origin, entry.span.start_ns);
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.span.start_ns < b.span.start_ns;
+    });
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first_event = true;
+    char buf[256];
+    auto emit = [&](const std::string& event) {
+        if (!first_event) {
+            json += ",";
+        }
+        first_event = false;
+        json += "\n";
+        json += event;
+    };
+
+    emit("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"robot\"}}");
+    for (const auto& thread : threads) {
+        emit("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(thread.first) +
+             ",\"args\":{\"name\":\"" + json_escape(thread.second.c_str()) + "\"}}");
+    }
+
+    for (const auto& entry : entries) {
+        const TraceSpan& span = entry.span;
+        double ts = (span.start_ns - origin) / 1000.0;
+        double dur = (span.end_ns - span.start_ns) / 1000.0;
+        std::string name = json_escape(span.name);
+        if (span.frame_lifetime) {
+            // 异步区间：同一帧序号的 b/e 成对，Perfetto 中按帧单独显示一条
+            std::snprintf(buf, sizeof(buf),
+                          "{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"b\",\"id\":%llu,\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+                          "\"args\":{\"frame\":%llu}}",
+                          name.c_str(), static_cast<unsigned long long>(span.frame_id), ts, entry.tid,
+                          static_cast<unsigned long long>(span.frame_id));
+            emit(buf);
+            std::snprintf(buf, sizeof(buf),
+                          "{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"e\",\"id\":%llu,\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                          name.c_str(), static_cast<unsigned long long>(span.frame_id), ts + dur, entry.tid);
+            emit(buf);
+        } else {
+            std::snprintf(buf, sizeof(buf),
+                          "{\"name\":\"%s\",\"cat\":\"stage\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,"
+                          "\"args\":{\"frame\":%llu}}",
+                          name.c_str(), ts, dur, entry.tid, static_cast<unsigned long long>(span.frame_id));
+            emit(buf);
+        }
+    }
+    json += "\n]}\n";
+    return json;
+}
+
+bool FrameTracer::writeChromeTrace(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "FrameTracer: 无法写入追踪文件 " << path << std::endl;
+        return false;
+    }
+    file << chromeTraceJson();
+    return file.good();
+}
+
+void FrameTracer::clear() {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    for (auto& buffer : buffers_) {
+        for (size_t i = 0; i <= buffer->mask; ++i) {
+            buffer->slots[i].seq.store(0, std::memory_order_relaxed);
+        }
+        buffer->head.store(0, std::memory_order_release);
+    }
+}
+
+} // namespace robot
@@ -0,0 +1,224 @@
+#include "hal.hpp"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <iostream>
+
+#include "zf_device_ips200_fb.h"
+#include "zf_driver_encoder.h"
+#include "zf_driver_file.h"
+#include "zf_driver_gpio.h"
+
+namespace robot {
+namespace hal {
+
+// IMUDevice 读取的 sysfs 路径（基于1.0内核，固定为 iio:device1）
+static const char* IMU_DIR = "/sys/bus/iio/devices/iio:device1";
+static const char* IMU_AXES[9] = {"accel_x", "accel_y", "accel_z", "anglvel_x", "anglvel_y", "anglvel_z",
+                                  "magn_x", "magn_y", "magn_z"};
+
+int16_t DeviceEncoder::read() {
+    return encoder_get_count(path_);
+}
+
+bool DevicePwm::info(pwm_info& out) {
+    out = pwm_info();
+    pwm_get_dev_info(path_, &out);
+    return out.duty_max > 0;
+}
+
+void DevicePwm::setDuty(uint16_t duty) {
+    pwm_set_duty(path_, duty);
+}
+
+void DeviceGpio::set(uint8_t level) {
+    gpio_set_level(path_, level);
+}
+
+uint8_t DeviceGpio::get() {
+    // 驱动返回 ASCII 电平
+    return gpio_get_level(path_) == '1' ? 1 : 0;
+}
+
+bool DeviceImu::initialize() {
+    return imu_->initialize();
+}
+
+bool DeviceImu::read(imu_raw_data_t& out) {
+    if (!imu_->update_all_data()) {
+        return false;
+    }
+    out = imu_->get_raw_data();
+    return true;
+}
+
+double DeviceImu::gyroScale() const {
+    return imu_->get_gyro_scale();
+}
+
+bool DeviceFramebuffer::open() {
+    // ips200_init 打开或映射失败时直接退出进程
+    ips200_init(path_);
+    return true;
+}
+
+bool MemoryPwm::info(pwm_info& out) {
+    out = info_;
+    return info_.duty_max > 0;
+}
+
+void MemoryPwm::setDuty(uint16_t duty) {
+    duty_.store(duty, std::memory_order_relaxed);
+    writes_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool MemoryImu::read(imu_raw_data_t& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!fresh_) {
+        return false;
+    }
+    out = data_;
+    fresh_ = false;
+    return true;
+}
+
+void MemoryImu::set(const imu_raw_data_t& data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    data_ = data;
+    fresh_ = true;
+}
+
+MemoryFramebuffer::MemoryFramebuffer(int width, int height)
+    : width_(width)
+    , height_(height)
+    , pixels_((size_t)width * height, 0) {}
+
+bool MemoryFramebuffer::open() {
+    ips200_attach(pixels_.data(), width_, height_, width_);
+    return true;
+}
+
+bool MemoryFramebuffer::savePpm(const std::string& path) const {
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp) {
+        std::cerr << "MemoryFramebuffer: 无法写入 " << path << std::endl;
+        return false;
+    }
+    fprintf(fp, "P6\n%d %d\n255\n", width_, height_);
+    std::vector<uint8_t> row((size_t)width_ * 3);
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            uint16_t c = pixel(x, y);
+            row[x * 3 + 0] = (uint8_t)((c >> 11) << 3);
+            row[x * 3 + 1] = (uint8_t)(((c >> 5) & 0x3F) << 2);
+            row[x * 3 + 2] = (uint8_t)((c & 0x1F) << 3);
+        }
+        fwrite(row.data(), 1, row.size(), fp);
+    }
+    return fclose(fp) == 0;
+}
+
+/*
+    逐级创建 path 的上级目录
+*/
+static void make_parent_dirs(const std::string& path) {
+    for (size_t pos = 1; (pos = path.find('/', pos)) != std::string::npos; ++pos) {
+        mkdir(path.substr(0, pos).c_str(), 0755);
+    }
+}
+
+bool SimDeviceTree::writeFile(const std::string& path, const void* data, size_t size) const {
+    // 不截断：驱动持有的句柄在偏移 0 处读写，文件长度保持不变
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "SimDeviceTree: 无法写入 " << path << std::endl;
+        return false;
+    }
+    bool ok = pwrite(fd, data, size, 0) == (ssize_t)size;
+    close(fd);
+    return ok;
+}
+
+bool SimDeviceTree::readFile(const std::string& path, void* data, size_t size) const {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = pread(fd, data, size, 0) == (ssize_t)size;
+    close(fd);
+    return ok;
+}
+
+bool SimDeviceTree::addEncoder(const char* path) {
+    make_parent_dirs(resolve(path));
+    int16_t count = 0;
+    return writeFile(resolve(path), &count, sizeof(count));
+}
+
+bool SimDeviceTree::addPwm(const char* path, const pwm_info& info) {
+    make_parent_dirs(resolve(path));
+    return writeFile(resolve(path), &info, sizeof(info));
+}
+
+bool SimDeviceTree::addGpio(const char* path, uint8_t level) {
+    make_parent_dirs(resolve(path));
+    char ascii = level ? '1' : '0';
+    return writeFile(resolve(path), &ascii, 1);
+}
+
+bool SimDeviceTree::addImu(const char* name, double gyro_scale) {
+    std::string dir = resolve(IMU_DIR);
+    make_parent_dirs(dir + "/name");
+    unlink((dir + "/name").c_str());
+    unlink((dir + "/in_anglvel_scale").c_str());
+    std::string name_line = std::string(name) + "\n";
+    char scale[32];
+    int scale_len = snprintf(scale, sizeof(scale), "%.9f\n", gyro_scale);
+    if (!writeFile(dir + "/name", name_line.data(), name_line.size()) ||
+        !writeFile(dir + "/in_anglvel_scale", scale, scale_len)) {
+        return false;
+    }
+    imu9_ = std::string(name) == "IMU963RA";
+    return setImu(imu_raw_data_t());
+}
+
+void SimDeviceTree::activate() {
+    file_set_device_root(root_.c_str());
+}
+
+bool SimDeviceTree::setEncoder(const char* path, int16_t count) {
+    return writeFile(resolve(path), &count, sizeof(count));
+}
+
+bool SimDeviceTree::pwmDuty(const char* path, uint16_t* duty) const {
+    return readFile(resolve(path), duty, sizeof(*duty));
+}
+
+bool SimDeviceTree::gpioLevel(const char* path, uint8_t* level) const {
+    char ascii = 0;
+    if (!readFile(resolve(path), &ascii, 1)) {
+        return false;
+    }
+    *level = ascii == '1' ? 1 : 0;
+    return true;
+}
+
+bool SimDeviceTree::setImu(const imu_raw_data_t& data) {
+    const int16_t values[9] = {data.acc_x, data.acc_y, data.acc_z, data.gyro_x, data.gyro_y, data.gyro_z,
+                               data.mag_x, data.mag_y, data.mag_z};
+    std::string dir = resolve(IMU_DIR);
+    for (int i = 0; i < (imu9_ ? 9 : 6); ++i) {
+        // 定宽写入，文件中不会残留上一个较长数值的字符
+        char text[16];
+        snprintf(text, sizeof(text), "%7d\n", values[i]);
+        if (!writeFile(dir + "/in_" + IMU_AXES[i] + "_raw", text, 8)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace hal
+} // namespace robot
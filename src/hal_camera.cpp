@@ -0,0 +1,122 @@
+#include "hal_camera.hpp"
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+namespace robot {
+namespace hal {
+
+static int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool V4l2Camera::open() {
+    if (!capture_.open(device_, cv::CAP_V4L2)) {
+        std::cerr << "V4l2Camera: 无法打开 " << device_ << std::endl;
+        return false;
+    }
+    capture_.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
+    capture_.set(cv::CAP_PROP_FRAME_WIDTH, width_);
+    capture_.set(cv::CAP_PROP_FRAME_HEIGHT, height_);
+    capture_.set(cv::CAP_PROP_FPS, fps_);
+    printf("摄像头配置信息：\n");
+    printf("分辨率：%.0fx%.0f\n", capture_.get(cv::CAP_PROP_FRAME_WIDTH), capture_.get(cv::CAP_PROP_FRAME_HEIGHT));
+    printf("帧率：%.0f FPS\n", capture_.get(cv::CAP_PROP_FPS));
+    return true;
+}
+
+/*
+    V4L2 后端的 CAP_PROP_POS_MSEC 是驱动填写的缓冲区时间戳（CLOCK_MONOTONIC），作为该帧的采集时刻；
+    取不到或明显不合理时退回读取完成的时间
+*/
+bool V4l2Camera::read(cv::Mat& frame, int64_t& sensor_ns) {
+    capture_ >> frame;
+    int64_t now_ns = steady_now_ns();
+    sensor_ns = (int64_t)(capture_.get(cv::CAP_PROP_POS_MSEC) * 1e6);
+    if (sensor_ns <= 0 || sensor_ns > now_ns || now_ns - sensor_ns > 1000000000LL) {
+        sensor_ns = now_ns;
+    }
+    return !frame.empty();
+}
+
+static bool is_image_file(const std::string& file) {
+    std::string ext = file.substr(file.find_last_of('.') + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == "png" || ext == "jpg" || ext == "jpeg" || ext == "bmp";
+}
+
+bool FileCamera::open() {
+    close();
+    struct stat st;
+    bool is_dir = stat(path_.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+    if (is_dir || path_.find('*') != std::string::npos) {
+        std::vector<cv::String> files;
+        cv::glob(path_, files, false);
+        for (const cv::String& file : files) {
+            if (is_image_file(file)) {
+                images_.push_back(file);
+            }
+        }
+        std::sort(images_.begin(), images_.end());
+        if (images_.empty()) {
+            std::cerr << "FileCamera: " << path_ << " 中没有图片" << std::endl;
+            return false;
+        }
+    } else if (!video_.open(path_)) {
+        std::cerr << "FileCamera: 无法打开视频 " << path_ << std::endl;
+        return false;
+    }
+    next_frame_ns_ = steady_now_ns();
+    return true;
+}
+
+bool FileCamera::readNext(cv::Mat& frame) {
+    if (!images_.empty()) {
+        if (next_image_ == images_.size()) {
+            if (!loop_) {
+                return false;
+            }
+            next_image_ = 0;
+        }
+        frame = cv::imread(images_[next_image_++], cv::IMREAD_COLOR);
+        return !frame.empty();
+    }
+    if (video_.read(frame) && !frame.empty()) {
+        return true;
+    }
+    if (!loop_ || !video_.set(cv::CAP_PROP_POS_FRAMES, 0)) {
+        return false;
+    }
+    return video_.read(frame) && !frame.empty();
+}
+
+bool FileCamera::read(cv::Mat& frame, int64_t& sensor_ns) {
+    if (fps_ > 0) {
+        int64_t now_ns = steady_now_ns();
+        if (next_frame_ns_ > now_ns) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(next_frame_ns_ - now_ns));
+        }
+        // 处理跟不上时不补发积压的帧，与摄像头丢帧的行为相同
+        next_frame_ns_ = std::max(next_frame_ns_, now_ns) + (int64_t)(1e9 / fps_);
+    }
+    bool ok = readNext(frame);
+    sensor_ns = steady_now_ns();
+    return ok;
+}
+
+void FileCamera::close() {
+    video_.release();
+    images_.clear();
+    next_image_ = 0;
+}
+
+} // namespace hal
+} // namespace robot
@@ -0,0 +1,241 @@
+#include "imu_stream.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include "rt_thread.hpp"
+
+namespace robot {
+
+static const size_t DEFAULT_CAPACITY = 4096;
+
+static size_t round_up_pow2(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+static int16_t lerp16(int16_t a, int16_t b, double alpha) {
+    return static_cast<int16_t>(std::lround(a + (b - a) * alpha));
+}
+
+ImuStream::ImuStream(IMUDevice* imu)
+    : imu_(imu)
+    , gyro_scale_(imu ? imu->get_gyro_scale() : 1.0) {
+    reset(DEFAULT_CAPACITY);
+}
+
+ImuStream::~ImuStream() {
+    stop();
+}
+
+void ImuStream::reset(size_t capacity) {
+    size_t size = round_up_pow2(capacity);
+    slots_.reset(new Slot[size]);
+    mask_ = size - 1;
+    head_.store(0, std::memory_order_release);
+    has_last_ = false;
+    last_angle_[0] = last_angle_[1] = last_angle_[2] = 0;
+}
+
+bool ImuStream::start(const ImuStreamOptions& options) {
+    if (running_) {
+        std::cerr << "ImuStream: 已经在运行" << std::endl;
+        return false;
+    }
+    if (!imu_ || !imu_->is_initialized()) {
+        std::cerr << "ImuStream: IMU设备未初始化" << std::endl;
+        return false;
+    }
+    if (round_up_pow2(options.capacity) != mask_ + 1) {
+        reset(options.capacity);
+    }
+    gyro_scale_ = imu_->get_gyro_scale();
+    running_ = true;
+    thread_ = std::thread(&ImuStream::captureLoop, this, options);
+    return true;
+}
+
+void ImuStream::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+// 采集线程：缓冲区模式由设备数据唤醒，sysfs 模式按固定周期读取
+void ImuStream::captureLoop(ImuStreamOptions options) {
+    setThreadName("imu_stream");
+    if (options.cpu >= 0) {
+        setThreadAffinity(options.cpu);
+    }
+    if (options.rt_priority > 0) {
+        setThreadRealtimePriority(options.rt_priority);
+    }
+
+    const bool buffered = imu_->get_backend() == IMU_BACKEND_BUFFER;
+    const auto period = std::chrono::nanoseconds(1000000000LL / (options.rate_hz > 0 ? options.rate_hz : 1000));
+    auto next = std::chrono::steady_clock::now();
+    imu_sample_t samples[64];
+
+    while (running_) {
+        int n = imu_->read_samples(samples, buffered ? 64 : 1, buffered ? 20 : 0);
+        for (int i = 0; i < n; ++i) {
+            push(samples[i]);
+        }
+        if (n < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        } else if (!buffered) {
+            next += period;
+            auto now = std::chrono::steady_clock::now();
+            if (next < now) {
+                next = now;     // 读取超时后不追赶，保持固定间隔
+            }
+            std::this_thread::sleep_until(next);
+        }
+    }
+}
+
+bool ImuStream::push(const imu_sample_t& sample) {
+    if (has_last_ && sample.timestamp_ns <= last_sample_.timestamp_ns) {
+        return false;
+    }
+
+    double angle[3] = {last_angle_[0], last_angle_[1], last_angle_[2]};
+    if (has_last_) {
+        double dt = (sample.timestamp_ns - last_sample_.timestamp_ns) / 1e9;
+        angle[0] += 0.5 * (last_sample_.data.gyro_x + sample.data.gyro_x) * gyro_scale_ * dt;
+        angle[1] += 0.5 * (last_sample_.data.gyro_y + sample.data.gyro_y) * gyro_scale_ * dt;
+        angle[2] += 0.5 * (last_sample_.data.gyro_z + sample.data.gyro_z) * gyro_scale_ * dt;
+    }
+
+    uint64_t n = head_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[n & mask_];
+    slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.sample = sample;
+    slot.angle[0] = angle[0];
+    slot.angle[1] = angle[1];
+    slot.angle[2] = angle[2];
+    slot.seq.store(2 * n + 2, std::memory_order_release);
+    head_.store(n + 1, std::memory_order_release);
+
+    has_last_ = true;
+    last_sample_ = sample;
+    last_angle_[0] = angle[0];
+    last_angle_[1] = angle[1];
+    last_angle_[2] = angle[2];
+
+    if (listener_) {
+        listener_(sample);
+    }
+    return true;
+}
+
+bool ImuStream::readEntry(uint64_t n, Entry& out) const {
+    const Slot& slot = slots_[n & mask_];
+    uint64_t before = slot.seq.load(std::memory_order_acquire);
+    if (before != 2 * n + 2) {
+        return false;
+    }
+    out.sample = slot.sample;
+    out.angle[0] = slot.angle[0];
+    out.angle[1] = slot.angle[1];
+    out.angle[2] = slot.angle[2];
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == before;
+}
+
+bool ImuStream::latest(imu_sample_t& out) const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    Entry entry;
+    if (head == 0 || !readEntry(head - 1, entry)) {
+        return false;
+    }
+    out = entry.sample;
+    return true;
+}
+
+// 二分查找 t_ns 两侧的样本并线性插值
+bool ImuStream::locate(int64_t t_ns, Entry& out) const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    if (head == 0) {
+        return false;
+    }
+    uint64_t window = (mask_ + 1) - (mask_ + 1) / 8;
+    uint64_t lo = head > window ? head - window : 0;
+    uint64_t hi = head - 1;
+
+    Entry a, b;
+    if (!readEntry(lo, a) || !readEntry(hi, b)) {
+        return false;
+    }
+    if (t_ns < a.sample.timestamp_ns || t_ns > b.sample.timestamp_ns) {
+        return false;
+    }
+    if (lo == hi || t_ns == b.sample.timestamp_ns) {
+        out = b;
+        return true;
+    }
+
+    // 不变式：ts(lo) <= t < ts(hi)
+    while (hi - lo > 1) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        Entry entry;
+        if (!readEntry(mid, entry)) {
+            return false;
+        }
+        if (entry.sample.timestamp_ns <= t_ns) {
+            lo = mid;
+            a = entry;
+        } else {
+            hi = mid;
+            b = entry;
+        }
+    }
+
+    double alpha = static_cast<double>(t_ns - a.sample.timestamp_ns) /
+                   static_cast<double>(b.sample.timestamp_ns - a.sample.timestamp_ns);
+    const imu_raw_data_t& da = a.sample.data;
+    const imu_raw_data_t& db = b.sample.data;
+    out.sample.timestamp_ns = t_ns;
+    out.sample.data.acc_x = lerp16(da.acc_x, db.acc_x, alpha);
+    out.sample.data.acc_y = lerp16(da.acc_y, db.acc_y, alpha);
+    out.sample.data.acc_z = lerp16(da.acc_z, db.acc_z, alpha);
+    out.sample.data.gyro_x = lerp16(da.gyro_x, db.gyro_x, alpha);
+    out.sample.data.gyro_y = lerp16(da.gyro_y, db.gyro_y, alpha);
+    out.sample.data.gyro_z = lerp16(da.gyro_z, db.gyro_z, alpha);
+    out.sample.data.mag_x = lerp16(da.mag_x, db.mag_x, alpha);
+    out.sample.data.mag_y = lerp16(da.mag_y, db.mag_y, alpha);
+    out.sample.data.mag_z = lerp16(da.mag_z, db.mag_z, alpha);
+    for (int i = 0; i < 3; ++i) {
+        out.angle[i] = a.angle[i] + (b.angle[i] - a.angle[i]) * alpha;
+    }
+    return true;
+}
+
+bool ImuStream::sampleAt(int64_t t_ns, imu_sample_t& out) const {
+    Entry entry;
+    if (!locate(t_ns, entry)) {
+        return false;
+    }
+    out = entry.sample;
+    return true;
+}
+
+bool ImuStream::integrateGyro(int64_t t0_ns, int64_t t1_ns, double angle_rad[3]) const {
+    Entry start, end;
+    if (!locate(t0_ns, start) || !locate(t1_ns, end)) {
+        return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        angle_rad[i] = end.angle[i] - start.angle[i];
+    }
+    return true;
+}
+
+} // namespace robot
@@ -1,6 +1,7 @@
 #include "common_system.h"
 #include "common_program.h"
 #include "libdata_store.h"
+#include "lookahead.hpp"
 
 using namespace std;
 using namespace cv;
@@ -207,6 +208,8 @@ LoopKind Judge::TrackKind_Judge(Img_Store* Img_Store_p,Data_Path *Data_Path_p,Fu
 /*
     ServoDirAngle_Judge说明
     计算舵机方向和舵机角度
+    前瞻拟合窗口为0时读取前瞻点一行的中线偏差；
+    否则在前瞻点附近多行加权拟合中线，前瞻点随车速调整，按纯追踪折算为前瞻点处的等效偏差
 */
 void Judge::ServoDirAngle_Judge(Data_Path *Data_Path_p)
 {
@@ -215,6 +218,23 @@ void Judge::ServoDirAngle_Judge(Data_Path *Data_Path_p)
     if (find_row < Data_Path_p->hightest) find_row = Data_Path_p->hightest + 10;
     
     (Data_Path_p -> ServoAngle) = (Data_Path_p -> center_line[find_row]) - image_w/2;
+
+    if (JSON_TrackConfigData.Lookahead_Window > 0)
+    {
+        robot::LookaheadOptions options;
+        options.window = JSON_TrackConfigData.Lookahead_Window;
+        options.quadratic = JSON_TrackConfigData.Lookahead_Quadratic;
+        options.speed_ref = JSON_TrackConfigData.Lookahead_Speed_Ref;
+        options.rows_per_mps = JSON_TrackConfigData.Lookahead_Rows_Per_Mps;
+        robot::LookaheadResult lookahead = robot::computeLookahead(Data_Path_p->center_line, image_h, image_w,
+            Data_Path_p->hightest, image_h - JSON_TrackConfigData.Path_Search_Start,
+            JSON_TrackConfigData.Forward, Data_Path_p->Speed, options);
+        if (lookahead.valid)
+        {
+            find_row = lookahead.row;
+            (Data_Path_p -> ServoAngle) = (int)lroundf(lookahead.steer);
+        }
+    }
     // printf("%d,%d,%d\r\n",(JSON_TrackConfigData.Forward)-(JSON_TrackConfigData.Path_Search_Start),Data_Path_p->hightest,find_row);
 
     Data_Path_p->findrow = find_row;
@@ -572,14 +592,12 @@ bool changetimes = 0;
 /*
     ConfigData_SYNC说明
     车辆上位机设置文件数据同步
+    首次调用时选择参数文件，之后沿用同一文件
 */
 void SYNC::ConfigData_SYNC(Data_Path *Data_Path_p,Function_EN *Function_EN_p,JSON_PIDConfigData *JSON_PIDConfigData_p)
 {
-    JSON_FunctionConfigData JSON_FunctionConfigData;
-    JSON_TrackConfigData JSON_TrackConfigData;
-
     int JSON_FileNum;
-    const char* ConfigFilePath;
+    const char* ConfigFilePath = "config/config_0.json";
 
     if (changetimes == 0){
         cout << "<---------------------JSON文件选择--------------------->" << endl;
@@ -599,12 +617,30 @@ void SYNC::ConfigData_SYNC(Data_Path *Data_Path_p,Function_EN *Function_EN_p,JSO
         case 1:{ ConfigFilePath = "config/config_1.json"; break; }
         case 2:{ ConfigFilePath = "config/config_2.json"; break; }
     }
+    ConfigData_Load(ConfigFilePath,Data_Path_p,Function_EN_p,JSON_PIDConfigData_p);
+}
+
+/*
+    ConfigData_Load说明
+    从指定文件读取参数，不做交互，离线回放等工具直接调用
+*/
+bool SYNC::ConfigData_Load(const char* ConfigFilePath,Data_Path *Data_Path_p,Function_EN *Function_EN_p,JSON_PIDConfigData *JSON_PIDConfigData_p)
+{
+    JSON_FunctionConfigData JSON_FunctionConfigData;
+    JSON_TrackConfigData JSON_TrackConfigData;
+
     printf("OPENING JSON FILE :%s\n",ConfigFilePath);
     ifstream ConfigFile(ConfigFilePath);
+    if (!ConfigFile.is_open()) {
+        cerr << "Error: cannot open config file " << ConfigFilePath << endl;
+        return false;
+    }
     nlohmann::json ConfigData = nlohmann::json::parse(ConfigFile);
 
     JSON_PIDConfigData_p->speedl = ConfigData.at("SPEED_L");    // 获取电机低速
     JSON_PIDConfigData_p->speedr = ConfigData.at("SPEED_R");    // 获取电机高速
+    JSON_PIDConfigData_p->encoder_meters_per_count = ConfigData.value("ENCODER_METERS_PER_COUNT", 0.000193);  // 编码器脉冲当量（需按车模标定）
+    JSON_PIDConfigData_p->wheel_track_width = ConfigData.value("WHEEL_TRACK_WIDTH", 0.155);  // 轮距
 
     JSON_PIDConfigData_p->motorpid.Kp = ConfigData.at("MOTOR_KP");
     JSON_PIDConfigData_p->motorpid.Ki = ConfigData.at("MOTOR_KI");
@@ -638,10 +674,17 @@ void SYNC::ConfigData_SYNC(Data_Path *Data_Path_p,Function_EN *Function_EN_p,JSO
     JSON_PIDConfigData_p->anglespeedpid.Dlimit = ConfigData.at("ANGLE_DL");
     JSON_PIDConfigData_p->anglespeedpid.Reslimit = ConfigData.at("ANGLE_RESL");
 
+    JSON_PIDConfigData_p->motor_kff = ConfigData.value("MOTOR_KFF", 0.0);  // 电机速度前馈
+    JSON_PIDConfigData_p->cascade_steer = ConfigData.value("CASCADE_STEER_EN", false);  // 串级转向使能
+    JSON_PIDConfigData_p->pid_d_tau = ConfigData.value("PID_D_TAU", 0.02);  // 微分低通时间常数
+
     JSON_FunctionConfigData.Uart_EN = ConfigData.at("UART_EN");    // 获取串口使能参数
     JSON_FunctionConfigData.ImgCompress_EN = ConfigData.at("IMG_COMPRESS_EN");  // 获取图像压缩使能参数
     JSON_FunctionConfigData.Camera_EN = CameraKind(ConfigData.at("CAMERA_EN"));   // 获取摄像头使能参数
     JSON_FunctionConfigData.ImageSave_EN = ConfigData.at("IMAGE_SAVE_EN");  // 图像存储使能
+    JSON_FunctionConfigData.FlightRecord_EN = ConfigData.value("FLIGHT_RECORD_EN", false);  // 飞行记录使能
+    JSON_FunctionConfigData.FlightRecord_Gray_Every = ConfigData.value("FLIGHT_RECORD_GRAY_EVERY", 0);  // 灰度图记录间隔
+    JSON_FunctionConfigData.FlightRecord_MB = ConfigData.value("FLIGHT_RECORD_MB", 128);  // 记录文件大小
     JSON_FunctionConfigData.VideoShow_EN = ConfigData.at("VIDEO_SHOW_EN"); // 获取图像显示使能参数
     JSON_FunctionConfigData.DataPrint_EN = ConfigData.at("DATA_PRINT_EN");  // 获取数据显示使能参数
     JSON_FunctionConfigData.AcrossIdentify_EN = ConfigData.at("ACROSS_IDENTIFY_EN");   // 获取十字识别使能参数
@@ -649,6 +692,10 @@ void SYNC::ConfigData_SYNC(Data_Path *Data_Path_p,Function_EN *Function_EN_p,JSO
 
     JSON_TrackConfigData.Forward = ConfigData.at("FORWARD"); // 获取前瞻点
     JSON_TrackConfigData.Default_Forward = ConfigData.at("FORWARD"); // 获取默认前瞻点
+    JSON_TrackConfigData.Lookahead_Window = ConfigData.value("LOOKAHEAD_WINDOW", 0); // 前瞻拟合窗口（0 为单行前瞻）
+    JSON_TrackConfigData.Lookahead_Quadratic = ConfigData.value("LOOKAHEAD_QUADRATIC", true); // 前瞻二次拟合
+    JSON_TrackConfigData.Lookahead_Speed_Ref = ConfigData.value("LOOKAHEAD_SPEED_REF", 1.0); // 前瞻参考车速
+    JSON_TrackConfigData.Lookahead_Rows_Per_Mps = ConfigData.value("LOOKAHEAD_ROWS_PER_MPS", 0.0); // 前瞻随车速移动的行数
     JSON_TrackConfigData.Path_Search_Start = ConfigData.at("PATH_SEARCH_START"); // 获取路径循线起始点
     JSON_TrackConfigData.Path_Search_End = ConfigData.at("PATH_SEARCH_END"); // 获取路径循线结束点
     JSON_TrackConfigData.Side_Search_Start = ConfigData.at("SIDE_SEARCH_START");    // 获取边线循线起始点
@@ -675,8 +722,21 @@ void SYNC::ConfigData_SYNC(Data_Path *Data_Path_p,Function_EN *Function_EN_p,JSO
     JSON_TrackConfigData.BridgeZoneMotorSpeed = ConfigData.at("BRIDGE_ZONE_MOTOR_SPEED"); // 桥梁区域电机速度
     JSON_TrackConfigData.CrosswalkZoneMotorSpeed = ConfigData.at("CROSSWALK_ZONE_MOTOR_SPEED_STOP_PREPARE"); // 斑马线区域准备停车电机速度
     JSON_TrackConfigData.Circle_In_Prepare_Time = ConfigData.at("CIRCLE_IN_PREPARE_TIME");  // 准备入环限定时间
+    JSON_TrackConfigData.Circle_Out_Gyro_Angle = ConfigData.value("CIRCLE_OUT_GYRO_ANGLE", 300);  // 出环陀螺仪积分角度（旧配置文件缺省300度）
+    JSON_TrackConfigData.SpeedPlan_EN = ConfigData.value("SPEED_PLAN_EN", false);  // 曲率速度规划使能
+    JSON_TrackConfigData.SpeedPlan_Lateral_Acc = ConfigData.value("SPEED_PLAN_LATERAL_ACC", 3.0);  // 侧向加速度限制
+    JSON_TrackConfigData.SpeedPlan_Acc = ConfigData.value("SPEED_PLAN_ACC", 2.0);  // 加速度限制
+    JSON_TrackConfigData.SpeedPlan_Dec = ConfigData.value("SPEED_PLAN_DEC", 4.0);  // 减速度限制
+    JSON_TrackConfigData.SpeedPlan_Min_Speed = ConfigData.value("SPEED_PLAN_MIN_SPEED", 0.5);  // 弯道限速下限
+    JSON_TrackConfigData.SpeedPlan_Horizon_Speed = ConfigData.value("SPEED_PLAN_HORIZON_SPEED", 1.2);  // 视野末端速度
+    JSON_TrackConfigData.Birdeye_Meters_Per_Pixel = ConfigData.value("BIRDEYE_METERS_PER_PIXEL", 0.005);  // 俯视图像素当量
+
+    // 各模块通过 [0] 读取当前参数
+    Function_EN_p -> JSON_FunctionConfigData_v.assign(1, JSON_FunctionConfigData);
+    Data_Path_p -> JSON_TrackConfigData_v.assign(1, JSON_TrackConfigData);
 
     cout << "<---------------------JSON参数获取成功--------------------->" << endl;
+    return true;
 }
 
 
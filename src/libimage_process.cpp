@@ -115,14 +115,15 @@ void CameraImgGet(Img_Store *Img_Store_p)
 
 void ImgProcess::imgPreProc(Img_Store *Img_Store_p,Data_Path *Data_Path_p,Function_EN *Function_EN_p)
 {
-	(Img_Store_p->Img_Track) = (Img_Store_p->Img_Color).clone();
-
     if (Img_Store_p->Img_Color.empty()) {
         cerr << "Error: Img_Color is empty!" << endl;
         return;
     }
 	
-	Img_Store_p -> Img_Track = (Img_Store_p -> Img_Color).clone();
+	// 赛道彩色图像只用于显示，不绘制时不复制
+	if (Img_Store_p -> Draw_EN) {
+		Img_Store_p -> Img_Track = (Img_Store_p -> Img_Color).clone();
+	}
 
 	cvtColor(Img_Store_p->Img_Color, Img_Store_p->Img_Gray, COLOR_BGR2GRAY);
 
@@ -0,0 +1,93 @@
+#include "lookahead.hpp"
+
+#include <cmath>
+
+namespace robot {
+
+static int clamp_int(int value, int lo, int hi) {
+    return value < lo ? lo : (value > hi ? hi : value);
+}
+
+// 3x3 行列式
+static double det3(double a00, double a01, double a02,
+                   double a10, double a11, double a12,
+                   double a20, double a21, double a22) {
+    return a00 * (a11 * a22 - a12 * a21) - a01 * (a10 * a22 - a12 * a20) + a02 * (a10 * a21 - a11 * a20);
+}
+
+LookaheadResult computeLookahead(const uint16_t* center_line, int image_height, int image_width,
+                                 int valid_top, int valid_bottom, int forward_row, float speed,
+                                 const LookaheadOptions& options) {
+    LookaheadResult result;
+    valid_top = clamp_int(valid_top, 0, image_height - 1);
+    valid_bottom = clamp_int(valid_bottom, 0, image_height);
+    if (center_line == nullptr || valid_bottom <= valid_top) {
+        return result;
+    }
+
+    // 前瞻行随车速移动，并保证拟合窗口尽量落在有效行内
+    int half = options.window > 1 ? options.window / 2 : 0;
+    int row = forward_row;
+    if (options.rows_per_mps != 0) {
+        row -= (int)std::lround(options.rows_per_mps * (speed - options.speed_ref));
+    }
+    int lo_limit = valid_top + half < valid_bottom - 1 ? valid_top + half : valid_bottom - 1;
+    row = clamp_int(row, lo_limit, valid_bottom - 1);
+
+    const double center = image_width / 2.0;
+    int begin = row - half < valid_top ? valid_top : row - half;
+    int end = row + half + 1 > valid_bottom ? valid_bottom : row + half + 1;
+    int rows = end - begin;
+
+    double a = center_line[row] - center, b = 0, c = 0;
+    int rows_used = 1;
+    if (options.window > 1 && rows >= options.min_rows) {
+        // 以前瞻行为原点 u = i - row，拟合 x(u) = a + b·u + c·u²，a 即前瞻行处的拟合值
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, t0 = 0, t1 = 0, t2 = 0;
+        for (int i = begin; i < end; ++i) {
+            double u = i - row;
+            double w = half + 1 - std::fabs(u);
+            double x = center_line[i] - center;
+            double wu = w * u, wu2 = wu * u;
+            s0 += w;
+            s1 += wu;
+            s2 += wu2;
+            s3 += wu2 * u;
+            s4 += wu2 * u * u;
+            t0 += w * x;
+            t1 += wu * x;
+            t2 += wu2 * x;
+        }
+        double d = options.quadratic ? det3(s0, s1, s2, s1, s2, s3, s2, s3, s4) : 0;
+        if (std::fabs(d) > 1e-9) {
+            a = det3(t0, s1, s2, t1, s2, s3, t2, s3, s4) / d;
+            b = det3(s0, t0, s2, s1, t1, s3, s2, t2, s4) / d;
+            c = det3(s0, s1, t0, s1, s2, t1, s2, s3, t2) / d;
+            rows_used = rows;
+        } else {
+            double d2 = s0 * s2 - s1 * s1;
+            if (std::fabs(d2) > 1e-9) {
+                a = (t0 * s2 - s1 * t1) / d2;
+                b = (s0 * t1 - s1 * t0) / d2;
+                rows_used = rows;
+            }
+        }
+    }
+
+    // 纯追踪：前瞻距离按行数计，折算为 Forward 行处的等效偏差
+    int origin = options.origin_row >= 0 ? options.origin_row : image_height;
+    double look = origin - row > 1 ? origin - row : 1;
+    double look_ref = origin - forward_row > 1 ? origin - forward_row : 1;
+    double kappa = 2 * a / (look * look + a * a);
+
+    result.valid = true;
+    result.row = row;
+    result.rows_used = rows_used;
+    result.offset = (float)a;
+    result.slope = (float)b;
+    result.curvature = (float)c;
+    result.steer = (float)(kappa * look_ref * look_ref / 2);
+    return result;
+}
+
+} // namespace robot
@@ -172,9 +172,6 @@ void cross_fill(uint8(*image)[image_w], uint16 *l_border, uint16 *r_border, uint
 		if (dir_l[i - 1] == 4 && dir_l[i] == 4 && dir_l[i + 3] == 6 && dir_l[i + 5] == 6 && dir_l[i + 7] == 6)
 		{
 			break_num_l = points_l[i][1];//传递y坐标
-			printf("brea_knum-L:%d\n", break_num_l);
-			printf("I:%d\n", i);
-			printf("十字标志位：1\n");
 			break;
 		}
 	}
@@ -183,9 +180,6 @@ void cross_fill(uint8(*image)[image_w], uint16 *l_border, uint16 *r_border, uint
 		if (dir_r[i - 1] == 4 && dir_r[i] == 4 && dir_r[i + 3] == 6 && dir_r[i + 5] == 6 && dir_r[i + 7] == 6)
 		{
 			break_num_r = points_r[i][1];//传递y坐标
-			printf("brea_knum-R:%d\n", break_num_r);
-			printf("I:%d\n", i);
-			printf("十字标志位：1\n");
 			break;
 		}
 	}
@@ -196,7 +190,6 @@ void cross_fill(uint8(*image)[image_w], uint16 *l_border, uint16 *r_border, uint
 		start = limit_a_b(start, 0, image_h);
 		end = break_num_l - 5;
 		calculate_s_i(start, end, l_border, &slope_l_rate, &intercept_l);
-		printf("slope_l_rate:%f\nintercept_l:%f\n", slope_l_rate, intercept_l);
 		for (i = break_num_l - 5; i < image_h - 1; i++)
 		{
 			l_border[i] = slope_l_rate * (i)+intercept_l;//y = kx+b
@@ -208,7 +201,6 @@ void cross_fill(uint8(*image)[image_w], uint16 *l_border, uint16 *r_border, uint
 		start = limit_a_b(start, 0, image_h);//限幅
 		end = break_num_r - 5;//终点
 		calculate_s_i(start, end, r_border, &slope_l_rate, &intercept_l);
-		printf("slope_l_rate:%f\nintercept_l:%f\n", slope_l_rate, intercept_l);
 		for (i = break_num_r - 5; i < image_h - 1; i++)
 		{
 			r_border[i] = slope_l_rate * (i)+intercept_l;
@@ -0,0 +1,161 @@
+#include "odometry.hpp"
+
+namespace robot {
+
+static size_t round_up_pow2(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+Odometry::Odometry(const OdometryOptions& options) {
+    configure(options);
+}
+
+void Odometry::configure(const OdometryOptions& options) {
+    options_ = options;
+    size_t size = round_up_pow2(options.history);
+    slots_.reset(new Slot[size]);
+    mask_ = size - 1;
+    reset();
+}
+
+void Odometry::reset() {
+    for (size_t i = 0; i <= mask_; ++i) {
+        slots_[i].seq.store(0, std::memory_order_relaxed);
+    }
+    head_.store(0, std::memory_order_release);
+    has_last_ = false;
+    left_count_ = right_count_ = 0;
+    heading_ = 0;
+    samples_ = 0;
+    left_ = WheelFilter();
+    right_ = WheelFilter();
+}
+
+// α-β 滤波：以累计脉冲为位置测量，预测后按残差修正位置与速度
+void Odometry::filterWheel(WheelFilter& wheel, int64_t count, double dt, bool restart) {
+    if (restart) {
+        wheel.velocity = dt > 0 ? (count - wheel.position) / dt : 0;
+        wheel.position = static_cast<double>(count);
+        return;
+    }
+    double predicted = wheel.position + wheel.velocity * dt;
+    double residual = count - predicted;
+    wheel.position = predicted + options_.alpha * residual;
+    wheel.velocity += options_.beta * residual / dt;
+}
+
+bool Odometry::update(int64_t timestamp_ns, int left_delta, int right_delta) {
+    if (has_last_ && timestamp_ns <= last_ns_) {
+        return false;
+    }
+
+    left_count_ += left_delta;
+    right_count_ += right_delta;
+    const double mpc = options_.meters_per_count;
+
+    if (!has_last_) {
+        left_.position = static_cast<double>(left_count_);
+        right_.position = static_cast<double>(right_count_);
+    } else {
+        int64_t gap = timestamp_ns - last_ns_;
+        double dt = gap / 1e9;
+        bool restart = gap > options_.max_gap_ns;
+        filterWheel(left_, left_count_, dt, restart);
+        filterWheel(right_, right_count_, dt, restart);
+        if (options_.track_width_m > 0) {
+            heading_ += (right_delta - left_delta) * mpc / options_.track_width_m;
+        }
+    }
+    has_last_ = true;
+    last_ns_ = timestamp_ns;
+    samples_++;
+
+    OdometryState state;
+    state.timestamp_ns = timestamp_ns;
+    state.samples = samples_;
+    state.left_count = left_count_;
+    state.right_count = right_count_;
+    state.left_cps = static_cast<float>(left_.velocity);
+    state.right_cps = static_cast<float>(right_.velocity);
+    state.left_speed = static_cast<float>(left_.velocity * mpc);
+    state.right_speed = static_cast<float>(right_.velocity * mpc);
+    state.speed = (state.left_speed + state.right_speed) / 2;
+    state.yaw_rate = options_.track_width_m > 0
+        ? static_cast<float>((state.right_speed - state.left_speed) / options_.track_width_m) : 0;
+    state.distance = (left_count_ + right_count_) * mpc / 2;
+    state.heading = heading_;
+    state_.store(state);
+
+    uint64_t n = head_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[n & mask_];
+    slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestamp_ns = timestamp_ns;
+    slot.distance = state.distance;
+    slot.seq.store(2 * n + 2, std::memory_order_release);
+    head_.store(n + 1, std::memory_order_release);
+    return true;
+}
+
+bool Odometry::readSlot(uint64_t n, int64_t& timestamp_ns, double& distance) const {
+    const Slot& slot = slots_[n & mask_];
+    uint64_t before = slot.seq.load(std::memory_order_acquire);
+    if (before != 2 * n + 2) {
+        return false;
+    }
+    timestamp_ns = slot.timestamp_ns;
+    distance = slot.distance;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == before;
+}
+
+// 与 ImuStream 相同：二分查找 t_ns 两侧的记录并插值，查询范围留出 1/8 余量避免与写者竞争
+bool Odometry::distanceAt(int64_t t_ns, double& meters) const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    if (head == 0) {
+        return false;
+    }
+    uint64_t window = (mask_ + 1) - (mask_ + 1) / 8;
+    uint64_t lo = head > window ? head - window : 0;
+    uint64_t hi = head - 1;
+
+    int64_t t_lo, t_hi;
+    double d_lo, d_hi;
+    if (!readSlot(lo, t_lo, d_lo) || !readSlot(hi, t_hi, d_hi)) {
+        return false;
+    }
+    if (t_ns < t_lo || t_ns > t_hi) {
+        return false;
+    }
+    if (lo == hi || t_ns == t_hi) {
+        meters = d_hi;
+        return true;
+    }
+
+    while (hi - lo > 1) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        int64_t t_mid;
+        double d_mid;
+        if (!readSlot(mid, t_mid, d_mid)) {
+            return false;
+        }
+        if (t_mid <= t_ns) {
+            lo = mid;
+            t_lo = t_mid;
+            d_lo = d_mid;
+        } else {
+            hi = mid;
+            t_hi = t_mid;
+            d_hi = d_mid;
+        }
+    }
+    double alpha = static_cast<double>(t_ns - t_lo) / static_cast<double>(t_hi - t_lo);
+    meters = d_lo + (d_hi - d_lo) * alpha;
+    return true;
+}
+
+} // namespace robot
@@ -16,7 +16,7 @@ void CircleTrack_Step_IN_Prepare(Img_Store *Img_Store_p,Data_Path *Data_Path_p)
         {
             // 准备左入环补线
             // 赛道彩色图像
-            line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point(int(image_w/2-(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[0])-1][1])),Scalar(128,0,128),4);
+            if (Img_Store_p -> Draw_EN) line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point(int(image_w/2-(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[0])-1][1])),Scalar(128,0,128),4);
             // 赛道二值化图像
             line((Img_Store_p -> Img_OTSU),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point(int(image_w/2-(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[0])-1][1])),Scalar(0),4);
             
@@ -26,7 +26,7 @@ void CircleTrack_Step_IN_Prepare(Img_Store *Img_Store_p,Data_Path *Data_Path_p)
         {
             // 准备右入环补线
             // 赛道彩色图像
-            line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point(int(image_w/2+(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[1])-1][3])),Scalar(128,0,128),4);
+            if (Img_Store_p -> Draw_EN) line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point(int(image_w/2+(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[1])-1][3])),Scalar(128,0,128),4);
             // 赛道二值化图像
             line((Img_Store_p -> Img_OTSU),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point(int(image_w/2+(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[1])-1][3])),Scalar(0),4);
             
@@ -49,7 +49,7 @@ void CircleTrack_Step_IN_Prepare_Stright(Img_Store *Img_Store_p,Data_Path *Data_
         {
             // 准备左入环补线
             // 赛道彩色图像
-            line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point(int(image_w/2-(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[0])-1][1])),Scalar(128,0,128),4);
+            if (Img_Store_p -> Draw_EN) line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point(int(image_w/2-(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[0])-1][1])),Scalar(128,0,128),4);
             // 赛道二值化图像
             line((Img_Store_p -> Img_OTSU),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point(int(image_w/2-(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[0])-1][1])),Scalar(0),4);
             
@@ -59,7 +59,7 @@ void CircleTrack_Step_IN_Prepare_Stright(Img_Store *Img_Store_p,Data_Path *Data_
         {
             // 准备右入环补线
             // 赛道彩色图像
-            line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point(int(image_w/2+(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[1])-1][3])),Scalar(128,0,128),4);
+            if (Img_Store_p -> Draw_EN) line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point(int(image_w/2+(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[1])-1][3])),Scalar(128,0,128),4);
             // 赛道二值化图像
             line((Img_Store_p -> Img_OTSU),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point(int(image_w/2+(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[1])-1][3])),Scalar(0),4);
             
@@ -81,7 +81,7 @@ void CircleTrack_Step_IN(Img_Store *Img_Store_p,Data_Path *Data_Path_p)
         {
             // 左入环补线
             // 赛道彩色图像
-            line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point((Data_Path_p -> InflectionPointCoordinate[(Data_Path_p -> InflectionPointNum[0])-1][0]),(Data_Path_p -> InflectionPointCoordinate[(Data_Path_p -> InflectionPointNum[0])-1][1])),Scalar(128,0,128),4);
+            if (Img_Store_p -> Draw_EN) line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point((Data_Path_p -> InflectionPointCoordinate[(Data_Path_p -> InflectionPointNum[0])-1][0]),(Data_Path_p -> InflectionPointCoordinate[(Data_Path_p -> InflectionPointNum[0])-1][1])),Scalar(128,0,128),4);
             // 赛道二值化图像
             line((Img_Store_p -> Img_OTSU),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point((Data_Path_p -> InflectionPointCoordinate[(Data_Path_p -> InflectionPointNum[0])-1][0]),(Data_Path_p -> InflectionPointCoordinate[(Data_Path_p -> InflectionPointNum[0])-1][1])),Scalar(0),4);
             
@@ -91,7 +91,7 @@ void CircleTrack_Step_IN(Img_Store *Img_Store_p,Data_Path *Data_Path_p)
         {
             // 右入环补线
             // 赛道彩色图像
-            line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point((Data_Path_p -> InflectionPointCoordinate[(Data_Path_p -> InflectionPointNum[1])-1][2]),(Data_Path_p -> InflectionPointCoordinate[(Data_Path_p -> InflectionPointNum[1])-1][3])),Scalar(128,0,128),4);
+            if (Img_Store_p -> Draw_EN) line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point((Data_Path_p -> InflectionPointCoordinate[(Data_Path_p -> InflectionPointNum[1])-1][2]),(Data_Path_p -> InflectionPointCoordinate[(Data_Path_p -> InflectionPointNum[1])-1][3])),Scalar(128,0,128),4);
             // 赛道二值化图像
             line((Img_Store_p -> Img_OTSU),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point((Data_Path_p -> InflectionPointCoordinate[(Data_Path_p -> InflectionPointNum[1])-1][2]),(Data_Path_p -> InflectionPointCoordinate[(Data_Path_p -> InflectionPointNum[1])-1][3])),Scalar(0),4);
 
@@ -114,7 +114,7 @@ void CircleTrack_Step_OUT(Img_Store *Img_Store_p,Data_Path *Data_Path_p)
         {
             // 准备左出环补线
             // 赛道彩色图像
-            line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point(image_w/2-JSON_TrackConfigData.CircleOutWidth,(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[0])-1][1])),Scalar(128,0,128),4);
+            if (Img_Store_p -> Draw_EN) line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point(image_w/2-JSON_TrackConfigData.CircleOutWidth,(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[0])-1][1])),Scalar(128,0,128),4);
             // 赛道二值化图像
             line((Img_Store_p -> Img_OTSU),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point(image_w/2-JSON_TrackConfigData.CircleOutWidth,(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[0])-1][1])),Scalar(0),4);
             
@@ -124,7 +124,7 @@ void CircleTrack_Step_OUT(Img_Store *Img_Store_p,Data_Path *Data_Path_p)
         {
             // 准备右出环补线
             // 赛道彩色图像
-            line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point(image_w/2+JSON_TrackConfigData.CircleOutWidth,(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[1])-1][3])),Scalar(128,0,128),4);
+            if (Img_Store_p -> Draw_EN) line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point(image_w/2+JSON_TrackConfigData.CircleOutWidth,(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[1])-1][3])),Scalar(128,0,128),4);
             // 赛道二值化图像
             line((Img_Store_p -> Img_OTSU),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point(image_w/2+JSON_TrackConfigData.CircleOutWidth,(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[1])-1][3])),Scalar(0),4);
             
@@ -147,7 +147,7 @@ void Circle2CommonTrack(Img_Store *Img_Store_p,Data_Path *Data_Path_p)
         {
             // 准备左出环后直线环补线
             // 赛道彩色图像
-            line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point(int(image_w/2-(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[0])-1][1])),Scalar(128,0,128),4);
+            if (Img_Store_p -> Draw_EN) line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point(int(image_w/2-(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[0])-1][1])),Scalar(128,0,128),4);
             // 赛道二值化图像
             line((Img_Store_p -> Img_OTSU),Point((Data_Path_p -> SideCoordinate_Eight[0][0]),(Data_Path_p -> SideCoordinate_Eight[0][1])),Point(int(image_w/2-(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[0])-1][1])),Scalar(0),4);
             
@@ -157,7 +157,7 @@ void Circle2CommonTrack(Img_Store *Img_Store_p,Data_Path *Data_Path_p)
         {
             // 准备右出环后直线补线
             // 赛道彩色图像
-            line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point(int(image_w/2+(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[1])-1][3])),Scalar(128,0,128),4);
+            if (Img_Store_p -> Draw_EN) line((Img_Store_p -> Img_Track),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point(int(image_w/2+(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[1])-1][3])),Scalar(128,0,128),4);
             // 赛道二值化图像
             line((Img_Store_p -> Img_OTSU),Point((Data_Path_p -> SideCoordinate_Eight[0][2]),(Data_Path_p -> SideCoordinate_Eight[0][3])),Point(int(image_w/2+(JSON_TrackConfigData.TrackWidth)/2),(Data_Path_p -> SideCoordinate_Eight[(Data_Path_p -> NumSearch[1])-1][3])),Scalar(0),4);
             
@@ -0,0 +1,184 @@
+#include "rgb565_scaler.hpp"
+
+#include <cstring>
+
+// 128 位 shuffle 可以编译为单条指令时才使用向量路径，否则 __builtin_shuffle 会退化成逐字节的模拟
+#if defined(__SSSE3__) || defined(__loongarch_sx) || defined(__ARM_NEON)
+#define RGB565_SCALER_SIMD 1
+#endif
+
+namespace robot {
+
+static inline uint16_t pack565(uint8_t b, uint8_t g, uint8_t r) {
+    return (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+#ifdef RGB565_SCALER_SIMD
+typedef uint8_t v16u8 __attribute__((vector_size(16)));
+typedef uint16_t v8u16 __attribute__((vector_size(16)));
+
+static inline v16u8 load16(const uint8_t* p) {
+    v16u8 v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 把 16 个字节零扩展为两组 8 个 16 位数
+static inline void widen(v16u8 v, v8u16* lo, v8u16* hi) {
+    const v16u8 zero = {0};
+    const v16u8 lo_mask = {0, 16, 1, 16, 2, 16, 3, 16, 4, 16, 5, 16, 6, 16, 7, 16};
+    const v16u8 hi_mask = {8, 16, 9, 16, 10, 16, 11, 16, 12, 16, 13, 16, 14, 16, 15, 16};
+    *lo = (v8u16)__builtin_shuffle(v, zero, lo_mask);
+    *hi = (v8u16)__builtin_shuffle(v, zero, hi_mask);
+}
+
+// 从 48 字节窗口（三个向量）按预先算好的位置取出一个分量的 16 个字节
+static inline v16u8 gather(v16u8 v0, v16u8 v1, v16u8 v2, const v16u8 m[3], const v16u8 sel[3]) {
+    return (__builtin_shuffle(v0, m[0]) & sel[0]) | (__builtin_shuffle(v1, m[1]) & sel[1]) |
+           (__builtin_shuffle(v2, m[2]) & sel[2]);
+}
+
+static inline v8u16 pack565(v8u16 b, v8u16 g, v8u16 r) {
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+static inline void store16(uint16_t* dst, v8u16 lo, v8u16 hi) {
+    std::memcpy(dst, &lo, sizeof(lo));
+    std::memcpy(dst + 8, &hi, sizeof(hi));
+}
+#endif
+
+bool Rgb565Scaler::configure(int src_width, int src_height, int dst_width, int dst_height, PixelFormat format) {
+    if (src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0) {
+        return false;
+    }
+    src_width_ = src_width;
+    src_height_ = src_height;
+    dst_width_ = dst_width;
+    dst_height_ = dst_height;
+    format_ = format;
+    x_index_.resize(dst_width);
+    y_index_.resize(dst_height);
+    for (int x = 0; x < dst_width; ++x) {
+        x_index_[x] = (int)((int64_t)x * src_width / dst_width);
+    }
+    for (int y = 0; y < dst_height; ++y) {
+        y_index_[y] = (int)((int64_t)y * src_height / dst_height);
+    }
+
+    group_ = 0;
+    group_span_ = 0;
+    vector_columns_ = 0;
+#ifdef RGB565_SCALER_SIMD
+    // 找每组最多的目标像素数 D：组内源像素落在 16 像素窗口内，且整行按 (D, 源跨度) 周期重复
+    for (int d = 16; d >= 4 && group_ == 0; --d) {
+        if (d >= dst_width) {
+            continue;
+        }
+        int span = x_index_[d];
+        if (span > 16) {
+            continue;
+        }
+        bool periodic = true;
+        for (int x = 0; x + d < dst_width && periodic; ++x) {
+            periodic = x_index_[x + d] == x_index_[x] + span;
+        }
+        if (periodic) {
+            group_ = d;
+            group_span_ = span;
+        }
+    }
+    if (group_ == 0) {
+        return true;
+    }
+    // 每组读 16 个源像素、写 16 个目标像素（多写的部分被下一组覆盖），不能越过行尾
+    int groups = 0;
+    while ((groups * group_ + 16) <= dst_width && x_index_[groups * group_] + 16 <= src_width) {
+        groups++;
+    }
+    vector_columns_ = groups * group_;
+
+    // 每个分量从窗口的每个 16 字节向量各 shuffle 一次，再按 select_ 合并（每个字节只来自其中一个向量）
+    int bytes_per_pixel = format == PixelFormat::Bgr ? 3 : 1;
+    std::memset(shuffle_, 0, sizeof(shuffle_));
+    std::memset(select_, 0, sizeof(select_));
+    for (int c = 0; c < bytes_per_pixel; ++c) {
+        for (int i = 0; i < group_; ++i) {
+            int index = x_index_[i] * bytes_per_pixel + c;
+            shuffle_[c][index / 16][i] = (uint8_t)(index % 16);
+            select_[c][index / 16][i] = 0xFF;
+        }
+    }
+#endif
+    return true;
+}
+
+void Rgb565Scaler::convertRow(const uint8_t* src, uint16_t* dst) const {
+    int x = 0;
+#ifdef RGB565_SCALER_SIMD
+    if (vector_columns_ > 0) {
+        if (format_ == PixelFormat::Bgr) {
+            v16u8 m[3][3], sel[3][3];
+            for (int c = 0; c < 3; ++c) {
+                for (int k = 0; k < 3; ++k) {
+                    m[c][k] = load16(shuffle_[c][k]);
+                    sel[c][k] = load16(select_[c][k]);
+                }
+            }
+            for (const uint8_t* p = src; x < vector_columns_; x += group_, p += group_span_ * 3) {
+                v16u8 v0 = load16(p), v1 = load16(p + 16), v2 = load16(p + 32);
+                v8u16 b_lo, b_hi, g_lo, g_hi, r_lo, r_hi;
+                widen(gather(v0, v1, v2, m[0], sel[0]), &b_lo, &b_hi);
+                widen(gather(v0, v1, v2, m[1], sel[1]), &g_lo, &g_hi);
+                widen(gather(v0, v1, v2, m[2], sel[2]), &r_lo, &r_hi);
+                store16(dst + x, pack565(b_lo, g_lo, r_lo), pack565(b_hi, g_hi, r_hi));
+            }
+        } else {
+            v16u8 mask = load16(shuffle_[0][0]);
+            bool binary = format_ == PixelFormat::Binary;
+            for (const uint8_t* p = src; x < vector_columns_; x += group_, p += group_span_) {
+                v16u8 v = load16(p);
+                v16u8 g = __builtin_shuffle(v, v, mask);
+                if (binary) {
+                    const v16u8 dup = {0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7};
+                    const v16u8 dup_hi = dup + 8;
+                    v16u8 white = (v16u8)(g != 0);
+                    store16(dst + x, (v8u16)__builtin_shuffle(white, dup), (v8u16)__builtin_shuffle(white, dup_hi));
+                } else {
+                    v8u16 g_lo, g_hi;
+                    widen(g, &g_lo, &g_hi);
+                    store16(dst + x, pack565(g_lo, g_lo, g_lo), pack565(g_hi, g_hi, g_hi));
+                }
+            }
+        }
+    }
+#endif
+    const int* x_index = x_index_.data();
+    switch (format_) {
+        case PixelFormat::Bgr:
+            for (; x < dst_width_; ++x) {
+                const uint8_t* p = src + x_index[x] * 3;
+                dst[x] = pack565(p[0], p[1], p[2]);
+            }
+            break;
+        case PixelFormat::Gray:
+            for (; x < dst_width_; ++x) {
+                uint8_t g = src[x_index[x]];
+                dst[x] = pack565(g, g, g);
+            }
+            break;
+        case PixelFormat::Binary:
+            for (; x < dst_width_; ++x) {
+                dst[x] = src[x_index[x]] ? 0xFFFF : 0x0000;
+            }
+            break;
+    }
+}
+
+void Rgb565Scaler::convert(const uint8_t* src, int src_stride, uint16_t* dst, int dst_stride) const {
+    for (int y = 0; y < dst_height_; ++y) {
+        convertRow(src + (size_t)y_index_[y] * src_stride, dst + (size_t)y * dst_stride);
+    }
+}
+
+} // namespace robot
@@ -0,0 +1,75 @@
+#include "rt_thread.hpp"
+#include <errno.h>
+#include <iostream>
+#include <sched.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace robot {
+
+bool setThreadRealtimePriority(int rt_priority, pthread_t thread) {
+    if (rt_priority < 1 || rt_priority > 99) {
+        std::cerr << "Invalid RT priority: " << rt_priority
+                  << " (must be 1-99)\n";
+        return false;
+    }
+
+    struct sched_param param;
+    param.sched_priority = rt_priority;
+
+    // 设置FIFO实时调度策略
+    int ret = pthread_setschedparam(thread, SCHED_FIFO, &param);
+    if (ret != 0) {
+        std::cerr << "Failed to set realtime priority. Error: "
+                  << strerror(ret) << "\n";
+        std::cerr << "Hint: Run with sudo or set capabilities with:\n"
+                  << "  sudo setcap cap_sys_nice=eip <executable>\n";
+        return false;
+    }
+    return true;
+}
+
+bool setThreadAffinity(int cpu, pthread_t thread) {
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpu < 0 || cpu >= cpu_count) {
+        std::cerr << "Invalid CPU index: " << cpu << " (online CPUs: " << cpu_count << ")\n";
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int ret = pthread_setaffinity_np(thread, sizeof(set), &set);
+    if (ret != 0) {
+        std::cerr << "Failed to set CPU affinity. Error: " << strerror(ret) << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool setThreadName(const char* name, pthread_t thread) {
+    // 内核限制线程名最长15个字符（不含结尾的'\0'）
+    char truncated[16];
+    strncpy(truncated, name, sizeof(truncated) - 1);
+    truncated[sizeof(truncated) - 1] = '\0';
+    int ret = pthread_setname_np(thread, truncated);
+    if (ret != 0) {
+        std::cerr << "Failed to set thread name. Error: " << strerror(ret) << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool setCurrentThreadNice(int nice) {
+    // Linux 上 nice 值属于线程，按线程ID设置只影响当前线程
+    pid_t tid = (pid_t)syscall(SYS_gettid);
+    if (setpriority(PRIO_PROCESS, tid, nice) != 0) {
+        std::cerr << "Failed to set thread nice. Error: " << strerror(errno) << "\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace robot
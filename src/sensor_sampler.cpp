@@ -0,0 +1,51 @@
+#include "sensor_sampler.hpp"
+#include <chrono>
+#include <iostream>
+#include "imu_stream.hpp"
+#include "zf_driver_file.h"
+
+namespace robot {
+
+SensorSampler::SensorSampler(const char* encoder_left_path, const char* encoder_right_path, IMUDevice* imu)
+    : encoder_left_path_(encoder_left_path)
+    , encoder_right_path_(encoder_right_path)
+    , imu_(imu) {}
+
+bool SensorSampler::open() {
+    encoder_left_fd_ = file_handle_get(encoder_left_path_, O_RDONLY);
+    encoder_right_fd_ = file_handle_get(encoder_right_path_, O_RDONLY);
+    if (encoder_left_fd_ < 0 || encoder_right_fd_ < 0) {
+        std::cerr << "SensorSampler: 无法打开编码器设备" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SensorSampler::sample(SensorSample& out) {
+    if (encoder_left_fd_ < 0 && !open()) {
+        return false;
+    }
+
+    out.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    bool ok = fd_read_dat(encoder_left_fd_, &out.encoder_left) == 0;
+    ok = fd_read_dat(encoder_right_fd_, &out.encoder_right) == 0 && ok;
+
+    if (imu_stream_) {
+        imu_sample_t latest;
+        out.imu_valid = imu_stream_->latest(latest);
+        if (out.imu_valid) {
+            out.imu = latest.data;
+        }
+        return ok;
+    }
+
+    out.imu_valid = imu_ && imu_->update_all_data();
+    if (out.imu_valid) {
+        out.imu = imu_->get_raw_data();
+    }
+    return ok;
+}
+
+} // namespace robot
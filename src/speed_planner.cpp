@@ -0,0 +1,101 @@
+#include "speed_planner.hpp"
+
+#include <cmath>
+
+namespace robot {
+
+CurvatureEstimate estimateCurvature(const uint16_t* center_line, int image_height, int image_width,
+                                    int valid_top, int valid_bottom, float meters_per_pixel, int segments) {
+    CurvatureEstimate estimate;
+    if (meters_per_pixel <= 0 || segments <= 0) {
+        return estimate;
+    }
+    if (segments > CurvatureEstimate::MAX_SEGMENTS) {
+        segments = CurvatureEstimate::MAX_SEGMENTS;
+    }
+    const int min_rows = 10;
+    int rows = valid_bottom - valid_top;
+    while (segments > 1 && rows / segments < min_rows) {
+        segments--;
+    }
+    if (rows <= 0) {
+        return estimate;
+    }
+    estimate.visible = (float)((image_height - valid_top) * meters_per_pixel);
+    if (rows < min_rows) {
+        return estimate;
+    }
+
+    // 由近到远：第 0 段紧邻 valid_bottom
+    for (int i = 0; i < segments; ++i) {
+        int bottom = valid_bottom - rows * i / segments;
+        int top = valid_bottom - rows * (i + 1) / segments;
+        LookaheadOptions options;
+        options.window = bottom - top;
+        options.quadratic = true;
+        options.min_rows = min_rows;
+        LookaheadResult fit = computeLookahead(center_line, image_height, image_width, top, bottom,
+                                               (top + bottom) / 2, 0, options);
+        if (!fit.valid || fit.rows_used < min_rows) {
+            continue;
+        }
+        double b = fit.slope;
+        double kappa_px = 2 * fit.curvature / std::pow(1 + b * b, 1.5);
+        estimate.curvature[estimate.count] = (float)(kappa_px / meters_per_pixel);
+        estimate.distance[estimate.count] = i == 0 ? 0.0f : (float)((image_height - bottom) * meters_per_pixel);
+        estimate.count++;
+    }
+    return estimate;
+}
+
+SpeedPlanner::SpeedPlanner(const SpeedPlannerOptions& options) {
+    configure(options);
+}
+
+void SpeedPlanner::configure(const SpeedPlannerOptions& options) {
+    options_ = options;
+    reset();
+}
+
+float SpeedPlanner::limit(float cap, const CurvatureEstimate& estimate) const {
+    if (cap <= 0) {
+        return 0;
+    }
+    float result = cap;
+    if (estimate.visible >= 0 && options_.horizon_speed > 0) {
+        float h = options_.horizon_speed;
+        result = std::fmin(result, std::sqrt(h * h + 2 * options_.max_decel * estimate.visible));
+    }
+    if (options_.max_lateral_accel <= 0) {
+        return result;
+    }
+    for (int i = 0; i < estimate.count; ++i) {
+        float kappa = std::fabs(estimate.curvature[i]);
+        if (kappa < 1e-6f) {
+            continue;
+        }
+        float v_curve = std::sqrt(options_.max_lateral_accel / kappa);
+        float v_now = std::sqrt(v_curve * v_curve + 2 * options_.max_decel * std::fmax(estimate.distance[i], 0.0f));
+        result = std::fmin(result, std::fmax(v_now, options_.min_speed));
+    }
+    return result < cap ? result : cap;
+}
+
+float SpeedPlanner::step(float limit, float dt) {
+    float diff = limit - speed_;
+    float up = options_.max_accel > 0 ? options_.max_accel * dt : diff;
+    float down = options_.max_decel > 0 ? options_.max_decel * dt : -diff;
+    if (diff > up) {
+        diff = up;
+    } else if (diff < -down) {
+        diff = -down;
+    }
+    speed_ += diff;
+    return speed_;
+}
+
+void SpeedPlanner::reset(float speed) {
+    speed_ = speed;
+}
+
+} // namespace robot
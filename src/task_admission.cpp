@@ -0,0 +1,150 @@
+#include "task_admission.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+namespace robot {
+
+namespace {
+
+// 参与分析的任务下标，按 优先级 -> 周期（速率单调）排序
+std::vector<size_t> priorityOrder(const std::vector<AdmissionTask>& tasks) {
+    std::vector<size_t> order;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        if (tasks[i].period_us > 0.0) {
+            order.push_back(i);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&tasks](size_t a, size_t b) {
+        if (tasks[a].priority != tasks[b].priority) {
+            return tasks[a].priority < tasks[b].priority;
+        }
+        return tasks[a].period_us < tasks[b].period_us;
+    });
+    return order;
+}
+
+// 单核非抢占式响应时间分析
+void responseTimeAnalysis(const std::vector<AdmissionTask>& tasks, AdmissionResult& result) {
+    auto order = priorityOrder(tasks);
+    result.response_us.assign(tasks.size(), 0.0);
+    result.bound = 1.0;
+
+    for (size_t k = 0; k < order.size(); ++k) {
+        const AdmissionTask& task = tasks[order[k]];
+
+        // 阻塞：已经开始执行的低优先级任务无法被打断
+        // 关键任务只会被可让路任务阻塞到让路阈值
+        double blocking = 0.0;
+        for (size_t l = k + 1; l < order.size(); ++l) {
+            const AdmissionTask& lp = tasks[order[l]];
+            if (task.critical && lp.sheddable) {
+                blocking = std::max(blocking, (task.period_us - task.wcet_us) / 2.0);
+            } else {
+                blocking = std::max(blocking, lp.wcet_us);
+            }
+        }
+
+        // 迭代求开始时间 w = B + Σ(floor(w/Tj)+1)·Cj
+        double start = blocking;
+        for (size_t j = 0; j < k; ++j) {
+            start += tasks[order[j]].wcet_us;
+        }
+        const double limit = task.period_us - task.wcet_us;
+        bool converged = false;
+        for (int iter = 0; iter < 1000 && start <= limit; ++iter) {
+            double next = blocking;
+            for (size_t j = 0; j < k; ++j) {
+                const AdmissionTask& hp = tasks[order[j]];
+                next += (std::floor(start / hp.period_us) + 1.0) * hp.wcet_us;
+            }
+            if (next == start) {
+                converged = true;
+                break;
+            }
+            start = next;
+        }
+
+        const double response = start + task.wcet_us;
+        result.response_us[order[k]] = response;
+        if (!converged || response > task.period_us) {
+            std::ostringstream oss;
+            oss << "任务 '" << task.name << "' 最坏响应时间 " << response
+                << "us 超过周期 " << task.period_us << "us";
+            result.schedulable = false;
+            result.reason = oss.str();
+            return;
+        }
+    }
+}
+
+} // namespace
+
+AdmissionResult analyzeSchedulability(const std::vector<AdmissionTask>& tasks, int cores) {
+    AdmissionResult result;
+    if (cores < 1) {
+        cores = 1;
+    }
+
+    double u_max = 0.0;
+    for (const auto& task : tasks) {
+        if (task.period_us <= 0.0) {
+            continue;
+        }
+        const double u = task.wcet_us / task.period_us;
+        result.utilization += u;
+        u_max = std::max(u_max, u);
+        if (u > 1.0) {
+            std::ostringstream oss;
+            oss << "任务 '" << task.name << "' 单独利用率 " << u << " > 1";
+            result.schedulable = false;
+            result.reason = oss.str();
+        }
+    }
+    if (!result.schedulable) {
+        return result;
+    }
+
+    if (cores == 1) {
+        responseTimeAnalysis(tasks, result);
+        return result;
+    }
+
+    result.bound = cores / 2.0 * (1.0 - u_max) + u_max;
+    if (result.utilization > result.bound) {
+        std::ostringstream oss;
+        oss << "总利用率 " << result.utilization << " 超过 " << cores
+            << " 核全局RM上界 " << result.bound;
+        result.schedulable = false;
+        result.reason = oss.str();
+    }
+    return result;
+}
+
+AdmissionResult degradeUntilSchedulable(std::vector<AdmissionTask>& tasks, int cores, double min_hz) {
+    const double max_period_us = 1e6 / std::max(min_hz, 1e-3);
+    AdmissionResult result = analyzeSchedulability(tasks, cores);
+
+    while (!result.schedulable) {
+        // 选出优先级最低（数值最大）、且还能降频的任务；同优先级先降频率高的
+        AdmissionTask* victim = nullptr;
+        for (auto& task : tasks) {
+            if (!task.degradable || task.period_us <= 0.0 || task.period_us * 2.0 > max_period_us) {
+                continue;
+            }
+            if (victim == nullptr || task.priority > victim->priority ||
+                (task.priority == victim->priority && task.period_us < victim->period_us)) {
+                victim = &task;
+            }
+        }
+        if (victim == nullptr) {
+            break;
+        }
+        victim->period_us *= 2.0;
+        result = analyzeSchedulability(tasks, cores);
+    }
+    return result;
+}
+
+} // namespace robot
@@ -1,7 +1,11 @@
 #include "task_scheduler.hpp"
 #include <algorithm>
+#include <cmath>
+#include <fstream>
 #include <iostream>
 #include <sstream>
+#include "json.hpp"
+#include "rt_thread.hpp"
 
 using namespace std::chrono;
 
@@ -12,20 +16,24 @@ TaskScheduler::TaskInfo::TaskInfo(const std::string& name,
                                  std::function<void()> func,
                                  int freq_hz,
                                  Priority prio,
-                                 int budget_ms)
+                                 int budget_ms,
+                                 const TaskOptions& opts)
     : name(name)
     , function(func)
     , frequency_hz(freq_hz)
     , priority(prio)
-    , time_budget_ms(budget_ms)
+    , options(opts)
     , last_stat_update(steady_clock::now())
     , last_execution_time(steady_clock::now()) {
     
-    if (frequency_hz > 0) {
-        period = microseconds(1000000 / frequency_hz);
+    if (options.period.count() > 0) {
+        period_us.store(options.period.count());
+    } else if (freq_hz > 0) {
+        period_us.store(1000000 / freq_hz);
     } else {
-        period = microseconds(0); // 单次任务
+        period_us.store(0); // 单次任务
     }
+    time_budget_us.store(options.time_budget_us > 0 ? options.time_budget_us : budget_ms * 1000);
     next_run_time = steady_clock::now();
     
     // 初始化原子变量
@@ -38,15 +46,14 @@ TaskScheduler::TaskInfo::TaskInfo(const std::string& name,
     min_interval_us.store(0);
     total_interval_us.store(0);
     interval_count.store(0);
+    total_executions.store(0);
+    release_time = next_run_time;
 }
 
 // TaskScheduler 构造函数
 TaskScheduler::TaskScheduler(int worker_threads)
-    : worker_threads_count_(worker_threads > 0 ? worker_threads : 1) {
-    // 确保至少有一个工作线程
-    if (worker_threads_count_ < 1) {
-        worker_threads_count_ = 1;
-    }
+    : worker_threads_count_(worker_threads >= 0 ? worker_threads : 1) {
+    // 0 个工作线程表示协作式，由调用者在 run() 中驱动
 }
 
 // TaskScheduler 析构函数
@@ -60,6 +67,16 @@ bool TaskScheduler::addTask(const std::string& name,
                            int frequency_hz, 
                            Priority priority,
                            int time_budget_ms) {
+    return addTask(name, std::move(task_function), frequency_hz, priority, time_budget_ms, TaskOptions{});
+}
+
+// 添加任务（带可选参数）
+bool TaskScheduler::addTask(const std::string& name,
+                           std::function<void()> task_function,
+                           int frequency_hz,
+                           Priority priority,
+                           int time_budget_ms,
+                           const TaskOptions& options) {
     
     // 参数检查
     if (name.empty() || !task_function) {
@@ -67,12 +84,12 @@ bool TaskScheduler::addTask(const std::string& name,
         return false;
     }
     
-    if (frequency_hz < 0) {
+    if (frequency_hz < 0 || options.period.count() < 0) {
         std::cerr << "TaskScheduler: 频率不能为负数" << std::endl;
         return false;
     }
     
-    if (time_budget_ms < 0) {
+    if (time_budget_ms < 0 || options.time_budget_us < 0) {
         std::cerr << "TaskScheduler: 时间预算不能为负数" << std::endl;
         return false;
     }
@@ -88,17 +105,35 @@ bool TaskScheduler::addTask(const std::string& name,
     }
     
     // 创建新任务
-    auto task = std::make_shared<TaskInfo>(name, task_function, frequency_hz, priority, time_budget_ms);
+    auto task = std::make_shared<TaskInfo>(name, task_function, frequency_hz, priority, time_budget_ms, options);
+
+    // 准入控制：新任务加入后必须仍然可调度（独占线程任务不占用工作线程，不参与分析）
+    if (admission_policy_ != AdmissionPolicy::None && task->periodic() && !options.dedicated_thread) {
+        auto candidates = admissionTasks(tasks_);
+        auto incoming = admissionTasks({task});
+        candidates.push_back(incoming.front());
+        if (!admit(candidates, name)) {
+            return false;
+        }
+        double period_us = candidates.back().period_us;
+        if (static_cast<int64_t>(std::llround(period_us)) != task->period_us.load()) {
+            task->period_us.store(std::llround(period_us));
+            task->frequency_hz.store(static_cast<int>(std::lround(1e6 / period_us)));
+            std::cout << "TaskScheduler: 任务 '" << name << "' 降频到 " << task->frequency_hz.load() << " Hz" << std::endl;
+        }
+    }
+
     tasks_.push_back(task);
+    sortTasks();
+    publishTaskView();
     
-    // 按优先级排序（CRITICAL 优先）
-    std::sort(tasks_.begin(), tasks_.end(), 
-              [](const std::shared_ptr<TaskInfo>& a, const std::shared_ptr<TaskInfo>& b) {
-                  return static_cast<int>(a->priority) < static_cast<int>(b->priority);
-              });
-    
-    std::cout << "TaskScheduler: 添加任务 '" << name << "'，频率 " << frequency_hz << " Hz，优先级 " 
-              << static_cast<int>(priority) << std::endl;
+    std::cout << "TaskScheduler: 添加任务 '" << name << "'，频率 " << task->frequency_hz.load() << " Hz，优先级 " 
+              << static_cast<int>(priority) << (options.dedicated_thread ? "（独占线程）" : "") << std::endl;
+
+    // 运行中添加的独占线程任务立即启动
+    if (running_ && options.dedicated_thread) {
+        launchDedicated(task);
+    }
     
     // 通知工作线程有新任务
     condition_.notify_all();
@@ -111,11 +146,17 @@ bool TaskScheduler::removeTask(const std::string& name) {
     
     auto it = std::remove_if(tasks_.begin(), tasks_.end(),
                             [&name](const std::shared_ptr<TaskInfo>& task) {
-                                return task->name == name;
+                                if (task->name == name) {
+                                    task->removed.store(true);
+                                    return true;
+                                }
+                                return false;
                             });
     
     if (it != tasks_.end()) {
         tasks_.erase(it, tasks_.end());
+        publishTaskView();
+        condition_.notify_all();
         std::cout << "TaskScheduler: 移除任务 '" << name << "'" << std::endl;
         return true;
     }
@@ -124,6 +165,58 @@ bool TaskScheduler::removeTask(const std::string& name) {
     return false;
 }
 
+// 修改任务优先级
+bool TaskScheduler::setTaskPriority(const std::string& name, Priority priority) {
+    std::lock_guard<std::mutex> lock(tasks_mutex_);
+    for (auto& task : tasks_) {
+        if (task->name == name) {
+            task->priority = priority;
+            sortTasks();
+            publishTaskView();
+            return true;
+        }
+    }
+    std::cerr << "TaskScheduler: 任务 '" << name << "' 不存在" << std::endl;
+    return false;
+}
+
+// 修改任务时间预算
+bool TaskScheduler::setTaskBudget(const std::string& name, microseconds budget) {
+    std::lock_guard<std::mutex> lock(tasks_mutex_);
+    for (auto& task : tasks_) {
+        if (task->name != name) {
+            continue;
+        }
+        if (admission_policy_ != AdmissionPolicy::None && task->periodic() && !task->options.dedicated_thread) {
+            auto candidates = admissionTasks(tasks_);
+            for (auto& item : candidates) {
+                if (item.name == name) {
+                    item.wcet_us = std::max(item.wcet_us, static_cast<double>(budget.count()));
+                }
+            }
+            if (!admit(candidates, name)) {
+                return false;
+            }
+        }
+        task->time_budget_us.store(static_cast<int>(budget.count()));
+        return true;
+    }
+    std::cerr << "TaskScheduler: 任务 '" << name << "' 不存在" << std::endl;
+    return false;
+}
+
+// 设置工作线程CPU绑定
+void TaskScheduler::setWorkerCpus(const std::vector<int>& cpus) {
+    std::lock_guard<std::mutex> lock(tasks_mutex_);
+    worker_cpus_ = cpus;
+}
+
+// 设置工作线程实时优先级
+void TaskScheduler::setWorkerRealtimePriority(int rt_priority) {
+    std::lock_guard<std::mutex> lock(tasks_mutex_);
+    worker_rt_priority_ = rt_priority;
+}
+
 // 启动调度器
 bool TaskScheduler::start() {
     if (running_) {
@@ -138,20 +231,60 @@ bool TaskScheduler::start() {
     for (int i = 0; i < worker_threads_count_; ++i) {
         worker_threads_.emplace_back(&TaskScheduler::workerThread, this, i);
     }
-    
-    // 启动统计线程
-    stats_running_ = true;
-    stats_thread_ = std::thread([this]() {
-        while (stats_running_) {
-            updateTaskStats();
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    // 启动独占线程任务
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        for (const auto& task : tasks_) {
+            if (task->options.dedicated_thread) {
+                launchDedicated(task);
+            }
         }
-    });
+    }
+    
+    // 启动统计线程（协作式下由 run() 循环负责统计）
+    if (worker_threads_count_ > 0) {
+        stats_running_ = true;
+        stats_thread_ = std::thread([this]() {
+            while (stats_running_) {
+                updateTaskStats();
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+            }
+        });
+    }
     
     std::cout << "TaskScheduler: 启动调度器，工作线程数: " << worker_threads_count_ << std::endl;
     return true;
 }
 
+// 协作式调度循环
+bool TaskScheduler::run(const std::function<bool()>& stop_flag) {
+    if (worker_threads_count_ != 0) {
+        std::cerr << "TaskScheduler: run() 只用于协作式调度器（worker_threads == 0）" << std::endl;
+        return false;
+    }
+    if (!running_ && !start()) {
+        return false;
+    }
+
+    applyWorkerThreadConfig(0);
+    auto last_stats_update = steady_clock::now();
+
+    while (running_ && !stop_requested_ && !(stop_flag && stop_flag())) {
+        // 最多等待10ms，保证 stop_flag 被及时检查
+        dispatchOnce(steady_clock::now() + milliseconds(10));
+
+        auto now = steady_clock::now();
+        if (now - last_stats_update >= seconds(1)) {
+            updateTaskStats();
+            last_stats_update = now;
+        }
+    }
+
+    stop();
+    return true;
+}
+
 // 停止调度器
 void TaskScheduler::stop() {
     if (!running_) {
@@ -162,9 +295,19 @@ void TaskScheduler::stop() {
     
     stop_requested_ = true;
     running_ = false;
+
+    // 唤醒阻塞在独占线程中的任务（如 Web 服务的 listen）
+    for (const auto& task : *taskView()) {
+        if (task->options.dedicated_thread && task->options.on_stop) {
+            task->options.on_stop();
+        }
+    }
     
-    // 通知所有线程
-    condition_.notify_all();
+    // 通知所有线程（持锁通知，避免等待方在检查条件与进入等待之间错过）
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        condition_.notify_all();
+    }
     
     // 停止统计线程
     stats_running_ = false;
@@ -178,98 +321,213 @@ void TaskScheduler::stop() {
             thread.join();
         }
     }
-    
     worker_threads_.clear();
+
+    for (auto& thread : dedicated_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    dedicated_threads_.clear();
     
     std::cout << "TaskScheduler: 调度器已停止" << std::endl;
 }
 
+// 工作线程配置
+void TaskScheduler::applyWorkerThreadConfig(int thread_id) {
+    std::vector<int> cpus;
+    int rt_priority = 0;
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        cpus = worker_cpus_;
+        rt_priority = worker_rt_priority_;
+    }
+    if (!cpus.empty()) {
+        setThreadAffinity(cpus[thread_id % cpus.size()]);
+    }
+    if (rt_priority > 0) {
+        setThreadRealtimePriority(rt_priority);
+    }
+}
+
 // 工作线程函数
 void TaskScheduler::workerThread(int thread_id) {
+    applyWorkerThreadConfig(thread_id);
     std::cout << "TaskScheduler: 工作线程 " << thread_id << " 启动" << std::endl;
     
     while (running_ && !stop_requested_) {
-        std::shared_ptr<TaskInfo> task_to_execute;
-        auto now = steady_clock::now();
+        if (dispatchOnce(steady_clock::time_point::max())) {
+            // 短暂休眠以避免忙等待，但保持响应性
+            std::this_thread::sleep_for(microseconds(10));
+        }
+    }
+    
+    std::cout << "TaskScheduler: 工作线程 " << thread_id << " 退出" << std::endl;
+}
+
+// 选出一个就绪任务并执行
+bool TaskScheduler::dispatchOnce(steady_clock::time_point wait_limit) {
+    std::shared_ptr<TaskInfo> task_to_execute;
+    auto now = steady_clock::now();
+    
+    {
+        std::unique_lock<std::mutex> lock(tasks_mutex_);
+        if (stop_requested_) {
+            return false;
+        }
         
-        {
-            std::unique_lock<std::mutex> lock(tasks_mutex_);
-            
-            // 如果没有任务，等待
-            if (tasks_.empty()) {
-                condition_.wait(lock);
+        // 查找就绪任务：固定优先级调度（与准入分析一致），同优先级按细分等级、到期时间
+        std::shared_ptr<TaskInfo> earliest_task = nullptr;
+        
+        for (auto& task : tasks_) {
+            if (task->options.dedicated_thread || now < task->next_run_time || task->is_running.load()) {
                 continue;
             }
-            
-            // 查找最早到期的就绪任务（按优先级和到期时间）
-            steady_clock::time_point earliest_time = steady_clock::time_point::max();
-            std::shared_ptr<TaskInfo> earliest_task = nullptr;
-            
-            for (auto& task : tasks_) {
-                if (now >= task->next_run_time && !task->is_running.load()) {
-                    // 找到就绪任务，选择最早到期的（按优先级优先）
-                    if (earliest_task == nullptr || 
-                        task->next_run_time < earliest_time ||
-                        (task->next_run_time == earliest_time && 
-                         static_cast<int>(task->priority) < static_cast<int>(earliest_task->priority))) {
-                        earliest_task = task;
-                        earliest_time = task->next_run_time;
-                    }
-                }
+
+            // 上次超出预算且设置了跳过：放弃本次
+            if (task->skip_next.exchange(false) && task->periodic()) {
+                advanceNextRun(*task, now);
+                continue;
             }
-            
-            // 如果没有就绪任务，计算下一个唤醒时间
-            if (earliest_task == nullptr) {
-                auto next_wake_time = steady_clock::time_point::max();
-                for (const auto& task : tasks_) {
-                    if (task->next_run_time < next_wake_time) {
-                        next_wake_time = task->next_run_time;
-                    }
+
+            // 会阻塞即将释放的 CRITICAL 任务：先推迟（让路），推迟超过一个周期则跳过本次
+            if (shouldShed(*task, now)) {
+                if (!task->deferred) {
+                    task->deferred = true;
+                    task->shed_count.fetch_add(1, std::memory_order_relaxed);
                 }
-                
-                if (next_wake_time != steady_clock::time_point::max()) {
-                    condition_.wait_until(lock, next_wake_time);
-                } else {
-                    condition_.wait(lock);
+                if (now - task->next_run_time >= task->period()) {
+                    task->next_run_time += task->period();
+                    task->missed_deadlines.fetch_add(1);
                 }
                 continue;
             }
-            
-            // 标记任务为执行中
-            task_to_execute = earliest_task;
-            task_to_execute->is_running.store(true);
-            
-            // 更新任务的下次执行时间（基于计划时间，不是当前时间）
-            if (task_to_execute->frequency_hz > 0) {
-                // 周期性任务：基于计划时间更新下次执行时间
-                task_to_execute->next_run_time = task_to_execute->next_run_time + task_to_execute->period;
-                
-                // 如果任务已经严重滞后，跳过一些周期
-                while (task_to_execute->next_run_time <= now && task_to_execute->frequency_hz > 0) {
-                    task_to_execute->next_run_time += task_to_execute->period;
-                    task_to_execute->missed_deadlines.fetch_add(1);
-                }
-            } else {
-                // 单次任务：设置为最大时间，不再执行
-                task_to_execute->next_run_time = steady_clock::time_point::max();
+
+            if (earliest_task == nullptr || 
+                static_cast<int>(task->priority) < static_cast<int>(earliest_task->priority) ||
+                (task->priority == earliest_task->priority &&
+                 (task->options.rank > earliest_task->options.rank ||
+                  (task->options.rank == earliest_task->options.rank &&
+                   task->next_run_time < earliest_task->next_run_time)))) {
+                earliest_task = task;
             }
         }
         
-        // 执行单个任务
-        if (task_to_execute) {
-            executeTask(task_to_execute);
+        // 如果没有就绪任务，计算下一个唤醒时间（被推迟的任务已到期，不参与计算）
+        if (earliest_task == nullptr) {
+            auto next_wake_time = wait_limit;
+            for (const auto& task : tasks_) {
+                if (!task->options.dedicated_thread &&
+                    task->next_run_time > now && task->next_run_time < next_wake_time) {
+                    next_wake_time = task->next_run_time;
+                }
+            }
+            
+            if (next_wake_time != steady_clock::time_point::max()) {
+                condition_.wait_until(lock, next_wake_time);
+            } else {
+                condition_.wait(lock);
+            }
+            return false;
         }
         
-        // 短暂休眠以避免忙等待，但保持响应性
-        std::this_thread::sleep_for(microseconds(10));
+        // 标记任务为执行中，并记录本次的计划释放时间用于延迟统计
+        task_to_execute = earliest_task;
+        task_to_execute->is_running.store(true);
+        task_to_execute->deferred = false;
+        task_to_execute->release_time = task_to_execute->next_run_time;
+        advanceNextRun(*task_to_execute, now);
+        busy_workers_.fetch_add(1);
     }
     
-    std::cout << "TaskScheduler: 工作线程 " << thread_id << " 退出" << std::endl;
+    // 执行单个任务
+    executeTask(task_to_execute);
+    busy_workers_.fetch_sub(1);
+    return true;
+}
+
+// 推进下次执行时间（基于计划时间，不是当前时间）
+void TaskScheduler::advanceNextRun(TaskInfo& task, steady_clock::time_point now) {
+    if (!task.periodic()) {
+        // 单次任务：设置为最大时间，不再执行
+        task.next_run_time = steady_clock::time_point::max();
+        return;
+    }
+
+    auto period = task.period();
+    task.next_run_time += period;
+    if (task.next_run_time > now) {
+        return;
+    }
+
+    if (task.options.miss_policy == MissPolicy::Skip) {
+        // 重新对齐到当前时间
+        task.next_run_time = now + period;
+        task.missed_deadlines.fetch_add(1);
+    } else {
+        // 保持相位，跳过已经错过的周期
+        while (task.next_run_time <= now) {
+            task.next_run_time += period;
+            task.missed_deadlines.fetch_add(1);
+        }
+    }
+}
+
+// 启动独占线程任务
+void TaskScheduler::launchDedicated(const std::shared_ptr<TaskInfo>& task) {
+    dedicated_threads_.emplace_back(&TaskScheduler::dedicatedThread, this, task);
+}
+
+// 独占线程任务循环
+void TaskScheduler::dedicatedThread(std::shared_ptr<TaskInfo> task) {
+    if (task->options.cpu >= 0) {
+        setThreadAffinity(task->options.cpu);
+    }
+    if (task->options.rt_priority > 0) {
+        setThreadRealtimePriority(task->options.rt_priority);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        task->next_run_time = steady_clock::now();
+    }
+
+    while (running_ && !stop_requested_ && !task->removed) {
+        {
+            std::unique_lock<std::mutex> lock(tasks_mutex_);
+            auto wake = [this, &task] { return stop_requested_ || task->removed; };
+            if (task->next_run_time == steady_clock::time_point::max()) {
+                condition_.wait(lock, wake);
+            } else {
+                condition_.wait_until(lock, task->next_run_time, wake);
+            }
+            if (stop_requested_ || task->removed) {
+                break;
+            }
+
+            auto now = steady_clock::now();
+            if (now < task->next_run_time) {
+                continue; // 被其他任务的通知唤醒
+            }
+            if (task->skip_next.exchange(false) && task->periodic()) {
+                advanceNextRun(*task, now);
+                continue;
+            }
+            task->is_running.store(true);
+            task->release_time = task->next_run_time;
+            advanceNextRun(*task, now);
+        }
+        executeTask(task);
+    }
 }
 
 // 执行单个任务
 void TaskScheduler::executeTask(std::shared_ptr<TaskInfo> task) {
     auto start_time = steady_clock::now();
+
+    // 启动延迟：实际开始时间相对计划释放时间
+    auto start_latency = duration_cast<microseconds>(start_time - task->release_time).count();
+    task->latency_hist.record(start_latency > 0 ? static_cast<uint64_t>(start_latency) : 0);
     
     // 计算执行间隔（从上次执行到现在的时间）
     auto time_since_last_execution = duration_cast<microseconds>(start_time - task->last_execution_time);
@@ -296,8 +554,8 @@ void TaskScheduler::executeTask(std::shared_ptr<TaskInfo> task) {
         }
         
         // 更新总间隔和计数
-        task->total_interval_us.fetch_add(interval_us);
-        task->interval_count.fetch_add(1);
+        task->total_interval_us.fetch_add(static_cast<uint64_t>(interval_us), std::memory_order_relaxed);
+        task->interval_count.fetch_add(1, std::memory_order_relaxed);
     } else {
         // 第一次执行，初始化间隔统计
         task->interval_count.store(1);
@@ -308,7 +566,8 @@ void TaskScheduler::executeTask(std::shared_ptr<TaskInfo> task) {
         task->function();
         
         // 更新执行计数
-        task->execution_count.fetch_add(1);
+        task->execution_count.fetch_add(1, std::memory_order_relaxed);
+        task->total_executions.fetch_add(1, std::memory_order_relaxed);
         
     } catch (const std::exception& e) {
         std::cerr << "TaskScheduler: 任务 '" << task->name << "' 抛出异常: " << e.what() << std::endl;
@@ -320,15 +579,24 @@ void TaskScheduler::executeTask(std::shared_ptr<TaskInfo> task) {
     auto execution_time = duration_cast<microseconds>(end_time - start_time);
     
     // 更新执行时间
-    task->execution_time_us.store(execution_time.count());
+    task->execution_time_us.store(static_cast<int>(execution_time.count()));
+    task->exec_hist.record(static_cast<uint64_t>(execution_time.count()));
     
     // 检查是否超时
-    if (task->time_budget_ms > 0) {
-        auto execution_time_ms = execution_time.count() / 1000;
-        if (execution_time_ms > task->time_budget_ms) {
-            task->missed_deadlines.fetch_add(1);
+    int budget_us = task->time_budget_us.load(std::memory_order_relaxed);
+    if (budget_us > 0 && execution_time.count() > budget_us) {
+        task->missed_deadlines.fetch_add(1);
+        task->budget_overruns.fetch_add(1, std::memory_order_relaxed);
+        auto over = microseconds(execution_time.count() - budget_us);
+        bool skip = task->options.skip_after_overrun;
+        if (task->options.on_overrun) {
+            skip = task->options.on_overrun(task->name, over) || skip;
+        } else {
             std::cerr << "TaskScheduler: 任务 '" << task->name << "' 超时: " 
-                      << execution_time_ms << "ms > " << task->time_budget_ms << "ms" << std::endl;
+                      << execution_time.count() << "us > " << budget_us << "us" << std::endl;
+        }
+        if (skip) {
+            task->skip_next.store(true);
         }
     }
     
@@ -336,28 +604,49 @@ void TaskScheduler::executeTask(std::shared_ptr<TaskInfo> task) {
     task->is_running.store(false);
 }
 
+// 发布写时复制的任务列表（调用者持有 tasks_mutex_）
+void TaskScheduler::publishTaskView() {
+    auto view = std::make_shared<const std::vector<std::shared_ptr<TaskInfo>>>(tasks_);
+    std::atomic_store(&tasks_view_, view);
+}
+
+// 无锁获取任务列表
+std::shared_ptr<const std::vector<std::shared_ptr<TaskScheduler::TaskInfo>>> TaskScheduler::taskView() const {
+    auto view = std::atomic_load(&tasks_view_);
+    if (!view) {
+        view = std::make_shared<const std::vector<std::shared_ptr<TaskInfo>>>();
+    }
+    return view;
+}
+
 // 更新任务统计信息
+// 只访问任务列表的只读副本，不持有 tasks_mutex_，避免与工作线程争锁
 void TaskScheduler::updateTaskStats() {
-    std::lock_guard<std::mutex> lock(tasks_mutex_);
-    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
-    
+    auto view = taskView();
     auto now = steady_clock::now();
+    std::map<std::string, std::map<std::string, int>> new_stats;
     
-    for (const auto& task : tasks_) {
+    for (const auto& task : *view) {
         std::map<std::string, int> stats;
         
         // 计算实际频率（过去1秒内的执行次数）
         auto time_since_last_update = duration_cast<seconds>(now - task->last_stat_update);
         if (time_since_last_update.count() >= 1) {
-            task->actual_frequency.store(task->execution_count.load());
-            task->execution_count.store(0);
+            task->actual_frequency.store(task->execution_count.exchange(0, std::memory_order_relaxed));
             task->last_stat_update = now;
         }
         
         // 计算平均间隔
         int avg_interval_us = 0;
-        if (task->interval_count.load() > 0) {
-            avg_interval_us = task->total_interval_us.load() / task->interval_count.load();
+        uint64_t interval_count = task->interval_count.load(std::memory_order_relaxed);
+        if (interval_count > 0) {
+            avg_interval_us = static_cast<int>(task->total_interval_us.load(std::memory_order_relaxed) / interval_count);
+        }
+
+        auto exec = task->exec_hist.snapshot();
+        auto latency = task->latency_hist.snapshot();
+        if (exec.count >= 8) {
+            task->wcet_estimate_us.store(static_cast<int>(exec.percentile(99)), std::memory_order_relaxed);
         }
         
         stats["frequency_hz"] = task->frequency_hz;
@@ -365,14 +654,38 @@ void TaskScheduler::updateTaskStats() {
         stats["execution_time_us"] = task->execution_time_us.load();
         stats["missed_deadlines"] = task->missed_deadlines.load();
         stats["priority"] = static_cast<int>(task->priority);
-        stats["time_budget_ms"] = task->time_budget_ms;
+        stats["time_budget_ms"] = task->time_budget_us.load() / 1000;
         stats["max_interval_us"] = task->max_interval_us.load();
         stats["min_interval_us"] = task->min_interval_us.load();
         stats["avg_interval_us"] = avg_interval_us;
-        stats["target_interval_us"] = (task->frequency_hz > 0) ? (1000000 / task->frequency_hz) : 0;
+        stats["target_interval_us"] = static_cast<int>(task->period_us.load());
+        stats["exec_p50_us"] = static_cast<int>(exec.percentile(50));
+        stats["exec_p90_us"] = static_cast<int>(exec.percentile(90));
+        stats["exec_p99_us"] = static_cast<int>(exec.percentile(99));
+        stats["exec_max_us"] = static_cast<int>(exec.max);
+        stats["latency_p50_us"] = static_cast<int>(latency.percentile(50));
+        stats["latency_p90_us"] = static_cast<int>(latency.percentile(90));
+        stats["latency_p99_us"] = static_cast<int>(latency.percentile(99));
+        stats["latency_max_us"] = static_cast<int>(latency.max);
+        stats["shed_count"] = task->shed_count.load();
+        stats["budget_overruns"] = task->budget_overruns.load();
+        stats["wcet_estimate_us"] = estimateWcetUs(*task);
         
-        tasks_stats_[task->name] = stats;
+        new_stats[task->name] = std::move(stats);
+    }
+
+    // 实测执行时间变化后重新检查可调度性，只在状态切换时打印
+    AdmissionResult admission = analyzeSchedulability(admissionTasks(*view), analysisCores());
+    if (schedulable_.exchange(admission.schedulable) != admission.schedulable) {
+        if (admission.schedulable) {
+            std::cout << "TaskScheduler: 任务集合恢复可调度，利用率 " << admission.utilization << std::endl;
+        } else {
+            std::cerr << "TaskScheduler: 按实测执行时间任务集合不可调度，" << admission.reason << std::endl;
+        }
     }
+
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    tasks_stats_.swap(new_stats);
 }
 
 // 获取所有任务统计信息
@@ -381,4 +694,227 @@ std::map<std::string, std::map<std::string, int>> TaskScheduler::getTasksStats()
     return tasks_stats_;
 }
 
+// 获取所有任务的直方图快照
+std::vector<TaskStatsSnapshot> TaskScheduler::getTaskSnapshots() const {
+    auto view = taskView();
+    std::vector<TaskStatsSnapshot> result;
+    result.reserve(view->size());
+
+    for (const auto& task : *view) {
+        TaskStatsSnapshot snap;
+        snap.name = task->name;
+        snap.frequency_hz = task->frequency_hz;
+        snap.priority = task->priority;
+        snap.time_budget_ms = task->time_budget_us.load(std::memory_order_relaxed) / 1000;
+        snap.actual_frequency_hz = task->actual_frequency.load(std::memory_order_relaxed);
+        snap.missed_deadlines = task->missed_deadlines.load(std::memory_order_relaxed);
+        snap.shed_count = task->shed_count.load(std::memory_order_relaxed);
+        snap.budget_overruns = task->budget_overruns.load(std::memory_order_relaxed);
+        snap.period_us = task->period_us.load(std::memory_order_relaxed);
+        snap.total_executions = task->total_executions.load(std::memory_order_relaxed);
+        snap.exec_us = task->exec_hist.snapshot();
+        snap.latency_us = task->latency_hist.snapshot();
+        result.push_back(std::move(snap));
+    }
+    return result;
+}
+
+// 以JSON字符串导出统计信息
+std::string TaskScheduler::getStatsJson() const {
+    nlohmann::json tasks = nlohmann::json::array();
+    for (const auto& snap : getTaskSnapshots()) {
+        tasks.push_back({
+            {"name", snap.name},
+            {"priority", static_cast<int>(snap.priority)},
+            {"frequency_hz", snap.frequency_hz},
+            {"actual_frequency_hz", snap.actual_frequency_hz},
+            {"time_budget_ms", snap.time_budget_ms},
+            {"missed_deadlines", snap.missed_deadlines},
+            {"shed_count", snap.shed_count},
+            {"budget_overruns", snap.budget_overruns},
+            {"total_executions", snap.total_executions},
+            {"exec_us", {
+                {"mean", snap.exec_us.mean()},
+                {"p50", snap.exec_us.percentile(50)},
+                {"p90", snap.exec_us.percentile(90)},
+                {"p99", snap.exec_us.percentile(99)},
+                {"max", snap.exec_us.max}}},
+            {"latency_us", {
+                {"mean", snap.latency_us.mean()},
+                {"p50", snap.latency_us.percentile(50)},
+                {"p90", snap.latency_us.percentile(90)},
+                {"p99", snap.latency_us.percentile(99)},
+                {"max", snap.latency_us.max}}}
+        });
+    }
+    return tasks.dump();
+}
+
+// 将统计信息导出为CSV字符串
+std::string TaskScheduler::getStatsCsv() const {
+    std::ostringstream csv;
+    csv << "name,priority,frequency_hz,actual_frequency_hz,time_budget_ms,missed_deadlines,budget_overruns,total_executions,"
+        << "exec_mean_us,exec_p50_us,exec_p90_us,exec_p99_us,exec_max_us,"
+        << "latency_mean_us,latency_p50_us,latency_p90_us,latency_p99_us,latency_max_us\n";
+    for (const auto& snap : getTaskSnapshots()) {
+        csv << snap.name << ','
+            << static_cast<int>(snap.priority) << ','
+            << snap.frequency_hz << ','
+            << snap.actual_frequency_hz << ','
+            << snap.time_budget_ms << ','
+            << snap.missed_deadlines << ','
+            << snap.budget_overruns << ','
+            << snap.total_executions << ','
+            << snap.exec_us.mean() << ','
+            << snap.exec_us.percentile(50) << ','
+            << snap.exec_us.percentile(90) << ','
+            << snap.exec_us.percentile(99) << ','
+            << snap.exec_us.max << ','
+            << snap.latency_us.mean() << ','
+            << snap.latency_us.percentile(50) << ','
+            << snap.latency_us.percentile(90) << ','
+            << snap.latency_us.percentile(99) << ','
+            << snap.latency_us.max << '\n';
+    }
+    return csv.str();
+}
+
+// 将统计信息导出为CSV文件
+bool TaskScheduler::dumpStatsCsv(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "TaskScheduler: 无法写入统计文件 '" << path << "'" << std::endl;
+        return false;
+    }
+    file << getStatsCsv();
+    return static_cast<bool>(file);
+}
+
+// 设置准入控制策略
+void TaskScheduler::setAdmissionPolicy(AdmissionPolicy policy, bool shed_for_critical) {
+    std::lock_guard<std::mutex> lock(tasks_mutex_);
+    admission_policy_ = policy;
+    shed_for_critical_ = shed_for_critical;
+}
+
+// 按实测执行时间重新分析
+AdmissionResult TaskScheduler::checkAdmission() const {
+    return analyzeSchedulability(admissionTasks(*taskView()), analysisCores());
+}
+
+// 按优先级、细分等级排序（调用者持有 tasks_mutex_）
+void TaskScheduler::sortTasks() {
+    std::stable_sort(tasks_.begin(), tasks_.end(),
+                     [](const std::shared_ptr<TaskInfo>& a, const std::shared_ptr<TaskInfo>& b) {
+                         if (a->priority != b->priority) {
+                             return static_cast<int>(a->priority) < static_cast<int>(b->priority);
+                         }
+                         return a->options.rank > b->options.rank;
+                     });
+}
+
+// 对候选任务集合做准入，通过时把降频结果写回（调用者持有 tasks_mutex_）
+bool TaskScheduler::admit(std::vector<AdmissionTask>& candidates, const std::string& name) {
+    AdmissionResult result = analyzeSchedulability(candidates, analysisCores());
+    if (!result.schedulable && admission_policy_ == AdmissionPolicy::Degrade) {
+        result = degradeUntilSchedulable(candidates, analysisCores());
+    }
+    if (!result.schedulable) {
+        std::cerr << "TaskScheduler: 任务 '" << name << "' 未通过准入检查，" << result.reason << std::endl;
+        return false;
+    }
+
+    // 写回被降频的已有任务
+    for (const auto& item : candidates) {
+        for (auto& task : tasks_) {
+            if (task->name != item.name) {
+                continue;
+            }
+            int64_t period_us = std::llround(item.period_us);
+            if (period_us != task->period_us.load()) {
+                task->period_us.store(period_us);
+                task->frequency_hz.store(static_cast<int>(std::lround(1e6 / item.period_us)));
+                std::cout << "TaskScheduler: 任务 '" << task->name << "' 降频到 " << task->frequency_hz.load() << " Hz" << std::endl;
+            }
+        }
+    }
+    return true;
+}
+
+// 执行时间估计
+int TaskScheduler::estimateWcetUs(const TaskInfo& task) {
+    return std::max(task.time_budget_us.load(std::memory_order_relaxed), task.wcet_estimate_us.load(std::memory_order_relaxed));
+}
+
+// 生成准入分析用的任务列表
+std::vector<AdmissionTask> TaskScheduler::admissionTasks(const std::vector<std::shared_ptr<TaskInfo>>& tasks) const {
+    std::vector<AdmissionTask> result;
+    result.reserve(tasks.size() + 1);
+    for (const auto& task : tasks) {
+        if (task->options.dedicated_thread) {
+            continue;
+        }
+        AdmissionTask item;
+        item.name = task->name;
+        item.period_us = static_cast<double>(task->period_us.load());
+        item.wcet_us = estimateWcetUs(*task);
+        item.priority = static_cast<int>(task->priority);
+        item.degradable = static_cast<int>(task->priority) >= static_cast<int>(Priority::MEDIUM);
+        item.critical = task->priority == Priority::CRITICAL;
+        item.sheddable = item.degradable && shed_for_critical_;
+        result.push_back(item);
+    }
+    return result;
+}
+
+// 运行时让路判断（调用者持有 tasks_mutex_）
+// 只有在没有其他空闲工作线程时才需要让路；阻塞时间超过 CRITICAL 任务一半松弛量即视为有风险
+bool TaskScheduler::shouldShed(const TaskInfo& candidate, steady_clock::time_point now) const {
+    if (!shed_for_critical_ || !candidate.periodic() ||
+        static_cast<int>(candidate.priority) < static_cast<int>(Priority::MEDIUM)) {
+        return false;
+    }
+    if (busy_workers_.load() + 1 < analysisCores()) {
+        return false;
+    }
+    int candidate_us = estimateWcetUs(candidate);
+    if (candidate_us <= 0) {
+        return false;
+    }
+    auto candidate_finish = now + microseconds(candidate_us);
+
+    for (const auto& task : tasks_) {
+        if (task->priority != Priority::CRITICAL || task->is_running.load() || !task->periodic() ||
+            task->options.dedicated_thread) {
+            continue;
+        }
+        auto release = std::max(task->next_run_time, now);
+        if (candidate_finish <= release) {
+            continue;
+        }
+        auto blocking = candidate_finish - release;
+        auto slack = (task->period() - microseconds(estimateWcetUs(*task))) / 2;
+        if (blocking > slack) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 清空所有任务的直方图与计数
+void TaskScheduler::resetStats() {
+    auto view = taskView();
+    for (const auto& task : *view) {
+        task->exec_hist.reset();
+        task->latency_hist.reset();
+        task->missed_deadlines.store(0, std::memory_order_relaxed);
+        task->shed_count.store(0, std::memory_order_relaxed);
+        task->budget_overruns.store(0, std::memory_order_relaxed);
+        task->max_interval_us.store(0, std::memory_order_relaxed);
+        task->min_interval_us.store(0, std::memory_order_relaxed);
+        task->total_interval_us.store(0, std::memory_order_relaxed);
+        task->interval_count.store(0, std::memory_order_relaxed);
+    }
+}
+
 } // namespace robot
\ No newline at end of file
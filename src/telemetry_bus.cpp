@@ -0,0 +1,71 @@
+#include "telemetry_bus.hpp"
+
+namespace robot {
+
+TelemetryBus::TelemetryBus(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    mask_ = size - 1;
+    slots_.reset(new Slot[size]);
+}
+
+void TelemetryBus::pushRaw(TelemetryType type, const void* payload, size_t size, int64_t timestamp_ns) {
+    if (size > PAYLOAD_SIZE) {
+        size = PAYLOAD_SIZE;
+    }
+    uint64_t n = head_.fetch_add(1, std::memory_order_acq_rel);
+    Slot& slot = slots_[n & mask_];
+    slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    TelemetryRecord& record = slot.record;
+    record.type = (uint16_t)type;
+    record.size = (uint16_t)size;
+    record.sequence = (uint32_t)n;
+    record.timestamp_ns = timestamp_ns;
+    std::memcpy(record.payload, payload, size);
+    std::memset(record.payload + size, 0, PAYLOAD_SIZE - size);
+    slot.seq.store(2 * n + 2, std::memory_order_release);
+}
+
+size_t TelemetryBus::read(uint64_t* cursor, TelemetryRecord* out, size_t max, uint64_t* lost) const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t next = *cursor;
+    uint64_t skipped = 0;
+    if (next > head) {
+        next = head;
+    }
+    if (head - next > capacity()) {
+        skipped += head - capacity() - next;
+        next = head - capacity();
+    }
+    size_t count = 0;
+    while (count < max && next < head) {
+        const Slot& slot = slots_[next & mask_];
+        uint64_t expected = 2 * next + 2;
+        uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before < expected) {
+            break;      // 生产者已占位但还没写完，下次再读
+        }
+        if (before == expected) {
+            out[count] = slot.record;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) == expected) {
+                count++;
+                next++;
+                continue;
+            }
+        }
+        // 读取过程中被下一圈覆盖
+        skipped++;
+        next++;
+    }
+    *cursor = next;
+    if (lost) {
+        *lost += skipped;
+    }
+    return count;
+}
+
+} // namespace robot
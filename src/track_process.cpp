@@ -0,0 +1,55 @@
+#include "common_system.h"
+#include "common_program.h"
+#include "track_process.h"
+#include "frame_trace.hpp"
+
+static ImgProcess track_imgProcess;
+static Judge track_judge;
+
+void TrackProcess(Img_Store *Img_Store_p,Data_Path *Data_Path_p,Function_EN *Function_EN_p,uint64_t frame_id)
+{
+    Data_Path_p -> JSON_TrackConfigData_v[0].Forward = Data_Path_p -> JSON_TrackConfigData_v[0].Default_Forward;
+
+    {
+        FRAME_TRACE_SCOPE(frame_id, "imgSearch_l_r");
+        imgSearch_l_r(Img_Store_p,Data_Path_p);   // 边线八邻域寻线
+        if (Img_Store_p -> Draw_EN) {
+            track_imgProcess.ImgLabel(Img_Store_p,Data_Path_p,Function_EN_p);
+        }
+    }
+
+    // 赛道类型决策与补线
+    int64_t judge_start_ns = robot::FrameTracer::nowNs();
+    Function_EN_p -> Loop_Kind_EN = track_judge.TrackKind_Judge(Img_Store_p,Data_Path_p,Function_EN_p);
+    switch(Function_EN_p -> Loop_Kind_EN)
+    {
+        case L_CIRCLE_TRACK_LOOP:
+        case R_CIRCLE_TRACK_LOOP:
+        {
+            switch(Data_Path_p -> Circle_Track_Step)
+            {
+                case IN_PREPARE: CircleTrack_Step_IN_Prepare(Img_Store_p,Data_Path_p); break;   // 准备入环补线
+                case IN:         CircleTrack_Step_IN(Img_Store_p,Data_Path_p);         break;   // 入环补线
+                case OUT:        CircleTrack_Step_OUT(Img_Store_p,Data_Path_p);        break;   // 出环补线
+                default: break;
+            }
+            imgSearch_l_r(Img_Store_p,Data_Path_p);
+            break;
+        }
+        case ACROSS_TRACK_LOOP:
+        {
+            AcrossTrack(Img_Store_p,Data_Path_p);
+            imgSearch_l_r(Img_Store_p,Data_Path_p);
+            break;
+        }
+        default: break;
+    }
+    Function_EN_p -> Loop_Kind_EN = CAMERA_CATCH_LOOP;
+    robot::FrameTracer::instance().record(frame_id, "TrackKind_Judge", judge_start_ns, robot::FrameTracer::nowNs());
+
+    {
+        FRAME_TRACE_SCOPE(frame_id, "ServoDirAngle_Judge");
+        track_judge.ServoDirAngle_Judge(Data_Path_p);
+        track_judge.MotorSpeed_Judge(Img_Store_p,Data_Path_p);
+    }
+}
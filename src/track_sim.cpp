@@ -0,0 +1,471 @@
+#include "track_sim.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace robot {
+
+static const float PI_F = 3.14159265358979f;
+static const float CLOSED_TOLERANCE_M = 0.05f;      // 终点与起点误差小于该值时视为闭合赛道
+static const float CROSS_ARM_M = 1.0f;              // 十字横向道路每侧长度
+
+// 180° 弯之间两条 6 米直道：上方直道含十字，下方直道含左右 S 弯与左右圆环
+const char* const TrackMap::DEFAULT_TRACK =
+    "width 0.45\n"
+    "straight 2.5\n"
+    "cross 1.0\n"
+    "straight 2.5\n"
+    "left 1.0 180\n"
+    "straight 0.8\n"
+    "right 1.0 30\n"
+    "left 1.0 30\n"
+    "straight 0.7\n"
+    "circle_left 0.5\n"
+    "straight 1.0\n"
+    "circle_right 0.5\n"
+    "straight 0.7\n"
+    "left 1.0 30\n"
+    "right 1.0 30\n"
+    "straight 0.8\n"
+    "left 1.0 180\n";
+
+void TrackMap::addStraight(float length, std::vector<TrackPoint>* path) {
+    int n = (int)std::lround(length / step_);
+    for (int k = 0; k < n; ++k) {
+        cursor_.x += step_ * std::cos(cursor_.heading);
+        cursor_.y += step_ * std::sin(cursor_.heading);
+        path->push_back(cursor_);
+    }
+}
+
+/*
+    圆弧：angle 为正左转、为负右转（弧度），按圆心计算每个采样点，累计误差不随弧长增加
+*/
+void TrackMap::addArc(float radius, float angle, std::vector<TrackPoint>* path) {
+    int n = (int)std::lround(radius * std::fabs(angle) / step_);
+    if (n <= 0) {
+        return;
+    }
+    float side = angle > 0 ? 1.0f : -1.0f;
+    float h0 = cursor_.heading;
+    float cx = cursor_.x - side * radius * std::sin(h0);
+    float cy = cursor_.y + side * radius * std::cos(h0);
+    for (int k = 1; k <= n; ++k) {
+        float h = h0 + angle * k / n;
+        cursor_.x = cx + side * radius * std::sin(h);
+        cursor_.y = cy - side * radius * std::cos(h);
+        cursor_.heading = h;
+        path->push_back(cursor_);
+    }
+}
+
+bool TrackMap::build(const std::string& text, float cell_m, std::string* error) {
+    elements_.clear();
+    points_.clear();
+    cursor_ = TrackPoint();
+    points_.push_back(cursor_);
+    std::vector<std::vector<TrackPoint>> crossings;
+
+    std::istringstream lines(text);
+    std::string line;
+    int line_no = 0;
+    while (std::getline(lines, line)) {
+        ++line_no;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.resize(comment);
+        }
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name)) {
+            continue;
+        }
+        TrackElement element;
+        bool ok = true;
+        if (name == "width") {
+            ok = (bool)(fields >> width_) && width_ > 0 && elements_.empty();
+        } else if (name == "straight") {
+            element.kind = TrackElement::Straight;
+            ok = (bool)(fields >> element.length) && element.length > 0;
+        } else if (name == "left" || name == "right") {
+            element.kind = name == "left" ? TrackElement::Left : TrackElement::Right;
+            ok = (bool)(fields >> element.radius >> element.angle) && element.radius > 0 && element.angle > 0;
+        } else if (name == "circle_left" || name == "circle_right") {
+            element.kind = name == "circle_left" ? TrackElement::CircleLeft : TrackElement::CircleRight;
+            ok = (bool)(fields >> element.radius) && element.radius > 0;
+        } else if (name == "cross") {
+            element.kind = TrackElement::Cross;
+            element.length = 1.0f;
+            fields >> element.length;
+            ok = element.length > 0;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            if (error) {
+                *error = "第 " + std::to_string(line_no) + " 行无法识别：" + line;
+            }
+            return false;
+        }
+        if (name == "width") {
+            continue;
+        }
+        elements_.push_back(element);
+
+        switch (element.kind) {
+            case TrackElement::Straight:
+                addStraight(element.length, &points_);
+                break;
+            case TrackElement::Left:
+            case TrackElement::Right:
+                addArc(element.radius, (element.kind == TrackElement::Left ? 1 : -1) * element.angle * PI_F / 180,
+                       &points_);
+                break;
+            case TrackElement::CircleLeft:
+            case TrackElement::CircleRight: {
+                // 整圆回到切点，航向恢复为进入时的值（消除浮点累计）
+                float heading = cursor_.heading;
+                addArc(element.radius, (element.kind == TrackElement::CircleLeft ? 2 : -2) * PI_F, &points_);
+                cursor_.heading = heading;
+                break;
+            }
+            case TrackElement::Cross: {
+                addStraight(element.length / 2, &points_);
+                // 横向道路：从一侧穿过中点到另一侧
+                TrackPoint saved = cursor_;
+                std::vector<TrackPoint> arm;
+                cursor_.heading = saved.heading + PI_F / 2;
+                cursor_.x = saved.x - CROSS_ARM_M * std::cos(cursor_.heading);
+                cursor_.y = saved.y - CROSS_ARM_M * std::sin(cursor_.heading);
+                arm.push_back(cursor_);
+                addStraight(2 * CROSS_ARM_M, &arm);
+                crossings.push_back(arm);
+                cursor_ = saved;
+                addStraight(element.length / 2, &points_);
+                break;
+            }
+        }
+    }
+    if (elements_.empty()) {
+        if (error) {
+            *error = "赛道描述中没有元素";
+        }
+        return false;
+    }
+
+    // 终点与起点重合时去掉重复的终点，中线按环形索引
+    const TrackPoint& first = points_.front();
+    const TrackPoint& last = points_.back();
+    closure_ = std::hypot(last.x - first.x, last.y - first.y);
+    closed_ = closure_ < CLOSED_TOLERANCE_M;
+    if (closed_ && points_.size() > 1) {
+        points_.pop_back();
+    }
+
+    crossings.push_back(points_);
+    rasterize(crossings, cell_m);
+    return true;
+}
+
+bool TrackMap::load(const std::string& path, float cell_m, std::string* error) {
+    std::ifstream file(path);
+    if (!file) {
+        if (error) {
+            *error = "无法打开赛道描述文件 " + path;
+        }
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    return build(text.str(), cell_m, error);
+}
+
+/*
+    路面栅格：沿每条道路的中线采样点盖上直径为赛道宽度的圆
+*/
+void TrackMap::rasterize(const std::vector<std::vector<TrackPoint>>& roads, float cell_m) {
+    float margin = width_ / 2 + 0.5f;
+    float min_x = 0, max_x = 0, min_y = 0, max_y = 0;
+    bool first = true;
+    for (const std::vector<TrackPoint>& road : roads) {
+        for (const TrackPoint& p : road) {
+            min_x = first ? p.x : std::fmin(min_x, p.x);
+            max_x = first ? p.x : std::fmax(max_x, p.x);
+            min_y = first ? p.y : std::fmin(min_y, p.y);
+            max_y = first ? p.y : std::fmax(max_y, p.y);
+            first = false;
+        }
+    }
+    origin_x_ = min_x - margin;
+    origin_y_ = min_y - margin;
+    inv_cell_ = 1.0f / cell_m;
+    cols_ = (int)std::ceil((max_x - min_x + 2 * margin) * inv_cell_);
+    rows_ = (int)std::ceil((max_y - min_y + 2 * margin) * inv_cell_);
+    cells_.assign((size_t)cols_ * rows_, 0);
+
+    int radius = (int)(width_ / 2 * inv_cell_);
+    std::vector<int> span(radius + 1);
+    for (int dy = 0; dy <= radius; ++dy) {
+        span[dy] = (int)std::sqrt((double)radius * radius - (double)dy * dy);
+    }
+    for (const std::vector<TrackPoint>& road : roads) {
+        for (const TrackPoint& p : road) {
+            int col = (int)((p.x - origin_x_) * inv_cell_);
+            int row = (int)((p.y - origin_y_) * inv_cell_);
+            for (int dy = -radius; dy <= radius; ++dy) {
+                int half = span[dy < 0 ? -dy : dy];
+                uint8_t* cells = &cells_[(size_t)(row + dy) * cols_];
+                for (int dx = -half; dx <= half; ++dx) {
+                    cells[col + dx] = 1;
+                }
+            }
+        }
+    }
+}
+
+int TrackMap::project(float x, float y, int hint, int window, float* lateral) const {
+    const int n = (int)points_.size();
+    int best = hint;
+    float best_d2 = -1;
+    for (int k = -window; k <= window; ++k) {
+        int i = hint + k;
+        if (closed_) {
+            i = ((i % n) + n) % n;
+        } else if (i < 0 || i >= n) {
+            continue;
+        }
+        float dx = x - points_[i].x;
+        float dy = y - points_[i].y;
+        float d2 = dx * dx + dy * dy;
+        if (best_d2 < 0 || d2 < best_d2) {
+            best_d2 = d2;
+            best = i;
+        }
+    }
+    if (lateral) {
+        const TrackPoint& p = points_[best];
+        *lateral = -(x - p.x) * std::sin(p.heading) + (y - p.y) * std::cos(p.heading);
+    }
+    return best;
+}
+
+/*
+    8 个未知数的线性方程组（h33 = 1），列主元消去
+*/
+bool TrackCamera::perspectiveFromPoints(const float src[4][2], const float dst[4][2], double out[3][3]) {
+    double a[8][9] = {};
+    for (int k = 0; k < 4; ++k) {
+        double x = src[k][0], y = src[k][1], u = dst[k][0], v = dst[k][1];
+        double row_u[9] = {x, y, 1, 0, 0, 0, -x * u, -y * u, u};
+        double row_v[9] = {0, 0, 0, x, y, 1, -x * v, -y * v, v};
+        for (int j = 0; j < 9; ++j) {
+            a[k][j] = row_u[j];
+            a[k + 4][j] = row_v[j];
+        }
+    }
+    for (int col = 0; col < 8; ++col) {
+        int pivot = col;
+        for (int r = col + 1; r < 8; ++r) {
+            if (std::fabs(a[r][col]) > std::fabs(a[pivot][col])) {
+                pivot = r;
+            }
+        }
+        if (std::fabs(a[pivot][col]) < 1e-12) {
+            return false;
+        }
+        for (int j = 0; j < 9; ++j) {
+            std::swap(a[col][j], a[pivot][j]);
+        }
+        for (int r = 0; r < 8; ++r) {
+            if (r == col) {
+                continue;
+            }
+            double f = a[r][col] / a[col][col];
+            for (int j = col; j < 9; ++j) {
+                a[r][j] -= f * a[col][j];
+            }
+        }
+    }
+    for (int k = 0; k < 8; ++k) {
+        out[k / 3][k % 3] = a[k][8] / a[k][k];
+    }
+    out[2][2] = 1;
+    return true;
+}
+
+void TrackCamera::defaultHomography(int image_width, int image_height, int result_cols, int result_rows,
+                                    double out[3][3]) {
+    const float w = (float)image_width, h = (float)image_height;
+    const float result[4][2] = {{0, 0}, {(float)result_cols - 1, 0},
+                                {(float)result_cols - 1, (float)result_rows - 1}, {0, (float)result_rows - 1}};
+    const float source[4][2] = {{w * 100 / 320, h * 60 / 240}, {w * 220 / 320, h * 60 / 240},
+                                {w - 1, h - 1}, {0, h - 1}};
+    perspectiveFromPoints(result, source, out);
+}
+
+bool TrackCamera::configure(const CameraModelOptions& options) {
+    options_ = options;
+    const double (*m)[3] = options.homography;
+    double det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+                 m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+                 m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    if (std::fabs(det) < 1e-12) {
+        return false;
+    }
+    double inv[3][3];
+    inv[0][0] = (m[1][1] * m[2][2] - m[1][2] * m[2][1]) / det;
+    inv[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) / det;
+    inv[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) / det;
+    inv[1][0] = (m[1][2] * m[2][0] - m[1][0] * m[2][2]) / det;
+    inv[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) / det;
+    inv[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) / det;
+    inv[2][0] = (m[1][0] * m[2][1] - m[1][1] * m[2][0]) / det;
+    inv[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) / det;
+    inv[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) / det;
+
+    // 齐次坐标的符号以原图最下一行中点（一定在地面上）为准，符号相反的像素在地平线以上
+    const int w = options.image_width, h = options.image_height;
+    double ref = inv[2][0] * (w / 2) + inv[2][1] * (h - 1) + inv[2][2];
+    forward_.assign((size_t)w * h, -1.0f);
+    left_.assign((size_t)w * h, 0.0f);
+    const float center_col = (options.result_cols - 1) / 2.0f;
+    for (int v = 0; v < h; ++v) {
+        for (int u = 0; u < w; ++u) {
+            double z = inv[2][0] * u + inv[2][1] * v + inv[2][2];
+            if (z * ref <= 0) {
+                continue;
+            }
+            double i = (inv[0][0] * u + inv[0][1] * v + inv[0][2]) / z;
+            double j = (inv[1][0] * u + inv[1][1] * v + inv[1][2]) / z;
+            float forward = options.near_m + (float)(options.result_rows - 1 - j) * options.meters_per_pixel;
+            if (forward < 0 || forward > options.max_range_m) {
+                continue;
+            }
+            forward_[(size_t)v * w + u] = forward;
+            left_[(size_t)v * w + u] = (center_col - (float)i) * options.meters_per_pixel;
+        }
+    }
+    return true;
+}
+
+void TrackCamera::render(const TrackMap& map, const VehiclePose& pose, uint8_t road, uint8_t background, int noise,
+                         uint8_t* out, int stride) {
+    const int w = options_.image_width, h = options_.image_height;
+    const float c = std::cos(pose.yaw), s = std::sin(pose.yaw);
+    for (int v = 0; v < h; ++v) {
+        const float* forward = &forward_[(size_t)v * w];
+        const float* left = &left_[(size_t)v * w];
+        uint8_t* row = out + (size_t)v * stride;
+        for (int u = 0; u < w; ++u) {
+            int value = background;
+            if (forward[u] >= 0 && map.road(pose.x + forward[u] * c - left[u] * s,
+                                            pose.y + forward[u] * s + left[u] * c)) {
+                value = road;
+            }
+            if (noise > 0) {
+                // xorshift32，结果只与调用顺序有关，同一参数的仿真可以复现
+                noise_state_ ^= noise_state_ << 13;
+                noise_state_ ^= noise_state_ >> 17;
+                noise_state_ ^= noise_state_ << 5;
+                value += (int)(noise_state_ % (uint32_t)(2 * noise + 1)) - noise;
+                value = value < 0 ? 0 : (value > 255 ? 255 : value);
+            }
+            row[u] = (uint8_t)value;
+        }
+    }
+}
+
+void VehicleModel::reset(const VehiclePose& pose) {
+    pose_ = pose;
+    speed_ = 0;
+    yaw_rate_ = 0;
+    steer_ = 0;
+}
+
+void VehicleModel::step(float servo_deg, float motor_percent, float dt) {
+    float max_steer = params_.max_steer_deg * PI_F / 180;
+    float target = servo_deg * params_.steer_ratio * PI_F / 180;
+    target = std::fmax(-max_steer, std::fmin(max_steer, target));
+    steer_ += (target - steer_) * std::fmin(1.0f, dt / params_.servo_tau);
+
+    motor_percent = std::fmax(-1.0f, std::fmin(1.0f, motor_percent));
+    speed_ += (motor_percent * params_.max_speed - speed_) * std::fmin(1.0f, dt / params_.motor_tau);
+
+    // 侧向加速度超过附着极限时转向不足，角速度限制为 a / v
+    yaw_rate_ = speed_ * std::tan(steer_) / params_.wheelbase;
+    float speed_abs = std::fabs(speed_);
+    if (speed_abs > 1e-3f && speed_abs * std::fabs(yaw_rate_) > params_.max_lateral_accel) {
+        yaw_rate_ = std::copysign(params_.max_lateral_accel / speed_abs, yaw_rate_);
+    }
+
+    float mid_yaw = pose_.yaw + yaw_rate_ * dt / 2;
+    pose_.x += speed_ * std::cos(mid_yaw) * dt;
+    pose_.y += speed_ * std::sin(mid_yaw) * dt;
+    pose_.yaw += yaw_rate_ * dt;
+}
+
+void LapTracker::reset(double time_s) {
+    index_ = 0;
+    progress_ = 0;
+    lap_start_s_ = time_s;
+    lateral_ = 0;
+    max_lateral_ = 0;
+    sum_lateral2_ = 0;
+    samples_ = 0;
+    off_track_ = false;
+}
+
+LapResult LapTracker::finish(double time_s, bool completed) {
+    LapResult result;
+    result.lap = ++lap_;
+    result.time_s = time_s - lap_start_s_;
+    double distance = completed ? map_->length() : progress();
+    result.mean_speed = result.time_s > 0 ? distance / result.time_s : 0;
+    result.max_lateral = max_lateral_;
+    result.rms_lateral = samples_ > 0 ? std::sqrt(sum_lateral2_ / samples_) : 0;
+    result.completed = completed;
+
+    lap_start_s_ = time_s;
+    max_lateral_ = 0;
+    sum_lateral2_ = 0;
+    samples_ = 0;
+    return result;
+}
+
+bool LapTracker::update(const VehiclePose& pose, double time_s, LapResult* result) {
+    if (off_track_) {
+        return false;
+    }
+    const int n = (int)map_->points().size();
+    int index = map_->project(pose.x, pose.y, index_, 50, &lateral_);
+    int delta = index - index_;
+    if (map_->closed()) {
+        if (delta > n / 2) {
+            delta -= n;
+        } else if (delta < -n / 2) {
+            delta += n;
+        }
+    }
+    progress_ += delta;
+    index_ = index;
+
+    float lateral_abs = std::fabs(lateral_);
+    max_lateral_ = std::fmax(max_lateral_, lateral_abs);
+    sum_lateral2_ += (double)lateral_ * lateral_;
+    ++samples_;
+
+    if (lateral_abs > map_->width() / 2) {
+        off_track_ = true;
+        *result = finish(time_s, false);
+        return true;
+    }
+    if ((map_->closed() && progress_ >= n) || (!map_->closed() && index_ == n - 1)) {
+        progress_ -= n;
+        *result = finish(time_s, true);
+        return true;
+    }
+    return false;
+}
+
+} // namespace robot
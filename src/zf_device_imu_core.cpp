@@ -8,6 +8,60 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <cerrno>
+#include <ctime>
+#include <poll.h>
+#include <string>
+#include <algorithm>
+
+// 与 sensor_index_t 顺序一致的 IIO 通道名
+static const char* const CHANNEL_NAMES[9] = {
+    "accel_x", "accel_y", "accel_z",
+    "anglvel_x", "anglvel_y", "anglvel_z",
+    "magn_x", "magn_y", "magn_z"
+};
+
+static const imu_buffer_config_t DEFAULT_BUFFER_CONFIG = { true, 256, 1, NULL };
+
+// 驱动未提供 in_anglvel_scale 时使用的默认比例：±2000dps 量程，16.4 LSB/(°/s)
+static const double DEFAULT_GYRO_SCALE = 3.14159265358979323846 / 180.0 / 16.4;
+
+static int64_t monotonic_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// 写 sysfs 属性（只在初始化时使用）
+static bool sysfs_write(const std::string& path, const std::string& value)
+{
+    char resolved[256];
+    int fd = open(file_resolve_path(path.c_str(), resolved, sizeof(resolved)), O_WRONLY);
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t written = write(fd, value.c_str(), value.size());
+    close(fd);
+    return written == (ssize_t)value.size();
+}
+
+// 读 sysfs 属性的第一个单词（文件不存在时不打印错误）
+static bool sysfs_read(const std::string& path, char* out, size_t size)
+{
+    char resolved[256];
+    int fd = open(file_resolve_path(path.c_str(), resolved, sizeof(resolved)), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t n = read(fd, out, size - 1);
+    close(fd);
+    if (n <= 0) {
+        return false;
+    }
+    out[n] = '\0';
+    out[strcspn(out, " \n")] = '\0';
+    return true;
+}
 
 //===================================================================================================================
 // IMUDevice 类实现
@@ -18,7 +72,15 @@
 //-------------------------------------------------------------------------------------------------------------------
 IMUDevice::IMUDevice() 
     : device_type_(IMU_DEV_NO_FIND), 
-      is_initialized_(false)
+      is_initialized_(false),
+      backend_(IMU_BACKEND_NONE),
+      buffer_config_(DEFAULT_BUFFER_CONFIG),
+      buffer_fd_(-1),
+      scan_channel_count_(0),
+      scan_size_(0),
+      read_pending_(0),
+      timestamp_ns_(0),
+      gyro_scale_(DEFAULT_GYRO_SCALE)
 {
     // 初始化传感器数据结构
     memset(&raw_data_, 0, sizeof(raw_data_));
@@ -34,19 +96,17 @@ IMUDevice::IMUDevice()
 //-------------------------------------------------------------------------------------------------------------------
 IMUDevice::~IMUDevice()
 {
+    close_buffer();
     close_sensor_files();
 }
 
 //-------------------------------------------------------------------------------------------------------------------
-// 关闭所有传感器文件
+// 释放所有传感器文件（句柄归设备文件缓存所有，这里只清除引用）
 //-------------------------------------------------------------------------------------------------------------------
 void IMUDevice::close_sensor_files()
 {
     for (int i = 0; i < 9; ++i) {
-        if (sensor_fds_[i] > 0) {
-            close(sensor_fds_[i]);
-            sensor_fds_[i] = -1;
-        }
+        sensor_fds_[i] = -1;
     }
 }
 
@@ -66,7 +126,7 @@ bool IMUDevice::open_sensor_files()
     
     // 打开需要的传感器文件
     for (int i = 0; i < sensors_to_open; ++i) {
-        sensor_fds_[i] = open(SENSOR_PATHS[i], O_RDONLY);
+        sensor_fds_[i] = file_handle_get(SENSOR_PATHS[i], O_RDONLY);
         if (sensor_fds_[i] < 0) {
             printf("Failed to open sensor file %s: errno=%d\n", SENSOR_PATHS[i], errno);
             success = false;
@@ -82,6 +142,219 @@ bool IMUDevice::open_sensor_files()
     return success;
 }
 
+//-------------------------------------------------------------------------------------------------------------------
+// 解析一个扫描通道：使能并读取 index 与 type
+//-------------------------------------------------------------------------------------------------------------------
+bool IMUDevice::parse_scan_channel(const char* channel, int sensor, scan_channel_t& out)
+{
+    std::string base = std::string(DEVICE_DIR) + "/scan_elements/in_" + channel;
+    char index[16], type[32];
+    if (!sysfs_write(base + "_en", "1") ||
+        !sysfs_read(base + "_index", index, sizeof(index)) ||
+        !sysfs_read(base + "_type", type, sizeof(type))) {
+        return false;
+    }
+
+    // 格式：[be|le]:[s|u]bits/storagebits>>shift，例如 "le:s16/16>>0"
+    char endian, sign;
+    int storage;
+    if (sscanf(type, "%ce:%c%d/%d>>%d", &endian, &sign, &out.bits, &storage, &out.shift) != 5 ||
+        storage % 8 != 0 || storage > 64 || out.bits > storage) {
+        printf("Unsupported IIO scan type for %s: %s\n", channel, type);
+        return false;
+    }
+    out.sensor = sensor;
+    out.index = atoi(index);
+    out.bytes = storage / 8;
+    out.is_signed = (sign == 's');
+    out.big_endian = (endian == 'b');
+    out.location = 0;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 打开IIO缓冲区：使能扫描通道，计算样本布局，打开 /dev/iio:deviceN
+//-------------------------------------------------------------------------------------------------------------------
+bool IMUDevice::open_buffer()
+{
+    if (!buffer_config_.enable) {
+        return false;
+    }
+
+    std::string dir = DEVICE_DIR;
+    sysfs_write(dir + "/buffer/enable", "0");   // 上次异常退出时可能仍处于使能状态
+
+    int sensors = (device_type_ == IMU_DEV_IMU963RA) ? 9 : 6;
+    scan_channel_count_ = 0;
+    for (int i = 0; i < sensors; ++i) {
+        if (!parse_scan_channel(CHANNEL_NAMES[i], i, scan_channels_[scan_channel_count_])) {
+            printf("IIO buffer: scan element %s unavailable\n", CHANNEL_NAMES[i]);
+            return false;
+        }
+        scan_channel_count_++;
+    }
+
+    // 时间戳通道：只有时钟为 CLOCK_MONOTONIC 时才使用内核时间戳，否则在读取时打时间戳
+    char clock_name[32] = {0};
+    sysfs_write(dir + "/current_timestamp_clock", "monotonic");
+    bool monotonic = sysfs_read(dir + "/current_timestamp_clock", clock_name, sizeof(clock_name)) &&
+                     strcmp(clock_name, "monotonic") == 0;
+    if (monotonic && parse_scan_channel("timestamp", -1, scan_channels_[scan_channel_count_])) {
+        scan_channel_count_++;
+    } else {
+        sysfs_write(dir + "/scan_elements/in_timestamp_en", "0");
+    }
+
+    if (buffer_config_.trigger != NULL &&
+        !sysfs_write(dir + "/trigger/current_trigger", buffer_config_.trigger)) {
+        printf("IIO buffer: failed to set trigger %s\n", buffer_config_.trigger);
+        return false;
+    }
+    sysfs_write(dir + "/buffer/length", std::to_string(buffer_config_.length));
+    sysfs_write(dir + "/buffer/watermark", std::to_string(buffer_config_.watermark));
+
+    // 按 index 排列，每个通道按自身大小对齐，整个样本按最大通道对齐
+    std::sort(scan_channels_, scan_channels_ + scan_channel_count_,
+              [](const scan_channel_t& a, const scan_channel_t& b) { return a.index < b.index; });
+    size_t offset = 0;
+    int max_bytes = 1;
+    for (int i = 0; i < scan_channel_count_; ++i) {
+        scan_channel_t& channel = scan_channels_[i];
+        if (offset % channel.bytes) {
+            offset += channel.bytes - offset % channel.bytes;
+        }
+        channel.location = (int)offset;
+        offset += channel.bytes;
+        max_bytes = std::max(max_bytes, channel.bytes);
+    }
+    if (offset % max_bytes) {
+        offset += max_bytes - offset % max_bytes;
+    }
+    scan_size_ = offset;
+
+    if (!sysfs_write(dir + "/buffer/enable", "1")) {
+        printf("IIO buffer: failed to enable buffer\n");
+        return false;
+    }
+
+    char resolved[256];
+    buffer_fd_ = open(file_resolve_path(BUFFER_DEV_PATH, resolved, sizeof(resolved)), O_RDONLY | O_NONBLOCK);
+    if (buffer_fd_ < 0) {
+        printf("IIO buffer: failed to open %s: errno=%d\n", BUFFER_DEV_PATH, errno);
+        close_buffer();
+        return false;
+    }
+
+    read_buffer_.assign(scan_size_ * 64, 0);
+    read_pending_ = 0;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 关闭IIO缓冲区
+//-------------------------------------------------------------------------------------------------------------------
+void IMUDevice::close_buffer()
+{
+    if (buffer_fd_ >= 0) {
+        close(buffer_fd_);
+        buffer_fd_ = -1;
+    }
+    if (backend_ == IMU_BACKEND_BUFFER || scan_channel_count_ > 0) {
+        sysfs_write(std::string(DEVICE_DIR) + "/buffer/enable", "0");
+    }
+    scan_channel_count_ = 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 解码一个打包样本
+//-------------------------------------------------------------------------------------------------------------------
+void IMUDevice::decode_sample(const uint8_t* scan, imu_sample_t& out) const
+{
+    int16_t* fields[9] = {
+        &out.data.acc_x, &out.data.acc_y, &out.data.acc_z,
+        &out.data.gyro_x, &out.data.gyro_y, &out.data.gyro_z,
+        &out.data.mag_x, &out.data.mag_y, &out.data.mag_z
+    };
+    memset(&out.data, 0, sizeof(out.data));
+    out.timestamp_ns = 0;
+
+    for (int i = 0; i < scan_channel_count_; ++i) {
+        const scan_channel_t& channel = scan_channels_[i];
+        uint64_t raw = 0;
+        for (int b = 0; b < channel.bytes; ++b) {
+            int src = channel.big_endian ? channel.bytes - 1 - b : b;
+            raw |= (uint64_t)scan[channel.location + src] << (8 * b);
+        }
+        raw >>= channel.shift;
+        if (channel.bits < 64) {
+            uint64_t mask = (1ULL << channel.bits) - 1;
+            raw &= mask;
+            if (channel.is_signed && (raw & (1ULL << (channel.bits - 1)))) {
+                raw |= ~mask;
+            }
+        }
+
+        if (channel.sensor < 0) {
+            out.timestamp_ns = (int64_t)raw;
+        } else {
+            *fields[channel.sensor] = (int16_t)(int64_t)raw;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 从缓冲区批量读取样本：poll 等待到有数据，然后非阻塞读空（最多 max_samples 个）
+//-------------------------------------------------------------------------------------------------------------------
+int IMUDevice::read_buffer_samples(imu_sample_t* out, int max_samples, int timeout_ms)
+{
+    if (timeout_ms != 0) {
+        struct pollfd pfd = { buffer_fd_, POLLIN, 0 };
+        int ret = poll(&pfd, 1, timeout_ms);
+        if (ret < 0 && errno != EINTR) {
+            perror("IIO buffer poll error");
+            return -1;
+        }
+        if (ret <= 0) {
+            return 0;
+        }
+    }
+
+    int count = 0;
+    while (count < max_samples) {
+        size_t capacity = std::min(read_buffer_.size(), (size_t)(max_samples - count) * scan_size_);
+        size_t request = capacity - read_pending_;
+        ssize_t n = read(buffer_fd_, read_buffer_.data() + read_pending_, request);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                break;
+            }
+            perror("IIO buffer read error");
+            return count > 0 ? count : -1;
+        }
+        if (n == 0) {
+            break;
+        }
+
+        int64_t now = monotonic_ns();
+        size_t total = read_pending_ + (size_t)n;
+        size_t whole = total / scan_size_;
+        for (size_t i = 0; i < whole; ++i) {
+            decode_sample(read_buffer_.data() + i * scan_size_, out[count]);
+            if (out[count].timestamp_ns == 0) {
+                out[count].timestamp_ns = now;
+            }
+            count++;
+        }
+        read_pending_ = total - whole * scan_size_;
+        memmove(read_buffer_.data(), read_buffer_.data() + whole * scan_size_, read_pending_);
+
+        if ((size_t)n < request) {
+            break;  // 已读空
+        }
+    }
+    return count;
+}
+
 //-------------------------------------------------------------------------------------------------------------------
 // 读取单个传感器数据
 //-------------------------------------------------------------------------------------------------------------------
@@ -93,11 +366,8 @@ int16_t IMUDevice::read_sensor_data(sensor_index_t index)
     
     char buffer[20] = {0};
     
-    // 重置文件指针到开头
-    lseek(sensor_fds_[index], 0, SEEK_SET);
-    
-    // 读取数据
-    ssize_t bytes_read = read(sensor_fds_[index], buffer, sizeof(buffer) - 1);
+    // 从偏移0读取数据（pread 省去每次的 lseek）
+    ssize_t bytes_read = pread(sensor_fds_[index], buffer, sizeof(buffer) - 1, 0);
     if (bytes_read <= 0) {
         return 0;
     }
@@ -154,8 +424,27 @@ bool IMUDevice::initialize()
     }
     
     printf("Detected IMU device: %s (type=%d)\n", device_name, device_type_);
+
+    char scale[32] = {0};
+    if (sysfs_read(std::string(DEVICE_DIR) + "/in_anglvel_scale", scale, sizeof(scale)) && atof(scale) > 0) {
+        gyro_scale_ = atof(scale);
+    }
     
-    // 步骤3：打开传感器文件
+    // 步骤3：优先使用IIO缓冲区，200ms内收到第一个样本才算可用，否则退回逐轴读取 sysfs
+    if (open_buffer()) {
+        imu_sample_t first;
+        if (read_buffer_samples(&first, 1, 200) == 1) {
+            backend_ = IMU_BACKEND_BUFFER;
+            raw_data_ = first.data;
+            timestamp_ns_ = first.timestamp_ns;
+            is_initialized_ = true;
+            printf("IMU device initialized successfully (IIO buffer, %zu bytes/sample)\n", scan_size_);
+            return true;
+        }
+        printf("IIO buffer produced no data, falling back to sysfs\n");
+        close_buffer();
+    }
+
     if (!open_sensor_files()) {
         printf("Failed to open sensor files for IMU device\n");
         device_type_ = IMU_DEV_NO_FIND;
@@ -163,9 +452,11 @@ bool IMUDevice::initialize()
     }
     
     // 步骤4：尝试读取一次数据以验证设备正常工作
+    backend_ = IMU_BACKEND_SYSFS;
     is_initialized_ = true;
     if (!update_all_data()) {
         is_initialized_ = false;
+        backend_ = IMU_BACKEND_NONE;
         printf("Failed to read initial data from IMU device\n");
         close_sensor_files();
         device_type_ = IMU_DEV_NO_FIND;
@@ -173,7 +464,7 @@ bool IMUDevice::initialize()
     }
     
     is_initialized_ = true;
-    printf("IMU device initialized successfully\n");
+    printf("IMU device initialized successfully (sysfs)\n");
     
     return true;
 }
@@ -186,7 +477,25 @@ bool IMUDevice::update_all_data()
     if (!is_initialized_) {
         return false;
     }
+
+    // 缓冲区模式：取走所有已到达的样本，保留最新一个
+    if (backend_ == IMU_BACKEND_BUFFER) {
+        imu_sample_t samples[32];
+        int total = 0;
+        int n;
+        while ((n = read_buffer_samples(samples, 32, 0)) > 0) {
+            raw_data_ = samples[n - 1].data;
+            timestamp_ns_ = samples[n - 1].timestamp_ns;
+            total += n;
+            if (n < 32) {
+                break;
+            }
+        }
+        return total > 0;
+    }
     
+    timestamp_ns_ = monotonic_ns();
+
     // 读取加速度数据
     raw_data_.acc_x = read_sensor_data(SENSOR_ACC_X);
     raw_data_.acc_y = read_sensor_data(SENSOR_ACC_Y);
@@ -201,6 +510,60 @@ bool IMUDevice::update_all_data()
     return true;
 }
 
+//-------------------------------------------------------------------------------------------------------------------
+// 批量读取带时间戳的样本
+//-------------------------------------------------------------------------------------------------------------------
+int IMUDevice::read_samples(imu_sample_t* out, int max_samples, int timeout_ms)
+{
+    if (!is_initialized_ || out == NULL || max_samples <= 0) {
+        return -1;
+    }
+    if (backend_ == IMU_BACKEND_BUFFER) {
+        int n = read_buffer_samples(out, max_samples, timeout_ms);
+        if (n > 0) {
+            raw_data_ = out[n - 1].data;
+            timestamp_ns_ = out[n - 1].timestamp_ns;
+        }
+        return n;
+    }
+    update_all_data();
+    out[0].data = raw_data_;
+    out[0].timestamp_ns = timestamp_ns_;
+    return 1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 设置IIO缓冲区配置
+//-------------------------------------------------------------------------------------------------------------------
+void IMUDevice::set_buffer_config(const imu_buffer_config_t& config)
+{
+    buffer_config_ = config;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 获取数据读取方式
+//-------------------------------------------------------------------------------------------------------------------
+imu_backend_t IMUDevice::get_backend() const
+{
+    return backend_;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 获取最新数据的采样时间
+//-------------------------------------------------------------------------------------------------------------------
+int64_t IMUDevice::get_timestamp_ns() const
+{
+    return timestamp_ns_;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 获取陀螺仪比例（rad/s 每 LSB）
+//-------------------------------------------------------------------------------------------------------------------
+double IMUDevice::get_gyro_scale() const
+{
+    return gyro_scale_;
+}
+
 //-------------------------------------------------------------------------------------------------------------------
 // 获取设备类型
 //-------------------------------------------------------------------------------------------------------------------
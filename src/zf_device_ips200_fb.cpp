@@ -1,14 +1,104 @@
 #include "zf_device_ips200_fb.h"
 #include "zf_common_font.h"
 #include "zf_common_function.h"
+#include "rgb565_scaler.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
 
 static uint16 ips200_pencolor = IPS200_DEFAULT_PENCOLOR;
 static uint16 ips200_bgcolor = IPS200_DEFAULT_BGCOLOR;
 
 static int ips200_width;                       
 static int ips200_height;                          
+static int ips200_stride;                   // 显存每行的像素数（fb_fix.line_length / 2，可能大于 xres）
 unsigned short *screen_base = NULL;         //映射后的显存基地址
 
+// 后台缓冲：所有绘制先写入进程内的缓冲区，ips200_update_screen() 时把脏矩形按行一次拷贝到显存
+static uint16 *back_buffer = NULL;
+static int dirty_x0, dirty_y0, dirty_x1, dirty_y1;     // 脏矩形 [x0, x1) x [y0, y1)，x0 >= x1 表示没有脏区域
+
+// 字模缓存：按当前画笔/背景颜色展开好的 8x16 字符像素，绘制字符时每行一次 memcpy
+#define IPS200_GLYPH_COUNT      (95)                    // ASCII 32 ~ 126
+static uint16 glyph_cache[IPS200_GLYPH_COUNT][16][8];
+static uint16 glyph_pencolor, glyph_bgcolor;
+static bool glyph_valid = false;
+
+
+static void ips200_mark_dirty(int x0, int y0, int x1, int y1)
+{
+    if (dirty_x0 >= dirty_x1) {
+        dirty_x0 = x0; dirty_y0 = y0; dirty_x1 = x1; dirty_y1 = y1;
+        return;
+    }
+    if (x0 < dirty_x0) dirty_x0 = x0;
+    if (y0 < dirty_y0) dirty_y0 = y0;
+    if (x1 > dirty_x1) dirty_x1 = x1;
+    if (y1 > dirty_y1) dirty_y1 = y1;
+}
+
+// 把矩形裁剪到屏幕内，完全在屏幕外时返回 false
+static bool ips200_clip(int *x0, int *y0, int *x1, int *y1)
+{
+    if (back_buffer == NULL) {
+        return false;
+    }
+    if (*x0 < 0) *x0 = 0;
+    if (*y0 < 0) *y0 = 0;
+    if (*x1 > ips200_width) *x1 = ips200_width;
+    if (*y1 > ips200_height) *y1 = ips200_height;
+    return *x0 < *x1 && *y0 < *y1;
+}
+
+static void ips200_fill_rect(int x0, int y0, int x1, int y1, uint16 color)
+{
+    if (!ips200_clip(&x0, &y0, &x1, &y1)) {
+        return;
+    }
+    // 先填好第一行，其余行整行拷贝
+    uint16 *first = back_buffer + y0 * ips200_width + x0;
+    int width = x1 - x0;
+    for (int i = 0; i < width; i++) {
+        first[i] = color;
+    }
+    for (int y = y0 + 1; y < y1; y++) {
+        memcpy(back_buffer + y * ips200_width + x0, first, width * sizeof(uint16));
+    }
+    ips200_mark_dirty(x0, y0, x1, y1);
+}
+
+static void ips200_build_glyph_cache(void)
+{
+    for (int c = 0; c < IPS200_GLYPH_COUNT; c++) {
+        for (int i = 0; i < 8; i++) {
+            uint8 temp_top = ascii_font_8x16[c][i];
+            uint8 temp_bottom = ascii_font_8x16[c][i + 8];
+            for (int j = 0; j < 8; j++) {
+                glyph_cache[c][j][i] = (temp_top >> j) & 0x01 ? ips200_pencolor : ips200_bgcolor;
+                glyph_cache[c][j + 8][i] = (temp_bottom >> j) & 0x01 ? ips200_pencolor : ips200_bgcolor;
+            }
+        }
+    }
+    glyph_pencolor = ips200_pencolor;
+    glyph_bgcolor = ips200_bgcolor;
+    glyph_valid = true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     IPS200 设置画笔与背景颜色
+// 参数说明     pencolor        字符颜色
+// 参数说明     bgcolor         字符背景颜色
+// 返回参数     void
+// 使用示例     ips200_set_color(RGB565_RED, RGB565_WHITE);
+// 备注信息     颜色改变后字模缓存在下一次显示字符时重新展开
+//-------------------------------------------------------------------------------------------------------------------
+void ips200_set_color(const uint16 pencolor, const uint16 bgcolor)
+{
+    ips200_pencolor = pencolor;
+    ips200_bgcolor = bgcolor;
+}
+
 //-------------------------------------------------------------------------------------------------------------------
 // 函数简介     IPS200 清屏函数
 // 参数说明     void
@@ -31,19 +121,16 @@ void ips200_clear(void)
 //-------------------------------------------------------------------------------------------------------------------
 void ips200_full(const uint16 color)
 {
-    uint16 i,j;
-    for(i=0;i<240; i++)
-    {
-        for(j=0; j<320; j++)
-        {
-            ips200_draw_point(i, j, color);
-        }
-    }
+    ips200_fill_rect(0, 0, ips200_width, ips200_height, color);
 }
 
 void ips200_draw_point(uint16_t x, uint16_t y, const uint16_t color)
 {
-    screen_base[y * ips200_width + x] = color;
+    if (back_buffer == NULL || x >= ips200_width || y >= ips200_height) {
+        return;
+    }
+    back_buffer[y * ips200_width + x] = color;
+    ips200_mark_dirty(x, y, x + 1, y + 1);
 }
 
 //-------------------------------------------------------------------------------------------------------------------
@@ -59,49 +146,18 @@ void ips200_draw_point(uint16_t x, uint16_t y, const uint16_t color)
 //-------------------------------------------------------------------------------------------------------------------
 void ips200_draw_line (uint16 x_start, uint16 y_start, uint16 x_end, uint16 y_end, const uint16 color)
 {
-    uint16 x,y;
-    for(x = x_start; x< x_end; x++)
-    {
-        for(y = y_start; y< y_end; y++)
-        {
-            ips200_draw_point(x, y, color);
-        }
-    }
+    ips200_fill_rect(x_start, y_start, x_end, y_end, color);
 }
 
 void ips200_show_char(uint16 x, uint16 y, const char dat)
 {
-    uint8 i = 0, j = 0;
-    for(i = 0; 8 > i; i ++)
-    {
-        uint8 temp_top = ascii_font_8x16[dat - 32][i];
-        uint8 temp_bottom = ascii_font_8x16[dat - 32][i + 8];
-        for(j = 0; 8 > j; j ++)
-        {
-            if(temp_top & 0x01)
-            {
-                ips200_draw_point(x + i, y + j, ips200_pencolor);
-            } 
-            else 
-            { 
-                ips200_draw_point(x + i, y + j, ips200_bgcolor);
-            }
-            temp_top >>= 1;
-        }
-
-        for(j = 0; 8 > j; j ++)
-        {
-            if(temp_bottom & 0x01)
-            {
-                ips200_draw_point(x + i, y + j + 8, ips200_pencolor);
-            }
-            else
-            {
-                ips200_draw_point(x + i, y + j + 8, ips200_bgcolor);
-            }
-            temp_bottom >>= 1;
-        }
+    if (dat < 32 || dat - 32 >= IPS200_GLYPH_COUNT) {
+        return;
+    }
+    if (!glyph_valid || glyph_pencolor != ips200_pencolor || glyph_bgcolor != ips200_bgcolor) {
+        ips200_build_glyph_cache();
     }
+    ips200_show_rgb565_image(x, y, &glyph_cache[dat - 32][0][0], 8, 16, 8);
 }
 
 void ips200_show_string(uint16 x, uint16 y, const char dat[])
@@ -203,23 +259,111 @@ void ips200_show_float (uint16 x, uint16 y, const double dat, uint8 num, uint8 p
 void ips200_show_gray_image(uint16 x, uint16 y, const uint8 *image, 
 uint16 width, uint16 height)
 {
-    uint32 x_start = 0, y_start = 0;
-    uint16 color = 0;
+    static robot::Rgb565Scaler scaler;
+    int x0 = x, y0 = y, x1 = x + width, y1 = y + height;
+    if (!ips200_clip(&x0, &y0, &x1, &y1)) {
+        return;
+    }
+    if (!scaler.matches(x1 - x0, y1 - y0, x1 - x0, y1 - y0, robot::PixelFormat::Gray)) {
+        scaler.configure(x1 - x0, y1 - y0, x1 - x0, y1 - y0, robot::PixelFormat::Gray);
+    }
+    scaler.convert(image + (y0 - y) * width + (x0 - x), width, back_buffer + y0 * ips200_width + x0, ips200_width);
+    ips200_mark_dirty(x0, y0, x1, y1);
+}
 
-    for(y_start = y; y_start < (y + height); y_start++) 
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     IPS200 显示 RGB565 图像
+// 参数说明     x               图像左上角在屏幕上的 x 坐标
+// 参数说明     y               图像左上角在屏幕上的 y 坐标
+// 参数说明     image           RGB565 像素
+// 参数说明     width           图像宽度
+// 参数说明     height          图像高度
+// 参数说明     stride          图像每行的像素数（>= width）
+// 返回参数     void
+// 使用示例     ips200_show_rgb565_image(0, 0, pixels, 240, 180, 240);
+// 备注信息     超出屏幕的部分被裁掉；每行一次 memcpy 写入后台缓冲
+//-------------------------------------------------------------------------------------------------------------------
+void ips200_show_rgb565_image(uint16 x, uint16 y, const uint16 *image, uint16 width, uint16 height, uint16 stride)
+{
+    int x0 = x, y0 = y, x1 = x + width, y1 = y + height;
+    if (!ips200_clip(&x0, &y0, &x1, &y1)) {
+        return;
+    }
+    for (int row = y0; row < y1; row++)
     {
-        for(x_start = x; x_start < (x + width); x_start++)
-        {
-            uint8_t grayValue = image[(x_start - x) + (y_start- y) * width];
-
-            uint16_t r = (grayValue >> 3) & 0b11111;
-            uint16_t g = (grayValue >> 2) & 0b111111;
-            uint16_t b = (grayValue >> 3) & 0b11111;
-            color = (r << 11) | (g << 5) | (b << 0);
-            
-            ips200_draw_point(x_start, y_start,  color);
-        }
-    }    
+        memcpy(back_buffer + row * ips200_width + x0, image + (row - y) * stride + (x0 - x), (x1 - x0) * sizeof(uint16));
+    }
+    ips200_mark_dirty(x0, y0, x1, y1);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     IPS200 取得后台缓冲中的矩形区域
+// 参数说明     x               区域左上角 x 坐标
+// 参数说明     y               区域左上角 y 坐标
+// 参数说明     width           区域宽度
+// 参数说明     height          区域高度
+// 参数说明     stride          返回后台缓冲每行的像素数
+// 返回参数     uint16 *        区域左上角像素的地址，区域不完全在屏幕内时返回 NULL
+// 使用示例     uint16 *dst = ips200_buffer(0, 0, 240, 180, &stride);
+// 备注信息     区域被标记为脏，调用方直接写入像素后由 ips200_update_screen() 刷新
+//-------------------------------------------------------------------------------------------------------------------
+uint16 *ips200_buffer(uint16 x, uint16 y, uint16 width, uint16 height, int *stride)
+{
+    if (back_buffer == NULL || x + width > ips200_width || y + height > ips200_height) {
+        return NULL;
+    }
+    ips200_mark_dirty(x, y, x + width, y + height);
+    *stride = ips200_width;
+    return back_buffer + y * ips200_width + x;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     IPS200 刷新屏幕
+// 参数说明     void
+// 返回参数     void
+// 使用示例     ips200_update_screen();
+// 备注信息     把上次刷新以来改动过的矩形区域从后台缓冲按行拷贝到显存，没有改动时不访问显存
+//-------------------------------------------------------------------------------------------------------------------
+void ips200_update_screen(void)
+{
+    if (screen_base == NULL || back_buffer == NULL || dirty_x0 >= dirty_x1) {
+        return;
+    }
+    size_t bytes = (dirty_x1 - dirty_x0) * sizeof(uint16);
+    for (int row = dirty_y0; row < dirty_y1; row++)
+    {
+        memcpy(screen_base + row * ips200_stride + dirty_x0, back_buffer + row * ips200_width + dirty_x0, bytes);
+    }
+    dirty_x0 = dirty_x1 = 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     IPS200 使用已映射的显存
+// 参数说明     base            显存基地址
+// 参数说明     width           屏幕宽度（像素）
+// 参数说明     height          屏幕高度（像素）
+// 参数说明     stride          显存每行的像素数
+// 返回参数     void
+// 使用示例     ips200_attach(screen, 240, 320, 240);
+// 备注信息     分配后台缓冲并清屏；ips200_init 映射 framebuffer 后调用，测试时也可以传入普通内存
+//-------------------------------------------------------------------------------------------------------------------
+void ips200_attach(uint16 *base, int width, int height, int stride)
+{
+    free(back_buffer);
+    back_buffer = (uint16 *)malloc((size_t)width * height * sizeof(uint16));
+    if (back_buffer == NULL) {
+        perror("malloc error");
+        exit(EXIT_FAILURE);
+    }
+    screen_base = base;
+    ips200_width = width;
+    ips200_height = height;
+    ips200_stride = stride;
+    dirty_x0 = dirty_x1 = 0;
+
+    // 刷屏为背景色
+    ips200_full(IPS200_DEFAULT_BGCOLOR);
+    ips200_update_screen();
 }
 
 
@@ -235,35 +379,19 @@ void ips200_init(const char *path)
         exit(EXIT_FAILURE);
     }
 
-    // if (0 > (fd = open(path, O_RDWR))) {
-    //     perror("open error");
-    //     exit(EXIT_FAILURE);
-    // }
-
     /* 获取参数信息 */
     ioctl(fd, FBIOGET_VSCREENINFO, &fb_var);
     ioctl(fd, FBIOGET_FSCREENINFO, &fb_fix);
 
     screen_size = fb_fix.line_length * fb_var.yres;
-    ips200_width = fb_var.xres;
-    ips200_height = fb_var.yres;
 
     /* 将显示缓冲区映射到进程地址空间 */
-    screen_base = (unsigned short *)mmap(NULL, screen_size, PROT_WRITE, MAP_SHARED, fd, 0);
-    if (MAP_FAILED == (void *)screen_base) {
+    unsigned short *base = (unsigned short *)mmap(NULL, screen_size, PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == (void *)base) {
         perror("mmap error");
         close(fd);
         exit(EXIT_FAILURE);
     }
 
-
-    // 刷屏全黑
-    for(uint16 i=0;i<240;i++)
-    {
-        for(uint16 j=0;j<320;j++)
-        {
-            ips200_draw_point(i, j, IPS200_DEFAULT_BGCOLOR);
-        }
-    }
-
+    ips200_attach(base, fb_var.xres, fb_var.yres, fb_fix.line_length / sizeof(uint16));
 }
@@ -6,41 +6,153 @@
 #include <unistd.h>
 #include <stdint.h>
 #include <string.h>
+#include <atomic>
+#include <mutex>
 
 
-// 辅助函数：执行文件读写操作
-int file_io_operation(const char *path, int flags, uint8 *buf, size_t size) 
+// 设备文件句柄缓存：表只追加，查找无锁（按发布的数量遍历），只有首次打开时加锁
+struct file_handle_entry
 {
-    if (path == NULL || buf == NULL) {
+    char path[FILE_HANDLE_PATH_MAX];
+    int  mode;                                  // O_RDONLY / O_WRONLY / O_RDWR
+    int  fd;
+};
+
+static file_handle_entry    handle_table[FILE_HANDLE_MAX];
+static std::atomic<int>     handle_count(0);
+static std::mutex           handle_mutex;
+
+// 设备根目录（仿真设备后端）
+static char                 device_root[128] = {0};
+static bool                 device_root_loaded = false;
+static std::mutex           device_root_mutex;
+
+
+void file_set_device_root(const char *root)
+{
+    std::lock_guard<std::mutex> lock(device_root_mutex);
+    snprintf(device_root, sizeof(device_root), "%s", root ? root : "");
+    device_root_loaded = true;
+}
+
+
+const char *file_resolve_path(const char *path, char *buf, size_t size)
+{
+    std::lock_guard<std::mutex> lock(device_root_mutex);
+    if (!device_root_loaded) {
+        const char *env = getenv("ZF_DEVICE_ROOT");
+        snprintf(device_root, sizeof(device_root), "%s", env ? env : "");
+        device_root_loaded = true;
+    }
+    if (device_root[0] == '\0') {
+        return path;
+    }
+    snprintf(buf, size, "%s%s", device_root, path);
+    return buf;
+}
+
+
+// 取得设备文件的缓存句柄，首次调用时打开
+int file_handle_get(const char *path, int flags)
+{
+    if (path == NULL) {
         fprintf(stderr, "Invalid input parameters\n");
         return -1;
     }
 
-    int fd = open(path, flags);
+    int mode = flags & O_ACCMODE;
+    int count = handle_count.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        if (handle_table[i].mode == mode && strcmp(handle_table[i].path, path) == 0) {
+            return handle_table[i].fd;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(handle_mutex);
+    count = handle_count.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; i++) {
+        if (handle_table[i].mode == mode && strcmp(handle_table[i].path, path) == 0) {
+            return handle_table[i].fd;
+        }
+    }
+    if (count >= FILE_HANDLE_MAX || strlen(path) >= FILE_HANDLE_PATH_MAX) {
+        fprintf(stderr, "File handle cache full or path too long: %s\n", path);
+        return -1;
+    }
+
+    char resolved[256];
+    int fd = open(file_resolve_path(path, resolved, sizeof(resolved)), flags);
     if (fd == -1) {
         perror("Failed to open file");
         return -1;
     }
 
-    ssize_t result;
-    if (flags & O_WRONLY) {
-        result = write(fd, buf, size);
-    } else {
-        result = read(fd, buf, size);
+    file_handle_entry &entry = handle_table[count];
+    snprintf(entry.path, sizeof(entry.path), "%s", path);
+    entry.mode = mode;
+    entry.fd = fd;
+    handle_count.store(count + 1, std::memory_order_release);
+    return fd;
+}
+
+
+// 在偏移0处读取（sysfs/字符设备每次读取都从头开始）
+int file_handle_read(int fd, uint8 *buf, size_t size)
+{
+    if (fd < 0 || buf == NULL) {
+        return -1;
+    }
+    if (pread(fd, buf, size, 0) == -1) {
+        perror("File read error");
+        return -1;
+    }
+    return 0;
+}
+
+
+// 在偏移0处写入
+int file_handle_write(int fd, const uint8 *buf, size_t size)
+{
+    if (fd < 0 || buf == NULL) {
+        return -1;
+    }
+    if (pwrite(fd, buf, size, 0) == -1) {
+        perror("File write error");
+        return -1;
+    }
+    return 0;
+}
+
+
+// 关闭所有缓存的句柄（仅在没有其他线程访问设备时调用，例如退出前或测试中切换设备根目录）
+void file_handle_close_all(void)
+{
+    std::lock_guard<std::mutex> lock(handle_mutex);
+    int count = handle_count.load(std::memory_order_relaxed);
+    handle_count.store(0, std::memory_order_release);
+    for (int i = 0; i < count; i++) {
+        close(handle_table[i].fd);
     }
+}
+
 
-    if (result == -1) {
-        perror("File read/write error");
-        close(fd);
+// 辅助函数：执行文件读写操作（使用缓存句柄，每次调用只有一次 pread/pwrite）
+int file_io_operation(const char *path, int flags, uint8 *buf, size_t size) 
+{
+    if (path == NULL || buf == NULL) {
+        fprintf(stderr, "Invalid input parameters\n");
         return -1;
     }
 
-    if (close(fd) == -1) {
-        perror("Failed to close file");
+    int fd = file_handle_get(path, flags);
+    if (fd == -1) {
         return -1;
     }
 
-    return 0;
+    if (flags & O_WRONLY) {
+        return file_handle_write(fd, buf, size);
+    }
+    return file_handle_read(fd, buf, size);
 }
 
 int8 file_read_string(const char *path, char *str)
@@ -48,7 +160,8 @@ int8 file_read_string(const char *path, char *str)
     int ret = 0;
 	FILE *fp;
 
-    fp = fopen(path, "r"); /* 只读打开 */
+    char resolved[256];
+    fp = fopen(file_resolve_path(path, resolved, sizeof(resolved)), "r"); /* 只读打开 */
     if(fp == NULL) 
     {
 		printf("can not open file %s\r\n", path);
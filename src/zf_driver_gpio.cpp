@@ -1,8 +1,15 @@
 #include "zf_driver_gpio.h"
 #include "zf_driver_file.h"
+#include "zf_driver_mmio.h"
 
 void gpio_set_level(const char *path, uint8 dat)
 {
+#ifdef ZF_DRIVER_MMIO
+    // 已绑定寄存器的引脚直接写输出寄存器
+    if (mmio_gpio_set_level(path, dat) == 0) {
+        return;
+    }
+#endif
     dat = dat + 0x30;
 
     file_write_dat(path, dat);
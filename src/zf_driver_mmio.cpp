@@ -0,0 +1,210 @@
+#include "zf_driver_mmio.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <atomic>
+
+
+struct mmio_window_entry
+{
+    void            *map;                       // mmap 返回的地址（页对齐）
+    size_t           map_size;
+    vuint32         *base;                      // 请求的物理地址对应的虚拟地址
+    size_t           size;                      // 从 base 起可访问的长度
+};
+
+struct mmio_bind_entry
+{
+    const char      *key;                       // 绑定时传入的路径指针（设备路径一般是同一个字符串常量，先比较指针）
+    char             path[64];
+    vuint32         *reg;                       // PWM：占空比寄存器
+    vuint8          *out;                       // GPIO：引脚的输出字节寄存器
+    bool             gpio;
+    uint32           period_count;              // PWM：周期计数
+    uint32           duty_max;                  // PWM：满占空比
+};
+
+static mmio_window_entry    window_table[MMIO_WINDOW_MAX];
+static int                  window_count = 0;
+static mmio_bind_entry      bind_table[MMIO_BIND_MAX];
+static std::atomic<int>     bind_count(0);
+
+
+static int mmio_add_window(void *map, size_t map_size, vuint32 *base, size_t size)
+{
+    if (window_count >= MMIO_WINDOW_MAX) {
+        fprintf(stderr, "mmio: too many register windows\n");
+        munmap(map, map_size);
+        return -1;
+    }
+    window_table[window_count].map = map;
+    window_table[window_count].map_size = map_size;
+    window_table[window_count].base = base;
+    window_table[window_count].size = size;
+    return window_count++;
+}
+
+
+// 与 test/mylib/register.cpp 的 map_register 相同的映射方式，但映射长度包含页内偏移，失败时返回 -1 而不是退出
+int mmio_map(uint32 physical_address, size_t size)
+{
+    if (physical_address == 0 || size == 0) {
+        fprintf(stderr, "mmio: register window not configured\n");
+        return -1;
+    }
+    long page_size = sysconf(_SC_PAGESIZE);
+    uint32 page_offset = physical_address & (uint32)(page_size - 1);
+    size_t map_size = size + page_offset;
+
+    int mem_fd = open("/dev/mem", O_RDWR | O_SYNC);
+    if (mem_fd < 0) {
+        perror("mmio: open /dev/mem");
+        return -1;
+    }
+    void *map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, mem_fd, physical_address - page_offset);
+    close(mem_fd);
+    if (map == MAP_FAILED) {
+        perror("mmio: mmap");
+        return -1;
+    }
+    return mmio_add_window(map, map_size, (vuint32 *)((uint8 *)map + page_offset), size);
+}
+
+
+int mmio_map_mock(size_t size)
+{
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) {
+        perror("mmio: mmap anonymous");
+        return -1;
+    }
+    return mmio_add_window(map, size, (vuint32 *)map, size);
+}
+
+
+vuint32 *mmio_window(int window)
+{
+    if (window < 0 || window >= window_count) {
+        return NULL;
+    }
+    return window_table[window].base;
+}
+
+
+void mmio_unmap_all(void)
+{
+    bind_count.store(0, std::memory_order_release);
+    for (int i = 0; i < window_count; ++i) {
+        munmap(window_table[i].map, window_table[i].map_size);
+    }
+    window_count = 0;
+}
+
+
+// width 为寄存器宽度（字节），偏移需按宽度对齐
+static mmio_bind_entry *mmio_add_bind(const char *path, int window, uint32 offset, uint32 width)
+{
+    vuint32 *base = mmio_window(window);
+    int n = bind_count.load(std::memory_order_relaxed);
+    if (path == NULL || base == NULL || (offset & (width - 1)) != 0 || (size_t)offset + width > window_table[window].size) {
+        fprintf(stderr, "mmio: invalid binding %s\n", path ? path : "(null)");
+        return NULL;
+    }
+    if (n >= MMIO_BIND_MAX || strlen(path) >= sizeof(bind_table[0].path) || mmio_find(path) >= 0) {
+        fprintf(stderr, "mmio: cannot bind %s\n", path);
+        return NULL;
+    }
+    mmio_bind_entry *entry = &bind_table[n];
+    memset(entry, 0, sizeof(*entry));
+    entry->key = path;
+    snprintf(entry->path, sizeof(entry->path), "%s", path);
+    entry->reg = (vuint32 *)((vuint8 *)base + offset);
+    entry->out = (vuint8 *)base + offset;
+    return entry;
+}
+
+
+int8 mmio_bind_pwm(const char *path, int window, uint32 offset, uint32 period_count, uint32 duty_max)
+{
+    if (period_count == 0 || duty_max == 0) {
+        fprintf(stderr, "mmio: invalid pwm period for %s\n", path ? path : "(null)");
+        return -1;
+    }
+    mmio_bind_entry *entry = mmio_add_bind(path, window, offset, sizeof(uint32));
+    if (entry == NULL) {
+        return -1;
+    }
+    entry->gpio = false;
+    entry->period_count = period_count;
+    entry->duty_max = duty_max;
+    bind_count.fetch_add(1, std::memory_order_release);
+    return 0;
+}
+
+
+int8 mmio_bind_gpio(const char *path, int window, uint32 offset)
+{
+    mmio_bind_entry *entry = mmio_add_bind(path, window, offset, sizeof(uint8));
+    if (entry == NULL) {
+        return -1;
+    }
+    entry->gpio = true;
+    bind_count.fetch_add(1, std::memory_order_release);
+    return 0;
+}
+
+
+int mmio_find(const char *path)
+{
+    int n = bind_count.load(std::memory_order_acquire);
+    for (int i = 0; i < n; ++i) {
+        if (bind_table[i].key == path) {
+            return i;
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        if (strcmp(bind_table[i].path, path) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+void mmio_write(int binding, uint32 value)
+{
+    mmio_bind_entry *entry = &bind_table[binding];
+    if (entry->gpio) {
+        *entry->out = value ? 1 : 0;
+        return;
+    }
+    if (value > entry->duty_max) {
+        value = entry->duty_max;
+    }
+    *entry->reg = (uint32)((uint64_t)value * entry->period_count / entry->duty_max);
+}
+
+
+int8 mmio_pwm_set_duty(const char *path, uint16 duty)
+{
+    int binding = mmio_find(path);
+    if (binding < 0 || bind_table[binding].gpio) {
+        return -1;
+    }
+    mmio_write(binding, duty);
+    return 0;
+}
+
+
+int8 mmio_gpio_set_level(const char *path, uint8 dat)
+{
+    int binding = mmio_find(path);
+    if (binding < 0 || !bind_table[binding].gpio) {
+        return -1;
+    }
+    mmio_write(binding, dat);
+    return 0;
+}
@@ -33,6 +33,7 @@
 
 #include "zf_driver_pwm.h"
 #include "zf_driver_file.h"
+#include "zf_driver_mmio.h"
 
 
 
@@ -45,5 +46,11 @@ void pwm_get_dev_info(const char *path, struct pwm_info *pwm_info)
 
 void pwm_set_duty(const char *path, uint16 duty)
 {
+#ifdef ZF_DRIVER_MMIO
+    // 已绑定寄存器的通道直接写占空比寄存器
+    if (mmio_pwm_set_duty(path, duty) == 0) {
+        return;
+    }
+#endif
     file_write_dat(path, duty);
 }
@@ -0,0 +1,180 @@
+// 执行器服务测试：设备由普通文件模拟（file_set_device_root），检查只写变化的值、按 PWM 周期限速合并、
+// 停止前写出最后的命令、GPIO 电平格式与命令到写入的延迟，以及帧的命令全部写入后才记录 glass-to-PWM
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/actuator_service_test.cpp src/actuator_service.cpp
+//               src/frame_trace.cpp src/rt_thread.cpp src/zf_driver_file.cpp -lpthread
+#include "actuator_service.hpp"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include "frame_trace.hpp"
+#include "zf_driver_file.h"
+#include "test_check.hpp"
+
+using namespace robot;
+
+static const char* ROOT = "/tmp/actuator_service_test";
+
+static void make_device(const char* name) {
+    std::string path = std::string(ROOT) + "/dev/" + name;
+    FILE* fp = std::fopen(path.c_str(), "w");
+    if (fp) {
+        std::fclose(fp);
+    }
+}
+
+static bool read_device(const char* name, void* out, size_t size) {
+    std::string path = std::string(ROOT) + "/dev/" + name;
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = ::pread(fd, out, size, 0) == (ssize_t)size;
+    ::close(fd);
+    return ok;
+}
+
+static void wait_writes(const ActuatorService& service, int channel, uint64_t writes) {
+    for (int i = 0; i < 1000 && service.stats(channel).writes < writes; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+static void test_change_only() {
+    std::printf("\n== 只写变化的值 ==\n");
+    ActuatorService service;
+    int motor = service.addPwm("/dev/motor_pwm", 0);
+    check(service.start(), "启动服务");
+    for (int i = 0; i < 100; ++i) {
+        service.set(motor, 1200);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    service.set(motor, 1300);
+    wait_writes(service, motor, 2);
+    service.stop();
+    ActuatorChannelStats stats = service.stats(motor);
+    uint16_t duty = 0;
+    std::printf("命令 %llu，写入 %llu，相同值省去 %llu，合并 %llu\n", (unsigned long long)stats.commands,
+                (unsigned long long)stats.writes, (unsigned long long)stats.unchanged,
+                (unsigned long long)stats.coalesced);
+    check(stats.commands == 101 && stats.writes == 2, "101 次命令只写入 2 次");
+    check(read_device("motor_pwm", &duty, sizeof(duty)) && duty == 1300, "设备中为最后的占空比");
+}
+
+static void test_rate_limit() {
+    std::printf("\n== 按 PWM 周期限速 ==\n");
+    ActuatorService service;
+    int servo = service.addPwm("/dev/servo_pwm", 20000000);        // 50Hz 舵机
+    service.start();
+    auto start = std::chrono::steady_clock::now();
+    int commands = 0;
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(200)) {
+        service.set(servo, 700 + commands % 50);                    // 每 1ms 一个不同的命令
+        commands++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    service.set(servo, 777);
+    service.stop();
+    ActuatorChannelStats stats = service.stats(servo);
+    uint16_t duty = 0;
+    std::printf("200ms 内 %d 次命令，写入 %llu 次，合并 %llu\n", commands + 1, (unsigned long long)stats.writes,
+                (unsigned long long)stats.coalesced);
+    check(stats.writes >= 9 && stats.writes <= 12, "写入次数不超过 PWM 周期数（200ms / 20ms + 停止时写出）");
+    check(read_device("servo_pwm", &duty, sizeof(duty)) && duty == 777, "停止前写出最后的命令");
+}
+
+static void test_gpio_and_latency() {
+    std::printf("\n== GPIO 与写入延迟 ==\n");
+    ActuatorService service;
+    int dir = service.addGpio("/dev/motor_dir");
+    int pwm = service.addPwm("/dev/motor_pwm2", 50000);            // 20kHz 电机
+    service.start();
+    for (int i = 0; i < 200; ++i) {
+        service.set(dir, i % 2);
+        service.set(pwm, 1000 + i);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    service.set(dir, 1);
+    wait_writes(service, pwm, 200);
+    service.stop();
+    uint8_t level = 0;
+    check(read_device("motor_dir", &level, 1) && level == '1', "GPIO 写入 ASCII 电平");
+    ActuatorChannelStats stats = service.stats(pwm);
+    std::printf("电机 PWM 写入 %llu 次，延迟 p50 %llu μs，p99 %llu μs\n", (unsigned long long)stats.writes,
+                (unsigned long long)stats.latency_us.percentile(50),
+                (unsigned long long)stats.latency_us.percentile(99));
+    check(stats.writes == 200 && stats.latency_us.count == 200, "周期短于命令间隔时每个命令都写入并记录延迟");
+}
+
+static void test_frame_actuated() {
+    std::printf("\n== 帧的 glass-to-PWM ==\n");
+    ActuatorService service;
+    int servo = service.addPwm("/dev/servo_pwm", 20000000);
+    int motor = service.addPwm("/dev/motor_pwm2", 50000);
+    service.start();
+    FrameTracer& tracer = FrameTracer::instance();
+
+    service.set(servo, 700);
+    service.set(motor, 1000);
+    service.setFrame(1, FrameTracer::nowNs());
+    wait_writes(service, servo, 1);
+
+    // 帧 2：电机立即写入，舵机要等到写入间隔结束，延迟至少包含舵机命令的等待时间
+    int64_t sensor_ns = FrameTracer::nowNs();
+    service.set(servo, 701);
+    service.set(motor, 1001);
+    service.setFrame(2, sensor_ns);
+    service.setFrame(2, sensor_ns);
+    wait_writes(service, servo, 2);
+    for (int i = 0; i < 1000 && tracer.glassToActuatorSnapshot().count < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    LatencyHistogram::Snapshot glass = tracer.glassToActuatorSnapshot();
+    ActuatorChannelStats servo_stats = service.stats(servo);
+    std::printf("记录 %llu 帧，最大延迟 %llu μs，舵机命令最大写入延迟 %llu μs\n", (unsigned long long)glass.count,
+                (unsigned long long)glass.max, (unsigned long long)servo_stats.latency_us.max);
+    check(glass.count == 2, "每帧记录一次");
+    check(glass.max >= servo_stats.latency_us.max, "延迟包含舵机按写入间隔暂缓的时间");
+
+    // 帧 3 的命令与已写入的值相同，不需要写设备也算生效
+    service.set(servo, 701);
+    service.set(motor, 1001);
+    service.setFrame(3, FrameTracer::nowNs());
+    for (int i = 0; i < 1000 && tracer.glassToActuatorSnapshot().count < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    service.stop();
+    check(tracer.glassToActuatorSnapshot().count == 3 && service.stats(servo).writes == 2, "命令未变化的帧也记录");
+}
+
+static void test_invalid() {
+    std::printf("\n== 错误处理 ==\n");
+    ActuatorService service;
+    service.addPwm("/dev/missing_pwm", 0);
+    check(!service.start(), "设备无法打开时启动失败");
+    ActuatorService full;
+    for (int i = 0; i < ActuatorService::MAX_CHANNELS; ++i) {
+        full.addGpio("/dev/motor_dir");
+    }
+    check(full.addGpio("/dev/motor_dir") == -1, "通道已满");
+}
+
+int main() {
+    mkdir(ROOT, 0755);
+    mkdir((std::string(ROOT) + "/dev").c_str(), 0755);
+    for (const char* name : {"motor_pwm", "servo_pwm", "motor_dir", "motor_pwm2"}) {
+        make_device(name);
+    }
+    file_set_device_root(ROOT);
+
+    test_change_only();
+    test_rate_limit();
+    test_gpio_and_latency();
+    test_frame_actuated();
+    test_invalid();
+    return test_report();
+}
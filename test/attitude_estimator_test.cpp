@@ -0,0 +1,271 @@
+// 姿态解算离线测试：按已知运动生成 IMU 日志（CSV），写入文件后读回并逐样本回放
+// 也可以回放实车记录的日志：./a.out imu_log.csv，CSV 每行 timestamp_ns,acc_x,acc_y,acc_z,gyro_x,gyro_y,gyro_z（原始值）
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/attitude_estimator_test.cpp src/attitude_estimator.cpp -lpthread
+#include "attitude_estimator.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "test_check.hpp"
+
+using namespace robot;
+
+static const double GYRO_SCALE = M_PI / 180.0 / 16.4;      // ±2000dps 量程
+static const double LSB_PER_DPS = 16.4;
+static const double ACC_1G = 4096;
+static const int64_t PERIOD_NS = 1000000;                  // 1kHz
+static const int16_t BIAS[3] = {12, -7, 25};
+
+static double deg(double rad) {
+    return rad * 180.0 / M_PI;
+}
+
+// 按角速度（度/秒，机体系）与横滚角生成样本，叠加零偏与零均值噪声
+class LogBuilder {
+public:
+    void hold(double seconds, double roll_deg = 0) {
+        move(seconds, 0, 0, roll_deg);
+    }
+
+    void move(double seconds, double rate_x_dps, double rate_z_dps, double roll_deg) {
+        int count = (int)std::lround(seconds * 1e9 / PERIOD_NS);
+        for (int i = 0; i < count; ++i) {
+            double roll = (roll_deg + rate_x_dps * i * PERIOD_NS / 1e9) * M_PI / 180.0;
+            int noise = (int)(samples.size() % 7) - 3;
+            imu_sample_t sample = {};
+            sample.timestamp_ns = t_ns;
+            sample.data.acc_x = (int16_t)(noise);
+            sample.data.acc_y = (int16_t)std::lround(ACC_1G * std::sin(roll)) + noise;
+            sample.data.acc_z = (int16_t)std::lround(ACC_1G * std::cos(roll)) - noise;
+            sample.data.gyro_x = (int16_t)std::lround(rate_x_dps * LSB_PER_DPS) + BIAS[0] + noise;
+            sample.data.gyro_y = BIAS[1] - noise;
+            sample.data.gyro_z = (int16_t)std::lround(rate_z_dps * LSB_PER_DPS) + BIAS[2] + noise;
+            samples.push_back(sample);
+            t_ns += PERIOD_NS;
+        }
+    }
+
+    std::vector<imu_sample_t> samples;
+    int64_t t_ns = 1000000000LL;
+};
+
+static bool write_csv(const std::string& path, const std::vector<imu_sample_t>& samples) {
+    FILE* fp = std::fopen(path.c_str(), "w");
+    if (!fp) {
+        return false;
+    }
+    for (const imu_sample_t& s : samples) {
+        std::fprintf(fp, "%lld,%d,%d,%d,%d,%d,%d\n", (long long)s.timestamp_ns, s.data.acc_x, s.data.acc_y,
+                     s.data.acc_z, s.data.gyro_x, s.data.gyro_y, s.data.gyro_z);
+    }
+    std::fclose(fp);
+    return true;
+}
+
+static std::vector<imu_sample_t> read_csv(const std::string& path) {
+    std::vector<imu_sample_t> samples;
+    FILE* fp = std::fopen(path.c_str(), "r");
+    if (!fp) {
+        return samples;
+    }
+    long long t;
+    int v[6];
+    while (std::fscanf(fp, "%lld,%d,%d,%d,%d,%d,%d", &t, &v[0], &v[1], &v[2], &v[3], &v[4], &v[5]) == 7) {
+        imu_sample_t s = {};
+        s.timestamp_ns = t;
+        s.data.acc_x = (int16_t)v[0];
+        s.data.acc_y = (int16_t)v[1];
+        s.data.acc_z = (int16_t)v[2];
+        s.data.gyro_x = (int16_t)v[3];
+        s.data.gyro_y = (int16_t)v[4];
+        s.data.gyro_z = (int16_t)v[5];
+        samples.push_back(s);
+    }
+    std::fclose(fp);
+    return samples;
+}
+
+static AttitudeState replay(AttitudeEstimator& estimator, const std::vector<imu_sample_t>& samples) {
+    for (const imu_sample_t& s : samples) {
+        estimator.update(s);
+    }
+    AttitudeState state;
+    estimator.state(state);
+    return state;
+}
+
+static void test_bias_and_heading(AttitudeFilter filter, const char* name) {
+    std::printf("\n== 零偏标定与航向展开（%s）==\n", name);
+    LogBuilder log;
+    log.hold(1.1);          // 标定
+    log.hold(10.0);
+    size_t still_end = log.samples.size();
+    log.move(8.0, 0, 90, 0);    // 90°/s 转 720°
+    log.hold(1.1);
+
+    AttitudeOptions options;
+    options.filter = filter;
+    AttitudeEstimator estimator(GYRO_SCALE, options);
+    AttitudeState state = replay(estimator, std::vector<imu_sample_t>(log.samples.begin(), log.samples.begin() + still_end));
+    std::printf("零偏 %.2f %.2f %.2f LSB，静止 10s 航向 %.4f°\n", state.gyro_bias[0], state.gyro_bias[1],
+                state.gyro_bias[2], deg(state.heading));
+    check(estimator.isCalibrated(), "标定完成");
+    check(std::fabs(state.gyro_bias[2] - BIAS[2]) < 0.5 && std::fabs(state.gyro_bias[0] - BIAS[0]) < 0.5,
+          "零偏估计误差小于 0.5 LSB");
+    check(std::fabs(deg(state.heading)) < 0.2, "去零偏后静止 10s 航向漂移小于 0.2°");
+
+    state = replay(estimator, std::vector<imu_sample_t>(log.samples.begin() + still_end, log.samples.end()));
+    std::printf("转动后航向 %.3f°，偏航 %.3f°\n", deg(state.heading), deg(state.yaw));
+    check(std::fabs(deg(state.heading) - 720) < 1.0, "航向展开为连续的 720°");
+    check(std::fabs(deg(state.yaw)) < 1.0, "偏航角折回 ±180° 以内");
+}
+
+static void test_roll_tracking(AttitudeFilter filter, const char* name) {
+    std::printf("\n== 横滚跟踪（%s）==\n", name);
+    LogBuilder log;
+    log.hold(1.1);
+    log.move(1.0, 20, 0, 0);    // 20°/s 横滚到 20°
+    log.hold(2.0, 20);
+
+    AttitudeOptions options;
+    options.filter = filter;
+    AttitudeEstimator estimator(GYRO_SCALE, options);
+    AttitudeState state = replay(estimator, log.samples);
+    std::printf("横滚 %.3f°，俯仰 %.3f°\n", deg(state.roll), deg(state.pitch));
+    check(std::fabs(deg(state.roll) - 20) < 0.5 && std::fabs(deg(state.pitch)) < 0.5, "横滚 20° 跟踪误差小于 0.5°");
+
+    // 陀螺仪与加速度不一致（只倾斜加速度）时由加速度逐渐修正
+    LogBuilder tilt;
+    tilt.hold(1.1);
+    tilt.hold(20.0, 10);
+    options.madgwick_beta = 0.1f;
+    AttitudeEstimator corrected(GYRO_SCALE, options);
+    state = replay(corrected, tilt.samples);
+    std::printf("加速度倾斜 10° 后 20s 横滚 %.3f°\n", deg(state.roll));
+    check(std::fabs(deg(state.roll) - 10) < 0.5, "加速度修正收敛到 10°");
+}
+
+static void test_calibration_motion() {
+    std::printf("\n== 标定期间运动 ==\n");
+    LogBuilder log;
+    log.move(0.5, 0, 45, 0);    // 标定时在转动
+    log.hold(2.5);
+    AttitudeEstimator estimator(GYRO_SCALE);
+    AttitudeState state = replay(estimator, log.samples);
+    check(estimator.isCalibrated() && std::fabs(state.gyro_bias[2] - BIAS[2]) < 0.5,
+          "检测到运动后重新标定，零偏不受影响");
+
+    estimator.requestCalibration();
+    check(estimator.isCalibrated(), "请求标定在下一个样本生效前保持原状态");
+    LogBuilder more;
+    more.t_ns = log.t_ns;
+    more.hold(0.5);
+    replay(estimator, more.samples);
+    check(!estimator.isCalibrated(), "重新标定期间不输出");
+}
+
+static void test_trigger() {
+    std::printf("\n== 转角触发 ==\n");
+    LogBuilder log;
+    log.hold(1.1);
+    AttitudeEstimator estimator(GYRO_SCALE);
+    replay(estimator, log.samples);
+
+    check(!estimator.yawTriggered(), "未设置时不触发");
+    estimator.armYawTrigger(300);
+    size_t start = log.samples.size();
+    log.move(3.0, 0, -180, 0);      // 右转 180°/s，1.667s 时达到 300°
+    int64_t trigger_ns = 0;
+    int64_t first_seen_ns = 0;
+    for (size_t i = start; i < log.samples.size(); ++i) {
+        estimator.update(log.samples[i]);
+        if (first_seen_ns == 0 && estimator.yawTriggered(&trigger_ns)) {
+            first_seen_ns = log.samples[i].timestamp_ns;
+        }
+    }
+    // 基准取设置后的第一个样本，从该样本起 300/180 秒达到目标
+    int64_t expected_ns = log.samples[start].timestamp_ns + (int64_t)(300.0 / 180.0 * 1e9);
+    std::printf("触发时刻与理论值相差 %.3f ms\n", (trigger_ns - expected_ns) / 1e6);
+    check(first_seen_ns == trigger_ns, "越过目标角度的样本上立即可见");
+    check(trigger_ns >= expected_ns - PERIOD_NS && trigger_ns <= expected_ns + 2 * PERIOD_NS,
+          "触发延迟在一个采样周期以内");
+
+    estimator.armYawTrigger(90);
+    check(!estimator.yawTriggered(), "重新设置后清除旧的触发");
+    estimator.disarmYawTrigger();
+    LogBuilder turn;
+    turn.t_ns = log.t_ns;
+    turn.move(1.0, 0, 180, 0);
+    replay(estimator, turn.samples);
+    check(!estimator.yawTriggered(), "取消后不再触发");
+}
+
+static void test_log_roundtrip() {
+    std::printf("\n== 日志回放 ==\n");
+    LogBuilder log;
+    log.hold(1.1);
+    log.move(4.0, 0, 90, 0);
+    const std::string path = "/tmp/attitude_estimator_test.csv";
+    check(write_csv(path, log.samples), "写入日志");
+    std::vector<imu_sample_t> loaded = read_csv(path);
+    check(loaded.size() == log.samples.size(), "读回全部样本");
+
+    AttitudeEstimator direct(GYRO_SCALE), replayed(GYRO_SCALE);
+    AttitudeState a = replay(direct, log.samples);
+    AttitudeState b = replay(replayed, loaded);
+    check(a.heading == b.heading && std::fabs(deg(b.heading) - 360) < 1.0, "回放结果与直接处理一致（360°）");
+}
+
+static void bench_update() {
+    std::printf("\n== 单样本耗时 ==\n");
+    LogBuilder log;
+    log.hold(1.1);
+    log.move(20.0, 0, 90, 0);
+    for (AttitudeFilter filter : {AttitudeFilter::MADGWICK, AttitudeFilter::COMPLEMENTARY}) {
+        AttitudeOptions options;
+        options.filter = filter;
+        AttitudeEstimator estimator(GYRO_SCALE, options);
+        auto start = std::chrono::steady_clock::now();
+        AttitudeState state = replay(estimator, log.samples);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                    log.samples.size();
+        std::printf("%s: %.0f ns/样本（航向 %.1f°）\n", filter == AttitudeFilter::MADGWICK ? "madgwick" : "complementary",
+                    ns, deg(state.heading));
+    }
+}
+
+static int replay_file(const char* path) {
+    std::vector<imu_sample_t> samples = read_csv(path);
+    if (samples.empty()) {
+        std::printf("无法读取日志 %s\n", path);
+        return 1;
+    }
+    AttitudeEstimator estimator(GYRO_SCALE);
+    AttitudeState state;
+    int64_t next_print = samples.front().timestamp_ns;
+    for (const imu_sample_t& s : samples) {
+        if (estimator.update(s) && s.timestamp_ns >= next_print && estimator.state(state)) {
+            std::printf("%10.3f s  roll %8.2f°  pitch %8.2f°  heading %10.2f°\n",
+                        (s.timestamp_ns - samples.front().timestamp_ns) / 1e9, deg(state.roll), deg(state.pitch),
+                        deg(state.heading));
+            next_print = s.timestamp_ns + 500000000LL;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        return replay_file(argv[1]);
+    }
+    test_bias_and_heading(AttitudeFilter::MADGWICK, "madgwick");
+    test_bias_and_heading(AttitudeFilter::COMPLEMENTARY, "complementary");
+    test_roll_tracking(AttitudeFilter::MADGWICK, "madgwick");
+    test_roll_tracking(AttitudeFilter::COMPLEMENTARY, "complementary");
+    test_calibration_motion();
+    test_trigger();
+    test_log_roundtrip();
+    bench_update();
+    return test_report();
+}
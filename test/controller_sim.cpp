@@ -0,0 +1,368 @@
+// 串级控制器阶跃响应仿真（桌面运行）
+// 电机：一阶惯性；转向：舵机一阶滞后 + 自行车模型 + 相机延迟，输出上升时间、超调与稳态误差
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/controller_sim.cpp src/cascaded_controller.cpp src/PID.cpp
+#include "cascaded_controller.hpp"
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <vector>
+#include "test_check.hpp"
+
+using namespace robot;
+
+static const int RATE_HZ = 100;
+static const double DT = 1.0 / RATE_HZ;
+static const int64_t PERIOD_NS = 1000000000LL / RATE_HZ;
+
+struct StepMetrics {
+    double rise_s = -1;         // 10% → 90%
+    double overshoot = 0;       // 相对阶跃幅度
+    double settle_s = -1;       // 进入 ±2% 后不再离开
+    double steady_error = 0;    // 最后 0.5s 平均误差
+};
+
+static StepMetrics analyze(const std::vector<double>& y, double start, double target) {
+    StepMetrics m;
+    double span = target - start;
+    int t10 = -1, t90 = -1;
+    double peak = start;
+    for (size_t i = 0; i < y.size(); ++i) {
+        double frac = (y[i] - start) / span;
+        if (t10 < 0 && frac >= 0.1) t10 = (int)i;
+        if (t90 < 0 && frac >= 0.9) t90 = (int)i;
+        peak = span > 0 ? std::fmax(peak, y[i]) : std::fmin(peak, y[i]);
+    }
+    if (t10 >= 0 && t90 >= 0) {
+        m.rise_s = (t90 - t10) * DT;
+    }
+    m.overshoot = std::fmax(0, (peak - target) / span);
+    for (int i = (int)y.size() - 1; i >= 0; --i) {
+        if (std::fabs(y[i] - target) > 0.02 * std::fabs(span)) {
+            m.settle_s = (i + 1) * DT;
+            break;
+        }
+    }
+    int tail = (int)(0.5 / DT);
+    for (int i = (int)y.size() - tail; i < (int)y.size(); ++i) {
+        m.steady_error += std::fabs(y[i] - target) / tail;
+    }
+    return m;
+}
+
+static void print_metrics(const char* name, const StepMetrics& m) {
+    std::printf("%-28s rise %6.3fs  overshoot %5.1f%%  settle %6.3fs  steady err %.3f\n", name, m.rise_s,
+                m.overshoot * 100, m.settle_s, m.steady_error);
+}
+
+// 电机：速度（每周期脉冲）对输出（±100）的一阶惯性，满输出对应 120 脉冲/周期
+struct MotorPlant {
+    double speed = 0;
+    double gain = 1.2;
+    double tau = 0.15;
+    double noise = 0;           // 测量噪声幅度（脉冲/周期）
+    unsigned seed = 1;
+
+    double step(double u) {
+        speed += (gain * u - speed) / tau * DT;
+        return measure();
+    }
+
+    double measure() {
+        seed = seed * 1103515245u + 12345u;
+        double n = ((seed >> 16) % 2001 / 1000.0 - 1.0) * noise;
+        return speed + n;
+    }
+};
+
+static PID motor_gains(float kp, float ki, float kd) {
+    PID pid;
+    pid.Kp = kp;
+    pid.Ki = ki;
+    pid.Kd = kd;
+    pid.Plimit = 100;
+    pid.Ilimit = 100;
+    pid.Dlimit = 100;
+    pid.Reslimit = 100;
+    return pid;
+}
+
+static std::vector<double> run_motor(CascadedController& controller, MotorPlant& plant, double target, double seconds,
+                                     std::vector<double>* outputs = nullptr) {
+    std::vector<double> y;
+    double measured = plant.measure();
+    for (int i = 0; i < (int)(seconds / DT); ++i) {
+        ControllerInput in;
+        in.timestamp_ns = (i + 1) * PERIOD_NS;
+        in.speed_target = (float)target;
+        in.speed_present = (float)measured;
+        ControllerOutput out = controller.step(in);
+        if (outputs) {
+            outputs->push_back(out.motor);
+        }
+        measured = plant.step(out.motor);
+        y.push_back(plant.speed);
+    }
+    return y;
+}
+
+static void test_motor_feedforward() {
+    std::printf("\n== 电机速度环：前馈 ==\n");
+    PID angle, servo;
+    PID motor = motor_gains(1.0f, 4.0f, 0);
+    ControllerOptions options;
+    CascadedController pid_only(angle, servo, motor, options);
+    MotorPlant plant;
+    StepMetrics a = analyze(run_motor(pid_only, plant, 50, 3.0), 0, 50);
+    print_metrics("PID", a);
+
+    PID motor_ff = motor_gains(1.0f, 4.0f, 0);
+    options.motor_kff = 1.0f / 1.2f;        // 前馈按稳态增益的倒数
+    CascadedController with_ff(angle, servo, motor_ff, options);
+    MotorPlant plant_ff;
+    StepMetrics b = analyze(run_motor(with_ff, plant_ff, 50, 3.0), 0, 50);
+    print_metrics("PID + 前馈", b);
+
+    check(b.rise_s > 0 && b.rise_s < a.rise_s * 0.7, "前馈使上升时间缩短 30% 以上");
+    check(a.steady_error < 0.5 && b.steady_error < 0.5, "稳态误差小于 0.5 脉冲/周期");
+}
+
+// 车轮受阻 1 秒（增益降到 0.2，输出长时间限幅）后恢复，比较恢复后的超调
+// legacy 为旧的 PIDCalculate：积分只靠限幅，饱和期间持续累积
+static std::vector<double> run_stall(bool legacy, PID pid, double target, double* peak_after) {
+    PID angle, servo;
+    CascadedController controller(angle, servo, pid);
+    PIDStatus status{};
+    MotorPlant plant;
+    std::vector<double> y;
+    *peak_after = 0;
+    for (int i = 0; i < (int)(5.0 / DT); ++i) {
+        double t = i * DT;
+        plant.gain = (t >= 1.5 && t < 2.5) ? 0.2 : 1.2;
+        float u;
+        if (legacy) {
+            status.target = (float)target;
+            status.present = (float)plant.speed;
+            status.time_present = t + DT;
+            PIDCalculate(pid, &status);
+            u = status.Res;
+        } else {
+            ControllerInput in;
+            in.timestamp_ns = (i + 1) * PERIOD_NS;
+            in.speed_target = (float)target;
+            in.speed_present = (float)plant.speed;
+            u = controller.step(in).motor;
+        }
+        plant.step(u);
+        y.push_back(plant.speed);
+        if (t >= 2.5) {
+            *peak_after = std::fmax(*peak_after, plant.speed);
+        }
+    }
+    return y;
+}
+
+static void test_anti_windup() {
+    std::printf("\n== 电机速度环：受阻后恢复（积分抗饱和）==\n");
+    double peak_legacy, peak_fixed;
+    std::vector<double> a = run_stall(true, motor_gains(1.0f, 20.0f, 0), 50, &peak_legacy);
+    std::vector<double> b = run_stall(false, motor_gains(1.0f, 20.0f, 0), 50, &peak_fixed);
+    std::vector<double> tail_a(a.begin() + (int)(2.5 / DT), a.end()), tail_b(b.begin() + (int)(2.5 / DT), b.end());
+    StepMetrics ma = analyze(tail_a, tail_a.front(), 50), mb = analyze(tail_b, tail_b.front(), 50);
+    std::printf("PIDCalculate（仅限幅）       恢复后峰值 %.1f，稳定 %.2fs\n", peak_legacy, ma.settle_s);
+    std::printf("PIDCalculateFixed（条件积分）恢复后峰值 %.1f，稳定 %.2fs\n", peak_fixed, mb.settle_s);
+    // 积分限幅等于输出限幅时，旧算法的积分最多累积到限幅值，条件积分在输出饱和时即停止累积
+    check(peak_fixed < peak_legacy - 2, "条件积分恢复后的超调更小");
+    check(mb.settle_s > 0 && mb.settle_s < ma.settle_s, "条件积分恢复后稳定得更快");
+}
+
+static void test_derivative_filter() {
+    std::printf("\n== 微分低通 ==\n");
+    double rms[2];
+    for (int k = 0; k < 2; ++k) {
+        PID angle, servo;
+        PID motor = motor_gains(1.0f, 4.0f, 0.05f);
+        ControllerOptions options;
+        options.d_tau = k == 0 ? 0.0f : 0.03f;
+        CascadedController controller(angle, servo, motor, options);
+        MotorPlant plant;
+        plant.noise = 1.0;          // ±1 脉冲量化噪声
+        std::vector<double> outputs;
+        run_motor(controller, plant, 50, 3.0, &outputs);
+        double mean = 0, var = 0;
+        size_t start = outputs.size() / 2;
+        for (size_t i = start; i < outputs.size(); ++i) mean += outputs[i] / (outputs.size() - start);
+        for (size_t i = start; i < outputs.size(); ++i) var += (outputs[i] - mean) * (outputs[i] - mean) / (outputs.size() - start);
+        rms[k] = std::sqrt(var);
+        std::printf("d_tau = %.2fs：稳态输出抖动 %.2f\n", options.d_tau, rms[k]);
+    }
+    check(rms[1] < rms[0] / 2, "微分低通使噪声引起的输出抖动减半");
+}
+
+// 转向：舵机一阶滞后，自行车模型，前瞻处的横向偏差经相机延迟换算为像素
+struct SteeringPlant {
+    double speed = 1.5;             // m/s
+    double wheelbase = 0.2;         // m
+    double servo_tau = 0.05;        // s
+    double lookahead = 0.4;         // m
+    double px_per_m = 200;
+    int camera_delay = 3;           // 周期
+    double delta = 0;               // 舵机实际角度（度）
+    double offset = 0;              // 相对中线的横向偏差（m，左为正）
+    double heading = 0;             // 相对中线的航向（rad）
+    double curvature = 0;           // 中线曲率（1/m，左弯为正）
+    std::deque<double> pixels;
+
+    double yawRateDeg() const {
+        return std::tan(delta * M_PI / 180.0) * speed / wheelbase * 180.0 / M_PI;
+    }
+
+    // 中线在前瞻处相对车头的横向位置（像素，偏右为正）
+    double pixelError() const {
+        return pixels.size() < (size_t)camera_delay ? 0 : pixels.front();
+    }
+
+    void step(double servo_cmd) {
+        delta += (servo_cmd - delta) / servo_tau * DT;
+        double r = yawRateDeg() * M_PI / 180.0;
+        heading += (r - curvature * speed) * DT;
+        offset += speed * std::sin(heading) * DT;
+        pixels.push_back((offset + lookahead * std::sin(heading)) * px_per_m);
+        if (pixels.size() > (size_t)camera_delay) {
+            pixels.pop_front();
+        }
+    }
+};
+
+static std::vector<double> run_steering(CascadedController& controller, SteeringPlant& plant, double seconds,
+                                        std::vector<double>* yaw_target = nullptr, std::vector<double>* yaw = nullptr) {
+    std::vector<double> offsets;
+    for (int i = 0; i < (int)(seconds / DT); ++i) {
+        ControllerInput in;
+        in.timestamp_ns = (i + 1) * PERIOD_NS;
+        in.pixel_error = (float)plant.pixelError();
+        in.yaw_rate = (float)plant.yawRateDeg();
+        ControllerOutput out = controller.step(in);
+        plant.step(out.servo);
+        offsets.push_back(plant.offset);
+        if (yaw_target) yaw_target->push_back(out.yaw_rate_target);
+        if (yaw) yaw->push_back(plant.yawRateDeg());
+    }
+    return offsets;
+}
+
+static PID steer_gains(float kp, float ki, float kd, float limit) {
+    PID pid = motor_gains(kp, ki, kd);
+    pid.Plimit = limit;
+    pid.Ilimit = limit;
+    pid.Dlimit = limit;
+    pid.Reslimit = limit;
+    return pid;
+}
+
+static PID single_servo_gains() {
+    return steer_gains(0.5f, 0, 0.02f, 30);         // 像素 → 舵机角度
+}
+
+static PID outer_gains() {
+    return steer_gains(4.0f, 0, 0.1f, 300);         // 像素 → 角速度目标（度/秒）
+}
+
+static PID inner_gains() {
+    return steer_gains(0.05f, 2.0f, 0, 30);         // 角速度偏差（度/秒）→ 舵机角度
+}
+
+static void test_steering() {
+    std::printf("\n== 转向：横向偏差 5cm 阶跃 ==\n");
+    PID motor;
+    ControllerOptions options;
+    options.cascade_steering = true;
+
+    PID angle_single, servo_single = single_servo_gains();
+    CascadedController single(angle_single, servo_single, motor);
+    SteeringPlant plant_single;
+    plant_single.offset = 0.05;
+    StepMetrics a = analyze(run_steering(single, plant_single, 4.0), 0.05, 0);
+    print_metrics("单环 像素→舵机", a);
+
+    PID angle = outer_gains(), servo = inner_gains();
+    CascadedController cascade(angle, servo, motor, options);
+    SteeringPlant plant;
+    plant.offset = 0.05;
+    StepMetrics b = analyze(run_steering(cascade, plant, 4.0), 0.05, 0);
+    print_metrics("串级 像素→角速度→舵机", b);
+    check(a.settle_s > 0 && a.settle_s < 3.0 && b.settle_s > 0 && b.settle_s < 3.0, "两种结构都能在 3s 内消除横向偏差");
+
+    // 不同车速下的阶跃响应（整定参考）：舵机角度到角速度的增益与横向运动都随车速变化
+    std::printf("\n== 转向：车速 0.8 / 3.0 m/s ==\n");
+    const double speeds[2] = {0.8, 3.0};
+    for (int k = 0; k < 2; ++k) {
+        PID a1, s1 = single_servo_gains();
+        CascadedController c1(a1, s1, motor);
+        SteeringPlant p1;
+        p1.speed = speeds[k];
+        p1.offset = 0.05;
+        StepMetrics m1 = analyze(run_steering(c1, p1, 6.0), 0.05, 0);
+        PID a2 = outer_gains(), s2 = inner_gains();
+        CascadedController c2(a2, s2, motor, options);
+        SteeringPlant p2;
+        p2.speed = speeds[k];
+        p2.offset = 0.05;
+        StepMetrics m2 = analyze(run_steering(c2, p2, 6.0), 0.05, 0);
+        std::printf("%.1f m/s  ", speeds[k]);
+        print_metrics("单环", m1);
+        std::printf("%.1f m/s  ", speeds[k]);
+        print_metrics("串级", m2);
+        check(m1.settle_s > 0 && m2.settle_s > 0 && m1.steady_error < 0.001 && m2.steady_error < 0.001,
+              "该车速下两种结构均稳定");
+    }
+
+    std::printf("\n== 串级内环：角速度目标阶跃 ==\n");
+    PID angle3 = outer_gains(), servo3 = inner_gains();
+    CascadedController cascade3(angle3, servo3, motor, options);
+    SteeringPlant plant3;
+    std::vector<double> yaw;
+    for (int i = 0; i < 100; ++i) {
+        ControllerInput in;
+        in.timestamp_ns = (i + 1) * PERIOD_NS;
+        in.pixel_error = -10;                   // 外环输出恒定 40°/s
+        in.yaw_rate = (float)plant3.yawRateDeg();
+        plant3.step(cascade3.step(in).servo);
+        yaw.push_back(plant3.yawRateDeg());
+    }
+    StepMetrics m = analyze(yaw, 0, 40);
+    print_metrics("角速度 0 → 40°/s", m);
+    check(m.settle_s > 0 && m.settle_s < 0.5 && m.steady_error < 0.5, "内环 0.5s 内跟踪角速度目标");
+}
+
+static void test_rate_contract() {
+    std::printf("\n== 执行频率约定 ==\n");
+    PID angle, servo, motor = motor_gains(1.0f, 10.0f, 0);
+    CascadedController controller(angle, servo, motor);
+    ControllerInput in;
+    in.speed_target = 50;
+    in.speed_present = 49;                      // 小偏差，输出不饱和
+    for (int i = 1; i <= 100; ++i) {
+        in.timestamp_ns = i * PERIOD_NS;
+        controller.step(in);
+    }
+    float integral = motor.I;
+    in.timestamp_ns += 3 * PERIOD_NS;           // 迟到 2 个周期
+    controller.step(in);
+    ControllerStats stats = controller.stats();
+    check(stats.late == 1 && stats.resets == 0 && motor.I > integral, "迟到计数，积分继续");
+    in.timestamp_ns += 20 * PERIOD_NS;          // 停顿 200ms
+    controller.step(in);
+    stats = controller.stats();
+    check(stats.resets == 1 && motor.I < integral, "停顿过长时复位积分");
+    std::printf("执行 %llu 次，间隔 p50 %llu us，p99 %llu us\n", (unsigned long long)stats.steps,
+                (unsigned long long)stats.interval_us.percentile(50), (unsigned long long)stats.interval_us.percentile(99));
+}
+
+int main() {
+    test_motor_feedforward();
+    test_anti_windup();
+    test_derivative_filter();
+    test_steering();
+    test_rate_contract();
+    return test_report();
+}
@@ -0,0 +1,204 @@
+// 调试视频流测试：二值图游程编码可逆且远小于原图、最坏情况不超过 1 位/像素；编码线程只在有连接等待时编码，
+// 帧率跟随连接的接收速度，JPEG 质量收敛到大小预算内，stop() 让等待中的连接立即返回
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/debug_stream_test.cpp src/debug_stream.cpp src/binary_rle.cpp
+//               src/rt_thread.cpp -lpthread
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+#include "binary_rle.hpp"
+#include "debug_stream.hpp"
+#include "test_check.hpp"
+
+using namespace robot;
+
+// 与 decode 结果（0/255）比较，源图非 0 即白
+static bool same_image(const std::vector<uint8_t>& src, int width, int height, int stride,
+                       const std::vector<uint8_t>& decoded) {
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if ((src[y * stride + x] != 0) != (decoded[y * width + x] != 0)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool round_trip(const std::vector<uint8_t>& src, int width, int height, int stride, std::string* encoded) {
+    std::vector<uint8_t> decoded;
+    int w = 0, h = 0;
+    return encodeBinaryRle(src.data(), width, height, stride, encoded) &&
+           decodeBinaryRle(*encoded, &decoded, &w, &h) && w == width && h == height &&
+           same_image(src, width, height, stride, decoded);
+}
+
+// 类似寻线二值图：黑色背景中一条逐行变窄的白色赛道，边框 3 像素黑线
+static std::vector<uint8_t> track_image(int width, int height) {
+    std::vector<uint8_t> img(width * height, 0);
+    for (int y = 3; y < height - 3; ++y) {
+        int half = 20 + y * (width / 2 - 30) / height;
+        int center = width / 2 + (y % 40) / 4;
+        for (int x = std::max(3, center - half); x < std::min(width - 3, center + half); ++x) {
+            img[y * width + x] = 255;
+        }
+    }
+    return img;
+}
+
+static void test_rle() {
+    std::printf("\n== 二值图游程编码 ==\n");
+    const int W = 320, H = 200;
+    std::string encoded;
+
+    std::vector<uint8_t> track = track_image(W, H);
+    check(round_trip(track, W, H, W, &encoded), "赛道图像编解码一致");
+    std::printf("赛道图像 %dx%d：原始 %d 字节，打包 %d 字节，游程 %zu 字节\n", W, H, W * H, W * H / 8, encoded.size());
+    check(encoded[1] == 1 && encoded.size() < 2048, "赛道图像使用游程编码，小于 2KB");
+
+    std::mt19937 rng(7);
+    std::vector<uint8_t> noise(W * H);
+    for (uint8_t& v : noise) {
+        v = (rng() & 1) ? 255 : 0;
+    }
+    check(round_trip(noise, W, H, W, &encoded), "随机图像编解码一致");
+    check(encoded[1] == 0 && encoded.size() == 6 + W * H / 8, "随机图像退回按位打包，不超过 1 位/像素");
+
+    std::vector<uint8_t> white(W * H, 255), black(W * H, 0);
+    std::string white_encoded;
+    check(round_trip(white, W, H, W, &white_encoded) && round_trip(black, W, H, W, &encoded) &&
+          white_encoded.size() < 16 && encoded.size() < 16, "全白、全黑各只有一两个游程");
+
+    // 奇数尺寸、带行填充，像素值不只是 0/255
+    const int w = 13, h = 7, stride = 16;
+    std::vector<uint8_t> odd(stride * h, 0);
+    for (int i = 0; i < stride * h; ++i) {
+        odd[i] = (uint8_t)((i * 37) % 5 == 0 ? 0 : (i % 200) + 1);
+    }
+    bool ok = round_trip(odd, w, h, stride, &encoded);
+    std::vector<uint8_t> one(1, 9);
+    ok = ok && round_trip(one, 1, 1, 1, &encoded);
+    check(ok, "奇数尺寸、行填充与非 255 的白色");
+
+    std::vector<uint8_t> decoded;
+    check(!encodeBinaryRle(track.data(), 0, H, W, &encoded) && !encodeBinaryRle(track.data(), W, H, W - 1, &encoded),
+          "尺寸无效时失败");
+    round_trip(track, W, H, W, &encoded);
+    check(!decodeBinaryRle(encoded.substr(0, encoded.size() / 2), &decoded, nullptr, nullptr) &&
+          !decodeBinaryRle("X", &decoded, nullptr, nullptr), "数据不完整时解码失败");
+
+    const int n = 2000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        encodeBinaryRle(track.data(), W, H, W, &encoded);
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / n;
+    std::printf("赛道图像编码 %.1f μs/帧\n", us);
+}
+
+struct Frame {
+    uint64_t id = 0;
+};
+
+// 模拟一个 HTTP 连接：取到新帧后"发送" send_ms 毫秒再取下一帧
+static void client(StreamHub* hub, int send_ms, std::atomic<bool>* stop, uint64_t* received) {
+    hub->connect();
+    uint64_t last = 0;
+    while (!stop->load()) {
+        auto packet = hub->wait(last, std::chrono::milliseconds(200));
+        if (!packet) {
+            continue;
+        }
+        last = packet->seq;
+        (*received)++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(send_ms));
+    }
+    hub->disconnect();
+}
+
+static void test_stream() {
+    std::printf("\n== 编码线程 ==\n");
+    std::atomic<int> jpeg_encodes{0};
+    // JPEG 大小与质量成正比（每质量单位 1000 字节），二值图固定 100 字节
+    DebugStream<Frame> stream([&](const Frame&, StreamFormat format, int quality, std::string* out) {
+        if (format == StreamFormat::Jpeg) {
+            jpeg_encodes++;
+            out->assign((size_t)quality * 1000, 'j');
+        } else {
+            out->assign(100, 'b');
+        }
+        return true;
+    });
+    DebugStreamOptions options;
+    options.max_fps = 50;
+    options.frame_bytes = 30000;
+    options.quality = 80;
+    check(stream.start(options), "启动");
+
+    // 视觉线程：有连接时才发布
+    std::atomic<bool> stop_vision{false};
+    std::atomic<uint64_t> offered{0};
+    std::thread vision([&]() {
+        uint64_t id = 0;
+        while (!stop_vision) {
+            ++id;
+            if (stream.wanted()) {
+                Frame frame;
+                frame.id = id;
+                stream.publish(frame);
+                offered++;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    check(!stream.wanted() && offered == 0 && stream.stats().encoded == 0, "没有连接时不发布、不编码");
+
+    // 快连接（几乎不耗时）与慢连接（每帧 100ms）分别看两种格式
+    std::atomic<bool> stop_clients{false};
+    uint64_t fast_received = 0, slow_received = 0;
+    std::thread slow(client, &stream.hub(StreamFormat::Jpeg), 100, &stop_clients, &slow_received);
+    std::thread fast(client, &stream.hub(StreamFormat::BinaryRle), 1, &stop_clients, &fast_received);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    stop_clients = true;
+    slow.join();
+    fast.join();
+
+    DebugStreamStats stats = stream.stats();
+    std::printf("慢连接收到 %llu 帧（JPEG 编码 %d 次），快连接收到 %llu 帧；最终质量 %d，丢弃 %llu\n",
+                (unsigned long long)slow_received, jpeg_encodes.load(), (unsigned long long)fast_received,
+                stats.quality, (unsigned long long)stats.dropped);
+    check(slow_received >= 7 && slow_received <= 12 && jpeg_encodes <= 13, "慢连接：编码帧率跟随接收速度（约 10fps）");
+    check(fast_received >= 30 && fast_received <= 52, "快连接：按帧率上限（50fps）编码");
+    check(stats.quality * 1000 <= (int)options.frame_bytes && stats.quality >= options.min_quality,
+          "JPEG 质量收敛到大小预算内");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    check(!stream.wanted(), "连接断开后不再需要帧");
+
+    // 等待中的连接在 stop() 后立即返回
+    StreamHub* hub = &stream.hub(StreamFormat::Jpeg);
+    std::atomic<bool> returned{false};
+    std::thread waiter([&]() {
+        hub->wait(hub->published(), std::chrono::milliseconds(5000));
+        returned = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto t0 = std::chrono::steady_clock::now();
+    stream.stop();
+    waiter.join();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    check(returned && ms < 200 && hub->isClosed(), "stop() 唤醒等待中的连接");
+
+    stop_vision = true;
+    vision.join();
+}
+
+int main() {
+    test_rle();
+    test_stream();
+    return test_report();
+}
@@ -0,0 +1,183 @@
+// 设备文件读写基准：一个控制周期（2个编码器 + IMU六轴 + 3路PWM + 2路方向GPIO）的系统调用次数与耗时
+// 原方式：每次访问 open/read/close，IMU 每轴 lseek+read；新方式：缓存句柄 + pread/pwrite
+// 设备由 tmpfs 上的普通文件模拟（file_set_device_root），系统调用次数由链接器 --wrap 统计
+// 编译（主机）：
+//   g++ -std=c++17 -O2 -U_FORTIFY_SOURCE -Iinclude test/device_io_bench.cpp src/zf_driver_file.cpp
+//       src/zf_driver_encoder.cpp src/zf_driver_pwm.cpp src/zf_driver_gpio.cpp src/zf_device_imu_core.cpp
+//       src/sensor_sampler.cpp src/imu_stream.cpp src/rt_thread.cpp -lpthread
+//       -Wl,--wrap=open,--wrap=close,--wrap=read,--wrap=write,--wrap=lseek,--wrap=pread,--wrap=pwrite
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+#include "sensor_sampler.hpp"
+#include "zf_driver_encoder.h"
+#include "zf_driver_file.h"
+#include "zf_driver_gpio.h"
+#include "zf_driver_pwm.h"
+
+static std::atomic<long> g_syscalls(0);
+
+extern "C" {
+int __real_open(const char* path, int flags, ...);
+int __real_close(int fd);
+ssize_t __real_read(int fd, void* buf, size_t size);
+ssize_t __real_write(int fd, const void* buf, size_t size);
+off_t __real_lseek(int fd, off_t offset, int whence);
+ssize_t __real_pread(int fd, void* buf, size_t size, off_t offset);
+ssize_t __real_pwrite(int fd, const void* buf, size_t size, off_t offset);
+
+int __wrap_open(const char* path, int flags, ...) {
+    g_syscalls++;
+    mode_t mode = 0;
+    if (flags & O_CREAT) {
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, mode_t);
+        va_end(args);
+    }
+    return __real_open(path, flags, mode);
+}
+int __wrap_close(int fd) { g_syscalls++; return __real_close(fd); }
+ssize_t __wrap_read(int fd, void* buf, size_t size) { g_syscalls++; return __real_read(fd, buf, size); }
+ssize_t __wrap_write(int fd, const void* buf, size_t size) { g_syscalls++; return __real_write(fd, buf, size); }
+off_t __wrap_lseek(int fd, off_t offset, int whence) { g_syscalls++; return __real_lseek(fd, offset, whence); }
+ssize_t __wrap_pread(int fd, void* buf, size_t size, off_t offset) { g_syscalls++; return __real_pread(fd, buf, size, offset); }
+ssize_t __wrap_pwrite(int fd, const void* buf, size_t size, off_t offset) { g_syscalls++; return __real_pwrite(fd, buf, size, offset); }
+}
+
+static const char* ROOT = "/dev/shm/zf_fakedev";
+static const char* ENCODER_L = "/dev/zf_encoder_1";
+static const char* ENCODER_R = "/dev/zf_encoder_2";
+static const char* PWM_PATHS[3] = {"/dev/zf_device_pwm_servo", "/dev/zf_device_pwm_motor_1", "/dev/zf_device_pwm_motor_2"};
+static const char* GPIO_PATHS[2] = {"/dev/zf_driver_gpio_motor_1", "/dev/zf_driver_gpio_motor_2"};
+static const char* IIO_DIR = "/sys/bus/iio/devices/iio:device1";
+static const char* IIO_AXES[6] = {"in_accel_x_raw", "in_accel_y_raw", "in_accel_z_raw",
+                                  "in_anglvel_x_raw", "in_anglvel_y_raw", "in_anglvel_z_raw"};
+
+static void write_fake(const std::string& path, const void* data, size_t size) {
+    std::string full = std::string(ROOT) + path;
+    for (size_t pos = 1; (pos = full.find('/', pos)) != std::string::npos; ++pos) {
+        mkdir(full.substr(0, pos).c_str(), 0755);
+    }
+    FILE* fp = fopen(full.c_str(), "wb");
+    fwrite(data, 1, size, fp);
+    fclose(fp);
+}
+
+static void create_fake_devices() {
+    int16 left = 123, right = -45;
+    write_fake(ENCODER_L, &left, sizeof(left));
+    write_fake(ENCODER_R, &right, sizeof(right));
+    uint16 duty = 0;
+    for (const char* path : PWM_PATHS) {
+        write_fake(path, &duty, sizeof(duty));
+    }
+    for (const char* path : GPIO_PATHS) {
+        write_fake(path, "0", 1);
+    }
+    write_fake(std::string(IIO_DIR) + "/name", "IMU660RA\n", 9);
+    for (int i = 0; i < 6; ++i) {
+        std::string value = std::to_string((i + 1) * 100) + "\n";
+        write_fake(std::string(IIO_DIR) + "/" + IIO_AXES[i], value.c_str(), value.size());
+    }
+}
+
+// 原实现：每次访问都 open/read(write)/close
+static int legacy_file_io(const char* path, int flags, uint8* buf, size_t size) {
+    std::string full = std::string(ROOT) + path;
+    int fd = open(full.c_str(), flags);
+    if (fd == -1) {
+        return -1;
+    }
+    ssize_t result = (flags & O_WRONLY) ? write(fd, buf, size) : read(fd, buf, size);
+    close(fd);
+    return result == -1 ? -1 : 0;
+}
+
+// 原IMU实现：句柄常开，每轴 lseek + read
+static int legacy_imu_fds[6];
+
+static void legacy_cycle(int16& left, int16& right, int16* imu) {
+    legacy_file_io(ENCODER_L, O_RDONLY, (uint8*)&left, sizeof(left));
+    legacy_file_io(ENCODER_R, O_RDONLY, (uint8*)&right, sizeof(right));
+    for (int i = 0; i < 6; ++i) {
+        char buffer[20] = {0};
+        lseek(legacy_imu_fds[i], 0, SEEK_SET);
+        read(legacy_imu_fds[i], buffer, sizeof(buffer) - 1);
+        imu[i] = (int16)atoi(buffer);
+    }
+    uint16 duty = 500;
+    for (const char* path : PWM_PATHS) {
+        legacy_file_io(path, O_WRONLY, (uint8*)&duty, sizeof(duty));
+    }
+    uint8 dir = '1';
+    for (const char* path : GPIO_PATHS) {
+        legacy_file_io(path, O_WRONLY, &dir, sizeof(dir));
+    }
+}
+
+static void cached_cycle(robot::SensorSampler& sampler, robot::SensorSample& sample) {
+    sampler.sample(sample);
+    for (const char* path : PWM_PATHS) {
+        pwm_set_duty(path, 500);
+    }
+    for (const char* path : GPIO_PATHS) {
+        gpio_set_level(path, 1);
+    }
+}
+
+template <typename F>
+static void measure(const char* name, int cycles, F&& cycle) {
+    cycle();    // 预热（首次打开句柄）
+    long before = g_syscalls.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < cycles; ++i) {
+        cycle();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    long calls = g_syscalls.load() - before;
+    std::printf("%-28s %8.1f syscalls/cycle %10.0f ns/cycle\n", name, (double)calls / cycles, ns / cycles);
+}
+
+int main() {
+    create_fake_devices();
+    file_set_device_root(ROOT);
+
+    for (int i = 0; i < 6; ++i) {
+        std::string full = std::string(ROOT) + IIO_DIR + "/" + IIO_AXES[i];
+        legacy_imu_fds[i] = open(full.c_str(), O_RDONLY);
+    }
+
+    IMUDevice imu;
+    if (!imu.initialize()) {
+        std::printf("fake IMU init failed\n");
+        return 1;
+    }
+    robot::SensorSampler sampler(ENCODER_L, ENCODER_R, &imu);
+    robot::SensorSample sample;
+    if (!sampler.open() || !sampler.sample(sample)) {
+        std::printf("fake encoder open failed\n");
+        return 1;
+    }
+
+    // 仿真设备读写正确
+    bool values_ok = sample.encoder_left == 123 && sample.encoder_right == -45 && sample.imu_valid &&
+                     sample.imu.acc_x == 100 && sample.imu.gyro_z == 600;
+    pwm_set_duty(PWM_PATHS[0], 1234);
+    gpio_set_level(GPIO_PATHS[0], 1);
+    uint16 duty = 0;
+    legacy_file_io(PWM_PATHS[0], O_RDONLY, (uint8*)&duty, sizeof(duty));
+    values_ok = values_ok && duty == 1234 && gpio_get_level(GPIO_PATHS[0]) == '1';
+    std::printf("[%s] fake device values read/written correctly\n\n", values_ok ? "PASS" : "FAIL");
+
+    const int cycles = 20000;
+    int16 left, right, imu_values[6];
+    measure("open/read/close (legacy)", cycles, [&]() { legacy_cycle(left, right, imu_values); });
+    measure("cached fd + pread/pwrite", cycles, [&]() { cached_cycle(sampler, sample); });
+
+    file_handle_close_all();
+    return values_ok ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+// 显示服务测试：三缓冲邮箱在并发下不撕裂且总能拿到最新帧；显示线程按帧率限速、丢弃旧帧、
+// 渲染慢时不阻塞发布者，发布耗时与渲染耗时无关
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/display_service_test.cpp src/rt_thread.cpp -lpthread
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "display_service.hpp"
+#include "triple_buffer.hpp"
+#include "test_check.hpp"
+
+using namespace robot;
+
+struct Payload {
+    uint64_t id = 0;
+    uint64_t data[64] = {0};    // 每个元素都是 id，读到不一致说明撕裂
+};
+
+static void test_triple_buffer() {
+    std::printf("\n== 三缓冲邮箱 ==\n");
+    TripleBuffer<Payload> mailbox;
+    check(!mailbox.update(), "没有发布时 update 返回 false");
+
+    const uint64_t total = 200000;
+    std::atomic<bool> done{false};
+    std::thread producer([&]() {
+        for (uint64_t id = 1; id <= total; ++id) {
+            Payload& p = mailbox.writeBuffer();
+            p.id = id;
+            for (uint64_t& v : p.data) {
+                v = id;
+            }
+            mailbox.publish();
+        }
+        done = true;
+    });
+    uint64_t last = 0, received = 0;
+    bool torn = false, backwards = false;
+    for (;;) {
+        bool finished = done.load();
+        if (!mailbox.update()) {
+            if (finished) {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        const Payload& p = mailbox.readBuffer();
+        for (uint64_t v : p.data) {
+            torn = torn || v != p.id;
+        }
+        backwards = backwards || p.id <= last;
+        last = p.id;
+        received++;
+    }
+    producer.join();
+    std::printf("发布 %llu 帧，取到 %llu 帧\n", (unsigned long long)mailbox.published(), (unsigned long long)received);
+    check(!torn, "取到的帧内容完整");
+    check(!backwards, "帧序号单调递增（只取新帧）");
+    check(mailbox.readBuffer().id == total, "最后取到的是最新一帧");
+}
+
+struct Frame {
+    uint64_t id = 0;
+    std::shared_ptr<std::vector<uint8_t>> image;    // 模拟引用计数的图像
+};
+
+static void test_service() {
+    std::printf("\n== 显示线程 ==\n");
+    std::vector<uint64_t> shown;
+    std::atomic<uint64_t> latest{0};
+    DisplayService<Frame> service([&](const Frame& frame) {
+        shown.push_back(frame.id);
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));    // 慢速屏幕
+    });
+    DisplayServiceOptions options;
+    options.fps = 15;
+    check(service.start(options), "启动");
+    check(!service.start(options), "重复启动失败");
+
+    // 视觉线程 100fps 发布，记录每次发布耗时
+    LatencyHistogram publish_ns;
+    auto begin = std::chrono::steady_clock::now();
+    uint64_t id = 0;
+    while (std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(1000)) {
+        Frame frame;
+        frame.id = ++id;
+        frame.image = std::make_shared<std::vector<uint8_t>>(320 * 240 * 3);
+        auto t0 = std::chrono::steady_clock::now();
+        service.publish(frame);
+        publish_ns.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+        latest = id;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    service.stop();
+
+    DisplayServiceStats stats = service.stats();
+    LatencyHistogram::Snapshot publish = publish_ns.snapshot();
+    std::printf("发布 %llu 帧，显示 %llu 帧（%.1f fps），丢弃 %llu；渲染 p50 %llu μs；发布 p50 %llu ns，p99 %llu ns\n",
+                (unsigned long long)stats.published, (unsigned long long)stats.rendered, stats.fps,
+                (unsigned long long)stats.dropped, (unsigned long long)stats.render_us.percentile(50),
+                (unsigned long long)publish.percentile(50), (unsigned long long)publish.percentile(99));
+    check(stats.rendered >= 12 && stats.rendered <= 17, "按 15fps 限速显示");
+    check(stats.published == id && stats.dropped + stats.rendered == stats.published, "未显示的帧计为丢弃");
+    bool increasing = true;
+    for (size_t i = 1; i < shown.size(); ++i) {
+        increasing = increasing && shown[i] > shown[i - 1];
+    }
+    check(increasing && !shown.empty() && shown.back() == latest, "只显示新帧，最后显示的是最新一帧");
+    check(publish.percentile(50) < 10000, "发布不等待渲染（p50 < 10μs）");
+}
+
+int main() {
+    test_triple_buffer();
+    test_service();
+    return test_report();
+}
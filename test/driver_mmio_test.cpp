@@ -0,0 +1,132 @@
+// 寄存器直写后端测试：以匿名内存作为假的寄存器窗口，检查 pwm_set_duty / gpio_set_level 对已绑定的路径
+// 变为寄存器写入、未绑定的路径仍写设备文件、执行器服务使用寄存器，并输出两种写法的耗时（只输出不断言）
+// 编译（主机）：g++ -std=c++17 -O2 -DZF_DRIVER_MMIO -Iinclude test/driver_mmio_test.cpp src/zf_driver_mmio.cpp
+//               src/zf_driver_pwm.cpp src/zf_driver_gpio.cpp src/zf_driver_file.cpp
+//               src/actuator_service.cpp src/frame_trace.cpp src/rt_thread.cpp -lpthread
+#include <sys/stat.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include "actuator_service.hpp"
+#include "zf_driver_file.h"
+#include "zf_driver_gpio.h"
+#include "zf_driver_mmio.h"
+#include "zf_driver_pwm.h"
+#include "test_check.hpp"
+
+using namespace robot;
+
+static const char* ROOT = "/tmp/driver_mmio_test";
+
+static const uint32 PERIOD_COUNT = 100000;     // 100MHz 时钟、1kHz PWM
+static const uint32 DUTY_MAX = 10000;
+static const uint32 GPIO_OUT = 0x100;           // 假窗口中按字节输出寄存器的起始偏移
+
+static void make_device(const char* name) {
+    std::string path = std::string(ROOT) + "/dev/" + name;
+    FILE* fp = std::fopen(path.c_str(), "w");
+    if (fp) {
+        std::fclose(fp);
+    }
+}
+
+static int g_pwm_window = -1;
+static int g_gpio_window = -1;
+
+static void test_bind() {
+    std::printf("\n== 绑定 ==\n");
+    g_pwm_window = mmio_map_mock(ZF_MMIO_PWM_STRIDE * 4);
+    g_gpio_window = mmio_map_mock(GPIO_OUT + ZF_MMIO_GPIO_PINS);
+    check(g_pwm_window >= 0 && g_gpio_window >= 0, "映射假寄存器窗口");
+    check(mmio_bind_pwm("/dev/pwm_0", g_pwm_window, 0 * ZF_MMIO_PWM_STRIDE + ZF_MMIO_PWM_LOW, PERIOD_COUNT, DUTY_MAX) == 0
+          && mmio_bind_pwm("/dev/pwm_2", g_pwm_window, 2 * ZF_MMIO_PWM_STRIDE + ZF_MMIO_PWM_LOW, PERIOD_COUNT, DUTY_MAX) == 0,
+          "绑定 PWM 通道");
+    check(mmio_bind_gpio("/dev/gpio_74", g_gpio_window, GPIO_OUT + 74) == 0
+          && mmio_bind_gpio("/dev/gpio_75", g_gpio_window, GPIO_OUT + 75) == 0,
+          "绑定 GPIO 引脚");
+    check(mmio_bind_pwm("/dev/pwm_0", g_pwm_window, ZF_MMIO_PWM_LOW, PERIOD_COUNT, DUTY_MAX) == -1, "重复绑定失败");
+    check(mmio_bind_pwm("/dev/pwm_9", g_pwm_window, ZF_MMIO_PWM_STRIDE * 4, PERIOD_COUNT, DUTY_MAX) == -1,
+          "超出窗口的偏移失败");
+    check(mmio_bind_gpio("/dev/gpio_x", 7, 0) == -1, "无效窗口失败");
+    check(mmio_bind_gpio("/dev/gpio_y", g_gpio_window, GPIO_OUT + ZF_MMIO_GPIO_PINS) == -1, "超出窗口的引脚失败");
+    check(mmio_map(0, 16) == -1, "未配置的物理地址返回错误而不退出");
+}
+
+static void test_driver_writes() {
+    std::printf("\n== pwm_set_duty / gpio_set_level ==\n");
+    vuint32* pwm = mmio_window(g_pwm_window);
+    vuint32* gpio = mmio_window(g_gpio_window);
+    std::string pwm_2 = "/dev/pwm_2";           // 与绑定时不是同一个指针，按字符串查找
+
+    pwm_set_duty("/dev/pwm_0", 2500);
+    pwm_set_duty(pwm_2.c_str(), 10000);
+    check(pwm[ZF_MMIO_PWM_LOW / 4] == PERIOD_COUNT / 4, "占空比 25% 写入通道 0 的低电平寄存器");
+    check(pwm[(2 * ZF_MMIO_PWM_STRIDE + ZF_MMIO_PWM_LOW) / 4] == PERIOD_COUNT, "满占空比写入通道 2");
+    check(pwm[(1 * ZF_MMIO_PWM_STRIDE + ZF_MMIO_PWM_LOW) / 4] == 0, "未绑定的通道不受影响");
+    pwm_set_duty("/dev/pwm_0", 20000);
+    check(pwm[ZF_MMIO_PWM_LOW / 4] == PERIOD_COUNT, "超过满占空比时限幅");
+
+    // 按字节模式：每个引脚一个输出字节，写入不读取、不改变相邻引脚（由其他写者维护）的字节
+    vuint8* out = (vuint8*)gpio + GPIO_OUT;
+    out[73] = 1;
+    out[76] = 1;
+    gpio_set_level("/dev/gpio_74", 1);
+    gpio_set_level("/dev/gpio_75", 1);
+    check(out[74] == 1 && out[75] == 1, "引脚 74、75 置位");
+    gpio_set_level("/dev/gpio_74", 0);
+    check(out[74] == 0 && out[75] == 1, "引脚 74 清零，75 保持");
+    check(out[72] == 0 && out[73] == 1 && out[76] == 1, "相邻引脚的字节不受影响");
+
+    uint16 duty = 0;
+    pwm_set_duty("/dev/pwm_file", 1234);
+    check(file_read_dat("/dev/pwm_file", &duty) == 0 && duty == 1234, "未绑定的路径仍写设备文件");
+    check(mmio_gpio_set_level("/dev/pwm_0", 1) == -1 && mmio_pwm_set_duty("/dev/gpio_74", 1) == -1,
+          "PWM 与 GPIO 绑定不混用");
+}
+
+static void test_actuator_service() {
+    std::printf("\n== 执行器服务 ==\n");
+    vuint32* pwm = mmio_window(g_pwm_window);
+    vuint32* gpio = mmio_window(g_gpio_window);
+    ActuatorService service;
+    int motor = service.addPwm("/dev/pwm_2", 0);
+    int dir = service.addGpio("/dev/gpio_75");
+    check(service.start(), "绑定的通道不需要设备文件也能启动");
+    service.set(motor, 5000);
+    service.set(dir, 0);
+    service.stop();
+    check(pwm[(2 * ZF_MMIO_PWM_STRIDE + ZF_MMIO_PWM_LOW) / 4] == PERIOD_COUNT / 2, "服务线程写入 PWM 寄存器");
+    check(((vuint8*)gpio)[GPIO_OUT + 75] == 0, "服务线程写入 GPIO 寄存器");
+    check(service.stats(motor).writes == 1 && service.stats(motor).errors == 0, "写入计数");
+}
+
+static double ns_per_call(const char* path, int n) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        pwm_set_duty(path, (uint16)(i % DUTY_MAX));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / n;
+}
+
+static void test_timing() {
+    std::printf("\n== 耗时 ==\n");
+    const int n = 200000;
+    double file_ns = ns_per_call("/dev/pwm_file", n);
+    double mmio_ns = ns_per_call("/dev/pwm_0", n);
+    std::printf("pwm_set_duty：设备文件 %.0f ns，寄存器 %.1f ns\n", file_ns, mmio_ns);
+}
+
+int main() {
+    mkdir(ROOT, 0755);
+    mkdir((std::string(ROOT) + "/dev").c_str(), 0755);
+    make_device("pwm_file");
+    file_set_device_root(ROOT);
+
+    test_bind();
+    test_driver_writes();
+    test_actuator_service();
+    test_timing();
+    mmio_unmap_all();
+    return test_report();
+}
@@ -0,0 +1,149 @@
+// 执行器与临时线程方案对比
+// 同一组模拟负载（相机、视觉、控制、IMU、显示）分别用：
+//   1. 每个循环一个 std::thread + sleep_for（原先的写法）
+//   2. TaskScheduler 多工作线程
+//   3. TaskScheduler 单核协作式
+// 比较控制环的周期抖动、实际频率和进程CPU占用
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/executor_bench.cpp src/task_scheduler.cpp src/task_admission.cpp src/rt_thread.cpp -lpthread
+#include "task_scheduler.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+using namespace robot;
+using namespace std::chrono;
+
+// 忙等模拟计算负载
+static void busy_us(int us) {
+    auto end = steady_clock::now() + microseconds(us);
+    while (steady_clock::now() < end) {
+    }
+}
+
+static double cpu_seconds() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+// 控制环周期抖动：|实际间隔 - 周期|
+struct JitterProbe {
+    explicit JitterProbe(int hz) : period_us(1000000 / hz) {}
+
+    void tick() {
+        auto now = steady_clock::now();
+        if (count > 0) {
+            int64_t interval = duration_cast<microseconds>(now - last).count();
+            jitter.record(static_cast<uint64_t>(std::llabs(interval - period_us)));
+        }
+        last = now;
+        count++;
+    }
+
+    int64_t period_us;
+    steady_clock::time_point last;
+    uint64_t count = 0;
+    LatencyHistogram jitter;
+};
+
+static const int kControlHz = 100;
+
+struct Workload {
+    JitterProbe control{kControlHz};
+    void camera() { std::this_thread::sleep_for(microseconds(16000)); }   // 阻塞等待下一帧
+    void vision() { busy_us(4000); }
+    void control_step() { control.tick(); busy_us(300); }
+    void imu() { busy_us(200); }
+    void display() { busy_us(3000); }
+};
+
+static void report(const char* name, Workload& load, double seconds, double cpu) {
+    auto snap = load.control.jitter.snapshot();
+    std::printf("%-22s %8.1f %10llu %10llu %10llu %8.1f%%\n", name,
+                load.control.count / seconds,
+                static_cast<unsigned long long>(snap.percentile(50)),
+                static_cast<unsigned long long>(snap.percentile(99)),
+                static_cast<unsigned long long>(snap.max),
+                100.0 * cpu / seconds);
+}
+
+// 方案1：每个循环一个线程，执行后 sleep_for 一个周期（周期随执行时间漂移）
+static void run_adhoc(int seconds_to_run) {
+    Workload load;
+    std::atomic<bool> stop(false);
+    auto loop = [&stop](int hz, std::function<void()> fn) {
+        return std::thread([&stop, hz, fn]() {
+            while (!stop) {
+                fn();
+                std::this_thread::sleep_for(microseconds(1000000 / hz));
+            }
+        });
+    };
+
+    double cpu_begin = cpu_seconds();
+    std::vector<std::thread> threads;
+    threads.push_back(std::thread([&]() { while (!stop) load.camera(); }));
+    threads.push_back(loop(60, [&]() { load.vision(); }));
+    threads.push_back(loop(kControlHz, [&]() { load.control_step(); }));
+    threads.push_back(loop(100, [&]() { load.imu(); }));
+    threads.push_back(loop(15, [&]() { load.display(); }));
+
+    std::this_thread::sleep_for(seconds(seconds_to_run));
+    stop = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+    report("ad-hoc threads", load, seconds_to_run, cpu_seconds() - cpu_begin);
+}
+
+// 方案2/3：执行器
+static void add_tasks(TaskScheduler& scheduler, Workload& load) {
+    TaskOptions camera;
+    camera.dedicated_thread = true;
+    camera.miss_policy = MissPolicy::Skip;
+    scheduler.setAdmissionPolicy(AdmissionPolicy::None);
+    scheduler.addTask("camera", [&]() { load.camera(); }, 60, Priority::HIGH, 0, camera);
+    scheduler.addTask("control", [&]() { load.control_step(); }, kControlHz, Priority::CRITICAL);
+    scheduler.addTask("imu", [&]() { load.imu(); }, 100, Priority::HIGH);
+    scheduler.addTask("vision", [&]() { load.vision(); }, 60, Priority::HIGH);
+    scheduler.addTask("display", [&]() { load.display(); }, 15, Priority::LOW);
+}
+
+static void run_executor(int workers, int seconds_to_run) {
+    Workload load;
+    TaskScheduler scheduler(workers);
+    add_tasks(scheduler, load);
+
+    double cpu_begin = cpu_seconds();
+    if (workers > 0) {
+        scheduler.start();
+        std::this_thread::sleep_for(seconds(seconds_to_run));
+        scheduler.stop();
+    } else {
+        auto deadline = steady_clock::now() + seconds(seconds_to_run);
+        scheduler.run([deadline]() { return steady_clock::now() >= deadline; });
+    }
+    double cpu = cpu_seconds() - cpu_begin;
+
+    char name[32];
+    std::snprintf(name, sizeof(name), workers > 0 ? "executor %d workers" : "executor cooperative", workers);
+    report(name, load, seconds_to_run, cpu);
+}
+
+int main(int argc, char* argv[]) {
+    int seconds_to_run = argc > 1 ? std::atoi(argv[1]) : 3;
+
+    std::printf("控制环 %d Hz，每种方案运行 %d 秒\n", kControlHz, seconds_to_run);
+    std::printf("%-22s %8s %10s %10s %10s %9s\n", "scheme", "rate Hz", "jit p50", "jit p99", "jit max", "CPU");
+
+    run_adhoc(seconds_to_run);
+    run_executor(2, seconds_to_run);
+    run_executor(0, seconds_to_run);
+    return 0;
+}
@@ -0,0 +1,361 @@
+// 飞行记录器测试：帧、寻线摘要与遥测记录写入后按序读回且内容一致；数据区回绕后保留最新的记录；
+// 文件头落后（断电前未写回）时找回之后的记录，写了一半的记录被丢弃；记录过程中复制出的文件从最旧的完整记录读起；
+// 没有空闲缓冲区时丢弃并计数，并输出视觉线程每帧的拷贝耗时（只输出不断言）
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/flight_recorder_test.cpp src/flight_recorder.cpp src/binary_rle.cpp
+//               src/telemetry_bus.cpp src/rt_thread.cpp -lpthread
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "flight_recorder.hpp"
+#include "test_check.hpp"
+
+using namespace robot;
+
+static const int W = 320, H = 240;
+
+// 类似寻线二值图：黑色背景中一条随帧号左右移动的白色赛道
+static std::vector<uint8_t> track_image(int frame) {
+    std::vector<uint8_t> img(W * H, 0);
+    for (int y = 3; y < H - 3; ++y) {
+        int half = 20 + y * (W / 2 - 30) / H;
+        int center = W / 2 + (frame % 40) - 20;
+        for (int x = std::max(3, center - half); x < std::min(W - 3, center + half); ++x) {
+            img[y * W + x] = 255;
+        }
+    }
+    return img;
+}
+
+struct Borders {
+    uint16_t left[H], right[H], center[H];
+    explicit Borders(int frame) {
+        for (int y = 0; y < H; ++y) {
+            left[y] = (uint16_t)(y + frame);
+            right[y] = (uint16_t)(W - y - frame);
+            center[y] = (uint16_t)((left[y] + right[y]) / 2);
+        }
+    }
+};
+
+// 视觉线程的一帧：取缓冲区、拷贝二值图、灰度图（需要时）与边线、填写摘要、提交
+static bool record_frame(FlightRecorder& recorder, int frame, const std::vector<uint8_t>& binary) {
+    FlightFrame* slot = recorder.acquire();
+    if (!slot) {
+        return false;
+    }
+    Borders borders(frame);
+    slot->setBinary(binary.data(), W, H, W);
+    if (slot->want_gray) {
+        slot->setGray(binary.data(), W, H, W);
+    }
+    slot->setBorders(borders.left, borders.right, borders.center, H);
+    slot->path.frame_id = frame;
+    slot->path.sensor_ns = 1000000LL * frame;
+    slot->path.track_kind = (int16_t)(frame % 7);
+    slot->path.servo_angle = (int16_t)(frame - 50);
+    slot->path.motor_speed = 100 + frame;
+    slot->path.distance = frame * 0.01;
+    slot->path.inflection_num[0] = 1;
+    slot->path.inflection[0][0] = {(int16_t)frame, 120};
+    recorder.commit(slot);
+    return true;
+}
+
+struct ReadResult {
+    std::vector<uint64_t> path_frames;
+    std::vector<uint64_t> binary_frames;
+    int gray_frames = 0;
+    uint64_t telemetry = 0;
+    bool consecutive = true;
+    bool content_ok = true;
+    uint64_t recovered = 0;
+};
+
+static ReadResult read_log(const std::string& path) {
+    ReadResult result;
+    FlightLogReader reader;
+    if (!reader.open(path)) {
+        result.consecutive = false;
+        return result;
+    }
+    FlightRecordView view;
+    uint64_t last_seq = 0;
+    bool first = true;
+    std::vector<uint16_t> borders;
+    std::vector<uint8_t> pixels;
+    std::vector<TelemetryRecord> records;
+    while (reader.next(&view)) {
+        // 序号只在跳过填充记录时多跳一个
+        if (!first && view.header.sequence != last_seq + 1) {
+            result.consecutive = result.consecutive && view.header.sequence == last_seq + 2;
+        }
+        first = false;
+        last_seq = view.header.sequence;
+        FlightPath path;
+        FlightFrameInfo info;
+        switch ((FlightRecordType)view.header.type) {
+        case FlightRecordType::Path: {
+            bool ok = FlightLogReader::parsePath(view, &path, &borders);
+            Borders expected((int)path.frame_id);
+            ok = ok && path.rows == H && path.motor_speed == 100 + (int)path.frame_id &&
+                 path.inflection[0][0].x == (int16_t)path.frame_id &&
+                 std::memcmp(borders.data(), expected.left, sizeof(expected.left)) == 0 &&
+                 std::memcmp(&borders[2 * H], expected.center, sizeof(expected.center)) == 0;
+            result.content_ok = result.content_ok && ok;
+            result.path_frames.push_back(path.frame_id);
+            break;
+        }
+        case FlightRecordType::BinaryFrame:
+        case FlightRecordType::GrayFrame: {
+            bool ok = FlightLogReader::parseFrame(view, &info, &pixels) && info.width == W && info.height == H;
+            std::vector<uint8_t> expected = track_image((int)info.frame_id);
+            ok = ok && pixels == expected;
+            result.content_ok = result.content_ok && ok;
+            if (view.header.type == (uint16_t)FlightRecordType::GrayFrame) {
+                result.gray_frames++;
+            } else {
+                result.binary_frames.push_back(info.frame_id);
+            }
+            break;
+        }
+        case FlightRecordType::Telemetry:
+            result.content_ok = result.content_ok && FlightLogReader::parseTelemetry(view, &records);
+            result.telemetry += records.size();
+            break;
+        default:
+            result.content_ok = false;
+            break;
+        }
+    }
+    result.recovered = reader.recovered();
+    return result;
+}
+
+static bool frames_consecutive(const std::vector<uint64_t>& frames, uint64_t last) {
+    for (size_t i = 1; i < frames.size(); ++i) {
+        if (frames[i] != frames[i - 1] + 1) {
+            return false;
+        }
+    }
+    return !frames.empty() && frames.back() == last;
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void write_file(const std::string& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), data.size());
+}
+
+static void test_round_trip() {
+    std::printf("\n== 写入与读回 ==\n");
+    const std::string path = "/tmp/flight_test/basic.rbl";
+    TelemetryBus bus(1024);
+    bus.push(TelemetryType::Imu, TelemetryImu{}, 1);       // 启动前的记录不写入
+    FlightRecorder recorder;
+    FlightRecorderOptions options;
+    options.path = path;
+    options.capacity = 4 << 20;
+    options.gray_every = 10;
+    options.keep_previous = false;
+    check(recorder.start(options, &bus), "启动");
+    check(!recorder.start(options, &bus), "重复启动失败");
+
+    const int frames = 30;
+    int committed = 0;
+    for (int i = 0; i < frames; ++i) {
+        for (int k = 0; k < 10; ++k) {
+            TelemetryEncoder encoder = {i, k, 0, 0, 0, 0};
+            bus.push(TelemetryType::Encoder, encoder, i * 10 + k);
+        }
+        committed += record_frame(recorder, i, track_image(i)) ? 1 : 0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    recorder.stop();
+    check(recorder.acquire() == nullptr, "停止后不再提供缓冲区");
+
+    FlightRecorderStats stats = recorder.stats();
+    ReadResult result = read_log(path);
+    std::printf("写入 %llu 帧、%llu 条遥测，共 %.1f KB（%.1f KB/帧）；丢弃 %llu；写入 p99 %llu μs\n",
+                (unsigned long long)stats.frames, (unsigned long long)stats.telemetry, stats.bytes / 1024.0,
+                stats.bytes / 1024.0 / frames, (unsigned long long)stats.dropped,
+                (unsigned long long)stats.write_us.percentile(99));
+    check(committed == frames && stats.frames == (uint64_t)frames && stats.dropped == 0, "所有帧都写入");
+    check(result.consecutive && result.content_ok, "记录连续，图像、摘要与边线内容一致");
+    check(frames_consecutive(result.path_frames, frames - 1) && result.path_frames.front() == 0 &&
+          result.binary_frames.size() == (size_t)frames, "每帧一条二值图记录和一条摘要记录");
+    check(result.gray_frames == 3, "每 10 帧记录一帧灰度图");
+    check(result.telemetry == (uint64_t)frames * 10 && stats.telemetry == result.telemetry,
+          "遥测记录从启动时开始全部写入");
+    uint64_t frame_bytes = (stats.bytes - 3 * (W * H + 64) - result.telemetry * sizeof(TelemetryRecord)) / frames;
+    std::printf("不计灰度图与遥测，每帧 %llu 字节（原始二值图 %d 字节）\n", (unsigned long long)frame_bytes, W * H);
+    check(frame_bytes < 4096, "二值图与摘要每帧不到 4KB");
+    check(stats.syncs >= 1, "停止时写回存储");
+
+    // 再次启动时上一次的记录改名保留
+    options.keep_previous = true;
+    check(recorder.start(options) && access((path + ".prev").c_str(), F_OK) == 0, "保留上一次运行的记录");
+    recorder.stop();
+    check(read_log(path + ".prev").path_frames.size() == (size_t)frames, "上一次的记录可以读取");
+    check(read_log(path).path_frames.empty(), "新文件没有旧记录");
+}
+
+static void test_wrap() {
+    std::printf("\n== 数据区回绕 ==\n");
+    const std::string path = "/tmp/flight_test/wrap.rbl";
+    FlightRecorder recorder;
+    FlightRecorderOptions options;
+    options.path = path;
+    options.capacity = 64 * 1024;
+    options.keep_previous = false;
+    options.poll_ms = 1;
+    check(recorder.start(options), "启动");
+    const int frames = 300;
+    for (int i = 0; i < frames; ++i) {
+        while (!record_frame(recorder, i, track_image(i))) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    recorder.stop();
+    FlightRecorderStats stats = recorder.stats();
+    ReadResult result = read_log(path);
+    std::printf("64KB 数据区写入 %llu 帧，回绕 %llu 次，保留最近 %zu 帧\n", (unsigned long long)stats.frames,
+                (unsigned long long)stats.wraps, result.path_frames.size());
+    check(stats.wraps >= 5, "多次回绕");
+    check(result.consecutive && result.content_ok, "回绕后记录连续、内容一致");
+    check(frames_consecutive(result.path_frames, frames - 1) && result.path_frames.size() > 10,
+          "保留的是最新的连续帧");
+
+    // 文件头落后：把 head 退回到最后第 5 条记录之前，之后的记录仍能找回
+    std::string data = read_file(path);
+    FlightLogHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    std::vector<uint64_t> positions;
+    {
+        FlightLogReader reader;
+        reader.open(path);
+        FlightRecordView view;
+        while (reader.next(&view)) {
+            positions.push_back(view.position);
+        }
+    }
+    FlightLogHeader stale = header;
+    stale.head = positions[positions.size() - 5];
+    std::memcpy(&data[0], &stale, sizeof(stale));
+    write_file(path + ".stale", data);
+    ReadResult recovered = read_log(path + ".stale");
+    check(recovered.recovered == 5 && frames_consecutive(recovered.path_frames, frames - 1),
+          "文件头未更新时找回之后写入的记录");
+
+    // 最后一条记录写了一半：校验失败，只读到它之前
+    uint64_t last = positions.back();
+    data[FLIGHT_LOG_DATA_OFFSET + last % header.capacity + sizeof(FlightRecordHeader) + 3] ^= 0x5A;
+    write_file(path + ".torn", data);
+    ReadResult torn = read_log(path + ".torn");
+    check(torn.content_ok && torn.path_frames.size() == result.path_frames.size() - 1 &&
+          torn.path_frames.back() == (uint64_t)frames - 2, "写了一半的记录被丢弃");
+}
+
+static void test_live_copy() {
+    std::printf("\n== 记录过程中复制的文件 ==\n");
+    // 文件头在复制开始时读取，数据区在复制过程中读取：此时已有新记录覆盖了最旧的一段
+    const std::string path = "/tmp/flight_test/live.rbl";
+    FlightRecorder recorder;
+    FlightRecorderOptions options;
+    options.path = path;
+    options.capacity = 64 * 1024;
+    options.keep_previous = false;
+    options.poll_ms = 1;
+    recorder.start(options);
+    int frame = 0;
+    auto write_frames = [&](int n) {
+        for (int i = 0; i < n; ++frame) {
+            while (!record_frame(recorder, frame, track_image(frame))) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            ++i;
+        }
+        while (recorder.stats().frames < (uint64_t)frame) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+    write_frames(100);
+    std::string before = read_file(path);
+    write_file(path + ".before", before);
+    write_frames(3);
+    std::string after = read_file(path);
+    recorder.stop();
+
+    std::string copy = after;
+    copy.replace(0, FLIGHT_LOG_DATA_OFFSET, before, 0, FLIGHT_LOG_DATA_OFFSET);
+    write_file(path + ".copy", copy);
+    ReadResult old_result = read_log(path + ".copy");
+    ReadResult new_result = read_log(path);
+    std::printf("复制开始时保留 %zu 帧，复制结束时 %zu 帧，从复制的文件读到 %zu 帧\n",
+                read_log(path + ".before").path_frames.size(), new_result.path_frames.size(), old_result.path_frames.size());
+    FlightLogReader reader;
+    FlightRecordView first;
+    bool skipped = reader.open(path + ".copy") && reader.next(&first) && first.position != reader.header().tail;
+    check(skipped, "文件头中的 tail 已被覆盖，读取从其后开始");
+    check(old_result.content_ok && frames_consecutive(old_result.path_frames, frame - 1) &&
+          old_result.path_frames.size() + 5 >= new_result.path_frames.size(),
+          "从被覆盖部分之后的最旧记录读到最新的记录");
+}
+
+static void test_producer_cost() {
+    std::printf("\n== 视觉线程开销 ==\n");
+    FlightRecorder recorder;
+    FlightRecorderOptions options;
+    options.path = "/tmp/flight_test/cost.rbl";
+    options.capacity = 8 << 20;
+    options.keep_previous = false;
+    options.slots = 2;
+    options.poll_ms = 200;
+    recorder.start(options);
+
+    // 记录线程 200ms 才处理一次：连续提交时只有两个缓冲区，其余丢弃
+    std::vector<uint8_t> binary = track_image(0);
+    int accepted = 0;
+    for (int i = 0; i < 10; ++i) {
+        accepted += record_frame(recorder, i, binary) ? 1 : 0;
+    }
+    FlightRecorderStats stats = recorder.stats();
+    check(accepted <= 4 && stats.dropped == (uint64_t)(10 - accepted), "没有空闲缓冲区时丢弃并计数，不阻塞");
+    recorder.stop();
+
+    options.slots = 8;
+    options.poll_ms = 5;
+    recorder.start(options);
+    const int n = 300;
+    double total_us = 0, max_us = 0;
+    for (int i = 0; i < n; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        record_frame(recorder, i, binary);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        total_us += us;
+        max_us = std::max(max_us, us);
+        std::this_thread::sleep_for(std::chrono::milliseconds(4));
+    }
+    recorder.stop();
+    stats = recorder.stats();
+    double mean_us = total_us / n;
+    std::printf("每帧拷贝 %.1f μs（最大 %.1f μs），占 60fps 帧时间的 %.2f%%；记录线程每帧 p50 %llu μs\n", mean_us,
+                max_us, mean_us / 16667.0 * 100, (unsigned long long)stats.write_us.percentile(50));
+}
+
+int main() {
+    test_round_trip();
+    test_wrap();
+    test_live_copy();
+    test_producer_cost();
+    return test_report();
+}
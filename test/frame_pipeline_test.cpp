@@ -0,0 +1,154 @@
+// 帧流水线测试
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/frame_pipeline_test.cpp src/frame_pipeline.cpp src/rt_thread.cpp -lpthread
+#include "frame_pipeline.hpp"
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include "test_check.hpp"
+
+using namespace robot;
+using namespace std::chrono;
+
+// SPSC 队列：两个线程传递一百万个递增数，顺序与内容不变
+static void test_ring() {
+    std::printf("\n== SpscRing ==\n");
+    SpscRing<uint32_t, 1024> ring;
+    const uint32_t count = 1000000;
+    bool in_order = true;
+
+    std::thread consumer([&]() {
+        uint32_t expected = 0;
+        uint32_t value;
+        while (expected < count) {
+            if (ring.pop(value)) {
+                in_order = in_order && value == expected;
+                expected++;
+            }
+        }
+    });
+    for (uint32_t i = 0; i < count;) {
+        if (ring.push(i)) {
+            i++;
+        }
+    }
+    consumer.join();
+    check(in_order, "跨线程传递顺序正确");
+    check(ring.size() == 0, "传递完成后队列为空");
+}
+
+// 流水线：各阶段用 sleep 模拟在不同核心上的耗时
+static void test_latest_value() {
+    std::printf("\n== LatestValue ==\n");
+    struct Pair {
+        uint64_t a;
+        uint64_t b;
+    };
+    LatestValue<Pair> value;
+    Pair out = {7, 7};
+    check(!value.load(out) && out.a == 7, "未写入时返回 false 且不修改输出");
+
+    // 写者连续写入，读者检查每次读到的都是同一次写入的完整数据，且序号不倒退
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (uint64_t n = 1; !done.load(std::memory_order_relaxed); ++n) {
+            value.store(Pair{n, n * 3});
+        }
+    });
+    Pair first;
+    while (!value.load(first)) {
+        std::this_thread::yield();
+    }
+    bool consistent = true;
+    long loaded = 0;
+    uint64_t last = 0;
+    for (int i = 0; i < 200000; ++i) {
+        Pair p;
+        if (value.load(p)) {
+            consistent = consistent && p.b == p.a * 3 && p.a >= last;
+            last = p.a;
+            ++loaded;
+        }
+    }
+    done = true;
+    writer.join();
+    std::printf("读取 %ld 次成功\n", loaded);
+    check(consistent, "并发写入时读不到撕裂的数据");
+    check(loaded > 0, "写者持续写入时读者仍能读到");
+}
+
+static void test_pipeline() {
+    std::printf("\n== FramePipeline ==\n");
+    const int capture_ms = 5, preprocess_ms = 8, track_ms = 8, display_ms = 6;
+
+    struct Frame {
+        uint64_t id = 0;
+        int stages_seen = 0;
+    };
+
+    FramePipeline pipeline(4);
+    std::vector<Frame> frames(pipeline.slotCount());
+    LatestValue<uint64_t> newest;
+    bool ordered = true;
+    bool slot_exclusive = true;
+    uint64_t last_id = 0;
+
+    pipeline.addStage("capture", [&](const FrameInfo& info) {
+        std::this_thread::sleep_for(milliseconds(capture_ms));
+        frames[info.slot].id = info.frame_id;
+        frames[info.slot].stages_seen = 1;
+        return true;
+    });
+    pipeline.addStage("preprocess", [&](const FrameInfo& info) {
+        slot_exclusive = slot_exclusive && frames[info.slot].id == info.frame_id && frames[info.slot].stages_seen == 1;
+        std::this_thread::sleep_for(milliseconds(preprocess_ms));
+        frames[info.slot].stages_seen = 2;
+        return true;
+    });
+    pipeline.addStage("track", [&](const FrameInfo& info) {
+        slot_exclusive = slot_exclusive && frames[info.slot].stages_seen == 2;
+        std::this_thread::sleep_for(milliseconds(track_ms));
+        frames[info.slot].stages_seen = 3;
+        newest.store(info.frame_id);
+        return true;
+    });
+    pipeline.addStage("display", [&](const FrameInfo& info) {
+        slot_exclusive = slot_exclusive && frames[info.slot].stages_seen == 3;
+        ordered = ordered && (last_id == 0 || info.frame_id > last_id);
+        last_id = info.frame_id;
+        std::this_thread::sleep_for(milliseconds(display_ms));
+        return true;
+    });
+
+    check(pipeline.start(), "启动流水线");
+    std::this_thread::sleep_for(milliseconds(300));
+    pipeline.resetStats();
+    std::this_thread::sleep_for(seconds(2));
+
+    uint64_t newest_id = 0;
+    bool has_newest = newest.load(newest_id);
+    pipeline.stop();
+    pipeline.printStats();
+
+    auto stats = pipeline.getStats();
+    double serial_fps = 1000.0 / (capture_ms + preprocess_ms + track_ms + display_ms);
+    double slowest_fps = 1000.0 / track_ms;
+    std::printf("串行上限 %.1f fps，最慢阶段上限 %.1f fps，实际 %.1f fps\n",
+                serial_fps, slowest_fps, stats.back().fps);
+
+    check(stats.back().fps > serial_fps * 1.5, "吞吐量明显高于各阶段串行之和");
+    check(stats.front().dropped > 0, "下游跟不上时采集阶段丢帧");
+    check(ordered, "帧序号按顺序到达最后一阶段");
+    check(slot_exclusive, "帧槽在阶段之间独占传递");
+    check(has_newest && newest_id > 0, "LatestValue 读到最新结果");
+    check(stats.back().age_us.percentile(50) >=
+              static_cast<uint64_t>((preprocess_ms + track_ms + display_ms) * 1000),
+          "端到端延迟不小于各下游阶段耗时之和");
+}
+
+int main() {
+    test_ring();
+    test_latest_value();
+    test_pipeline();
+    return test_report();
+}
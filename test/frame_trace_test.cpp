@@ -0,0 +1,85 @@
+// 逐帧追踪测试
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/frame_trace_test.cpp src/frame_trace.cpp src/rt_thread.cpp -lpthread
+#include "frame_trace.hpp"
+#include <cstdio>
+#include <string>
+#include <thread>
+#include "rt_thread.hpp"
+#include "test_check.hpp"
+
+using namespace robot;
+
+static size_t count_of(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+int main() {
+    FrameTracer& tracer = FrameTracer::instance();
+    tracer.setSpansPerThread(64);
+
+    // 两个线程模拟相邻的两个阶段，各自写自己的缓冲区
+    const int frames = 20;
+    std::thread stage_a([&]() {
+        setThreadName("stage_a");
+        for (int i = 0; i < frames; ++i) {
+            FRAME_TRACE_SCOPE(i, "imgPreProc");
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+    std::thread stage_b([&]() {
+        tracer.setThreadName("stage_b");
+        for (int i = 0; i < frames; ++i) {
+            int64_t start = FrameTracer::nowNs();
+            tracer.record(i, "TrackKind_Judge", start, start + 1000);
+            tracer.recordFrameActuated(i, start - 5000000, start + 2000);   // 5ms
+        }
+    });
+    stage_a.join();
+    stage_b.join();
+
+    std::string json = tracer.chromeTraceJson();
+    check(json.find("\"traceEvents\"") != std::string::npos, "输出 Chrome trace 格式");
+    check(count_of(json, "\"name\":\"imgPreProc\"") == frames, "线程A的区间全部导出");
+    check(count_of(json, "\"name\":\"TrackKind_Judge\"") == frames, "线程B的区间全部导出");
+    check(count_of(json, "\"ph\":\"b\"") == frames && count_of(json, "\"ph\":\"e\"") == frames,
+          "帧生命周期导出为成对的异步事件");
+    check(json.find("\"name\":\"stage_a\"") != std::string::npos, "使用线程名");
+    check(json.find("\"name\":\"stage_b\"") != std::string::npos, "使用 setThreadName 设置的名称");
+
+    auto latency = tracer.glassToActuatorSnapshot();
+    check(latency.count == static_cast<uint64_t>(frames), "glass-to-PWM 延迟样本数");
+    check(latency.percentile(99) >= 4900 && latency.percentile(99) <= 5400, "glass-to-PWM p99 约为 5ms");
+
+    // 缓冲区写满后只保留最新的记录
+    tracer.clear();
+    std::thread overflow([&]() {
+        for (int i = 0; i < 1000; ++i) {
+            tracer.record(i, "overflow", i * 1000, i * 1000 + 10);
+        }
+    });
+    overflow.join();
+    json = tracer.chromeTraceJson();
+    check(count_of(json, "\"name\":\"overflow\"") == 64, "写满后保留缓冲区容量条记录");
+    check(json.find("\"frame\":999}") != std::string::npos && json.find("\"frame\":900}") == std::string::npos,
+          "保留的是最新的记录");
+
+    // 关闭后不再记录区间，延迟统计照常
+    tracer.clear();
+    tracer.setEnabled(false);
+    {
+        FRAME_TRACE_SCOPE(1, "disabled");
+    }
+    tracer.recordFrameActuated(1, 0, 1000);
+    tracer.setEnabled(true);
+    json = tracer.chromeTraceJson();
+    check(json.find("disabled") == std::string::npos, "关闭时不记录区间");
+    check(tracer.glassToActuatorSnapshot().count == static_cast<uint64_t>(frames + 1), "关闭时仍统计延迟");
+
+    check(tracer.writeChromeTrace("/tmp/frame_trace_test.json"), "写入追踪文件");
+
+    return test_report();
+}
@@ -0,0 +1,143 @@
+// 硬件抽象层测试：进程内假设备的读写；文件仿真的设备树与车上驱动（编码器、PWM、GPIO、IMU sysfs）、
+// SensorSampler、ActuatorService 之间的数据往返；内存显存上的 ips200 绘制与 PPM 输出
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/hal_test.cpp src/hal.cpp src/sensor_sampler.cpp src/imu_stream.cpp
+//               src/actuator_service.cpp src/frame_trace.cpp src/rt_thread.cpp src/zf_device_imu_core.cpp src/zf_driver_file.cpp
+//               src/zf_driver_encoder.cpp src/zf_driver_pwm.cpp src/zf_driver_gpio.cpp src/zf_driver_mmio.cpp
+//               src/zf_device_ips200_fb.cpp src/zf_common_font.cpp src/zf_common_function.cpp
+//               src/rgb565_scaler.cpp -lpthread
+#include "hal.hpp"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include "actuator_service.hpp"
+#include "sensor_sampler.hpp"
+#include "zf_common_font.h"
+#include "zf_device_ips200_fb.h"
+#include "zf_driver_encoder.h"
+#include "zf_driver_gpio.h"
+#include "test_check.hpp"
+
+using namespace robot;
+
+static const char* ROOT = "/tmp/hal_test";
+
+static void test_memory_devices() {
+    std::printf("\n== 进程内假设备 ==\n");
+    hal::MemoryEncoder encoder;
+    encoder.set(-123);
+    check(encoder.read() == -123, "编码器返回设置的计数");
+
+    pwm_info info = {50, 0, 10000, 0, 20000000, 0};
+    hal::MemoryPwm pwm(info);
+    pwm_info read_info;
+    check(pwm.info(read_info) && read_info.duty_max == 10000 && read_info.period_ns == 20000000, "PWM 参数");
+    pwm.setDuty(750);
+    pwm.setDuty(760);
+    check(pwm.duty() == 760 && pwm.writes() == 2, "PWM 记录最新占空比与写入次数");
+
+    hal::MemoryGpio gpio;
+    gpio.set(5);
+    check(gpio.get() == 1, "GPIO 电平归一为 0/1");
+
+    hal::MemoryImu imu(0.001);
+    imu_raw_data_t data;
+    check(imu.initialize() && !imu.read(data), "IMU 没有新样本时读取失败");
+    imu_raw_data_t sample = {};
+    sample.gyro_z = 321;
+    imu.set(sample);
+    check(imu.read(data) && data.gyro_z == 321 && !imu.read(data), "IMU 每个样本只读到一次");
+}
+
+static void test_sim_device_tree() {
+    std::printf("\n== 文件仿真的设备树 ==\n");
+    hal::SimDeviceTree tree(ROOT);
+    pwm_info servo = {50, 0, 10000, 0, 20000000, 0};
+    check(tree.addEncoder("/dev/zf_encoder_1") && tree.addEncoder("/dev/zf_encoder_2") &&
+          tree.addPwm("/dev/zf_device_pwm_servo", servo) && tree.addGpio("/dev/zf_driver_gpio_motor_1") &&
+          tree.addGpio("/dev/zf_driver_gpio_key_0", 1) && tree.addImu("IMU660RA", 0.00106),
+          "创建设备文件");
+    tree.activate();
+
+    // 车上驱动读写同一批文件
+    hal::DevicePwm pwm("/dev/zf_device_pwm_servo");
+    pwm_info info;
+    check(pwm.info(info) && info.freq == 50 && info.duty_max == 10000, "pwm_get_dev_info 读到创建时的参数");
+    pwm.setDuty(725);
+    uint16_t duty = 0;
+    check(tree.pwmDuty("/dev/zf_device_pwm_servo", &duty) && duty == 725, "pwm_set_duty 写入的占空比");
+
+    hal::DeviceGpio dir("/dev/zf_driver_gpio_motor_1");
+    dir.set(1);
+    uint8_t level = 0;
+    check(tree.gpioLevel("/dev/zf_driver_gpio_motor_1", &level) && level == 1 && dir.get() == 1, "GPIO ASCII 电平");
+    hal::DeviceGpio key("/dev/zf_driver_gpio_key_0");
+    check(key.get() == 1, "按键初始电平");
+
+    tree.setEncoder("/dev/zf_encoder_1", 42);
+    tree.setEncoder("/dev/zf_encoder_2", -17);
+    hal::DeviceEncoder encoder("/dev/zf_encoder_1");
+    check(encoder.read() == 42, "encoder_get_count 读到仿真计数");
+
+    // IMU：没有 IIO 缓冲区，退回 sysfs 逐轴读取
+    IMUDevice imu;
+    hal::DeviceImu device_imu(&imu);
+    check(device_imu.initialize() && imu.get_device_type() == IMU_DEV_IMU660RA &&
+          imu.get_backend() == IMU_BACKEND_SYSFS, "IMUDevice 识别仿真 IMU（sysfs）");
+    check(device_imu.gyroScale() > 0.00105 && device_imu.gyroScale() < 0.00107, "陀螺仪比例");
+    imu_raw_data_t data = {};
+    data.acc_z = 4096;
+    data.gyro_z = -12345;
+    tree.setImu(data);
+    imu_raw_data_t read_data;
+    check(device_imu.read(read_data) && read_data.acc_z == 4096 && read_data.gyro_z == -12345, "IMU 各轴数值");
+    data.gyro_z = 7;
+    tree.setImu(data);
+    check(device_imu.read(read_data) && read_data.gyro_z == 7, "较短的数值覆盖较长的数值");
+
+    // 直接持有设备句柄的模块
+    SensorSampler sampler("/dev/zf_encoder_1", "/dev/zf_encoder_2", &imu);
+    SensorSample sample;
+    check(sampler.open() && sampler.sample(sample) && sample.encoder_left == 42 && sample.encoder_right == -17 &&
+          sample.imu_valid && sample.imu.gyro_z == 7, "SensorSampler 批量读取仿真设备");
+
+    ActuatorService actuators;
+    int channel = actuators.addPwm("/dev/zf_device_pwm_servo", 0);
+    actuators.start();
+    actuators.set(channel, 800);
+    for (int i = 0; i < 100 && actuators.stats(channel).writes == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    actuators.stop();
+    check(tree.pwmDuty("/dev/zf_device_pwm_servo", &duty) && duty == 800, "ActuatorService 写入仿真 PWM");
+}
+
+static void test_memory_framebuffer() {
+    std::printf("\n== 内存显存 ==\n");
+    hal::MemoryFramebuffer screen(240, 320);
+    check(screen.open(), "ips200_attach 到内存");
+    ips200_full(RGB565_BLUE);
+    ips200_draw_point(10, 20, RGB565_RED);
+    ips200_update_screen();
+    check(screen.pixel(0, 0) == RGB565_BLUE && screen.pixel(10, 20) == RGB565_RED, "绘制结果写入内存显存");
+
+    std::string path = std::string(ROOT) + "/screen.ppm";
+    check(screen.savePpm(path), "保存 PPM");
+    FILE* fp = std::fopen(path.c_str(), "rb");
+    int width = 0, height = 0, max = 0;
+    bool header = fp && std::fscanf(fp, "P6 %d %d %d", &width, &height, &max) == 3;
+    long size = 0;
+    if (fp) {
+        std::fseek(fp, 0, SEEK_END);
+        size = std::ftell(fp);
+        std::fclose(fp);
+    }
+    check(header && width == 240 && height == 320 && max == 255 && size >= 240 * 320 * 3, "PPM 头与像素数据");
+}
+
+int main() {
+    test_memory_devices();
+    test_sim_device_tree();
+    test_memory_framebuffer();
+    return test_report();
+}
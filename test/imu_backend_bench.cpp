@@ -0,0 +1,201 @@
+// IMU 读取方式对比：IIO 缓冲区（批量读取打包样本）与逐轴 sysfs
+// 设备由 tmpfs 上的仿真文件模拟，/dev/iio:device1 用 FIFO 代替，由生产者线程按给定速率写入打包样本
+// 注意：仿真的 sysfs 读取不含真实驱动每次读取时的总线传输，实际设备上 sysfs 方式的开销更大
+// 编译（主机）：
+//   g++ -std=c++17 -O2 -Iinclude test/imu_backend_bench.cpp src/zf_device_imu_core.cpp src/zf_driver_file.cpp -lpthread
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+#include "zf_device_imu_core.h"
+#include "zf_driver_file.h"
+#include "test_check.hpp"
+
+static const std::string ROOT = "/dev/shm/zf_imu_fake";
+static const std::string DIR = ROOT + "/sys/bus/iio/devices/iio:device1";
+static const std::string FIFO = ROOT + "/dev/iio:device1";
+static const char* AXES[6] = {"accel_x", "accel_y", "accel_z", "anglvel_x", "anglvel_y", "anglvel_z"};
+
+static void write_file(const std::string& path, const std::string& content) {
+    for (size_t pos = 1; (pos = path.find('/', pos)) != std::string::npos; ++pos) {
+        mkdir(path.substr(0, pos).c_str(), 0755);
+    }
+    FILE* fp = fopen(path.c_str(), "w");
+    fputs(content.c_str(), fp);
+    fclose(fp);
+}
+
+static void create_fake_device() {
+    write_file(DIR + "/name", "IMU660RA\n");
+    for (int i = 0; i < 6; ++i) {
+        write_file(DIR + "/in_" + AXES[i] + "_raw", std::to_string(i * 10) + "\n");
+        write_file(DIR + "/scan_elements/in_" + AXES[i] + "_en", "0");
+        write_file(DIR + "/scan_elements/in_" + AXES[i] + "_index", std::to_string(i) + "\n");
+        write_file(DIR + "/scan_elements/in_" + AXES[i] + "_type", "le:s16/16>>0\n");
+    }
+    write_file(DIR + "/scan_elements/in_timestamp_en", "0");
+    write_file(DIR + "/scan_elements/in_timestamp_index", "6\n");
+    write_file(DIR + "/scan_elements/in_timestamp_type", "le:s64/64>>0\n");
+    write_file(DIR + "/current_timestamp_clock", "");
+    write_file(DIR + "/buffer/enable", "0");
+    write_file(DIR + "/buffer/length", "");
+    write_file(DIR + "/buffer/watermark", "");
+    unlink(FIFO.c_str());
+    write_file(ROOT + "/dev/.keep", "");
+    mkfifo(FIFO.c_str(), 0644);
+}
+
+static int64_t monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static double thread_cpu_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 生产者：每毫秒写入一批打包样本（6×s16 + 对齐 + s64 时间戳 = 24 字节），各轴值为 序号+轴号
+class FakeProducer {
+public:
+    explicit FakeProducer(int rate) : rate_(rate) {}
+
+    void start() {
+        running_ = true;
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    void stop() {
+        running_ = false;
+        thread_.join();
+    }
+
+    uint64_t produced() const { return produced_; }
+
+private:
+    void run() {
+        int fd = open(FIFO.c_str(), O_WRONLY);
+        auto next = std::chrono::steady_clock::now();
+        double owed = 0;
+        std::vector<uint8_t> batch;
+        while (running_) {
+            next += std::chrono::milliseconds(1);
+            owed += rate_ / 1000.0;
+            int count = (int)owed;
+            owed -= count;
+            batch.assign((size_t)count * 24, 0);
+            for (int i = 0; i < count; ++i) {
+                uint8_t* scan = batch.data() + i * 24;
+                for (int axis = 0; axis < 6; ++axis) {
+                    int16_t value = (int16_t)(produced_ + axis);
+                    memcpy(scan + axis * 2, &value, 2);
+                }
+                int64_t timestamp = monotonic_ns();
+                memcpy(scan + 16, &timestamp, 8);
+                produced_++;
+            }
+            if (count > 0 && write(fd, batch.data(), batch.size()) < 0) {
+                break;
+            }
+            std::this_thread::sleep_until(next);
+        }
+        close(fd);
+    }
+
+    int rate_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> produced_{0};
+    std::thread thread_;
+};
+
+static void bench_buffer(int rate, double seconds) {
+    create_fake_device();
+    FakeProducer producer(rate);
+    producer.start();
+
+    IMUDevice imu;
+    bool ok = imu.initialize() && imu.get_backend() == IMU_BACKEND_BUFFER;
+    if (!ok) {
+        check(false, "缓冲区模式初始化");
+        producer.stop();
+        return;
+    }
+
+    std::vector<imu_sample_t> samples(256);
+    uint64_t received = 1;          // initialize 已读取一个样本
+    bool continuous = true;
+    bool timestamps_ok = true;
+    int16_t expected = (int16_t)(imu.get_raw_data().acc_x + 1);
+    int64_t last_ts = imu.get_timestamp_ns();
+
+    double cpu_start = thread_cpu_seconds();
+    auto wall_start = std::chrono::steady_clock::now();
+    auto wall_end = wall_start + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < wall_end) {
+        int n = imu.read_samples(samples.data(), (int)samples.size(), 10);
+        for (int i = 0; i < n; ++i) {
+            continuous = continuous && samples[i].data.acc_x == expected && samples[i].data.gyro_z == (int16_t)(expected + 5);
+            timestamps_ok = timestamps_ok && samples[i].timestamp_ns >= last_ts;
+            last_ts = samples[i].timestamp_ns;
+            expected++;
+        }
+        received += n > 0 ? n : 0;
+    }
+    double cpu = thread_cpu_seconds() - cpu_start;
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    producer.stop();
+
+    std::printf("buffer  %6d Hz target: %8.0f samples/s received, CPU %5.1f%%, %6.2f us CPU/sample, continuous=%d\n",
+                rate, received / wall, 100.0 * cpu / wall, 1e6 * cpu / received, continuous ? 1 : 0);
+    check(continuous, "样本连续且各轴解码正确");
+    check(timestamps_ok, "内核时间戳单调递增");
+}
+
+static void bench_sysfs(double seconds) {
+    create_fake_device();
+    IMUDevice imu;
+    imu_buffer_config_t config = {false, 0, 0, NULL};
+    imu.set_buffer_config(config);
+    bool ok = imu.initialize() && imu.get_backend() == IMU_BACKEND_SYSFS;
+    check(ok && imu.get_raw_data().gyro_z == 50, "sysfs 模式初始化并读取");
+
+    uint64_t updates = 0;
+    double cpu_start = thread_cpu_seconds();
+    auto wall_start = std::chrono::steady_clock::now();
+    auto wall_end = wall_start + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < wall_end) {
+        imu.update_all_data();
+        updates++;
+    }
+    double cpu = thread_cpu_seconds() - cpu_start;
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    std::printf("sysfs   busy loop:      %8.0f samples/s max,      CPU %5.1f%%, %6.2f us CPU/sample\n",
+                updates / wall, 100.0 * cpu / wall, 1e6 * cpu / updates);
+}
+
+static void test_fallback() {
+    // 没有缓冲区设备节点时退回 sysfs
+    create_fake_device();
+    unlink(FIFO.c_str());
+    IMUDevice imu;
+    check(imu.initialize() && imu.get_backend() == IMU_BACKEND_SYSFS, "缓冲区不可用时退回 sysfs");
+}
+
+int main() {
+    file_set_device_root(ROOT.c_str());
+
+    test_fallback();
+    bench_sysfs(1.0);
+    for (int rate : {1000, 4000, 16000, 64000}) {
+        bench_buffer(rate, 1.0);
+    }
+
+    return test_report();
+}
@@ -0,0 +1,146 @@
+// IMU 流式缓冲与按时间戳查询测试
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/imu_stream_test.cpp src/imu_stream.cpp src/zf_device_imu_core.cpp
+//              src/zf_driver_file.cpp src/rt_thread.cpp -lpthread
+#include "imu_stream.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include "test_check.hpp"
+
+using namespace robot;
+
+static imu_sample_t make_sample(int64_t t_ns, int16_t gyro_z, int16_t value) {
+    imu_sample_t sample = {};
+    sample.timestamp_ns = t_ns;
+    sample.data.gyro_z = gyro_z;
+    sample.data.acc_x = value;
+    sample.data.acc_y = value;
+    sample.data.acc_z = value;
+    return sample;
+}
+
+// 1kHz 恒定角速度：积分角应等于 角速度 × 时间
+static void test_integration() {
+    std::printf("\n== 积分与插值 ==\n");
+    ImuStream stream;
+    stream.setGyroScale(0.001);             // 1 LSB = 0.001 rad/s
+    const int64_t t0 = 1000000000LL;
+    for (int i = 0; i < 2000; ++i) {
+        stream.push(make_sample(t0 + i * 1000000LL, 500, (int16_t)i));   // 0.5 rad/s
+    }
+
+    double angle[3];
+    check(stream.integrateGyro(t0 + 100000000LL, t0 + 1100000000LL, angle) && std::fabs(angle[2] - 0.5) < 1e-9,
+          "恒定 0.5 rad/s 积分 1s 得到 0.5 rad");
+    check(stream.integrateGyro(t0 + 100500000LL, t0 + 100750000LL, angle) && std::fabs(angle[2] - 0.000125) < 1e-9,
+          "样本之间的时刻按插值积分");
+    check(stream.integrateGyro(t0 + 500000000LL, t0 + 200000000LL, angle) && angle[2] < 0,
+          "t1 早于 t0 时得到负角度");
+
+    imu_sample_t sample;
+    check(stream.sampleAt(t0 + 10500000LL, sample) && sample.data.acc_x == 11 && sample.timestamp_ns == t0 + 10500000LL,
+          "插值样本（10 与 11 之间取 10.5，四舍五入）");
+    check(!stream.sampleAt(t0 - 1, sample), "早于缓冲区范围返回false");
+    check(!stream.sampleAt(t0 + 2000 * 1000000LL, sample), "晚于最新样本返回false");
+    check(!stream.push(make_sample(t0, 0, 0)), "时间戳倒退的样本被丢弃");
+    check(stream.latest(sample) && sample.data.acc_x == 1999, "最新样本");
+}
+
+// 变角速度：与逐样本梯形积分对比
+static void test_varying_rate() {
+    ImuStream stream;
+    stream.setGyroScale(0.002);
+    double expected = 0;
+    int16_t last = 0;
+    for (int i = 0; i < 1000; ++i) {
+        int16_t gyro = (int16_t)(1000 * std::sin(i * 0.01));
+        if (i > 0) {
+            expected += 0.5 * (last + gyro) * 0.002 * 0.002;
+        }
+        last = gyro;
+        stream.push(make_sample(i * 2000000LL + 1, gyro, 0));     // 500Hz
+    }
+    double angle[3];
+    check(stream.integrateGyro(1, 999 * 2000000LL + 1, angle) && std::fabs(angle[2] - expected) < 1e-9,
+          "变角速度时与逐样本梯形积分一致");
+}
+
+// 环形缓冲区回绕后只能查询最近的数据
+static void test_wrap() {
+    ImuStream stream;
+    stream.reset(256);
+    for (int i = 0; i < 1000; ++i) {
+        stream.push(make_sample((i + 1) * 1000000LL, 0, 0));
+    }
+    imu_sample_t sample;
+    check(!stream.sampleAt(500 * 1000000LL, sample), "已被覆盖的时间返回false");
+    check(stream.sampleAt(900 * 1000000LL, sample), "最近的数据仍可查询");
+}
+
+// 写者与读者并发：读者永远不会拿到撕裂的样本
+static void test_concurrent() {
+    std::printf("\n== 并发读写 ==\n");
+    ImuStream stream;
+    stream.reset(1024);
+    std::atomic<bool> done(false);
+    std::atomic<int64_t> written_until(0);
+
+    std::thread writer([&]() {
+        for (int i = 1; i <= 300000; ++i) {
+            int16_t value = (int16_t)(i % 20000);
+            stream.push(make_sample(i * 1000LL, 0, value));
+            written_until.store(i * 1000LL, std::memory_order_release);
+        }
+        done = true;
+    });
+
+    uint64_t queries = 0, hits = 0;
+    bool consistent = true;
+    while (!done) {
+        int64_t newest = written_until.load(std::memory_order_acquire);
+        if (newest < 2000) {
+            continue;
+        }
+        imu_sample_t sample;
+        if (stream.sampleAt(newest - 500, sample)) {
+            hits++;
+            consistent = consistent && sample.data.acc_x == sample.data.acc_y && sample.data.acc_y == sample.data.acc_z;
+        }
+        queries++;
+    }
+    writer.join();
+    std::printf("查询 %llu 次，成功 %llu 次\n", (unsigned long long)queries, (unsigned long long)hits);
+    check(consistent, "并发查询得到的样本各字段一致");
+    check(hits > 0, "并发时可以查询到最近的数据");
+}
+
+static void bench_query() {
+    std::printf("\n== 查询耗时 ==\n");
+    ImuStream stream;
+    stream.reset(65536);
+    for (int i = 0; i < 65536; ++i) {
+        stream.push(make_sample((i + 1) * 1000000LL, 100, 0));
+    }
+    const int queries = 200000;
+    double sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < queries; ++i) {
+        double angle[3];
+        int64_t t = (int64_t)(10000 + (i * 7919) % 50000) * 1000000LL + 123;
+        stream.integrateGyro(t, t + 20000000LL, angle);
+        sum += angle[2];
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / queries;
+    std::printf("65536 个样本中 integrateGyro 平均 %.0f ns（checksum %.3f）\n", ns, sum);
+}
+
+int main() {
+    test_integration();
+    test_varying_rate();
+    test_wrap();
+    test_concurrent();
+    bench_query();
+    return test_report();
+}
@@ -0,0 +1,190 @@
+// IPS200 显示测试：显存由普通内存模拟（ips200_attach，每行带填充），检查后台缓冲与脏矩形刷新、
+// 字模缓存与逐点绘制的结果一致、裁剪不越界，并输出与原来逐点写显存的实现的耗时对比（只输出不断言）
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/ips200_fb_test.cpp src/zf_device_ips200_fb.cpp
+//               src/zf_common_font.cpp src/zf_common_function.cpp src/rgb565_scaler.cpp
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "zf_common_font.h"
+#include "zf_device_ips200_fb.h"
+#include "test_check.hpp"
+
+static const int WIDTH = 240;
+static const int HEIGHT = 320;
+static const int STRIDE = 256;                  // 显存每行像素数大于屏幕宽度
+static const uint16 GUARD = 0xA5A5;             // 行尾填充区的值，不应被改写
+
+static std::vector<uint16> g_screen(STRIDE * HEIGHT);
+
+static uint16 pixel(int x, int y) {
+    return g_screen[y * STRIDE + x];
+}
+
+static bool guard_intact() {
+    for (int y = 0; y < HEIGHT; ++y) {
+        for (int x = WIDTH; x < STRIDE; ++x) {
+            if (pixel(x, y) != GUARD) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 原实现：逐点写显存
+static void reference_point(uint16* screen, int x, int y, uint16 color) {
+    screen[y * STRIDE + x] = color;
+}
+
+static void reference_char(uint16* screen, int x, int y, char dat, uint16 pen, uint16 bg) {
+    for (int i = 0; i < 8; i++) {
+        uint8 temp_top = ascii_font_8x16[dat - 32][i];
+        uint8 temp_bottom = ascii_font_8x16[dat - 32][i + 8];
+        for (int j = 0; j < 8; j++) {
+            reference_point(screen, x + i, y + j, temp_top & 0x01 ? pen : bg);
+            temp_top >>= 1;
+        }
+        for (int j = 0; j < 8; j++) {
+            reference_point(screen, x + i, y + j + 8, temp_bottom & 0x01 ? pen : bg);
+            temp_bottom >>= 1;
+        }
+    }
+}
+
+static void test_full_and_dirty() {
+    std::printf("\n== 清屏与脏矩形 ==\n");
+    bool all_bg = true;
+    for (int y = 0; y < HEIGHT; ++y) {
+        for (int x = 0; x < WIDTH; ++x) {
+            all_bg = all_bg && pixel(x, y) == IPS200_DEFAULT_BGCOLOR;
+        }
+    }
+    check(all_bg && guard_intact(), "初始化后整屏为背景色，行尾填充不变");
+
+    ips200_full(RGB565_BLUE);
+    check(pixel(0, 0) == IPS200_DEFAULT_BGCOLOR, "刷新前显存不变");
+    ips200_update_screen();
+    check(pixel(0, 0) == RGB565_BLUE && pixel(WIDTH - 1, HEIGHT - 1) == RGB565_BLUE && guard_intact(),
+          "刷新后整屏填充，x/y 不越界");
+
+    g_screen[0] = RGB565_RED;                   // 脏矩形之外的像素刷新后应保持
+    ips200_draw_line(10, 20, 30, 25, RGB565_GREEN);
+    ips200_update_screen();
+    check(pixel(10, 20) == RGB565_GREEN && pixel(29, 24) == RGB565_GREEN && pixel(30, 24) == RGB565_BLUE
+          && pixel(10, 25) == RGB565_BLUE, "矩形填充");
+    check(g_screen[0] == RGB565_RED, "只刷新脏矩形");
+
+    g_screen[0] = RGB565_RED;
+    ips200_update_screen();
+    check(g_screen[0] == RGB565_RED, "没有改动时不写显存");
+}
+
+static void test_text() {
+    std::printf("\n== 字符 ==\n");
+    std::vector<uint16> expected(g_screen);
+    const char* text = "IP:192.168.1.10";
+    for (int i = 0; text[i] != '\0'; ++i) {
+        reference_char(expected.data(), 4 + 8 * i, 100, text[i], IPS200_DEFAULT_PENCOLOR, IPS200_DEFAULT_BGCOLOR);
+    }
+    ips200_show_string(4, 100, text);
+    ips200_update_screen();
+    check(g_screen == expected, "字模缓存与逐点绘制的结果一致");
+
+    ips200_set_color(RGB565_BLACK, RGB565_YELLOW);
+    reference_char(expected.data(), 200, 200, 'A', RGB565_BLACK, RGB565_YELLOW);
+    ips200_show_char(200, 200, 'A');
+    ips200_update_screen();
+    check(g_screen == expected, "改变颜色后重新展开字模");
+    ips200_set_color(IPS200_DEFAULT_PENCOLOR, IPS200_DEFAULT_BGCOLOR);
+
+    ips200_show_string(WIDTH - 12, HEIGHT - 8, "WW");
+    ips200_update_screen();
+    check(guard_intact(), "超出屏幕的字符被裁剪");
+}
+
+static void test_images() {
+    std::printf("\n== 图像 ==\n");
+    std::vector<uint8> gray(40 * 30);
+    for (size_t i = 0; i < gray.size(); ++i) {
+        gray[i] = (uint8)(i * 7);
+    }
+    ips200_show_gray_image(WIDTH - 20, 50, gray.data(), 40, 30);
+    ips200_update_screen();
+    uint8 g = gray[5 * 40 + 3];
+    uint16 expected = ((g >> 3) << 11) | ((g >> 2) << 5) | (g >> 3);
+    check(pixel(WIDTH - 17, 55) == expected && guard_intact(), "灰度图像转换为 RGB565 并裁剪到屏幕内");
+
+    std::vector<uint16> rgb(64 * 8, RGB565_CYAN);
+    ips200_show_rgb565_image(0, 300, rgb.data(), 48, 8, 64);
+    ips200_update_screen();
+    check(pixel(47, 307) == RGB565_CYAN && pixel(48, 307) != RGB565_CYAN, "RGB565 图像按行拷贝");
+}
+
+template <typename F>
+static double us_per_call(F f, int n) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        f(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / n;
+}
+
+static void test_timing() {
+    std::printf("\n== 耗时 ==\n");
+    std::vector<uint16> screen(STRIDE * HEIGHT);
+    std::vector<uint16> frame(240 * 180);
+    const int n = 200;
+
+    double old_full = us_per_call([&](int i) {
+        for (int x = 0; x < WIDTH; x++) {
+            for (int y = 0; y < HEIGHT; y++) {
+                reference_point(screen.data(), x, y, (uint16)i);
+            }
+        }
+    }, n);
+    double new_full = us_per_call([&](int i) {
+        ips200_full((uint16)i);
+        ips200_update_screen();
+    }, n);
+    std::printf("整屏刷新：逐点 %.1f μs，后台缓冲 %.1f μs\n", old_full, new_full);
+
+    double old_frame = us_per_call([&](int i) {
+        for (int y = 0; y < 180; y++) {
+            for (int x = 0; x < 240; x++) {
+                reference_point(screen.data(), x, y, frame[y * 240 + x] + (uint16)i);
+            }
+        }
+    }, n);
+    double new_frame = us_per_call([&](int) {
+        ips200_show_rgb565_image(0, 0, frame.data(), 240, 180, 240);
+        ips200_update_screen();
+    }, n);
+    std::printf("240x180 帧：逐点 %.1f μs，按行拷贝 %.1f μs\n", old_frame, new_frame);
+
+    const char* text = "speed 1.25 m/s";
+    double old_text = us_per_call([&](int) {
+        for (int i = 0; text[i] != '\0'; ++i) {
+            reference_char(screen.data(), 8 * i, 200, text[i], RGB565_RED, RGB565_WHITE);
+        }
+    }, n * 10);
+    double new_text = us_per_call([&](int) {
+        ips200_show_string(0, 200, text);
+        ips200_update_screen();
+    }, n * 10);
+    std::printf("14 个字符：逐点 %.2f μs，字模缓存 %.2f μs\n", old_text, new_text);
+    std::printf("加速：整屏刷新 %.1f 倍，帧 %.1f 倍，文字 %.1f 倍\n", old_full / new_full, old_frame / new_frame,
+                old_text / new_text);
+}
+
+int main() {
+    std::fill(g_screen.begin(), g_screen.end(), GUARD);
+    ips200_attach(g_screen.data(), WIDTH, HEIGHT, STRIDE);
+
+    test_full_and_dirty();
+    test_text();
+    test_images();
+    test_timing();
+    return test_report();
+}
@@ -0,0 +1,171 @@
+// 延迟直方图与调度器统计导出测试：分桶边界（含 0 与饱和）、已知分布的百分位数、
+// TaskScheduler::getStatsJson / getStatsCsv / dumpStatsCsv 的字段与数值
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/latency_histogram_test.cpp src/task_scheduler.cpp src/task_admission.cpp src/rt_thread.cpp -lpthread
+#include "latency_histogram.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "json.hpp"
+#include "task_scheduler.hpp"
+#include "test_check.hpp"
+
+using namespace robot;
+using namespace std::chrono;
+
+static void test_buckets() {
+    std::printf("\n== 分桶边界 ==\n");
+    typedef LatencyHistogram H;
+    check(H::bucketIndex(0) == 0 && H::bucketUpper(0) == 0, "0 落在第一个桶");
+    check(H::bucketIndex(H::SUB_BUCKETS - 1) == H::SUB_BUCKETS - 1 &&
+          H::bucketUpper(H::SUB_BUCKETS - 1) == (uint64_t)H::SUB_BUCKETS - 1, "小于 SUB_BUCKETS 的值每个值一个桶");
+    check(H::bucketIndex(16) == 16 && H::bucketIndex(17) == 17 && H::bucketUpper(16) == 16, "第一个量级仍为精确值");
+    check(H::bucketIndex(32) == 32 && H::bucketIndex(33) == 32 && H::bucketIndex(34) == 33 &&
+          H::bucketUpper(32) == 33, "第二个量级每桶 2 个值");
+    check(H::bucketIndex(H::MAX_VALUE) == H::BUCKET_COUNT - 1 && H::bucketUpper(H::BUCKET_COUNT - 1) == H::MAX_VALUE,
+          "最大值落在最后一个桶");
+
+    // 每个值都不超过所在桶的上界，且大于前一个桶的上界
+    bool bounded = true;
+    for (uint64_t v = 1; v < (1u << 20); v = v * 5 / 4 + 1) {
+        int i = H::bucketIndex(v);
+        bounded = bounded && v <= H::bucketUpper(i) && v > H::bucketUpper(i - 1);
+    }
+    check(bounded, "数值位于所在桶的上下界之间");
+
+    H histogram;
+    histogram.record(H::MAX_VALUE + 12345);
+    H::Snapshot s = histogram.snapshot();
+    check(s.count == 1 && s.buckets[H::BUCKET_COUNT - 1] == 1 && s.max == H::MAX_VALUE, "超出范围的值饱和到最后一个桶");
+}
+
+static void test_percentile() {
+    std::printf("\n== 百分位数 ==\n");
+    LatencyHistogram empty;
+    check(empty.snapshot().percentile(50) == 0 && empty.snapshot().mean() == 0, "无样本时为 0");
+
+    // 1..1000 均匀分布：百分位数的相对误差不超过 1/SUB_BUCKETS
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        histogram.record(v);
+    }
+    LatencyHistogram::Snapshot s = histogram.snapshot();
+    const double ps[4] = {10, 50, 90, 99};
+    bool accurate = true;
+    for (double p : ps) {
+        double expected = p * 10;
+        double got = (double)s.percentile(p);
+        std::printf("p%.0f = %.0f（精确值 %.0f）\n", p, got, expected);
+        accurate = accurate && got >= expected && got <= expected * (1 + 1.0 / LatencyHistogram::SUB_BUCKETS);
+    }
+    check(accurate, "均匀分布的百分位数误差在一个子桶内");
+    check(s.count == 1000 && s.max == 1000 && s.mean() == 500.5, "样本数、最大值与平均值");
+    check(s.percentile(100) == 1000 && s.percentile(0) == 1, "p0 为最小值所在桶，p100 为最大值");
+
+    // 双峰分布：99% 为 100，1% 为 10000
+    LatencyHistogram bimodal;
+    for (int i = 0; i < 990; ++i) {
+        bimodal.record(100);
+    }
+    for (int i = 0; i < 10; ++i) {
+        bimodal.record(10000);
+    }
+    s = bimodal.snapshot();
+    check(s.percentile(50) >= 100 && s.percentile(50) < 104 && s.percentile(99) < 104 && s.percentile(99.5) == 10000,
+          "双峰分布的 p99 与 p99.5");
+}
+
+static void busy_us(int us) {
+    auto end = steady_clock::now() + microseconds(us);
+    while (steady_clock::now() < end) {
+    }
+}
+
+static std::vector<std::string> split(const std::string& line) {
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, ',')) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+static void test_export() {
+    std::printf("\n== 统计导出 ==\n");
+    TaskScheduler scheduler(1);
+    scheduler.addTask("control", [] { busy_us(300); }, 100, Priority::CRITICAL, 1);
+    scheduler.addTask("display", [] { busy_us(1000); }, 20, Priority::LOW);
+    scheduler.start();
+    std::this_thread::sleep_for(milliseconds(1200));
+    scheduler.stop();
+
+    nlohmann::json tasks = nlohmann::json::parse(scheduler.getStatsJson(), nullptr, false);
+    check(tasks.is_array() && tasks.size() == 2, "JSON 为每个任务一项的数组");
+    bool fields = true;
+    const nlohmann::json* control = nullptr;
+    for (const auto& task : tasks) {
+        fields = fields && task.contains("name") && task.contains("total_executions") &&
+                 task.contains("exec_us") && task.contains("latency_us");
+        for (const char* key : {"mean", "p50", "p90", "p99", "max"}) {
+            fields = fields && task["exec_us"].contains(key) && task["latency_us"].contains(key);
+        }
+        if (task.value("name", "") == "control") {
+            control = &task;
+        }
+    }
+    check(fields, "JSON 包含执行时间与启动延迟的各分位数");
+    if (control) {
+        uint64_t p50 = (*control)["exec_us"]["p50"].get<uint64_t>();
+        uint64_t max = (*control)["exec_us"]["max"].get<uint64_t>();
+        std::printf("control：执行 %llu 次，p50 %lluus，最大 %lluus\n",
+                    (unsigned long long)(*control)["total_executions"].get<uint64_t>(), (unsigned long long)p50,
+                    (unsigned long long)max);
+        check((*control)["total_executions"].get<uint64_t>() > 50 && p50 >= 290 && p50 <= max,
+              "control 的执行次数与执行时间分位数");
+    } else {
+        check(false, "control 的执行次数与执行时间分位数");
+    }
+
+    const std::string path = "/tmp/latency_histogram_test.csv";
+    check(scheduler.dumpStatsCsv(path), "写入 CSV");
+    std::ifstream file(path);
+    std::string header, line;
+    std::getline(file, header);
+    std::vector<std::string> columns = split(header);
+    int rows = 0;
+    bool row_width = true;
+    bool control_row = false;
+    while (std::getline(file, line)) {
+        std::vector<std::string> row = split(line);
+        row_width = row_width && row.size() == columns.size();
+        if (!row.empty() && row[0] == "control") {
+            // exec_p50_us 列与 JSON 一致
+            for (size_t i = 0; i < columns.size() && i < row.size(); ++i) {
+                if (columns[i] == "exec_p50_us" && control) {
+                    control_row = std::stoull(row[i]) == (*control)["exec_us"]["p50"].get<uint64_t>();
+                }
+            }
+        }
+        ++rows;
+    }
+    check(columns.size() == 18 && columns[0] == "name" && columns.back() == "latency_max_us", "CSV 表头");
+    check(rows == 2 && row_width, "CSV 每个任务一行，列数与表头一致");
+    check(control_row, "CSV 与 JSON 的数值一致");
+    std::ifstream reread(path);
+    std::string content((std::istreambuf_iterator<char>(reread)), std::istreambuf_iterator<char>());
+    std::string csv = scheduler.getStatsCsv();
+    check(!csv.empty() && csv == content, "getStatsCsv 与写入文件的内容相同");
+    check(!scheduler.dumpStatsCsv("/nonexistent/dir/stats.csv"), "无法写入时返回 false");
+}
+
+int main() {
+    test_buckets();
+    test_percentile();
+    test_export();
+    return test_report();
+}
@@ -0,0 +1,279 @@
+// 多行前瞻离线测试：合成带噪声的中线序列，比较单行读数与加权拟合的误差和帧间跳动，
+// 写入日志后读回回放；也可以回放实车记录的中线：./a.out centerline_log.csv [forward]
+// CSV 每行 valid_top,valid_bottom,speed,c0,c1,...,c239（image_h 个中线值）
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/lookahead_test.cpp src/lookahead.cpp
+#include "lookahead.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "test_check.hpp"
+
+using namespace robot;
+
+static const int IMAGE_H = 240;
+static const int IMAGE_W = 320;
+static const int FORWARD = 100;
+
+struct Frame {
+    int valid_top = 0;
+    int valid_bottom = IMAGE_H;
+    float speed = 0;
+    uint16_t center[IMAGE_H] = {0};
+    double truth = 0;           // 前瞻行处无噪声的中线偏差（仅合成数据）
+};
+
+// 中线 x(row) = 160 + e + k1·(row - FORWARD) + k2·(row - FORWARD)²，每行叠加量化与边线抖动噪声
+static Frame make_frame(double e, double k1, double k2, double noise, std::mt19937& rng, int valid_top = 40) {
+    std::uniform_real_distribution<double> jitter(-noise, noise);
+    Frame frame;
+    frame.valid_top = valid_top;
+    frame.valid_bottom = IMAGE_H - 10;
+    for (int i = 0; i < IMAGE_H; ++i) {
+        double u = i - FORWARD;
+        double x = IMAGE_W / 2.0 + e + k1 * u + k2 * u * u + (noise > 0 ? jitter(rng) : 0);
+        frame.center[i] = (uint16_t)std::lround(std::fmin(std::fmax(x, 0), IMAGE_W - 1));
+    }
+    frame.truth = e;
+    return frame;
+}
+
+static LookaheadResult run(const Frame& frame, const LookaheadOptions& options, int forward = FORWARD) {
+    return computeLookahead(frame.center, IMAGE_H, IMAGE_W, frame.valid_top, frame.valid_bottom, forward,
+                            frame.speed, options);
+}
+
+static void test_straight() {
+    std::printf("\n== 直线中线 ==\n");
+    std::mt19937 rng(1);
+    LookaheadOptions options;
+    Frame frame = make_frame(30, -0.2, 0, 0, rng);
+    LookaheadResult r = run(frame, options);
+    double look = IMAGE_H - FORWARD;
+    double expected_steer = 2 * 30 / (look * look + 900) * look * look / 2;
+    std::printf("偏差 %.2f，斜率 %.3f，转向 %.2f（理论 %.2f），拟合 %d 行\n", r.offset, r.slope, r.steer,
+                expected_steer, r.rows_used);
+    check(r.valid && r.row == FORWARD && r.rows_used == 21, "以前瞻行为中心拟合整个窗口");
+    check(std::fabs(r.offset - 30) < 0.5 && std::fabs(r.slope + 0.2) < 0.02, "拟合偏差与斜率");
+    check(std::fabs(r.steer - expected_steer) < 0.5, "纯追踪转向：参考车速下约等于前瞻行偏差");
+
+    options.window = 0;
+    LookaheadResult single = run(frame, options);
+    check(single.rows_used == 1 && single.offset == 30, "窗口为0时退回单行读数");
+}
+
+static void test_curvature() {
+    std::printf("\n== 弯道曲率 ==\n");
+    std::mt19937 rng(2);
+    Frame frame = make_frame(-20, 0.3, 0.004, 0, rng);
+    LookaheadOptions options;
+    options.window = 40;
+    LookaheadResult quad = run(frame, options);
+    options.quadratic = false;
+    LookaheadResult line = run(frame, options);
+    std::printf("二次拟合 偏差 %.3f 曲率 %.5f；直线拟合 偏差 %.3f\n", quad.offset, quad.curvature, line.offset);
+    check(std::fabs(quad.curvature - 0.004) < 0.0005, "二次拟合得到曲率");
+    check(std::fabs(quad.offset + 20) < 0.5, "二次拟合在前瞻行无偏");
+    check(std::fabs(line.offset + 20) > std::fabs(quad.offset + 20), "直线拟合在弯道有偏差，二次拟合更准确");
+}
+
+static void test_speed_scaling() {
+    std::printf("\n== 前瞻随车速调整 ==\n");
+    std::mt19937 rng(3);
+    Frame frame = make_frame(10, 0, 0, 0, rng);
+    LookaheadOptions options;
+    options.speed_ref = 1.0f;
+    options.rows_per_mps = 20;
+    frame.speed = 1.0f;
+    int row_ref = run(frame, options).row;
+    frame.speed = 2.0f;
+    LookaheadResult fast = run(frame, options);
+    frame.speed = 0.5f;
+    LookaheadResult slow = run(frame, options);
+    std::printf("1.0 m/s 行 %d，2.0 m/s 行 %d（转向 %.2f），0.5 m/s 行 %d（转向 %.2f）\n", row_ref, fast.row,
+                fast.steer, slow.row, slow.steer);
+    check(row_ref == FORWARD && fast.row == FORWARD - 20 && slow.row == FORWARD + 10, "车速越高前瞻越远");
+    check(fast.steer < slow.steer, "同样的偏差，前瞻越远转向越小");
+
+    frame.speed = 10.0f;
+    LookaheadResult clipped = run(frame, options);
+    check(clipped.row == frame.valid_top + options.window / 2, "前瞻行不超出中线有效范围");
+}
+
+static void test_invalid() {
+    std::printf("\n== 边界情况 ==\n");
+    std::mt19937 rng(4);
+    Frame frame = make_frame(0, 0, 0, 0, rng);
+    LookaheadOptions options;
+    check(!computeLookahead(frame.center, IMAGE_H, IMAGE_W, 120, 120, FORWARD, 0, options).valid, "无有效行");
+    LookaheadResult r = computeLookahead(frame.center, IMAGE_H, IMAGE_W, 110, 113, FORWARD, 0, options);
+    check(r.valid && r.row == 112 && r.rows_used == 1, "有效行过少时退回单行");
+    r = computeLookahead(frame.center, IMAGE_H, IMAGE_W, 0, 105, FORWARD, 0, options);
+    check(r.valid && r.rows_used == 15, "窗口在有效行边界截断");
+}
+
+struct Metrics {
+    double rms = 0;
+    double jitter = 0;
+};
+
+static Metrics evaluate(const std::vector<Frame>& frames, const LookaheadOptions& options, bool has_truth) {
+    Metrics m;
+    double last = 0;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        LookaheadResult r = run(frames[i], options);
+        if (has_truth) {
+            m.rms += (r.offset - frames[i].truth) * (r.offset - frames[i].truth);
+        }
+        if (i > 0) {
+            m.jitter += std::fabs(r.offset - last);
+        }
+        last = r.offset;
+    }
+    m.rms = std::sqrt(m.rms / frames.size());
+    m.jitter /= frames.size() > 1 ? frames.size() - 1 : 1;
+    return m;
+}
+
+static std::vector<Frame> make_run(int count) {
+    std::mt19937 rng(5);
+    std::vector<Frame> frames;
+    for (int i = 0; i < count; ++i) {
+        double t = i / 60.0;
+        double e = 25 * std::sin(t * 1.3);
+        double k2 = 0.003 * std::sin(t * 0.7);
+        frames.push_back(make_frame(e, 0.1 * std::cos(t * 1.3), k2, 3.0, rng));
+        frames.back().speed = 1.5f;
+    }
+    return frames;
+}
+
+static bool write_csv(const std::string& path, const std::vector<Frame>& frames) {
+    FILE* fp = std::fopen(path.c_str(), "w");
+    if (!fp) {
+        return false;
+    }
+    for (const Frame& f : frames) {
+        std::fprintf(fp, "%d,%d,%.3f", f.valid_top, f.valid_bottom, f.speed);
+        for (int i = 0; i < IMAGE_H; ++i) {
+            std::fprintf(fp, ",%u", (unsigned)f.center[i]);
+        }
+        std::fprintf(fp, "\n");
+    }
+    std::fclose(fp);
+    return true;
+}
+
+static std::vector<Frame> read_csv(const std::string& path) {
+    std::vector<Frame> frames;
+    FILE* fp = std::fopen(path.c_str(), "r");
+    if (!fp) {
+        return frames;
+    }
+    Frame f;
+    while (std::fscanf(fp, "%d,%d,%f", &f.valid_top, &f.valid_bottom, &f.speed) == 3) {
+        bool ok = true;
+        for (int i = 0; i < IMAGE_H && ok; ++i) {
+            unsigned v;
+            ok = std::fscanf(fp, ",%u", &v) == 1;
+            f.center[i] = (uint16_t)v;
+        }
+        if (!ok) {
+            break;
+        }
+        frames.push_back(f);
+    }
+    std::fclose(fp);
+    return frames;
+}
+
+static void print_comparison(const std::vector<Frame>& frames, bool has_truth, Metrics* single_out,
+                             Metrics* fitted_out) {
+    LookaheadOptions single;
+    single.window = 0;
+    LookaheadOptions linear;
+    linear.quadratic = false;
+    LookaheadOptions quadratic;
+    Metrics a = evaluate(frames, single, has_truth);
+    Metrics b = evaluate(frames, linear, has_truth);
+    Metrics c = evaluate(frames, quadratic, has_truth);
+    std::printf("%-16s %10s %12s\n", "方法", "RMS误差", "帧间跳动");
+    std::printf("%-16s %10.2f %12.2f\n", "单行", a.rms, a.jitter);
+    std::printf("%-16s %10.2f %12.2f\n", "加权直线21行", b.rms, b.jitter);
+    std::printf("%-16s %10.2f %12.2f\n", "加权二次21行", c.rms, c.jitter);
+    if (single_out) {
+        *single_out = a;
+    }
+    if (fitted_out) {
+        *fitted_out = c;
+    }
+}
+
+static void test_recorded_run() {
+    std::printf("\n== 合成行驶记录回放 ==\n");
+    std::vector<Frame> frames = make_run(600);
+    const std::string path = "/tmp/lookahead_test.csv";
+    check(write_csv(path, frames), "写入日志");
+    std::vector<Frame> loaded = read_csv(path);
+    check(loaded.size() == frames.size(), "读回全部帧");
+    Metrics single, fitted;
+    print_comparison(frames, true, &single, &fitted);
+    check(fitted.rms < single.rms / 2, "加权拟合误差小于单行的一半");
+    check(fitted.jitter < single.jitter / 2, "加权拟合帧间跳动小于单行的一半");
+    check(evaluate(loaded, LookaheadOptions(), false).jitter == evaluate(frames, LookaheadOptions(), false).jitter,
+          "回放结果与直接处理一致");
+}
+
+static void bench() {
+    std::printf("\n== 单帧耗时 ==\n");
+    std::vector<Frame> frames = make_run(200);
+    LookaheadOptions options;
+    options.window = 40;
+    float sink = 0;
+    const int rounds = 50;
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < rounds; ++n) {
+        for (const Frame& f : frames) {
+            sink += run(f, options).steer;
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                (rounds * frames.size());
+    std::printf("41 行二次拟合 %.0f ns/帧（%.1f）\n", ns, sink);
+}
+
+static int replay_file(const char* path, int forward) {
+    std::vector<Frame> frames = read_csv(path);
+    if (frames.empty()) {
+        std::printf("无法读取日志 %s\n", path);
+        return 1;
+    }
+    std::printf("%zu 帧，前瞻行 %d\n", frames.size(), forward);
+    LookaheadOptions single;
+    single.window = 0;
+    LookaheadOptions fitted;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        LookaheadResult a = run(frames[i], single, forward);
+        LookaheadResult b = run(frames[i], fitted, forward);
+        std::printf("%6zu  单行 %7.1f  拟合 %7.1f  曲率 %9.5f  转向 %7.1f\n", i, a.offset, b.offset, b.curvature,
+                    b.steer);
+    }
+    print_comparison(frames, false, nullptr, nullptr);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        return replay_file(argv[1], argc > 2 ? std::atoi(argv[2]) : FORWARD);
+    }
+    test_straight();
+    test_curvature();
+    test_speed_scaling();
+    test_invalid();
+    test_recorded_run();
+    bench();
+    return test_report();
+}
@@ -6,14 +6,14 @@
 #include <string>
 #include <vector>
 
+#include "task_scheduler.hpp"
+
 namespace rate_control {
 
 using Clock = std::chrono::steady_clock;
 
-enum class MissPolicy : uint8_t {
-    CatchUp, // 追赶：next += period，可能连续执行几次（不sleep）追到当前
-    Skip     // 跳过：next = now + period，避免"补课"导致抖动/堆积
-};
+// 与 robot::TaskScheduler 共用同一套错过策略
+using MissPolicy = robot::MissPolicy;
 
 enum class OverrunAction : uint8_t {
     None,    // 不做特殊处理（继续执行）
@@ -78,12 +78,14 @@ struct Task {
     OverrunAction budget_action = OverrunAction::None;
     OverrunCallback overrun_cb;
 
-    // 运行时字段
-    Clock::time_point next;
+    // 统计（由执行器的统计快照刷新，见 Scheduler::tasks()）
     RateStats stats;
-    bool skip_next = false;
+    bool critical = false;   // 关键任务：不会被降频，其他任务会为它让路
 };
 
+// 单核协作式调度器
+// 基于 robot::TaskScheduler 的协作式模式（0 个工作线程），保留原有接口；
+// 错过策略、准入控制、让路与统计都由执行器统一实现
 class Scheduler {
 public:
     Scheduler();
@@ -99,13 +101,25 @@ public:
     Scheduler& operator=(Scheduler&&) = delete;
 
     // hz: 频率；name: 用于调试统计；priority: 优先级（高优先级优先执行）
-    void add_task(const std::string& name, double hz, std::function<void()> fn,
-                 MissPolicy policy = MissPolicy::CatchUp, int priority = 0);
-
-    // 为任务设置时间预算
-    void set_task_budget(const std::string& name, 
+    // budget: 时间预算，同时作为准入分析的执行时间估计
+    // 准入检查不通过（单核不可调度）时返回 false，任务不会被加入
+    bool add_task(const std::string& name, double hz, std::function<void()> fn,
+                 MissPolicy policy = MissPolicy::CatchUp, int priority = 0,
+                 std::chrono::nanoseconds budget = std::chrono::nanoseconds(0));
+
+    // 为任务设置时间预算；新预算使任务集合不可调度时返回 false（Reject）或降频其他任务（Degrade）
+    bool set_task_budget(const std::string& name, 
                         std::chrono::nanoseconds budget,
                         OverrunAction action = OverrunAction::Warn);
+
+    // 准入策略（默认 Reject），与 robot::TaskScheduler 共用同一套分析
+    void set_admission_policy(robot::AdmissionPolicy policy);
+
+    // 标记关键任务（如控制环）。其截止期有风险时，低优先级任务会被推迟
+    bool set_critical_task(const std::string& name);
+
+    // 按当前预算与实测执行时间做一次可调度性分析
+    robot::AdmissionResult check_admission() const;
     
     // 设置超时回调（仅当 OverrunAction::Callback 时才调用）
     void set_overrun_callback(const std::string& name, OverrunCallback cb);
@@ -126,23 +140,26 @@ public:
     // 清空统计
     void reset_stats();
 
-    const std::vector<Task>& tasks() const { return tasks_; }
+    // 任务列表（添加顺序），统计字段在调用时刷新
+    const std::vector<Task>& tasks() const;
+
+    // 底层执行器，可用于导出 JSON/CSV 统计或挂到 Web 面板
+    robot::TaskScheduler& executor();
 
 private:
-    std::vector<Task> tasks_;
+    mutable std::vector<Task> tasks_;
     OverrunCallback global_overrun_cb_;
     struct SchedulerImpl;
     std::unique_ptr<SchedulerImpl> pimpl_;
 
     // 内部方法：找到指定名称的任务
     Task* find_task(const std::string& name);
-    
-    
-    // 处理任务超时
-    void handle_overrun(Task& task, std::chrono::nanoseconds late);
-    
-    // 处理预算超时
-    void handle_budget_exceeded(Task& task, std::chrono::nanoseconds exec_time);
+
+    // 处理预算超时，返回是否跳过下一周期
+    bool handle_budget_exceeded(const std::string& name, std::chrono::nanoseconds over);
+
+    // 用执行器的统计快照刷新 tasks_ 中的统计与周期
+    void refresh_stats() const;
 };
 
 } // namespace rate_control
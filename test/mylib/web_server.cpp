@@ -10,20 +10,27 @@
 #include <fstream>
 #include <streambuf>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <mutex>
 #include "json.hpp"
 #include "zf_common_headfile.h"
-#include "zf_device_imu660ra.h"
-
-// 声明外部变量
-extern int encoder_left;
-extern int encoder_right;
+#include "task_scheduler.hpp"
+#include "frame_trace.hpp"
+#include "debug_stream.hpp"
+#include "telemetry_bus.hpp"
 
 #define BEEP "/dev/zf_driver_gpio_beep"
 
 
 // 全局变量定义
 std::atomic<bool> running(false);
-httplib::Server* g_server = nullptr;
+std::atomic<httplib::Server*> g_server{nullptr};
+
+// 停止请求与服务器指针的互斥：stop_web_server 持锁调用 stop()，start_web_server 持锁设置/清除指针，
+// 保证 stop() 不会落在已析构的服务器上
+static std::mutex g_server_mutex;
+static std::atomic<bool> g_server_stop{false};
 
 // 智能车控制状态变量
 static int power_value = 0;
@@ -31,6 +38,19 @@ static int steer_angle = 180;
 static bool car_stopped = false;
 static bool buzzer_state = false;
 
+// 调度器统计来源（由主程序注册，可为空）
+static std::atomic<robot::TaskScheduler*> g_scheduler{nullptr};
+
+// 遥测总线（由主程序注册，可为空）
+static std::atomic<robot::TelemetryBus*> g_telemetry{nullptr};
+
+// 调试视频流（由主程序注册，可为空）：合成图像 JPEG 与二值图游程编码
+static std::atomic<robot::StreamHub*> g_stream_video{nullptr};
+static std::atomic<robot::StreamHub*> g_stream_binary{nullptr};
+
+// 飞行记录文件路径（由主程序注册，可为空）
+static std::atomic<const char*> g_flight_path{nullptr};
+
 // 配置文件路径
 static const std::string CONFIG_DIR = "config/";
 
@@ -38,113 +58,131 @@ static const std::string CONFIG_DIR = "config/";
 void signal_handler(int signal) {
     cout << "\n收到终止信号 " << signal << ", 正在关闭服务器..." << endl;
     running = false;
-    if (g_server) {
-        g_server->stop();
+    g_server_stop = true;
+    httplib::Server* server = g_server.load();
+    if (server) {
+        server->stop();
+    }
+}
+
+// 停止web服务器（可在任意线程调用，阻塞到 start_web_server 的 listen 返回或确认不会再启动）
+// listen 开始前 stop() 不起作用，因此服务器未进入运行状态时等待并重试
+void stop_web_server() {
+    g_server_stop = true;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(g_server_mutex);
+            httplib::Server* server = g_server.load();
+            if (!server) {
+                return;
+            }
+            if (server->is_running()) {
+                server->stop();
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 }
 
 // SSE流处理函数
+// 每个连接持有自己的遥测游标和最新值，每10ms取一次新记录，IMU或编码器有新记录时发送一条消息
 void handle_sse_stream(const httplib::Request& req, httplib::Response& res) {
+    robot::TelemetryBus* bus = g_telemetry.load();
+    if (!bus) {
+        res.status = 503;
+        res.set_content("telemetry not attached", "text/plain");
+        return;
+    }
+
     // 设置SSE相关的HTTP头
-    res.set_header("Content-Type", "text/event-stream");
     res.set_header("Cache-Control", "no-cache");
     res.set_header("Connection", "keep-alive");
     res.set_header("Access-Control-Allow-Origin", "*");
-    
+
+    struct ClientState {
+        uint64_t cursor = 0;
+        int sent = 0;
+        robot::TelemetryImu imu = {};
+        robot::TelemetryEncoder encoder = {};
+    };
+    auto state = std::make_shared<ClientState>();
+    state->cursor = bus->head();
+
     // 设置块传输编码（支持持续流式响应）
-    res.set_chunked_content_provider("text/event-stream", 
-        [&](size_t offset, httplib::DataSink& sink) {
-            // 上一次的传感器数据值，用于检测变化
-            static int16 last_imu660ra_acc_x = 0;
-            static int16 last_imu660ra_acc_y = 0;
-            static int16 last_imu660ra_acc_z = 0;
-            static int16 last_imu660ra_gyro_x = 0;
-            static int16 last_imu660ra_gyro_y = 0;
-            static int16 last_imu660ra_gyro_z = 0;
-            static int last_encoder_left = 0;
-            static int last_encoder_right = 0;
-            
-            // 数据发送计数器
-            int data_sent_count = 0;
-            
-            while (running) {
-                // 检查传感器数据是否发生变化
-                bool data_changed = false;
-                
-                if (imu660ra_acc_x != last_imu660ra_acc_x ||
-                    imu660ra_acc_y != last_imu660ra_acc_y ||
-                    imu660ra_acc_z != last_imu660ra_acc_z ||
-                    imu660ra_gyro_x != last_imu660ra_gyro_x ||
-                    imu660ra_gyro_y != last_imu660ra_gyro_y ||
-                    imu660ra_gyro_z != last_imu660ra_gyro_z ||
-                    encoder_left != last_encoder_left ||
-                    encoder_right != last_encoder_right) {
-                    
-                    data_changed = true;
-                    
-                    // 更新上一次的值
-                    last_imu660ra_acc_x = imu660ra_acc_x;
-                    last_imu660ra_acc_y = imu660ra_acc_y;
-                    last_imu660ra_acc_z = imu660ra_acc_z;
-                    last_imu660ra_gyro_x = imu660ra_gyro_x;
-                    last_imu660ra_gyro_y = imu660ra_gyro_y;
-                    last_imu660ra_gyro_z = imu660ra_gyro_z;
-                    last_encoder_left = encoder_left;
-                    last_encoder_right = encoder_right;
-                }
-                
-                // 如果数据发生变化，发送SSE消息
-                if (data_changed) {
-                    data_sent_count++;
-                    
-                    // 构建SSE格式的消息
-                    stringstream ss;
-                    
-                    // 事件类型
-                    ss << "event: sensor-data\n";
-                    
-                    // 数据行 - 包含所有传感器数据
-                    ss << "data: {"
-                       << "\"imu660ra_acc_x\": " << imu660ra_acc_x
-                       << ", \"imu660ra_acc_y\": " << imu660ra_acc_y
-                       << ", \"imu660ra_acc_z\": " << imu660ra_acc_z
-                       << ", \"imu660ra_gyro_x\": " << imu660ra_gyro_x
-                       << ", \"imu660ra_gyro_y\": " << imu660ra_gyro_y
-                       << ", \"imu660ra_gyro_z\": " << imu660ra_gyro_z
-                       << ", \"encoder_left\": " << encoder_left
-                       << ", \"encoder_right\": " << encoder_right
-                       << ", \"timestamp\": " << time(nullptr)
-                       << ", \"sequence\": " << data_sent_count
-                       << "}\n";
-                    
-                    // 空行表示消息结束
-                    ss << "\n";
-                    
-                    string message = ss.str();
-                    
-                    // 发送数据块
-                    if (!sink.write(message.c_str(), message.size())) {
-                        cout << "客户端断开连接" << endl;
-                        break;
-                    }
-                    
-                    // 调试输出
-                    if (data_sent_count % 10 == 0) {
-                        cout << "已发送 " << data_sent_count << " 条传感器数据" << endl;
+    res.set_chunked_content_provider("text/event-stream",
+        [bus, state](size_t offset, httplib::DataSink& sink) {
+            if (!running) {
+                // 发送结束消息
+                string end_msg = "event: end\ndata: {\"status\": \"finished\", \"total_sent\": " +
+                                 std::to_string(state->sent) + "}\n\n";
+                sink.write(end_msg.c_str(), end_msg.size());
+                sink.done();
+                cout << "SSE流结束，总共发送 " << state->sent << " 条数据" << endl;
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+            robot::TelemetryRecord records[64];
+            bool changed = false;
+            size_t count;
+            while ((count = bus->read(&state->cursor, records, 64)) > 0) {
+                for (size_t i = 0; i < count; ++i) {
+                    if (records[i].type == (uint16_t)robot::TelemetryType::Imu) {
+                        changed = records[i].get(state->imu) || changed;
+                    } else if (records[i].type == (uint16_t)robot::TelemetryType::Encoder) {
+                        changed = records[i].get(state->encoder) || changed;
                     }
                 }
-                
-                // 等待10ms后再次检查数据变化
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
             }
-            
-            // 发送结束消息
-            string end_msg = "event: end\ndata: {\"status\": \"finished\", \"total_sent\": " + std::to_string(data_sent_count) + "}\n\n";
-            sink.write(end_msg.c_str(), end_msg.size());
-            sink.done();
-            
-            cout << "SSE流结束，总共发送 " << data_sent_count << " 条数据" << endl;
-            
+            if (!changed) {
+                return true;
+            }
+
+            state->sent++;
+            char message[512];
+            int length = snprintf(message, sizeof(message),
+                "event: sensor-data\n"
+                "data: {\"imu660ra_acc_x\": %d, \"imu660ra_acc_y\": %d, \"imu660ra_acc_z\": %d, "
+                "\"imu660ra_gyro_x\": %d, \"imu660ra_gyro_y\": %d, \"imu660ra_gyro_z\": %d, "
+                "\"encoder_left\": %d, \"encoder_right\": %d, \"timestamp\": %lld, \"sequence\": %d}\n\n",
+                state->imu.acc[0], state->imu.acc[1], state->imu.acc[2],
+                state->imu.gyro[0], state->imu.gyro[1], state->imu.gyro[2],
+                state->encoder.left, state->encoder.right, (long long)time(nullptr), state->sent);
+            if (!sink.write(message, length)) {
+                cout << "客户端断开连接" << endl;
+                return false;
+            }
+            return true;
+        }
+    );
+}
+
+// 遥测二进制流：每20ms发送一批64字节记录（小端，布局见 telemetry_bus.hpp），每个连接从连接时刻开始读
+// 连接读得慢时最旧的记录被覆盖，客户端按记录序号的间隔统计丢失
+void handle_telemetry_stream(const httplib::Request& req, httplib::Response& res) {
+    robot::TelemetryBus* bus = g_telemetry.load();
+    if (!bus) {
+        res.status = 503;
+        res.set_content("telemetry not attached", "text/plain");
+        return;
+    }
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("Access-Control-Allow-Origin", "*");
+    auto cursor = std::make_shared<uint64_t>(bus->head());
+    res.set_chunked_content_provider("application/octet-stream",
+        [bus, cursor](size_t offset, httplib::DataSink& sink) {
+            if (!running) {
+                sink.done();
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            robot::TelemetryRecord records[128];
+            size_t count;
+            while ((count = bus->read(cursor.get(), records, 128)) > 0) {
+                if (!sink.write((const char*)records, count * sizeof(robot::TelemetryRecord))) {
+                    return false;
+                }
+            }
             return true;
         }
     );
@@ -495,10 +533,141 @@ void handle_upload_config(const httplib::Request& req, httplib::Response& res) {
     }
 }
 
+// 注册调度器，用于统计接口
+void web_server_attach_scheduler(robot::TaskScheduler* scheduler) {
+    g_scheduler.store(scheduler);
+}
+
+// 调度器统计（JSON）
+void handle_scheduler_stats(const httplib::Request& req, httplib::Response& res) {
+    robot::TaskScheduler* scheduler = g_scheduler.load();
+    if (!scheduler) {
+        res.status = 503;
+        res.set_content("{\"error\": \"scheduler not attached\"}", "application/json");
+        return;
+    }
+    res.set_header("Cache-Control", "no-cache");
+    res.set_content(scheduler->getStatsJson(), "application/json");
+}
+
+// 调度器统计（CSV下载）
+void handle_scheduler_stats_csv(const httplib::Request& req, httplib::Response& res) {
+    robot::TaskScheduler* scheduler = g_scheduler.load();
+    if (!scheduler) {
+        res.status = 503;
+        res.set_content("scheduler not attached", "text/plain");
+        return;
+    }
+    res.set_header("Content-Disposition", "attachment; filename=scheduler_stats.csv");
+    res.set_content(scheduler->getStatsCsv(), "text/csv");
+}
+
+// 逐帧追踪（Chrome trace JSON 下载，可用 chrome://tracing 或 ui.perfetto.dev 打开）
+void handle_trace_download(const httplib::Request& req, httplib::Response& res) {
+    res.set_header("Content-Disposition", "attachment; filename=robot_trace.json");
+    res.set_content(robot::FrameTracer::instance().chromeTraceJson(), "application/json");
+}
+
+// 采集到PWM写入的端到端延迟（微秒）
+void handle_trace_latency(const httplib::Request& req, httplib::Response& res) {
+    auto snapshot = robot::FrameTracer::instance().glassToActuatorSnapshot();
+    nlohmann::json json_data;
+    json_data["count"] = snapshot.count;
+    json_data["mean_us"] = snapshot.mean();
+    json_data["p50_us"] = snapshot.percentile(50);
+    json_data["p99_us"] = snapshot.percentile(99);
+    json_data["max_us"] = snapshot.max;
+    res.set_header("Cache-Control", "no-cache");
+    res.set_content(json_data.dump(), "application/json");
+}
+
+// 注册遥测总线
+void web_server_attach_telemetry(robot::TelemetryBus* bus) {
+    g_telemetry.store(bus);
+}
+
+// 注册调试视频流
+void web_server_attach_stream(robot::StreamHub* video, robot::StreamHub* binary) {
+    g_stream_video.store(video);
+    g_stream_binary.store(binary);
+}
+
+// 注册飞行记录文件
+void web_server_attach_flight(const char* path) {
+    g_flight_path.store(path);
+}
+
+// 飞行记录下载（?prev=1 下载上一次运行的记录）
+// 记录文件固定大小，按块读取发送，不整份读入内存；记录过程中下载时最旧的一段可能已被新记录覆盖，
+// FlightLogReader 从之后的第一条完整记录读起
+void handle_flight_download(const httplib::Request& req, httplib::Response& res) {
+    const char* path = g_flight_path.load();
+    if (!path) {
+        res.status = 503;
+        res.set_content("flight recorder not attached", "text/plain");
+        return;
+    }
+    std::string file = std::string(path) + (req.has_param("prev") ? ".prev" : "");
+    FILE* fp = fopen(file.c_str(), "rb");
+    struct stat st;
+    if (!fp || fstat(fileno(fp), &st) != 0) {
+        if (fp) {
+            fclose(fp);
+        }
+        res.status = 404;
+        res.set_content("flight log not found", "text/plain");
+        return;
+    }
+    std::shared_ptr<FILE> handle(fp, fclose);
+    res.set_header("Content-Disposition", req.has_param("prev") ? "attachment; filename=flight.prev.rbl"
+                                                                : "attachment; filename=flight.rbl");
+    res.set_content_provider((size_t)st.st_size, "application/octet-stream",
+        [handle](size_t offset, size_t length, httplib::DataSink& sink) {
+            char buffer[64 * 1024];
+            ssize_t n = pread(fileno(handle.get()), buffer, std::min(length, sizeof(buffer)), (off_t)offset);
+            return n > 0 && sink.write(buffer, (size_t)n);
+        });
+}
+
+// 调试视频流（multipart/x-mixed-replace，每部分一帧）
+// 每个连接发送完一帧才取下一帧，编码线程只在有连接等待时编码，网络慢时帧率随之降低
+static void handle_debug_stream(robot::StreamHub* hub, const httplib::Request& req, httplib::Response& res) {
+    if (!hub) {
+        res.status = 503;
+        res.set_content("stream not attached", "text/plain");
+        return;
+    }
+    hub->connect();
+    auto last_seq = std::make_shared<uint64_t>(0);
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("Access-Control-Allow-Origin", "*");
+    res.set_chunked_content_provider("multipart/x-mixed-replace; boundary=frame",
+        [hub, last_seq](size_t offset, httplib::DataSink& sink) {
+            auto packet = hub->wait(*last_seq, std::chrono::milliseconds(1000));
+            if (!running || hub->isClosed()) {
+                sink.done();
+                return true;
+            }
+            if (!packet) {
+                return true;    // 暂时没有新帧（例如视觉流水线停顿），继续等待
+            }
+            string header = "--frame\r\nContent-Type: " + string(hub->contentType()) +
+                            "\r\nContent-Length: " + std::to_string(packet->data.size()) + "\r\n\r\n";
+            if (!sink.write(header.data(), header.size()) ||
+                !sink.write(packet->data.data(), packet->data.size()) || !sink.write("\r\n", 2)) {
+                return false;   // 客户端断开
+            }
+            *last_seq = packet->seq;
+            return true;
+        },
+        [hub](bool success) { hub->disconnect(); });
+}
+
 // 设置路由
 void setup_routes(httplib::Server& svr) {
     svr.Get("/", handle_root);
     svr.Get("/events", handle_sse_stream);
+    svr.Get("/api/telemetry", handle_telemetry_stream);
     
     // 智能车控制API
     svr.Post("/api/power", handle_power_control);
@@ -515,6 +684,31 @@ void setup_routes(httplib::Server& svr) {
     });
     svr.Post("/api/reload-config", handle_reload_config);
     svr.Post("/api/upload-config", handle_upload_config);
+
+    // 调度器统计API
+    svr.Get("/api/scheduler/stats", handle_scheduler_stats);
+    svr.Get("/api/scheduler/stats.csv", handle_scheduler_stats_csv);
+    svr.Post("/api/scheduler/reset", [](const httplib::Request& req, httplib::Response& res) {
+        robot::TaskScheduler* scheduler = g_scheduler.load();
+        if (scheduler) {
+            scheduler->resetStats();
+        }
+        res.set_content(scheduler ? "{\"status\": \"ok\"}" : "{\"error\": \"scheduler not attached\"}",
+                        "application/json");
+    });
+
+    // 逐帧追踪API
+    svr.Get("/api/trace", handle_trace_download);
+    svr.Get("/api/trace/latency", handle_trace_latency);
+    svr.Get("/api/flight", handle_flight_download);
+
+    // 调试视频流
+    svr.Get("/stream/video", [](const httplib::Request& req, httplib::Response& res) {
+        handle_debug_stream(g_stream_video.load(), req, res);
+    });
+    svr.Get("/stream/binary", [](const httplib::Request& req, httplib::Response& res) {
+        handle_debug_stream(g_stream_binary.load(), req, res);
+    });
     
     // 停止服务器的接口
     svr.Get("/stop", [&](const httplib::Request& req, httplib::Response& res) {
@@ -537,15 +731,23 @@ void print_server_info() {
 }
 
 // 启动web服务器
-int start_web_server() {
+int start_web_server(bool install_signal_handlers) {
     httplib::Server svr;
     
-    // 设置全局服务器指针用于信号处理
-    g_server = &svr;
+    // 设置全局服务器指针用于停止；已请求停止时不再启动
+    {
+        std::lock_guard<std::mutex> lock(g_server_mutex);
+        if (g_server_stop) {
+            return 0;
+        }
+        g_server = &svr;
+    }
     
-    // 注册信号处理器
-    signal(SIGINT, signal_handler);
-    signal(SIGTERM, signal_handler);
+    // 注册信号处理器（由调用者负责退出流程时不注册，以免覆盖调用者的 SIGINT 处理）
+    if (install_signal_handlers) {
+        signal(SIGINT, signal_handler);
+        signal(SIGTERM, signal_handler);
+    }
     
     // 设置日志处理
     svr.set_logger([](const httplib::Request& req, const httplib::Response& res) {
@@ -562,14 +764,17 @@ int start_web_server() {
     running = true;
     
     // 启动服务器
-    if (!svr.listen("0.0.0.0", 8080)) {
+    bool ok = svr.listen("0.0.0.0", 8080);
+    
+    // svr 即将析构，持锁清除全局指针（等待进行中的 stop_web_server 调用结束）
+    {
+        std::lock_guard<std::mutex> lock(g_server_mutex);
+        g_server = nullptr;
+    }
+    running = false;
+    if (!ok) {
         cerr << "启动服务器失败" << endl;
-        // 服务器启动失败，设置running为false
-        running = false;
         return 1;
     }
-    
-    // 服务器正常停止后，设置running为false
-    running = false;
     return 0;
 }
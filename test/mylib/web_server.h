@@ -28,18 +28,26 @@ using std::uniform_int_distribution;
 using std::time;
 using std::signal;
 
+namespace robot { class TaskScheduler; class StreamHub; class TelemetryBus; }
+
 // 全局变量声明
 extern std::atomic<bool> running;
-extern httplib::Server* g_server;
+extern std::atomic<httplib::Server*> g_server;
 
 // 函数声明
 void signal_handler(int signal);
 void handle_sse_stream(const httplib::Request& req, httplib::Response& res);
+void handle_telemetry_stream(const httplib::Request& req, httplib::Response& res);
 std::string read_file(const std::string& filename);
 void handle_root(const httplib::Request& req, httplib::Response& res);
 void setup_routes(httplib::Server& svr);
 void setup_static_file_handlers(httplib::Server& svr);
 void print_server_info();
-int start_web_server();
+int start_web_server(bool install_signal_handlers = true);
+void stop_web_server();
+void web_server_attach_scheduler(robot::TaskScheduler* scheduler);
+void web_server_attach_telemetry(robot::TelemetryBus* bus);
+void web_server_attach_stream(robot::StreamHub* video, robot::StreamHub* binary);
+void web_server_attach_flight(const char* path);
 
 #endif // WEB_SERVER_H
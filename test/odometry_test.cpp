@@ -0,0 +1,172 @@
+// 编码器里程计测试：按已知轮速生成量化后的脉冲增量，检查速度估计、距离、差速角速度与按时间戳查询
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/odometry_test.cpp src/odometry.cpp -lpthread
+#include "odometry.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include "test_check.hpp"
+
+using namespace robot;
+
+static const int64_t PERIOD_NS = 10000000;     // 100Hz，与控制任务相同
+
+// 按连续的轮速（脉冲/秒）生成整数增量，模拟编码器读后清零的量化
+class WheelSim {
+public:
+    int step(double cps, double dt) {
+        position_ += cps * dt;
+        int64_t now = (int64_t)std::floor(position_);
+        int delta = (int)(now - reported_);
+        reported_ = now;
+        return delta;
+    }
+
+private:
+    double position_ = 0;
+    int64_t reported_ = 0;
+};
+
+static void test_constant_speed() {
+    std::printf("\n== 恒速与量化噪声 ==\n");
+    Odometry odometry;
+    WheelSim left, right;
+    int64_t t = 1000000000LL;
+    double max_raw_error = 0, max_filtered_error = 0;
+    const double cps = 4730;        // 每周期 47.3 个脉冲，单周期读数在 47 和 48 之间跳动
+    for (int i = 0; i < 500; ++i) {
+        int l = left.step(cps, 0.01), r = right.step(cps, 0.01);
+        odometry.update(t, l, r);
+        t += PERIOD_NS;
+        if (i >= 100) {
+            OdometryState state;
+            odometry.state(state);
+            max_raw_error = std::fmax(max_raw_error, std::fabs(l * 100.0 - cps));
+            max_filtered_error = std::fmax(max_filtered_error, std::fabs(state.left_cps - cps));
+        }
+    }
+    std::printf("单周期脉冲数换算速度最大误差 %.1f cps，滤波后 %.1f cps\n", max_raw_error, max_filtered_error);
+    check(max_filtered_error < max_raw_error / 2, "滤波后量化误差小于单周期读数的一半");
+    check(max_filtered_error < cps * 0.01, "稳态速度误差小于 1%");
+
+    OdometryState state;
+    odometry.state(state);
+    double expected_m = 500 * 47.3 * OdometryOptions().meters_per_count;
+    check(std::fabs(state.distance - expected_m) < 2 * OdometryOptions().meters_per_count, "行驶距离等于累计脉冲换算");
+    check(std::fabs(state.yaw_rate) < 0.01 && std::fabs(state.heading) < 1e-9, "两轮同速时角速度为0");
+}
+
+static void test_step_response() {
+    std::printf("\n== 速度阶跃 ==\n");
+    Odometry odometry;
+    WheelSim left, right;
+    int64_t t = 0;
+    for (int i = 0; i < 100; ++i) {
+        odometry.update(t += PERIOD_NS, left.step(2000, 0.01), right.step(2000, 0.01));
+    }
+    int settle = -1;
+    for (int i = 0; i < 100; ++i) {
+        odometry.update(t += PERIOD_NS, left.step(4000, 0.01), right.step(4000, 0.01));
+        OdometryState state;
+        odometry.state(state);
+        if (settle < 0 && std::fabs(state.left_cps - 4000) < 40) {
+            settle = i + 1;
+        }
+    }
+    std::printf("2000 → 4000 cps 阶跃，%d 个周期进入 1%% 误差带\n", settle);
+    check(settle > 0 && settle <= 20, "阶跃后 20 个周期（200ms）内收敛");
+}
+
+static void test_differential() {
+    std::printf("\n== 差速转向 ==\n");
+    OdometryOptions options;
+    Odometry odometry(options);
+    WheelSim left, right;
+    int64_t t = 0;
+    // 左轮 0.8 m/s，右轮 1.2 m/s，左转
+    double l_cps = 0.8 / options.meters_per_count, r_cps = 1.2 / options.meters_per_count;
+    for (int i = 0; i < 200; ++i) {
+        odometry.update(t += PERIOD_NS, left.step(l_cps, 0.01), right.step(r_cps, 0.01));
+    }
+    OdometryState state;
+    odometry.state(state);
+    double expected_rate = (1.2 - 0.8) / options.track_width_m;
+    std::printf("速度 %.3f m/s，角速度 %.3f rad/s（理论 %.3f），2s 航向 %.3f rad\n", state.speed, state.yaw_rate,
+                expected_rate, state.heading);
+    check(std::fabs(state.speed - 1.0) < 0.01, "车体速度为两轮平均");
+    check(std::fabs(state.yaw_rate - expected_rate) < 0.02, "差速角速度");
+    check(std::fabs(state.heading - expected_rate * 1.99) < 0.01, "差速航向积分");
+}
+
+static void test_distance_at() {
+    std::printf("\n== 按时间戳查询距离 ==\n");
+    OdometryOptions options;
+    options.meters_per_count = 0.001;
+    options.history = 64;
+    Odometry odometry(options);
+    for (int i = 1; i <= 200; ++i) {
+        odometry.update(i * PERIOD_NS, 10, 10);        // 每周期 1cm
+    }
+    double meters = 0;
+    check(odometry.distanceAt(190 * PERIOD_NS + PERIOD_NS / 2, meters) && std::fabs(meters - 1.905) < 1e-9,
+          "两次采样之间线性插值");
+    check(odometry.distanceAt(200 * PERIOD_NS, meters) && std::fabs(meters - 2.0) < 1e-9, "最新采样时刻");
+    check(!odometry.distanceAt(100 * PERIOD_NS, meters), "超出历史范围返回false");
+    check(!odometry.distanceAt(201 * PERIOD_NS, meters), "晚于最新采样返回false");
+    check(!odometry.update(200 * PERIOD_NS, 1, 1), "时间戳不递增的采样被丢弃");
+}
+
+static void test_gap() {
+    std::printf("\n== 采样中断 ==\n");
+    Odometry odometry;
+    WheelSim left, right;
+    int64_t t = 0;
+    for (int i = 0; i < 101; ++i) {
+        odometry.update(t += PERIOD_NS, left.step(3000, 0.01), right.step(3000, 0.01));
+    }
+    // 采样停顿 500ms（调度被阻塞），期间的脉冲在下一次读取中一次给出
+    t += 500000000LL;
+    odometry.update(t, left.step(3000, 0.5), right.step(3000, 0.5));
+    OdometryState state;
+    odometry.state(state);
+    std::printf("中断后速度 %.0f cps\n", state.left_cps);
+    check(std::fabs(state.left_cps - 3000) < 30, "中断后按整段增量重新初始化速度，没有尖峰");
+    check(state.left_count == 3000 * 151 / 100, "中断期间的脉冲全部计入距离");
+}
+
+static void test_concurrent() {
+    std::printf("\n== 并发读取 ==\n");
+    OdometryOptions options;
+    options.meters_per_count = 0.001;
+    Odometry odometry(options);
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (int i = 1; i <= 200000; ++i) {
+            odometry.update(i * 1000LL, 1, 3);
+        }
+        done = true;
+    });
+    bool consistent = true;
+    uint64_t reads = 0;
+    while (!done) {
+        OdometryState state;
+        if (odometry.state(state)) {
+            consistent = consistent && state.right_count == 3 * state.left_count &&
+                         state.left_count == (int64_t)state.samples;
+            reads++;
+        }
+    }
+    writer.join();
+    std::printf("读取 %llu 次\n", (unsigned long long)reads);
+    check(consistent, "快照各字段来自同一次采样");
+}
+
+int main() {
+    test_constant_speed();
+    test_step_response();
+    test_differential();
+    test_distance_at();
+    test_gap();
+    test_concurrent();
+    return test_report();
+}
@@ -0,0 +1,356 @@
+// 离线回放：在桌面上把录像、图片目录或飞行记录按帧顺序送入与车上相同的寻线决策流程
+// imgPreProc → TrackProcess（imgSearch_l_r → TrackKind_Judge 与补线 → ServoDirAngle_Judge / MotorSpeed_Judge），
+// 不需要摄像头、IMU、编码器和执行器；关闭 Img_Track 绘制，不按帧率等待，尽快处理完所有帧。
+// 逐帧决策结果写入 CSV，结束时打印各阶段耗时分位数；指定 --golden 时与基准 CSV 逐行比较，
+// 不一致时打印前几处差异并返回 1，修改算法或参数后用同一段录像做回归检查。
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/replay.cpp src/track_process.cpp src/libimage_process.cpp
+//               src/libdata_process.cpp src/path_side_search.cpp src/path_circle.cpp src/path_across.cpp
+//               src/mycross.cpp src/Perspective.cpp src/lookahead.cpp src/frame_trace.cpp src/flight_recorder.cpp
+//               src/binary_rle.cpp src/telemetry_bus.cpp src/rt_thread.cpp $(pkg-config --cflags --libs opencv4) -lpthread
+// 用法：./replay [--config config/config_0.json] [--csv out.csv] [--golden golden.csv] [--draw] [--limit N] <输入>
+//   输入为视频文件、图片目录（按文件名排序）或 .rbl 飞行记录。飞行记录使用记录的补线前二值图（跳过 imgPreProc），
+//   行驶距离与车速取记录值；陀螺仪出环判断没有记录，回放中始终为未触发，因此圆环出环处可能与车上不同。
+//   赛道状态机的状态跨帧延续（含 TrackKind_Judge 内的静态变量），每次运行只回放一个输入。
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <strings.h>
+#include <vector>
+#include "common_system.h"
+#include "common_program.h"
+#include "flight_recorder.hpp"
+#include "frame_trace.hpp"
+#include "latency_histogram.hpp"
+
+using namespace std;
+using namespace cv;
+
+// 与 main.cpp 相同的全局状态（静态存储，初值为 0）
+static JSON_PIDConfigData  JSON_PIDConfigData_c;
+static Function_EN         Function_EN_c;
+static Data_Path           Data_Path_c;
+static Img_Store           Img_Store_c;
+static ImgProcess          imgProcess;
+
+struct ReplayOptions {
+    string config = "config/config_0.json";
+    string input;
+    string csv;
+    string golden;
+    bool draw = false;
+    long limit = -1;
+};
+
+/*
+    阶段耗时：FrameTracer 区间按名称累计到直方图（单线程，名称为静态字符串）
+*/
+struct StageTiming {
+    const char* name = nullptr;
+    robot::LatencyHistogram histogram;
+};
+
+static const int MAX_STAGES = 8;
+static StageTiming g_stages[MAX_STAGES];
+
+static void record_stage(const char* name, int64_t duration_ns)
+{
+    for (int i = 0; i < MAX_STAGES; ++i) {
+        if (g_stages[i].name == nullptr) {
+            g_stages[i].name = name;
+        }
+        if (g_stages[i].name == name || strcmp(g_stages[i].name, name) == 0) {
+            g_stages[i].histogram.record((uint64_t)(duration_ns / 1000));
+            return;
+        }
+    }
+}
+
+static void on_span(const robot::TraceSpan& span)
+{
+    record_stage(span.name, span.end_ns - span.start_ns);
+}
+
+static void print_stages(long frames, double seconds)
+{
+    printf("\n%-22s %8s %8s %8s %8s %8s\n", "阶段", "帧数", "平均", "p50", "p99", "最大");
+    for (int i = 0; i < MAX_STAGES && g_stages[i].name; ++i) {
+        robot::LatencyHistogram::Snapshot s = g_stages[i].histogram.snapshot();
+        printf("%-20s %8llu %6.0fus %6lluus %6lluus %6lluus\n", g_stages[i].name, (unsigned long long)s.count, s.mean(),
+               (unsigned long long)s.percentile(50), (unsigned long long)s.percentile(99), (unsigned long long)s.max);
+    }
+    printf("共 %ld 帧，用时 %.2f s，%.0f 帧/秒\n", frames, seconds, seconds > 0 ? frames / seconds : 0.0);
+}
+
+/*
+    一帧的决策结果，格式即 CSV 的一行
+*/
+static string result_line(uint64_t frame_id)
+{
+    char line[160];
+    snprintf(line, sizeof(line), "%llu,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d", (unsigned long long)frame_id,
+             (int)Data_Path_c.Track_Kind, (int)Data_Path_c.Circle_Track_Step, Data_Path_c.ServoDir,
+             Data_Path_c.ServoAngle, Data_Path_c.MotorSpeed, (int)Data_Path_c.hightest,
+             Data_Path_c.InflectionPointNum[0], Data_Path_c.InflectionPointNum[1],
+             Data_Path_c.BendPointNum[0], Data_Path_c.BendPointNum[1]);
+    return line;
+}
+
+static const char* CSV_HEADER = "frame,track_kind,circle_step,servo_dir,servo_angle,motor_speed,hightest,"
+                                "inflection_l,inflection_r,bend_l,bend_r";
+
+/*
+    回放状态：输出与统计
+*/
+struct Replay {
+    FILE* csv = nullptr;
+    vector<string> lines;
+    long frames = 0;
+    long recorded = 0;          ///< 飞行记录中带决策结果的帧
+    long recorded_diff = 0;     ///< 与车上记录的决策不同的帧
+};
+
+static void process_binary(Replay* replay, uint64_t frame_id)
+{
+    Img_Store* Img_Store_p = &Img_Store_c;
+    {
+        FRAME_TRACE_SCOPE(frame_id, "track");
+        TrackProcess(Img_Store_p, &Data_Path_c, &Function_EN_c, frame_id);
+    }
+    string line = result_line(frame_id);
+    if (replay->csv) {
+        fprintf(replay->csv, "%s\n", line.c_str());
+    }
+    replay->lines.push_back(line);
+    ++replay->frames;
+}
+
+/*
+    彩色图像：与车上预处理阶段相同，尺寸不符时缩放到摄像头分辨率
+*/
+static void process_color(Replay* replay, const Mat& color, uint64_t frame_id)
+{
+    Img_Store* Img_Store_p = &Img_Store_c;
+    if (color.cols != CAMERA_W || color.rows != CAMERA_H) {
+        resize(color, Img_Store_p->Img_Color, Size(CAMERA_W, CAMERA_H), 0, 0, INTER_AREA);
+    } else {
+        color.copyTo(Img_Store_p->Img_Color);
+    }
+    {
+        FRAME_TRACE_SCOPE(frame_id, "imgPreProc");
+        imgProcess.imgPreProc(Img_Store_p, &Data_Path_c, &Function_EN_c);
+    }
+    process_binary(replay, frame_id);
+}
+
+static bool has_suffix(const string& s, const char* suffix)
+{
+    size_t n = strlen(suffix);
+    return s.size() >= n && strcasecmp(s.c_str() + s.size() - n, suffix) == 0;
+}
+
+static bool replay_flight_log(Replay* replay, const ReplayOptions& options)
+{
+    robot::FlightLogReader reader;
+    if (!reader.open(options.input)) {
+        fprintf(stderr, "无法打开飞行记录 %s\n", options.input.c_str());
+        return false;
+    }
+    robot::FlightRecordView record;
+    robot::FlightFrameInfo info;
+    robot::FlightPath path;
+    vector<uint8_t> pixels;
+    vector<uint16_t> borders;
+    bool has_frame = false;
+    Img_Store_c.Img_OTSU = Mat(CAMERA_H, CAMERA_W, CV_8UC1, Scalar(0));
+
+    // 每帧依次写入二值图、（灰度图、）决策结果，收到决策结果时处理该帧
+    while (reader.next(&record) && replay->frames != options.limit) {
+        if (record.header.type == (uint16_t)robot::FlightRecordType::BinaryFrame) {
+            has_frame = robot::FlightLogReader::parseFrame(record, &info, &pixels) &&
+                        info.width == image_w && info.height == image_h;
+            continue;
+        }
+        if (record.header.type != (uint16_t)robot::FlightRecordType::Path || !has_frame ||
+            !robot::FlightLogReader::parsePath(record, &path, &borders) || path.frame_id != info.frame_id) {
+            continue;
+        }
+        has_frame = false;
+        for (int row = 0; row < image_h; ++row) {
+            memcpy(Img_Store_c.Img_OTSU.ptr<uint8_t>(row), &pixels[(size_t)row * image_w], image_w);
+        }
+        if (options.draw) {
+            cvtColor(Img_Store_c.Img_OTSU, Img_Store_c.Img_Track, COLOR_GRAY2BGR);
+        }
+        Data_Path_c.Distance = path.distance;
+        Data_Path_c.Speed = path.speed;
+        process_binary(replay, path.frame_id);
+
+        ++replay->recorded;
+        if ((int)Data_Path_c.Track_Kind != path.track_kind || (int)Data_Path_c.Circle_Track_Step != path.circle_step ||
+            Data_Path_c.ServoDir != path.servo_dir || Data_Path_c.ServoAngle != path.servo_angle ||
+            Data_Path_c.MotorSpeed != path.motor_speed) {
+            ++replay->recorded_diff;
+        }
+    }
+    if (reader.recovered() > 0) {
+        printf("飞行记录头部未及时更新，多读到 %llu 条记录\n", (unsigned long long)reader.recovered());
+    }
+    return true;
+}
+
+static bool replay_images(Replay* replay, const ReplayOptions& options)
+{
+    vector<String> files;
+    glob(options.input, files, false);
+    sort(files.begin(), files.end());
+    for (const String& file : files) {
+        if (replay->frames == options.limit) {
+            break;
+        }
+        if (!has_suffix(file, ".jpg") && !has_suffix(file, ".jpeg") && !has_suffix(file, ".png") &&
+            !has_suffix(file, ".bmp")) {
+            continue;
+        }
+        Mat color = imread(file, IMREAD_COLOR);
+        if (color.empty()) {
+            fprintf(stderr, "跳过无法读取的图片 %s\n", file.c_str());
+            continue;
+        }
+        process_color(replay, color, replay->frames);
+    }
+    return true;
+}
+
+static bool replay_video(Replay* replay, const ReplayOptions& options)
+{
+    VideoCapture video(options.input);
+    if (!video.isOpened()) {
+        fprintf(stderr, "无法打开视频 %s\n", options.input.c_str());
+        return false;
+    }
+    Mat color;
+    while (replay->frames != options.limit && video.read(color) && !color.empty()) {
+        process_color(replay, color, replay->frames);
+    }
+    return true;
+}
+
+/*
+    与基准结果逐行比较，打印前几处差异
+*/
+static int compare_golden(const Replay& replay, const string& golden_path)
+{
+    ifstream golden(golden_path);
+    if (!golden.is_open()) {
+        fprintf(stderr, "无法打开基准结果 %s\n", golden_path.c_str());
+        return -1;
+    }
+    string line;
+    getline(golden, line);      // 表头
+    vector<string> expected;
+    while (getline(golden, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            expected.push_back(line);
+        }
+    }
+
+    int diffs = 0;
+    size_t n = max(expected.size(), replay.lines.size());
+    for (size_t i = 0; i < n; ++i) {
+        const string* want = i < expected.size() ? &expected[i] : nullptr;
+        const string* got = i < replay.lines.size() ? &replay.lines[i] : nullptr;
+        if (want && got && *want == *got) {
+            continue;
+        }
+        if (++diffs <= 10) {
+            printf("第 %zu 行不同\n  基准：%s\n  回放：%s\n", i + 1, want ? want->c_str() : "(无)",
+                   got ? got->c_str() : "(无)");
+        }
+    }
+    printf("与基准比较：%zu / %zu 行，%d 行不同\n", replay.lines.size(), expected.size(), diffs);
+    return diffs;
+}
+
+static bool parse_args(int argc, char** argv, ReplayOptions* options)
+{
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--config" && has_value) {
+            options->config = argv[++i];
+        } else if (arg == "--csv" && has_value) {
+            options->csv = argv[++i];
+        } else if (arg == "--golden" && has_value) {
+            options->golden = argv[++i];
+        } else if (arg == "--limit" && has_value) {
+            options->limit = atol(argv[++i]);
+        } else if (arg == "--draw") {
+            options->draw = true;
+        } else if (arg[0] != '-' && options->input.empty()) {
+            options->input = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options->input.empty();
+}
+
+int main(int argc, char** argv)
+{
+    ReplayOptions options;
+    if (!parse_args(argc, argv, &options)) {
+        fprintf(stderr, "用法：%s [--config 参数文件] [--csv 输出] [--golden 基准] [--draw] [--limit 帧数] "
+                        "<视频 | 图片目录 | .rbl>\n", argv[0]);
+        return 2;
+    }
+
+    SYNC sync;
+    if (!sync.ConfigData_Load(options.config.c_str(), &Data_Path_c, &Function_EN_c, &JSON_PIDConfigData_c)) {
+        return 2;
+    }
+    Function_EN_c.Loop_Kind_EN = CAMERA_CATCH_LOOP;
+    Function_EN_c.Gyroscope_EN = false;
+    Img_Store_c.Draw_EN = options.draw;
+
+    Replay replay;
+    if (!options.csv.empty()) {
+        replay.csv = fopen(options.csv.c_str(), "w");
+        if (!replay.csv) {
+            fprintf(stderr, "无法写入 %s\n", options.csv.c_str());
+            return 2;
+        }
+        fprintf(replay.csv, "%s\n", CSV_HEADER);
+    }
+
+    robot::FrameTracer::instance().setSpanListener(on_span);
+    int64_t start_ns = robot::FrameTracer::nowNs();
+    bool ok;
+    struct stat st;
+    if (has_suffix(options.input, ".rbl") || has_suffix(options.input, ".rbl.prev")) {
+        ok = replay_flight_log(&replay, options);
+    } else if (stat(options.input.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        ok = replay_images(&replay, options);
+    } else {
+        ok = replay_video(&replay, options);
+    }
+    double seconds = (robot::FrameTracer::nowNs() - start_ns) / 1e9;
+    robot::FrameTracer::instance().setSpanListener(nullptr);
+    if (replay.csv) {
+        fclose(replay.csv);
+    }
+    if (!ok) {
+        return 2;
+    }
+
+    print_stages(replay.frames, seconds);
+    if (replay.recorded > 0) {
+        printf("与车上记录的决策不同的帧：%ld / %ld\n", replay.recorded_diff, replay.recorded);
+    }
+    if (!options.golden.empty()) {
+        return compare_golden(replay, options.golden) == 0 ? 0 : 1;
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+// RGB565 缩放转换测试：向量路径与逐像素参考实现逐像素比较（BGR / 灰度 / 二值，320x240→240x180、等尺寸、
+// 非周期比例），并输出 320x240→240x180 每帧的耗时（原实现为先缩放到临时图像再逐像素转换；耗时只输出不断言）
+// 编译（主机）：g++ -std=c++17 -O2 -mssse3 -Iinclude test/rgb565_scaler_test.cpp src/rgb565_scaler.cpp
+//               去掉 -mssse3 时只有逐像素路径
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "rgb565_scaler.hpp"
+#include "test_check.hpp"
+
+using namespace robot;
+
+static uint16_t reference_pixel(const uint8_t* p, PixelFormat format) {
+    switch (format) {
+        case PixelFormat::Bgr:
+            return (uint16_t)(((p[2] >> 3) << 11) | ((p[1] >> 2) << 5) | (p[0] >> 3));
+        case PixelFormat::Gray:
+            return (uint16_t)(((p[0] >> 3) << 11) | ((p[0] >> 2) << 5) | (p[0] >> 3));
+        case PixelFormat::Binary:
+            return p[0] ? 0xFFFF : 0x0000;
+    }
+    return 0;
+}
+
+static std::vector<uint8_t> make_image(int width, int height, int channels, int stride, bool binary) {
+    std::vector<uint8_t> image((size_t)stride * height);
+    for (auto& v : image) {
+        v = (uint8_t)std::rand();
+        if (binary) {
+            v = v & 1 ? 255 : 0;
+        }
+    }
+    (void)width;
+    (void)channels;
+    return image;
+}
+
+static bool compare(int sw, int sh, int dw, int dh, PixelFormat format, bool* vectorized) {
+    int channels = format == PixelFormat::Bgr ? 3 : 1;
+    int src_stride = sw * channels + 8;                 // 行尾带填充
+    int dst_stride = dw + 5;
+    std::vector<uint8_t> src = make_image(sw, sh, channels, src_stride, format == PixelFormat::Binary);
+    std::vector<uint16_t> dst((size_t)dst_stride * dh, 0x1234);
+
+    Rgb565Scaler scaler;
+    scaler.configure(sw, sh, dw, dh, format);
+    scaler.convert(src.data(), src_stride, dst.data(), dst_stride);
+    *vectorized = scaler.vectorized();
+
+    for (int y = 0; y < dh; ++y) {
+        int sy = y * sh / dh;
+        for (int x = 0; x < dw; ++x) {
+            int sx = x * sw / dw;
+            if (dst[(size_t)y * dst_stride + x] != reference_pixel(&src[(size_t)sy * src_stride + sx * channels], format)) {
+                std::printf("  mismatch at (%d, %d)\n", x, y);
+                return false;
+            }
+        }
+        for (int x = dw; x < dst_stride; ++x) {
+            if (dst[(size_t)y * dst_stride + x] != 0x1234) {
+                std::printf("  row %d overrun at %d\n", y, x);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void test_correctness() {
+    std::printf("\n== 与逐像素参考实现比较 ==\n");
+    struct Case {
+        int sw, sh, dw, dh;
+        PixelFormat format;
+        const char* name;
+    } cases[] = {
+        {320, 240, 240, 180, PixelFormat::Bgr, "BGR 320x240→240x180"},
+        {320, 240, 240, 180, PixelFormat::Gray, "灰度 320x240→240x180"},
+        {320, 240, 240, 180, PixelFormat::Binary, "二值 320x240→240x180"},
+        {240, 180, 240, 180, PixelFormat::Bgr, "BGR 等尺寸"},
+        {100, 30, 100, 30, PixelFormat::Gray, "灰度等尺寸（ips200_show_gray_image）"},
+        {640, 480, 240, 180, PixelFormat::Bgr, "BGR 640x480→240x180"},
+        {333, 250, 240, 180, PixelFormat::Bgr, "BGR 非周期比例"},
+        {20, 10, 15, 7, PixelFormat::Gray, "窄图像"},
+    };
+    for (const Case& c : cases) {
+        bool vectorized = false;
+        bool ok = compare(c.sw, c.sh, c.dw, c.dh, c.format, &vectorized);
+        char label[96];
+        std::snprintf(label, sizeof(label), "%s（%s）", c.name, vectorized ? "向量" : "逐像素");
+        check(ok, label);
+    }
+}
+
+template <typename F>
+static double us_per_frame(F f, int n) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        f();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / n;
+}
+
+static void test_timing() {
+    std::printf("\n== 320x240→240x180 每帧耗时 ==\n");
+    const int sw = 320, sh = 240, dw = 240, dh = 180, n = 500;
+    std::vector<uint8_t> bgr = make_image(sw, sh, 3, sw * 3, false);
+    std::vector<uint8_t> gray = make_image(sw, sh, 1, sw, false);
+    std::vector<uint8_t> resized(dw * dh * 3);
+    std::vector<uint16_t> screen(dw * dh);
+    volatile uint16_t sink = 0;
+
+    // 原实现：先缩放到临时图像，再逐像素转换写入
+    double two_pass = us_per_frame([&]() {
+        for (int y = 0; y < dh; ++y) {
+            const uint8_t* row = &bgr[(size_t)(y * sh / dh) * sw * 3];
+            for (int x = 0; x < dw; ++x) {
+                const uint8_t* p = row + (x * sw / dw) * 3;
+                uint8_t* q = &resized[(y * dw + x) * 3];
+                q[0] = p[0]; q[1] = p[1]; q[2] = p[2];
+            }
+        }
+        for (int y = 0; y < dh; ++y) {
+            for (int x = 0; x < dw; ++x) {
+                const uint8_t* p = &resized[(y * dw + x) * 3];
+                screen[y * dw + x] = (uint16_t)(((p[2] >> 3) << 11) | ((p[1] >> 2) << 5) | (p[0] >> 3));
+            }
+        }
+        sink = screen[dw * dh / 2];
+    }, n);
+
+    Rgb565Scaler bgr_scaler, gray_scaler;
+    bgr_scaler.configure(sw, sh, dw, dh, PixelFormat::Bgr);
+    gray_scaler.configure(sw, sh, dw, dh, PixelFormat::Gray);
+    double fused_bgr = us_per_frame([&]() {
+        bgr_scaler.convert(bgr.data(), sw * 3, screen.data(), dw);
+        sink = screen[dw * dh / 2];
+    }, n);
+    double fused_gray = us_per_frame([&]() {
+        gray_scaler.convert(gray.data(), sw, screen.data(), dw);
+        sink = screen[dw * dh / 2];
+    }, n);
+    (void)sink;
+    std::printf("BGR 两遍：%.1f μs，一遍%s：%.1f μs；灰度一遍：%.1f μs\n", two_pass,
+                bgr_scaler.vectorized() ? "（向量）" : "（逐像素）", fused_bgr, fused_gray);
+    std::printf("合并后为两遍的 %.0f%%\n", fused_bgr / two_pass * 100);
+}
+
+int main() {
+    std::srand(42);
+    test_correctness();
+    test_timing();
+    return test_report();
+}
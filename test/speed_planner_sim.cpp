@@ -0,0 +1,233 @@
+// 速度规划回放仿真：按曲率分段的赛道生成俯视图中线，比较原查表速度（直道/弯道两档阶跃）与曲率限速规划
+// 的圈速、侧向加速度和超出抓地力的累计量（循迹误差的代理指标）
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/speed_planner_sim.cpp src/speed_planner.cpp src/lookahead.cpp
+#include "speed_planner.hpp"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "test_check.hpp"
+
+using namespace robot;
+
+static const int IMAGE_H = 240;
+static const int IMAGE_W = 320;
+static const float MPP = 0.005f;            // 俯视图 5mm/像素
+static const double NEAR_M = 0.10;          // 视野近端
+static const double FAR_M = 1.00;           // 视野远端
+static const double DT = 0.01;              // 控制周期 100Hz
+static const int FRAME_DIV = 2;             // 每 2 个控制周期一帧（50fps）
+static const double MOTOR_TAU = 0.08;       // 速度环等效一阶时间常数
+static const double GRIP = 3.5;             // 轮胎可提供的侧向加速度（m/s²）
+
+struct Segment {
+    double length;
+    double curvature;
+};
+
+class Track {
+public:
+    explicit Track(const std::vector<Segment>& segments) : segments_(segments) {
+        for (const Segment& s : segments_) {
+            length_ += s.length;
+        }
+    }
+
+    double length() const { return length_; }
+
+    double curvature(double s) const {
+        for (const Segment& seg : segments_) {
+            if (s < seg.length) {
+                return seg.curvature;
+            }
+            s -= seg.length;
+        }
+        return 0;
+    }
+
+    // 以车辆位置 s 处的切线为 y 轴，生成前方中线（俯视图像素）；中线离开视野（转过 90° 或出图像左右边界）处
+    // 作为最高有效行，与寻线得到的 hightest 对应
+    void centerline(double s, uint16_t* center, int& valid_top, int& valid_bottom) const {
+        double heading = 0, x = 0, y = 0;
+        const double ds = 0.002;
+        int far_row = IMAGE_H - (int)(FAR_M / MPP);
+        int row = IMAGE_H - 1;
+        for (int i = 0; i < IMAGE_H; ++i) {
+            center[i] = IMAGE_W / 2;
+        }
+        for (double d = 0; d < 3 * FAR_M && row >= far_row && std::fabs(heading) < M_PI / 2; d += ds) {
+            heading += curvature(s + d) * ds;
+            x += std::sin(heading) * ds;
+            y += std::cos(heading) * ds;
+            double px = IMAGE_W / 2.0 + x / MPP;
+            if (px < 0 || px > IMAGE_W - 1) {
+                break;
+            }
+            while (row >= far_row && (IMAGE_H - row) * MPP <= y) {
+                center[row] = (uint16_t)std::lround(px);
+                --row;
+            }
+        }
+        valid_top = row + 1;
+        valid_bottom = IMAGE_H - (int)(NEAR_M / MPP);
+    }
+
+private:
+    std::vector<Segment> segments_;
+    double length_ = 0;
+};
+
+struct LapResult {
+    double time = 0;
+    double max_lateral = 0;
+    double slip = 0;            // ∫ max(0, v²κ - GRIP) dt
+    double max_target_rate = 0; // 速度目标的最大变化率（m/s²）
+};
+
+// 原方案：看到弯道（估计曲率超过阈值）时切换到弯道速度，否则直道速度
+struct LookupSpeed {
+    float straight;
+    float bend;
+    float threshold;
+};
+
+static LapResult drive(const Track& track, const LookupSpeed* lookup, SpeedPlanner* planner, float cap) {
+    LapResult result;
+    double s = 0, v = 0, target = 0, limit = 0;
+    uint16_t center[IMAGE_H];
+    int top = 0, bottom = 0;
+    int step = 0;
+    if (planner) {
+        planner->reset();
+    }
+    while (s < track.length() && result.time < 60) {
+        if (step % FRAME_DIV == 0) {
+            track.centerline(s, center, top, bottom);
+            CurvatureEstimate estimate = estimateCurvature(center, IMAGE_H, IMAGE_W, top, bottom, MPP);
+            if (planner) {
+                limit = planner->limit(cap, estimate);
+            } else {
+                bool bend = false;
+                for (int i = 0; i < estimate.count; ++i) {
+                    bend = bend || std::fabs(estimate.curvature[i]) > lookup->threshold;
+                }
+                limit = bend ? lookup->bend : lookup->straight;
+            }
+        }
+        double previous = target;
+        target = planner ? planner->step((float)limit, (float)DT) : limit;
+        if (step > 0) {
+            result.max_target_rate = std::fmax(result.max_target_rate, std::fabs(target - previous) / DT);
+        }
+        v += (target - v) * DT / MOTOR_TAU;
+        double lateral = v * v * std::fabs(track.curvature(s));
+        result.max_lateral = std::fmax(result.max_lateral, lateral);
+        result.slip += std::fmax(0.0, lateral - GRIP) * DT;
+        s += v * DT;
+        result.time += DT;
+        step++;
+    }
+    return result;
+}
+
+static Track make_track() {
+    return Track({
+        {3.0, 0}, {1.26, 1.25}, {2.0, 0}, {1.57, 2.0}, {2.0, 0},
+        {1.0, 1.5}, {1.0, -1.5}, {1.5, 0}, {0.94, -1.0}, {2.5, 0},
+    });
+}
+
+static void test_curvature_estimate() {
+    std::printf("\n== 曲率估计 ==\n");
+    uint16_t center[IMAGE_H];
+    int top = 0, bottom = 0;
+    for (double kappa : {0.0, 1.0, 2.0, -1.5}) {
+        Track track({{5.0, kappa}});
+        track.centerline(0, center, top, bottom);
+        CurvatureEstimate e = estimateCurvature(center, IMAGE_H, IMAGE_W, top, bottom, MPP);
+        bool ok = e.count == 2;
+        std::printf("κ = %5.2f 1/m，估计", kappa);
+        for (int i = 0; i < e.count; ++i) {
+            std::printf(" %6.3f（%.2f m）", e.curvature[i], e.distance[i]);
+            ok = ok && std::fabs(e.curvature[i] - kappa) < 0.1 + 0.1 * std::fabs(kappa);
+        }
+        std::printf("\n");
+        check(ok, "圆弧曲率估计（近、远两段）");
+    }
+
+    // 直道末端：远段先看到弯道
+    Track track({{0.6, 0}, {3.0, 1.5}});
+    track.centerline(0, center, top, bottom);
+    CurvatureEstimate e = estimateCurvature(center, IMAGE_H, IMAGE_W, top, bottom, MPP);
+    std::printf("0.6 m 后进入 κ = 1.5 的弯道：近段 %.3f，远段 %.3f\n", e.curvature[0], e.curvature[1]);
+    check(e.count == 2 && std::fabs(e.curvature[0]) < 0.3 && e.curvature[1] > 0.6, "远段先看到弯道");
+    {
+    }
+}
+
+static void test_limit_and_ramp() {
+    std::printf("\n== 限速与斜率 ==\n");
+    SpeedPlannerOptions options;
+    SpeedPlanner planner(options);
+    CurvatureEstimate curve;
+    curve.count = 1;
+    curve.curvature[0] = 2.0f;
+    curve.distance[0] = 0;
+    float v_curve = std::sqrt(options.max_lateral_accel / 2.0f);
+    check(std::fabs(planner.limit(3.0f, curve) - v_curve) < 1e-4f, "弯道内限速 sqrt(a/κ)");
+    curve.distance[0] = 0.5f;
+    float early = planner.limit(3.0f, curve);
+    check(early > v_curve && std::fabs(early * early - v_curve * v_curve - 2 * options.max_decel * 0.5f) < 1e-3f,
+          "弯道在前方时按减速度提前限速");
+    check(planner.limit(1.0f, curve) == 1.0f, "预设速度作为上限");
+    check(planner.limit(3.0f, CurvatureEstimate()) == 3.0f, "无曲率估计时只受预设上限约束");
+
+    planner.reset();
+    float v = 0;
+    int steps = 0;
+    while (v < 2.0f && steps < 1000) {
+        v = planner.step(2.0f, 0.01f);
+        steps++;
+    }
+    std::printf("0 → 2 m/s 用时 %.2f s\n", steps * 0.01);
+    check(std::abs(steps - 100) <= 1, "加速按 max_accel 斜率");
+    steps = 0;
+    while (v > 0 && steps < 1000) {
+        v = planner.step(0, 0.01f);
+        steps++;
+    }
+    check(std::abs(steps - 50) <= 1, "减速按 max_decel 斜率");
+}
+
+static void test_lap() {
+    std::printf("\n== 圈速仿真 ==\n");
+    Track track = make_track();
+    const float top_speed = 3.0f;
+    LookupSpeed fast = {top_speed, 1.6f, 0.6f};
+    LookupSpeed safe = {top_speed, 1.2f, 0.6f};
+    SpeedPlanner planner;
+
+    LapResult a = drive(track, &fast, nullptr, 0);
+    LapResult b = drive(track, &safe, nullptr, 0);
+    LapResult c = drive(track, nullptr, &planner, top_speed);
+    std::printf("赛道 %.2f m，抓地力 %.1f m/s²\n", track.length(), GRIP);
+    std::printf("%-20s %8s %12s %12s %14s\n", "方案", "圈速s", "最大侧向", "超出抓地力", "目标变化率");
+    std::printf("%-20s %8.2f %12.2f %12.3f %14.1f\n", "查表 弯道1.6m/s", a.time, a.max_lateral, a.slip,
+                a.max_target_rate);
+    std::printf("%-20s %8.2f %12.2f %12.3f %14.1f\n", "查表 弯道1.2m/s", b.time, b.max_lateral, b.slip,
+                b.max_target_rate);
+    std::printf("%-20s %8.2f %12.2f %12.3f %14.1f\n", "曲率规划", c.time, c.max_lateral, c.slip, c.max_target_rate);
+
+    const SpeedPlannerOptions& options = planner.options();
+    check(c.max_target_rate <= std::fmax(options.max_accel, options.max_decel) + 0.01, "速度目标连续，变化率受斜率限制");
+    check(c.slip < a.slip, "规划的超出抓地力累计量小于同档位查表");
+    // 入弯时电机滞后、出弯时摄像头先看到直道（车身仍在弯内），规划仍会短时超出抓地力，但远小于查表
+    check(c.max_lateral < b.max_lateral * 0.6, "规划的最大侧向加速度明显低于查表");
+    check(c.time < b.time, "规划圈速快于弯道降到 1.2m/s 的查表");
+}
+
+int main() {
+    test_curvature_estimate();
+    test_limit_and_ramp();
+    test_lap();
+    return test_report();
+}
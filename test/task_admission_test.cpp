@@ -0,0 +1,149 @@
+// 准入控制与关键任务保护测试
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/task_admission_test.cpp src/task_scheduler.cpp src/task_admission.cpp src/rt_thread.cpp -lpthread
+#include "task_scheduler.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include "test_check.hpp"
+
+using namespace robot;
+using namespace std::chrono;
+
+// 忙等模拟计算负载（sleep 会让出CPU，测不出阻塞）
+static void busy_us(int us) {
+    auto end = steady_clock::now() + microseconds(us);
+    while (steady_clock::now() < end) {
+    }
+}
+
+static AdmissionTask make_task(const char* name, double hz, double wcet_us, Priority prio) {
+    AdmissionTask task;
+    task.name = name;
+    task.period_us = 1e6 / hz;
+    task.wcet_us = wcet_us;
+    task.priority = static_cast<int>(prio);
+    task.degradable = static_cast<int>(prio) >= static_cast<int>(Priority::MEDIUM);
+    task.critical = prio == Priority::CRITICAL;
+    task.sheddable = task.degradable;
+    return task;
+}
+
+// 纯分析部分
+static void test_analysis() {
+    std::printf("\n== 可调度性分析 ==\n");
+
+    // 单核：控制 200Hz/0.8ms + 显示 30Hz/2ms + 网页 10Hz/3ms
+    std::vector<AdmissionTask> ok = {
+        make_task("control", 200, 800, Priority::CRITICAL),
+        make_task("display", 30, 2000, Priority::MEDIUM),
+        make_task("web", 10, 3000, Priority::LOW),
+    };
+    auto r = analyzeSchedulability(ok, 1);
+    std::printf("U=%.3f control R=%.0fus\n", r.utilization, r.response_us[0]);
+    check(r.schedulable, "单核轻载任务集合可调度");
+
+    // 单核：HIGH 任务 100Hz，后台推理 30ms 非抢占阻塞 -> 不可调度
+    std::vector<AdmissionTask> blocked = ok;
+    blocked.push_back(make_task("imu", 100, 300, Priority::HIGH));
+    blocked.push_back(make_task("inference", 10, 30000, Priority::BACKGROUND));
+    r = analyzeSchedulability(blocked, 1);
+    std::printf("%s\n", r.reason.c_str());
+    check(!r.schedulable, "长时间非抢占任务阻塞 HIGH 任务被识别");
+
+    // 利用率超过 1：降频后可调度
+    std::vector<AdmissionTask> heavy = {
+        make_task("control", 200, 1000, Priority::CRITICAL),
+        make_task("vision", 60, 12000, Priority::MEDIUM),
+        make_task("display", 30, 4000, Priority::LOW),
+    };
+    r = analyzeSchedulability(heavy, 1);
+    check(!r.schedulable, "超载任务集合不可调度");
+    r = degradeUntilSchedulable(heavy, 1);
+    std::printf("降频后 vision=%.1fHz display=%.1fHz U=%.3f\n",
+                1e6 / heavy[1].period_us, 1e6 / heavy[2].period_us, r.utilization);
+    check(r.schedulable && heavy[0].period_us == 5000.0, "降频只作用于低优先级任务");
+
+    // 多核上界
+    std::vector<AdmissionTask> multi = {
+        make_task("a", 100, 4000, Priority::HIGH),
+        make_task("b", 100, 4000, Priority::HIGH),
+        make_task("c", 100, 4000, Priority::HIGH),
+    };
+    check(analyzeSchedulability(multi, 3).schedulable, "3核 U=1.2 满足全局RM上界");
+    check(!analyzeSchedulability(multi, 2).schedulable, "2核 U=1.2 超过全局RM上界");
+}
+
+// 调度器 addTask 准入
+static void test_add_task() {
+    std::printf("\n== addTask 准入 ==\n");
+    TaskScheduler scheduler(1);
+    check(scheduler.addTask("control", [] {}, 200, Priority::CRITICAL, 1), "添加控制任务");
+    check(!scheduler.addTask("inference", [] {}, 50, Priority::BACKGROUND, 20), "Reject: 超载任务被拒绝");
+
+    scheduler.setAdmissionPolicy(AdmissionPolicy::Degrade);
+    check(scheduler.addTask("display", [] {}, 100, Priority::LOW, 4), "Degrade: 超载任务降频后加入");
+    auto stats = scheduler.getTaskSnapshots();
+    for (const auto& s : stats) {
+        std::printf("  %-10s %d Hz\n", s.name.c_str(), s.frequency_hz);
+    }
+    check(scheduler.checkAdmission().schedulable, "降频后任务集合可调度");
+}
+
+// 运行时：关键任务在混合负载下不超时
+static bool run_mixed_load(bool shed, int seconds_to_run) {
+    const int control_hz = 200;
+    const int control_us = 800;
+
+    TaskScheduler scheduler(1);
+    scheduler.setAdmissionPolicy(AdmissionPolicy::None, shed);
+
+    scheduler.addTask("control", [] { busy_us(control_us); }, control_hz, Priority::CRITICAL, 1);
+    scheduler.addTask("imu", [] { busy_us(200); }, 100, Priority::HIGH);
+    // 以下任务未声明预算，执行时间由统计线程实测得到
+    scheduler.addTask("display", [] { busy_us(2500); }, 30, Priority::MEDIUM);
+    scheduler.addTask("web", [] { busy_us(3500); }, 10, Priority::LOW);
+    scheduler.addTask("inference", [] { busy_us(4000); }, 20, Priority::BACKGROUND);
+
+    scheduler.start();
+    // 第一秒用于实测执行时间，之后清空统计再计数
+    std::this_thread::sleep_for(milliseconds(1500));
+    scheduler.resetStats();
+    std::this_thread::sleep_for(seconds(seconds_to_run));
+    scheduler.stop();
+
+    bool control_ok = true;
+    std::printf("%-10s %8s %6s %6s %10s %10s\n", "task", "runs", "miss", "defer", "lat p99", "lat max");
+    for (const auto& s : scheduler.getTaskSnapshots()) {
+        std::printf("%-10s %8llu %6d %6d %10llu %10llu\n", s.name.c_str(),
+                    static_cast<unsigned long long>(s.latency_us.count), s.missed_deadlines, s.shed_count,
+                    static_cast<unsigned long long>(s.latency_us.percentile(99)),
+                    static_cast<unsigned long long>(s.latency_us.max));
+        if (s.priority == Priority::CRITICAL) {
+            // 启动延迟 + 执行时间不超过周期即未错过截止期
+            // 非实时内核上偶发的毫秒级抢占不归调度器负责，按 p99.9 判定；目标板上配合 SCHED_FIFO 可看 max
+            uint64_t period_us = 1000000 / control_hz;
+            uint64_t worst_us = s.latency_us.percentile(99.9) + s.exec_us.percentile(99.9);
+            std::printf("control p99.9 延迟+执行 = %lluus / 周期 %lluus\n",
+                        static_cast<unsigned long long>(worst_us), static_cast<unsigned long long>(period_us));
+            control_ok = worst_us <= period_us;
+        }
+    }
+    return control_ok;
+}
+
+int main(int argc, char* argv[]) {
+    int seconds_to_run = argc > 1 ? std::atoi(argv[1]) : 3;
+
+    test_analysis();
+    test_add_task();
+
+    std::printf("\n== 运行时（1 工作线程，不让路）==\n");
+    bool without_shed = run_mixed_load(false, seconds_to_run);
+    std::printf("控制任务%s截止期\n", without_shed ? "未错过" : "错过");
+
+    std::printf("\n== 运行时（1 工作线程，为关键任务让路）==\n");
+    check(run_mixed_load(true, seconds_to_run), "关键控制任务从未错过截止期");
+
+    return test_report();
+}
@@ -0,0 +1,208 @@
+// 遥测总线测试：多个生产者并发写入时每个读者按各自游标完整读到记录、内容不撕裂；读者落后被覆盖时计入丢失；
+// FrameTracer 区间转发为阶段耗时记录；输出单条写入与原来 stringstream 拼 JSON 的耗时（只输出不断言）
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/telemetry_bus_test.cpp src/telemetry_bus.cpp src/frame_trace.cpp
+//               src/rt_thread.cpp -lpthread
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "frame_trace.hpp"
+#include "telemetry_bus.hpp"
+#include "test_check.hpp"
+
+using namespace robot;
+
+static void test_basic() {
+    std::printf("\n== 写入与读取 ==\n");
+    TelemetryBus bus(100);
+    check(bus.capacity() == 128, "容量向上取整为 2 的幂");
+
+    uint64_t cursor = bus.head();
+    TelemetryImu imu = {{1, 2, 3}, {-4, -5, -6}, 12.5f, 90.0f};
+    TelemetryEncoder encoder = {10, -11, 100.0f, 110.0f, 1.5f, 3.25f};
+    bus.push(TelemetryType::Imu, imu, 1000);
+    bus.push(TelemetryType::Encoder, encoder, 2000);
+
+    TelemetryRecord records[8];
+    size_t n = bus.read(&cursor, records, 8);
+    TelemetryImu imu_out = {};
+    TelemetryEncoder encoder_out = {};
+    TelemetryControl wrong = {};
+    check(n == 2 && cursor == 2, "读到两条记录，游标前移");
+    check(records[0].type == (uint16_t)TelemetryType::Imu && records[0].timestamp_ns == 1000 &&
+          records[0].get(imu_out) && std::memcmp(&imu_out, &imu, sizeof(imu)) == 0, "IMU 记录内容");
+    check(records[1].sequence == 1 && records[1].get(encoder_out) && encoder_out.right == -11 &&
+          encoder_out.distance == 3.25f, "编码器记录内容");
+    check(!records[1].get(wrong), "负载类型不符时 get 失败");
+    check(bus.read(&cursor, records, 8) == 0, "没有新记录时读到 0 条");
+
+    // 负载偏移与网页解码一致
+    check(offsetof(TelemetryRecord, payload) == 16 && offsetof(TelemetryControl, servo_duty) == 24 &&
+          offsetof(TelemetryTrack, motor_speed) == 16 && offsetof(TelemetryTrack, age_us) == 24 &&
+          offsetof(TelemetryStage, name) == 12, "负载布局");
+
+    // 读者落后：写入 300 条，容量 128
+    uint64_t slow = bus.head();
+    for (int i = 0; i < 300; ++i) {
+        bus.push(TelemetryType::Encoder, encoder, i);
+    }
+    uint64_t lost = 0, received = 0;
+    TelemetryRecord batch[64];
+    while ((n = bus.read(&slow, batch, 64, &lost)) > 0) {
+        received += n;
+    }
+    check(lost == 300 - 128 && received == 128 && batch[(128 - 1) % 64].timestamp_ns == 299,
+          "被覆盖的记录计入丢失，读者从最旧的有效记录继续");
+}
+
+// 负载：producer 编号 + 该生产者的计数，重复写满，读到不一致说明撕裂
+struct TestPayload {
+    uint32_t producer;
+    uint32_t count;
+    uint32_t check[10];
+};
+
+static void test_concurrent() {
+    std::printf("\n== 多生产者、多读者 ==\n");
+    TelemetryBus bus(4096);
+    const int producers = 3;
+    const uint32_t per_producer = 200000;
+    std::atomic<int> finished{0};
+
+    auto reader = [&](uint64_t* received, uint64_t* lost, bool* ok, int delay_us) {
+        uint64_t cursor = 0;
+        uint32_t last[producers] = {0};
+        TelemetryRecord records[256];
+        *ok = true;
+        for (;;) {
+            bool done = finished.load() == producers;
+            size_t n = bus.read(&cursor, records, 256, lost);
+            for (size_t i = 0; i < n; ++i) {
+                TestPayload p;
+                if (!records[i].get(p) || p.producer >= producers) {
+                    *ok = false;
+                    continue;
+                }
+                for (uint32_t v : p.check) {
+                    *ok = *ok && v == p.producer * 1000003u + p.count;
+                }
+                *ok = *ok && p.count > last[p.producer];
+                last[p.producer] = p.count;
+            }
+            *received += n;
+            if (n == 0) {
+                if (done) {
+                    break;
+                }
+                std::this_thread::yield();
+            } else if (delay_us > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+            }
+        }
+    };
+
+    uint64_t fast_received = 0, fast_lost = 0, slow_received = 0, slow_lost = 0;
+    bool fast_ok = false, slow_ok = false;
+    std::thread fast(reader, &fast_received, &fast_lost, &fast_ok, 0);
+    std::thread slow(reader, &slow_received, &slow_lost, &slow_ok, 2000);
+    std::vector<std::thread> threads;
+    for (int id = 0; id < producers; ++id) {
+        threads.emplace_back([&, id]() {
+            TestPayload p;
+            p.producer = id;
+            for (uint32_t count = 1; count <= per_producer; ++count) {
+                p.count = count;
+                for (uint32_t& v : p.check) {
+                    v = id * 1000003u + count;
+                }
+                bus.push(TelemetryType::Stage, p, count);
+            }
+            finished++;
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    fast.join();
+    slow.join();
+
+    uint64_t total = (uint64_t)producers * per_producer;
+    std::printf("共写入 %llu 条；快读者收到 %llu、丢失 %llu；慢读者收到 %llu、丢失 %llu\n",
+                (unsigned long long)total, (unsigned long long)fast_received, (unsigned long long)fast_lost,
+                (unsigned long long)slow_received, (unsigned long long)slow_lost);
+    check(fast_ok && slow_ok, "内容不撕裂，每个生产者的记录按顺序到达");
+    check(fast_received + fast_lost == total && slow_received + slow_lost == total, "收到 + 丢失 = 写入");
+    check(slow_lost > 0, "慢读者被覆盖时丢失旧记录，不阻塞生产者");
+}
+
+static TelemetryBus* g_stage_bus = nullptr;
+
+static void forward_span(const TraceSpan& span) {
+    TelemetryStage record = {};
+    record.frame_id = span.frame_id;
+    record.duration_us = (uint32_t)((span.end_ns - span.start_ns) / 1000);
+    std::strncpy(record.name, span.name, sizeof(record.name) - 1);
+    g_stage_bus->push(TelemetryType::Stage, record, span.start_ns);
+}
+
+static void test_stage_listener() {
+    std::printf("\n== 阶段耗时 ==\n");
+    TelemetryBus bus(64);
+    g_stage_bus = &bus;
+    FrameTracer& tracer = FrameTracer::instance();
+    tracer.setSpanListener(forward_span);
+    tracer.record(42, "imgSearch_l_r", 1000000, 1250000);
+    tracer.record(42, "a_very_long_stage_name_over_20", 0, 1000);
+    tracer.setSpanListener(nullptr);
+    tracer.record(43, "ignored", 0, 1000);
+
+    uint64_t cursor = 0;
+    TelemetryRecord records[4];
+    size_t n = bus.read(&cursor, records, 4);
+    TelemetryStage stage = {}, long_name = {};
+    check(n == 2 && records[0].get(stage) && stage.frame_id == 42 && stage.duration_us == 250 &&
+          std::strcmp(stage.name, "imgSearch_l_r") == 0 && records[0].timestamp_ns == 1000000,
+          "FrameTracer 区间转发为阶段记录");
+    check(records[1].get(long_name) && std::strlen(long_name.name) == 19, "过长的阶段名被截断");
+}
+
+static void test_cost() {
+    std::printf("\n== 写入耗时 ==\n");
+    TelemetryBus bus;
+    TelemetryImu imu = {{1, 2, 3}, {4, 5, 6}, 0.5f, 1.0f};
+    const int n = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        imu.acc[0] = (int16_t)i;
+        bus.push(TelemetryType::Imu, imu, i);
+    }
+    double push_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+
+    // 原来每条 SSE 消息的构造方式
+    const int m = 100000;
+    size_t sink = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < m; ++i) {
+        std::stringstream ss;
+        ss << "event: sensor-data\n";
+        ss << "data: {" << "\"imu660ra_acc_x\": " << i << ", \"imu660ra_acc_y\": " << 2 << ", \"imu660ra_acc_z\": " << 3
+           << ", \"imu660ra_gyro_x\": " << 4 << ", \"imu660ra_gyro_y\": " << 5 << ", \"imu660ra_gyro_z\": " << 6
+           << ", \"encoder_left\": " << 7 << ", \"encoder_right\": " << 8 << ", \"timestamp\": " << 9
+           << ", \"sequence\": " << i << "}\n\n";
+        sink += ss.str().size();
+    }
+    double json_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / m;
+    std::printf("写入一条二进制记录 %.1f ns（64 字节）；stringstream 拼一条 JSON %.1f ns（%zu 字节）\n",
+                push_ns, json_ns, sink / m);
+}
+
+int main() {
+    test_basic();
+    test_concurrent();
+    test_stage_listener();
+    test_cost();
+    return test_report();
+}
@@ -0,0 +1,28 @@
+/**
+ * @file test_check.hpp
+ * @brief 主机测试共用的断言与结果汇总
+ *
+ * 各测试程序包含本头文件后用 check() 逐项断言，main() 末尾 return test_report()。
+ */
+#ifndef ROBOT_TEST_CHECK_HPP
+#define ROBOT_TEST_CHECK_HPP
+
+#include <cstdio>
+
+static int g_failures = 0;  ///< 失败的断言数
+
+/// @brief 打印一项断言结果，失败时计数
+static inline void check(bool condition, const char* what) {
+    std::printf("[%s] %s\n", condition ? "PASS" : "FAIL", what);
+    if (!condition) {
+        ++g_failures;
+    }
+}
+
+/// @brief 打印汇总行，返回进程退出码（全部通过为 0）
+static inline int test_report() {
+    std::printf("\n%s (%d failures)\n", g_failures == 0 ? "ALL PASSED" : "FAILED", g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
+
+#endif  // ROBOT_TEST_CHECK_HPP
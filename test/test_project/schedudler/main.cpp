@@ -5,7 +5,7 @@
  * 展示如何使用robot::TaskScheduler库来调度和管理周期性任务。
  */
 
-#include "include/task_scheduler.hpp"
+#include "task_scheduler.hpp"
 #include <iostream>
 #include <thread>
 #include <chrono>
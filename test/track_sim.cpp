@@ -0,0 +1,447 @@
+// 闭环赛道仿真：在桌面上用俯视赛道地图合成摄像头图像，送入与车上相同的寻线与控制流程，
+// 控制输出驱动自行车模型车辆，车辆位姿再决定下一帧图像，按仿真时间尽快运行，可以连续跑上千圈。
+//   成像：按透视矩阵（与 ImagePerspective_Init 相同，俯视图 → 原图）的逆把原图每个像素对应到地面，查赛道栅格
+//   感知：imgPreProc → TrackProcess（--binary 时直接生成二值图，跳过灰度与 OTSU）
+//   控制：与 control_task 相同的 CascadedController 输入输出、曲率速度规划、编码器里程计与陀螺仪出环判断
+//   时序：100Hz 控制周期；摄像头按 --fps 成像，决策结果在采集时刻之后 --latency-ms 才被控制任务使用
+// 每圈结果打印并可写入 CSV；冲出赛道或单圈超时时结束。
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/track_sim.cpp src/track_sim.cpp src/track_process.cpp
+//               src/libimage_process.cpp src/libdata_process.cpp src/path_side_search.cpp src/path_circle.cpp
+//               src/path_across.cpp src/mycross.cpp src/Perspective.cpp src/lookahead.cpp src/frame_trace.cpp
+//               src/cascaded_controller.cpp src/PID.cpp src/speed_planner.cpp src/odometry.cpp
+//               $(pkg-config --cflags --libs opencv4) -lpthread
+// 用法：./track_sim [--config config/config_0.json] [--track 赛道描述] [--laps N] [--csv laps.csv]
+//                  [--trace trace.csv] [--binary] [--noise N] [--fps N] [--latency-ms N] [--lap-timeout S]
+//                  [--homography h00 h01 ... h22] [--near M] [--wheelbase M] [--steer-ratio K]
+//                  [--max-speed M/S] [--servo-tau S] [--motor-tau S] [--lateral-acc A] [--dump-frames 目录]
+//   赛道描述格式见 include/track_sim.hpp，不指定时使用内置的默认赛道。
+//   车辆参数与透视矩阵的默认值未经实车标定，调参结论需要在车上确认。
+//   赛道状态机的状态跨圈延续（含 TrackKind_Judge 内的静态变量），与车上连续跑圈相同。
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+#include "common_system.h"
+#include "common_program.h"
+#include "cascaded_controller.hpp"
+#include "frame_trace.hpp"
+#include "odometry.hpp"
+#include "speed_planner.hpp"
+#include "track_sim.hpp"
+
+using namespace std;
+using namespace cv;
+
+static const int CONTROL_HZ = 100;
+static const int64_t CONTROL_PERIOD_NS = 1000000000LL / CONTROL_HZ;
+
+// 与 main.cpp 相同的全局状态（静态存储，初值为 0）
+static JSON_PIDConfigData  JSON_PIDConfigData_c;
+static Function_EN         Function_EN_c;
+static Data_Path           Data_Path_c;
+static Img_Store           Img_Store_c;
+static ImgProcess          imgProcess;
+
+struct SimOptions {
+    string config = "config/config_0.json";
+    string track;
+    string csv;
+    string trace;
+    string dump_frames;
+    int laps = 10;
+    bool binary = false;
+    int noise = 0;
+    double fps = 50;
+    double latency_ms = 20;
+    double lap_timeout_s = 60;
+    bool has_homography = false;
+    double homography[3][3] = {};
+    float near_m = 0.20f;
+    robot::VehicleParams vehicle;
+};
+
+/*
+    一帧的决策结果，控制任务在 ready_ns 之后才能使用（模拟采集、传输与处理的延迟）
+*/
+struct SimTarget {
+    int64_t ready_ns;
+    int servo_dir;
+    int servo_angle;
+    int motor_speed;
+    float speed_limit;
+};
+
+/*
+    仿真状态
+*/
+struct Sim {
+    robot::TrackMap map;
+    robot::TrackCamera camera;
+    robot::VehicleModel vehicle;
+    robot::Odometry odometry;
+    robot::SpeedPlanner speed_planner;
+    bool speed_plan_enabled = false;
+    unique_ptr<robot::CascadedController> controller;
+
+    deque<SimTarget> pending;
+    SimTarget target = {};
+    bool has_target = false;
+
+    // 编码器脉冲的小数部分，累计到整数后输出
+    double left_counts = 0;
+    double right_counts = 0;
+
+    // 陀螺仪出环判断：入环后记录航向，转过配置角度时置位
+    bool circle_gyro_armed = false;
+    float circle_yaw0 = 0;
+
+    Mat gray;
+    uint64_t frames = 0;
+    FILE* trace = nullptr;
+};
+
+static void circle_gyro_update(Sim* sim)
+{
+    CircleTrackStep step = Data_Path_c.Circle_Track_Step;
+    if (step == IN_PREPARE || step == OUT_2_STRIGHT || step == INIT) {
+        sim->circle_gyro_armed = false;
+        Function_EN_c.Gyroscope_EN = false;
+        return;
+    }
+    if (!sim->circle_gyro_armed) {
+        sim->circle_yaw0 = sim->vehicle.pose().yaw;
+        sim->circle_gyro_armed = true;
+    }
+    float turned = fabs(sim->vehicle.pose().yaw - sim->circle_yaw0) * 180.0f / (float)M_PI;
+    Function_EN_c.Gyroscope_EN = turned >= Data_Path_c.JSON_TrackConfigData_v[0].Circle_Out_Gyro_Angle;
+}
+
+/*
+    采集与寻线：按当前位姿成像，预处理后寻线决策，结果在延迟之后生效
+*/
+static void vision_step(Sim* sim, const SimOptions& options, int64_t now_ns)
+{
+    Img_Store* Img_Store_p = &Img_Store_c;
+    uint64_t frame_id = sim->frames++;
+    if (options.binary) {
+        sim->camera.render(sim->map, sim->vehicle.pose(), 255, 0, 0, Img_Store_p->Img_OTSU.data,
+                           (int)Img_Store_p->Img_OTSU.step);
+        // 与 imgPreProc 相同的黑框
+        line(Img_Store_p->Img_OTSU, Point(0, 0), Point(image_w - 1, 0), Scalar(0), 3);
+        line(Img_Store_p->Img_OTSU, Point(image_w - 1, 0), Point(image_w - 1, image_h - 1), Scalar(0), 3);
+        line(Img_Store_p->Img_OTSU, Point(image_w - 1, image_h - 1), Point(0, image_h - 1), Scalar(0), 3);
+        line(Img_Store_p->Img_OTSU, Point(0, image_h - 1), Point(0, 0), Scalar(0), 3);
+    } else {
+        sim->camera.render(sim->map, sim->vehicle.pose(), 200, 60, options.noise, sim->gray.data,
+                           (int)sim->gray.step);
+        cvtColor(sim->gray, Img_Store_p->Img_Color, COLOR_GRAY2BGR);
+        imgProcess.imgPreProc(Img_Store_p, &Data_Path_c, &Function_EN_c);
+    }
+    if (!options.dump_frames.empty()) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%06llu.png", options.dump_frames.c_str(), (unsigned long long)frame_id);
+        imwrite(path, options.binary ? Img_Store_p->Img_OTSU : sim->gray);
+    }
+
+    circle_gyro_update(sim);
+
+    // 当前帧采集时刻的行驶距离与车速
+    double distance = 0;
+    robot::OdometryState odom;
+    bool has_odom = sim->odometry.state(odom);
+    if (sim->odometry.distanceAt(now_ns, distance)) {
+        Data_Path_c.Distance = distance;
+    } else if (has_odom) {
+        Data_Path_c.Distance = odom.distance;
+    }
+    if (has_odom) {
+        Data_Path_c.Speed = odom.speed;
+    }
+
+    TrackProcess(Img_Store_p, &Data_Path_c, &Function_EN_c, frame_id);
+
+    SimTarget target;
+    target.ready_ns = now_ns + (int64_t)(options.latency_ms * 1e6);
+    target.servo_dir = Data_Path_c.ServoDir;
+    target.servo_angle = Data_Path_c.ServoAngle;
+    target.motor_speed = Data_Path_c.MotorSpeed;
+    target.speed_limit = 0;
+    if (sim->speed_plan_enabled) {
+        const JSON_TrackConfigData& track_config = Data_Path_c.JSON_TrackConfigData_v[0];
+        float cap = Data_Path_c.MotorSpeed * CONTROL_HZ * (float)JSON_PIDConfigData_c.encoder_meters_per_count;
+        robot::CurvatureEstimate estimate = robot::estimateCurvature(Data_Path_c.center_line, image_h, image_w,
+            Data_Path_c.hightest, image_h - track_config.Path_Search_Start, track_config.Birdeye_Meters_Per_Pixel);
+        target.speed_limit = sim->speed_planner.limit(cap, estimate);
+    }
+    sim->pending.push_back(target);
+}
+
+/*
+    控制周期：编码器采样 → 与 control_task 相同的控制器输入 → 车辆模型前进一个周期
+*/
+static robot::ControllerOutput control_step(Sim* sim, int64_t now_ns)
+{
+    const double meters_per_count = JSON_PIDConfigData_c.encoder_meters_per_count;
+    const float dt = 1.0f / CONTROL_HZ;
+    sim->left_counts += sim->vehicle.leftSpeed() * dt / meters_per_count;
+    sim->right_counts += sim->vehicle.rightSpeed() * dt / meters_per_count;
+    int left_delta = (int)sim->left_counts;
+    int right_delta = (int)sim->right_counts;
+    sim->left_counts -= left_delta;
+    sim->right_counts -= right_delta;
+    sim->odometry.update(now_ns, left_delta, right_delta);
+
+    while (!sim->pending.empty() && sim->pending.front().ready_ns <= now_ns) {
+        sim->target = sim->pending.front();
+        sim->pending.pop_front();
+        sim->has_target = true;
+    }
+
+    robot::OdometryState odom;
+    sim->odometry.state(odom);
+    const SimTarget& target = sim->target;
+    robot::ControllerInput input;
+    input.timestamp_ns = now_ns;
+    input.pixel_error = (float)(-target.servo_dir * target.servo_angle);
+    input.yaw_rate = sim->vehicle.yawRate() * 180.0f / (float)M_PI;
+    input.speed_target = sim->has_target ? (float)target.motor_speed : 0;
+    if (sim->speed_plan_enabled) {
+        if (sim->has_target) {
+            float speed = sim->speed_planner.step(target.speed_limit, dt);
+            input.speed_target = speed / (CONTROL_HZ * (float)meters_per_count);
+        } else {
+            sim->speed_planner.reset();
+        }
+    }
+    input.speed_present = (odom.left_cps + odom.right_cps) / 2 / CONTROL_HZ;
+    robot::ControllerOutput output = sim->controller->step(input);
+
+    sim->vehicle.step(output.servo, output.motor / JSON_PIDConfigData_c.motorpid.Reslimit, dt);
+    return output;
+}
+
+static bool parse_args(int argc, char** argv, SimOptions* options)
+{
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--config" && has_value) {
+            options->config = argv[++i];
+        } else if (arg == "--track" && has_value) {
+            options->track = argv[++i];
+        } else if (arg == "--laps" && has_value) {
+            options->laps = atoi(argv[++i]);
+        } else if (arg == "--csv" && has_value) {
+            options->csv = argv[++i];
+        } else if (arg == "--trace" && has_value) {
+            options->trace = argv[++i];
+        } else if (arg == "--dump-frames" && has_value) {
+            options->dump_frames = argv[++i];
+        } else if (arg == "--binary") {
+            options->binary = true;
+        } else if (arg == "--noise" && has_value) {
+            options->noise = atoi(argv[++i]);
+        } else if (arg == "--fps" && has_value) {
+            options->fps = atof(argv[++i]);
+        } else if (arg == "--latency-ms" && has_value) {
+            options->latency_ms = atof(argv[++i]);
+        } else if (arg == "--lap-timeout" && has_value) {
+            options->lap_timeout_s = atof(argv[++i]);
+        } else if (arg == "--homography" && i + 9 < argc) {
+            for (int k = 0; k < 9; ++k) {
+                options->homography[k / 3][k % 3] = atof(argv[++i]);
+            }
+            options->has_homography = true;
+        } else if (arg == "--near" && has_value) {
+            options->near_m = (float)atof(argv[++i]);
+        } else if (arg == "--wheelbase" && has_value) {
+            options->vehicle.wheelbase = (float)atof(argv[++i]);
+        } else if (arg == "--steer-ratio" && has_value) {
+            options->vehicle.steer_ratio = (float)atof(argv[++i]);
+        } else if (arg == "--max-speed" && has_value) {
+            options->vehicle.max_speed = (float)atof(argv[++i]);
+        } else if (arg == "--servo-tau" && has_value) {
+            options->vehicle.servo_tau = (float)atof(argv[++i]);
+        } else if (arg == "--motor-tau" && has_value) {
+            options->vehicle.motor_tau = (float)atof(argv[++i]);
+        } else if (arg == "--lateral-acc" && has_value) {
+            options->vehicle.max_lateral_accel = (float)atof(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return options->laps > 0 && options->fps > 0 && options->latency_ms >= 0;
+}
+
+int main(int argc, char** argv)
+{
+    SimOptions options;
+    if (!parse_args(argc, argv, &options)) {
+        fprintf(stderr, "用法：%s [--config 参数文件] [--track 赛道描述] [--laps 圈数] [--csv 每圈结果] "
+                        "[--trace 逐周期记录] [--binary] [--noise 幅度] [--fps 帧率] [--latency-ms 延迟] "
+                        "[--lap-timeout 秒] [--homography 9个值] [--near 米] [--wheelbase 米] [--steer-ratio 比例] "
+                        "[--max-speed 米/秒] [--servo-tau 秒] [--motor-tau 秒] [--lateral-acc 米/秒²] "
+                        "[--dump-frames 目录]\n", argv[0]);
+        return 2;
+    }
+
+    SYNC sync;
+    if (!sync.ConfigData_Load(options.config.c_str(), &Data_Path_c, &Function_EN_c, &JSON_PIDConfigData_c)) {
+        return 2;
+    }
+    Function_EN_c.Loop_Kind_EN = CAMERA_CATCH_LOOP;
+    Function_EN_c.Gyroscope_EN = false;
+    Function_EN_c.Game_EN = true;
+    Img_Store_c.Draw_EN = false;
+    Img_Store_c.Img_OTSU = Mat(CAMERA_H, CAMERA_W, CV_8UC1, Scalar(0));
+
+    Sim sim;
+    string error;
+    bool loaded = options.track.empty() ? sim.map.build(robot::TrackMap::DEFAULT_TRACK, 0.005f, &error)
+                                        : sim.map.load(options.track, 0.005f, &error);
+    if (!loaded) {
+        fprintf(stderr, "赛道描述有误：%s\n", error.c_str());
+        return 2;
+    }
+    if (!sim.map.closed()) {
+        fprintf(stderr, "赛道终点与起点相距 %.3fm，按单程运行\n", sim.map.closureError());
+    }
+
+    const JSON_TrackConfigData& track_config = Data_Path_c.JSON_TrackConfigData_v[0];
+    robot::CameraModelOptions camera_options;
+    if (options.has_homography) {
+        memcpy(camera_options.homography, options.homography, sizeof(options.homography));
+    } else {
+        robot::TrackCamera::defaultHomography(CAMERA_W, CAMERA_H, RESULT_COL, RESULT_ROW, camera_options.homography);
+    }
+    camera_options.image_width = CAMERA_W;
+    camera_options.image_height = CAMERA_H;
+    camera_options.result_cols = RESULT_COL;
+    camera_options.result_rows = RESULT_ROW;
+    camera_options.meters_per_pixel = track_config.Birdeye_Meters_Per_Pixel;
+    camera_options.near_m = options.near_m;
+    if (!sim.camera.configure(camera_options)) {
+        fprintf(stderr, "透视矩阵不可逆\n");
+        return 2;
+    }
+    sim.gray = Mat(CAMERA_H, CAMERA_W, CV_8UC1, Scalar(0));
+
+    // 与 main.cpp 初始化相同的里程计、控制器与速度规划配置
+    robot::OdometryOptions odometry_options;
+    odometry_options.meters_per_count = JSON_PIDConfigData_c.encoder_meters_per_count;
+    odometry_options.track_width_m = JSON_PIDConfigData_c.wheel_track_width;
+    sim.odometry.configure(odometry_options);
+
+    robot::ControllerOptions controller_options;
+    controller_options.rate_hz = CONTROL_HZ;
+    controller_options.cascade_steering = JSON_PIDConfigData_c.cascade_steer;
+    controller_options.motor_kff = JSON_PIDConfigData_c.motor_kff;
+    controller_options.d_tau = JSON_PIDConfigData_c.pid_d_tau;
+    sim.controller.reset(new robot::CascadedController(JSON_PIDConfigData_c.anglespeedpid,
+                                                       JSON_PIDConfigData_c.servopid,
+                                                       JSON_PIDConfigData_c.motorpid, controller_options));
+
+    robot::SpeedPlannerOptions planner_options;
+    planner_options.max_lateral_accel = track_config.SpeedPlan_Lateral_Acc;
+    planner_options.max_accel = track_config.SpeedPlan_Acc;
+    planner_options.max_decel = track_config.SpeedPlan_Dec;
+    planner_options.min_speed = track_config.SpeedPlan_Min_Speed;
+    planner_options.horizon_speed = track_config.SpeedPlan_Horizon_Speed;
+    sim.speed_planner.configure(planner_options);
+    sim.speed_plan_enabled = track_config.SpeedPlan_EN;
+
+    sim.vehicle = robot::VehicleModel(options.vehicle);
+    sim.vehicle.reset(robot::VehiclePose());
+    robot::LapTracker tracker(&sim.map);
+    tracker.reset(0);
+
+    FILE* csv = nullptr;
+    if (!options.csv.empty()) {
+        csv = fopen(options.csv.c_str(), "w");
+        if (!csv) {
+            fprintf(stderr, "无法写入 %s\n", options.csv.c_str());
+            return 2;
+        }
+        fprintf(csv, "lap,completed,time_s,mean_speed,max_lateral,rms_lateral\n");
+    }
+    if (!options.trace.empty()) {
+        sim.trace = fopen(options.trace.c_str(), "w");
+        if (!sim.trace) {
+            fprintf(stderr, "无法写入 %s\n", options.trace.c_str());
+            return 2;
+        }
+        fprintf(sim.trace, "t,x,y,yaw,speed,lateral,servo,motor,track_kind,circle_step\n");
+    }
+
+    printf("赛道长 %.2fm（%s），宽 %.2fm；%s，%.0f 帧/秒，延迟 %.0fms\n", sim.map.length(),
+           sim.map.closed() ? "闭合" : "单程", sim.map.width(), options.binary ? "二值成像" : "灰度成像",
+           options.fps, options.latency_ms);
+
+    const int64_t frame_period_ns = (int64_t)(1e9 / options.fps);
+    int64_t next_frame_ns = 0;
+    int64_t now_ns = 0;
+    int completed = 0;
+    double best_s = 0, sum_s = 0;
+    bool crashed = false, timed_out = false;
+    int64_t start_ns = robot::FrameTracer::nowNs();
+    while (completed < options.laps) {
+        now_ns += CONTROL_PERIOD_NS;
+        if (now_ns >= next_frame_ns) {
+            vision_step(&sim, options, now_ns);
+            next_frame_ns += frame_period_ns;
+        }
+        robot::ControllerOutput output = control_step(&sim, now_ns);
+        double now_s = now_ns / 1e9;
+
+        robot::LapResult lap;
+        bool finished = tracker.update(sim.vehicle.pose(), now_s, &lap);
+        if (sim.trace) {
+            const robot::VehiclePose& pose = sim.vehicle.pose();
+            fprintf(sim.trace, "%.2f,%.3f,%.3f,%.3f,%.3f,%.3f,%.2f,%.2f,%d,%d\n", now_s, pose.x, pose.y, pose.yaw,
+                    sim.vehicle.speed(), tracker.lateral(), output.servo, output.motor, (int)Data_Path_c.Track_Kind,
+                    (int)Data_Path_c.Circle_Track_Step);
+        }
+        if (finished) {
+            printf("第 %d 圈 %s：%.2fs，平均 %.2fm/s，最大偏差 %.3fm，RMS %.3fm\n", lap.lap,
+                   lap.completed ? "完成" : "冲出赛道", lap.time_s, lap.mean_speed, lap.max_lateral, lap.rms_lateral);
+            if (csv) {
+                fprintf(csv, "%d,%d,%.3f,%.3f,%.3f,%.3f\n", lap.lap, lap.completed ? 1 : 0, lap.time_s,
+                        lap.mean_speed, lap.max_lateral, lap.rms_lateral);
+            }
+            if (!lap.completed) {
+                crashed = true;
+                break;
+            }
+            ++completed;
+            sum_s += lap.time_s;
+            best_s = completed == 1 ? lap.time_s : min(best_s, lap.time_s);
+            if (!sim.map.closed()) {
+                break;
+            }
+        }
+        // 各圈首尾相接，当前圈从已完成各圈的总时间开始
+        if (now_s - sum_s > options.lap_timeout_s) {
+            printf("第 %d 圈超过 %.0fs 未完成（进度 %.2fm）\n", tracker.lap() + 1, options.lap_timeout_s,
+                   tracker.progress());
+            timed_out = true;
+            break;
+        }
+    }
+    double wall_s = (robot::FrameTracer::nowNs() - start_ns) / 1e9;
+    if (csv) {
+        fclose(csv);
+    }
+    if (sim.trace) {
+        fclose(sim.trace);
+    }
+
+    double sim_s = now_ns / 1e9;
+    printf("\n完成 %d / %d 圈", completed, options.laps);
+    if (completed > 0) {
+        printf("，最快 %.2fs，平均 %.2fs", best_s, sum_s / completed);
+    }
+    printf("\n仿真 %.1fs，%llu 帧，用时 %.2fs（%.1f 倍实时）\n", sim_s, (unsigned long long)sim.frames, wall_s,
+           wall_s > 0 ? sim_s / wall_s : 0.0);
+    return crashed || timed_out ? 1 : 0;
+}
@@ -0,0 +1,269 @@
+// 赛道仿真被控对象测试：赛道描述解析与闭合、中线投影、由透视矩阵反推的成像（按车上的俯视变换取回后赛道宽度）、
+// 自行车模型转弯半径与侧滑限制，以及用简化感知（原图单行找边）+ CascadedController 跑完整圈的闭环
+// 编译（主机）：g++ -std=c++17 -O2 -Iinclude test/track_sim_test.cpp src/track_sim.cpp src/cascaded_controller.cpp src/PID.cpp
+#include "track_sim.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "cascaded_controller.hpp"
+#include "test_check.hpp"
+
+using namespace robot;
+
+static const int W = 320;
+static const int H = 240;
+static const int RESULT_COLS = 320;
+static const int RESULT_ROWS = 180;
+static const int LOOKAHEAD_ROW = 130;     // 简化感知的前瞻行（原图），默认矩阵下约在后轴前 0.53m
+
+static CameraModelOptions default_camera() {
+    CameraModelOptions options;
+    TrackCamera::defaultHomography(W, H, RESULT_COLS, RESULT_ROWS, options.homography);
+    return options;
+}
+
+static void test_map() {
+    std::printf("\n== 赛道描述 ==\n");
+    TrackMap map;
+    std::string error;
+    check(map.build(TrackMap::DEFAULT_TRACK, 0.01f, &error), "解析默认赛道");
+    std::printf("长度 %.2fm，闭合误差 %.4fm，%zu 个元素\n", map.length(), map.closureError(), map.elements().size());
+    check(map.closed() && map.closureError() < 0.02f, "默认赛道首尾相接");
+    check(map.length() > 20 && map.length() < 30, "默认赛道约 25 米");
+
+    TrackMap open;
+    check(open.build("width 0.4\nstraight 1.0 # 注释\nleft 1.0 90\n", 0.01f, &error) && !open.closed() &&
+          std::fabs(open.width() - 0.4f) < 1e-6f, "非闭合赛道与行尾注释");
+    const TrackPoint& end = open.points().back();
+    check(std::fabs(end.x - 2.0f) < 0.02f && std::fabs(end.y - 1.0f) < 0.02f &&
+          std::fabs(end.heading - 1.5708f) < 0.01f, "直道 + 左转 90° 的终点与航向");
+
+    check(!open.build("straight 1.0\nzigzag 3\n", 0.01f, &error) && error.find("2") != std::string::npos,
+          "未知元素报告行号");
+
+    // 路面栅格与中线投影
+    check(map.road(1.0f, 0.0f) && map.road(1.0f, 0.2f) && !map.road(1.0f, 0.26f), "直道路面宽度");
+    check(map.road(3.0f, 0.9f) && map.road(3.0f, -0.9f) && !map.road(3.6f, 0.9f), "十字横向道路");
+    float lateral = 0;
+    int index = map.project(1.0f, 0.1f, 90, 50, &lateral);
+    check(index == 100 && std::fabs(lateral - 0.1f) < 1e-3f, "投影到最近中线点，左侧偏差为正");
+    index = map.project(0.0f, -0.05f, (int)map.points().size() - 10, 50, &lateral);
+    check(index == 0 && std::fabs(lateral + 0.05f) < 1e-3f, "闭合赛道投影跨过终点");
+}
+
+static void test_camera() {
+    std::printf("\n== 摄像头模型 ==\n");
+    double m[3][3];
+    const float result[4][2] = {{0, 0}, {319, 0}, {319, 179}, {0, 179}};
+    const float source[4][2] = {{100, 60}, {220, 60}, {319, 239}, {0, 239}};
+    check(TrackCamera::perspectiveFromPoints(result, source, m), "求透视矩阵");
+    double worst = 0;
+    for (int k = 0; k < 4; ++k) {
+        double z = m[2][0] * result[k][0] + m[2][1] * result[k][1] + m[2][2];
+        double u = (m[0][0] * result[k][0] + m[0][1] * result[k][1] + m[0][2]) / z;
+        double v = (m[1][0] * result[k][0] + m[1][1] * result[k][1] + m[1][2]) / z;
+        worst = std::fmax(worst, std::fmax(std::fabs(u - source[k][0]), std::fabs(v - source[k][1])));
+    }
+    check(worst < 1e-6, "四组对应点映射准确");
+    const float collinear[4][2] = {{0, 0}, {1, 1}, {2, 2}, {3, 3}};
+    check(!TrackCamera::perspectiveFromPoints(collinear, source, m), "共线点返回 false");
+
+    TrackMap map;
+    std::string error;
+    map.build(TrackMap::DEFAULT_TRACK, 0.01f, &error);
+    CameraModelOptions options = default_camera();
+    TrackCamera camera;
+    check(camera.configure(options), "配置成像查找表");
+    std::vector<uint8_t> image((size_t)W * H);
+    VehiclePose pose;
+    pose.x = 0.5f;
+    CameraModelOptions short_range = options;
+    short_range.max_range_m = 1.2f;
+    TrackCamera near_camera;
+    near_camera.configure(short_range);
+    near_camera.render(map, pose, 255, 0, 0, image.data(), W);
+    int sky = 0;
+    for (int u = 0; u < W; ++u) {
+        sky += image[u] == 0;
+    }
+    check(sky == W, "超出 max_range_m 的远处为背景");
+    camera.render(map, pose, 255, 0, 0, image.data(), W);
+
+    // 与车上相同：俯视图每个像素按透视矩阵到原图取最近像素
+    int widths[3];
+    const int rows[3] = {RESULT_ROWS - 1, RESULT_ROWS - 20, RESULT_ROWS - 40};
+    const double (*h)[3] = options.homography;
+    for (int r = 0; r < 3; ++r) {
+        int road = 0;
+        int j = rows[r];
+        for (int i = 0; i < RESULT_COLS; ++i) {
+            double z = h[2][0] * i + h[2][1] * j + h[2][2];
+            int u = (int)std::lround((h[0][0] * i + h[0][1] * j + h[0][2]) / z);
+            int v = (int)std::lround((h[1][0] * i + h[1][1] * j + h[1][2]) / z);
+            if (u >= 0 && u < W && v >= 0 && v < H && image[(size_t)v * W + u]) {
+                ++road;
+            }
+        }
+        widths[r] = road;
+    }
+    std::printf("俯视图赛道宽度（像素）：%d %d %d\n", widths[0], widths[1], widths[2]);
+    int expected = (int)std::lround(map.width() / options.meters_per_pixel);
+    bool width_ok = true;
+    for (int r = 0; r < 3; ++r) {
+        width_ok = width_ok && std::abs(widths[r] - expected) <= 3;
+    }
+    check(width_ok, "俯视图中直道宽度为 赛道宽度 / Birdeye_Meters_Per_Pixel");
+
+    // 车辆左移后路面在图像中右移
+    VehiclePose shifted = pose;
+    shifted.y = 0.1f;
+    std::vector<uint8_t> image2((size_t)W * H);
+    camera.render(map, shifted, 255, 0, 0, image2.data(), W);
+    int sum1 = 0, sum2 = 0, n1 = 0, n2 = 0;
+    for (int u = 0; u < W; ++u) {
+        if (image[(size_t)(H - 1) * W + u]) { sum1 += u; ++n1; }
+        if (image2[(size_t)(H - 1) * W + u]) { sum2 += u; ++n2; }
+    }
+    check(n1 > 0 && n2 > 0 && sum2 / n2 > sum1 / n1 + 10, "车辆偏左时赛道中线在图像中偏右");
+
+    TrackCamera noisy;
+    noisy.configure(options);
+    VehiclePose outside;
+    outside.x = 100;
+    noisy.render(map, outside, 200, 50, 10, image2.data(), W);
+    int low = 255, high = 0;
+    for (int u = 0; u < W; ++u) {
+        low = std::min(low, (int)image2[u]);
+        high = std::max(high, (int)image2[u]);
+    }
+    check(low >= 40 && high <= 60 && high > low, "噪声幅度");
+}
+
+static void test_vehicle() {
+    std::printf("\n== 车辆模型 ==\n");
+    VehicleParams params;
+    VehicleModel car(params);
+    car.reset(VehiclePose());
+    for (int i = 0; i < 300; ++i) {
+        car.step(0, 0.25f, 0.01f);
+    }
+    check(std::fabs(car.speed() - 1.0f) < 0.02f && std::fabs(car.pose().y) < 1e-4f, "直行稳态速度");
+
+    // 舵机 20° → 前轮 10°：半径 L / tan(10°) ≈ 1.134m，稳态角速度 v / R
+    for (int i = 0; i < 300; ++i) {
+        car.step(20, 0.25f, 0.01f);
+    }
+    float radius = car.speed() / car.yawRate();
+    check(std::fabs(radius - params.wheelbase / std::tan(10 * 3.14159265f / 180)) < 0.01f, "转弯半径");
+    check(car.leftSpeed() < car.speed() && car.rightSpeed() > car.speed(), "左转时右轮快于左轮");
+
+    for (int i = 0; i < 300; ++i) {
+        car.step(60, 1.0f, 0.01f);
+    }
+    check(car.steer() <= params.max_steer_deg * 3.14159265f / 180 + 1e-6f, "前轮转角限幅");
+    check(car.speed() * car.yawRate() <= params.max_lateral_accel + 1e-3f, "高速急转时侧向加速度受限（推头）");
+}
+
+/*
+    简化感知：原图某一行路面像素的平均列相对图像中心的偏差作为像素偏差（只用于验证闭环的连接，不代替车上的巡线）
+*/
+static float row_centroid_error(const std::vector<uint8_t>& image, int row, float previous) {
+    const uint8_t* p = &image[(size_t)row * W];
+    long sum = 0;
+    int count = 0;
+    for (int u = 0; u < W; ++u) {
+        if (p[u]) {
+            sum += u;
+            ++count;
+        }
+    }
+    return count > 0 ? (float)sum / count - (W - 1) / 2.0f : previous;
+}
+
+static PID gains(float kp, float ki, float kd, float limit) {
+    PID pid;
+    pid.Kp = kp;
+    pid.Ki = ki;
+    pid.Kd = kd;
+    pid.Plimit = limit;
+    pid.Ilimit = limit;
+    pid.Dlimit = limit;
+    pid.Reslimit = limit;
+    return pid;
+}
+
+static void test_closed_loop() {
+    std::printf("\n== 闭环：简化感知 + CascadedController ==\n");
+    TrackMap map;
+    std::string error;
+    check(map.build("width 0.45\nstraight 2.0\nleft 1.0 180\nstraight 2.0\nleft 1.0 180\n", 0.01f, &error) &&
+          map.closed(), "椭圆赛道");
+    TrackCamera camera;
+    camera.configure(default_camera());
+    VehicleModel car;
+    car.reset(VehiclePose());
+    LapTracker tracker(&map);
+    tracker.reset(0);
+
+    PID angle, servo = gains(1.0f, 0, 0.02f, 30), motor = gains(1.0f, 4.0f, 0, 100);
+    CascadedController controller(angle, servo, motor);
+    const double meters_per_count = 0.000193;
+    const float speed_target = (float)(1.2 / 100 / meters_per_count);
+
+    std::vector<uint8_t> image((size_t)W * H);
+    float pixel_error = 0;
+    std::vector<LapResult> laps;
+    auto start = std::chrono::steady_clock::now();
+    int steps = 0;
+    for (; steps < 100 * 60 && laps.size() < 3; ++steps) {
+        // 50 帧/秒成像，控制 100Hz
+        if (steps % 2 == 0) {
+            camera.render(map, car.pose(), 255, 0, 0, image.data(), W);
+            pixel_error = row_centroid_error(image, LOOKAHEAD_ROW, pixel_error);
+        }
+        ControllerInput in;
+        in.timestamp_ns = (int64_t)(steps + 1) * 10000000LL;
+        in.pixel_error = pixel_error;
+        in.yaw_rate = car.yawRate() * 180 / 3.14159265f;
+        in.speed_target = speed_target;
+        in.speed_present = (float)(car.speed() / 100 / meters_per_count);
+        ControllerOutput out = controller.step(in);
+        car.step(out.servo, out.motor / motor.Reslimit, 0.01f);
+        LapResult lap;
+        if (tracker.update(car.pose(), (steps + 1) * 0.01, &lap)) {
+            std::printf("第 %d 圈 %s：%.2fs，平均 %.2fm/s，最大偏差 %.3fm，RMS %.3fm\n", lap.lap,
+                        lap.completed ? "完成" : "冲出赛道", lap.time_s, lap.mean_speed, lap.max_lateral,
+                        lap.rms_lateral);
+            laps.push_back(lap);
+            if (!lap.completed) {
+                break;
+            }
+        }
+    }
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("仿真 %.1fs 用时 %.3fs（%.0f 倍实时）\n", steps * 0.01, wall_s, steps * 0.01 / wall_s);
+    check(laps.size() == 3 && laps[0].completed && laps[1].completed && laps[2].completed, "连续跑完 3 圈");
+    check(!laps.empty() && laps.back().max_lateral < map.width() / 2, "全程未冲出赛道");
+
+    // 不转向时在第一个弯道冲出赛道
+    VehicleModel blind;
+    blind.reset(VehiclePose());
+    LapTracker tracker2(&map);
+    tracker2.reset(0);
+    LapResult lap;
+    bool finished = false;
+    for (int i = 0; i < 1000 && !finished; ++i) {
+        blind.step(0, 0.3f, 0.01f);
+        finished = tracker2.update(blind.pose(), (i + 1) * 0.01, &lap);
+    }
+    check(finished && !lap.completed && tracker2.offTrack() && tracker2.progress() > 1.8f, "直行在弯道处冲出赛道");
+}
+
+int main() {
+    test_map();
+    test_camera();
+    test_vehicle();
+    test_closed_loop();
+    return test_report();
+}